@@ -0,0 +1,548 @@
+#include "bench.h"
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace bench {
+
+namespace detail {
+
+void use_char_pointer(const volatile char*) noexcept {}
+
+} // namespace detail
+
+namespace {
+
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && !defined(_DEBUG))
+constexpr bool optimized_build = true;
+#else
+constexpr bool optimized_build = false;
+#endif
+
+// Calibration never runs more iterations than this, however fast the body
+constexpr std::uint64_t max_iterations = 1'000'000'000;
+
+} // namespace
+
+// =============================================================================
+// State
+// =============================================================================
+
+bool State::keep_running_slow() noexcept {
+    if (!started_) {
+        started_ = true;
+        start_clock();
+        if (iterations_ != 0) {
+            remaining_ = iterations_ - 1;
+            return true;
+        }
+    }
+    if (running_) {
+        stop_clock();
+    }
+    return false;
+}
+
+void State::start_clock() noexcept {
+    running_ = true;
+    if (counters_ != nullptr) {
+        counters_->start();
+    }
+    resumed_at_ = Clock::now();
+}
+
+void State::stop_clock() noexcept {
+    const auto now = Clock::now();
+    if (counters_ != nullptr) {
+        const auto values = counters_->stop();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            counted_[i] += values[i];
+        }
+    }
+    elapsed_ += std::chrono::duration_cast<std::chrono::nanoseconds>(now - resumed_at_);
+    running_ = false;
+}
+
+void State::pause_timing() noexcept {
+    if (running_) {
+        stop_clock();
+    }
+}
+
+void State::resume_timing() noexcept {
+    if (!running_) {
+        start_clock();
+    }
+}
+
+// =============================================================================
+// Running
+// =============================================================================
+
+namespace {
+
+struct Run {
+    std::chrono::nanoseconds elapsed;
+    PerfCounters::Values counters;
+    std::int64_t items;
+    std::int64_t bytes;
+};
+
+Run run_once(const Function& body, std::uint64_t iterations, std::int64_t arg,
+             PerfCounters* counters) {
+    State state{iterations, arg, counters};
+    body(state);
+    return Run{state.elapsed(), state.counter_values(), state.items_per_iteration(),
+               state.bytes_per_iteration()};
+}
+
+std::uint64_t calibrate(const Function& body, std::int64_t arg, std::chrono::nanoseconds target) {
+    std::uint64_t iterations = 1;
+    while (true) {
+        const auto elapsed = run_once(body, iterations, arg, nullptr).elapsed;
+        if (elapsed >= target || iterations >= max_iterations) {
+            return iterations;
+        }
+        // Aim 40% past the target, growing at least 2x and at most 10x per step
+        double factor = 10.0;
+        if (elapsed.count() > 0) {
+            factor = 1.4 * static_cast<double>(target.count()) /
+                     static_cast<double>(elapsed.count());
+            factor = std::clamp(factor, 2.0, 10.0);
+        }
+        iterations = std::min(
+            max_iterations, static_cast<std::uint64_t>(static_cast<double>(iterations) * factor));
+    }
+}
+
+} // namespace
+
+Result run(const std::string& name, const Function& body, std::int64_t arg,
+           const Options& options) {
+    using namespace std::chrono;
+
+    const std::uint64_t iterations = calibrate(body, arg, options.min_time);
+
+    const auto warmup_end = steady_clock::now() + options.warmup;
+    while (steady_clock::now() < warmup_end) {
+        run_once(body, iterations, arg, nullptr);
+    }
+
+    std::unique_ptr<PerfCounters> counters;
+    if (options.counters) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->available()) {
+            counters.reset();
+        }
+    }
+
+    Result result;
+    result.name = name;
+    result.arg = arg;
+    result.iterations = iterations;
+
+    const int repetitions = std::max(1, options.repetitions);
+    std::array<std::vector<double>, PerfCounters::event_count> counter_samples;
+    std::int64_t items = 0;
+    std::int64_t bytes = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        const Run run = run_once(body, iterations, arg, counters.get());
+        const auto per_iteration = static_cast<double>(iterations);
+        result.samples_ns.push_back(static_cast<double>(run.elapsed.count()) / per_iteration);
+        for (std::size_t i = 0; i < counter_samples.size(); ++i) {
+            counter_samples[i].push_back(static_cast<double>(run.counters[i]) / per_iteration);
+        }
+        items = run.items;
+        bytes = run.bytes;
+    }
+
+    result.time_ns = summarize(result.samples_ns);
+    if (result.time_ns.median > 0.0) {
+        const double per_second = 1e9 / result.time_ns.median;
+        result.items_per_second = static_cast<double>(items) * per_second;
+        result.bytes_per_second = static_cast<double>(bytes) * per_second;
+    }
+    if (counters) {
+        result.has_counters = true;
+        for (std::size_t i = 0; i < counter_samples.size(); ++i) {
+            result.counters[i] = median(counter_samples[i]);
+        }
+    }
+    return result;
+}
+
+// =============================================================================
+// Registration
+// =============================================================================
+
+Benchmark* Benchmark::range(std::int64_t lo, std::int64_t hi, std::int64_t multiplier) {
+    if (lo <= 0 || hi < lo || multiplier < 2) {
+        throw std::invalid_argument{"Benchmark::range: need 0 < lo <= hi and multiplier >= 2"};
+    }
+    for (std::int64_t value = lo;; value *= multiplier) {
+        args_.push_back(value);
+        if (value > hi / multiplier) {
+            break;
+        }
+    }
+    if (args_.back() != hi) {
+        args_.push_back(hi);
+    }
+    return this;
+}
+
+namespace {
+
+std::vector<std::unique_ptr<Benchmark>>& registry() {
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+} // namespace
+
+Benchmark* register_benchmark(std::string name, Function body) {
+    auto& benchmarks = registry();
+    benchmarks.push_back(std::make_unique<Benchmark>(std::move(name), std::move(body)));
+    return benchmarks.back().get();
+}
+
+const std::vector<std::unique_ptr<Benchmark>>& registered_benchmarks() {
+    return registry();
+}
+
+// =============================================================================
+// Command line
+// =============================================================================
+
+namespace {
+
+long parse_number(std::string_view flag, std::string_view text) {
+    long value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || end != text.data() + text.size() || value < 0) {
+        throw std::invalid_argument{"invalid value for " + std::string{flag} + ": '" +
+                                    std::string{text} + "'"};
+    }
+    return value;
+}
+
+} // namespace
+
+Options parse_options(int argc, const char* const* argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const auto eq = arg.find('=');
+        const std::string_view flag = arg.substr(0, eq);
+        const std::string_view value = eq == std::string_view::npos ? "" : arg.substr(eq + 1);
+
+        if (flag == "--format") {
+            if (value == "console") {
+                options.format = Format::console;
+            } else if (value == "json") {
+                options.format = Format::json;
+            } else if (value == "csv") {
+                options.format = Format::csv;
+            } else {
+                throw std::invalid_argument{"unknown format '" + std::string{value} + "'"};
+            }
+        } else if (flag == "--out") {
+            options.output = value;
+        } else if (flag == "--filter") {
+            options.filter = value;
+        } else if (flag == "--repetitions") {
+            options.repetitions = static_cast<int>(parse_number(flag, value));
+        } else if (flag == "--min-time") {
+            options.min_time = std::chrono::milliseconds{parse_number(flag, value)};
+        } else if (flag == "--warmup") {
+            options.warmup = std::chrono::milliseconds{parse_number(flag, value)};
+        } else if (flag == "--counters") {
+            options.counters = true;
+        } else if (flag == "--list") {
+            options.list = true;
+        } else {
+            throw std::invalid_argument{"unknown option '" + std::string{arg} + "'"};
+        }
+    }
+    return options;
+}
+
+// =============================================================================
+// Reporting
+// =============================================================================
+
+namespace {
+
+std::string format_time(double ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    if (ns < 1e3) {
+        out << ns << " ns";
+    } else if (ns < 1e6) {
+        out << ns / 1e3 << " us";
+    } else if (ns < 1e9) {
+        out << ns / 1e6 << " ms";
+    } else {
+        out << ns / 1e9 << " s";
+    }
+    return out.str();
+}
+
+std::string format_rate(double per_second, std::string_view unit) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (per_second >= 1e9) {
+        out << per_second / 1e9 << " G";
+    } else if (per_second >= 1e6) {
+        out << per_second / 1e6 << " M";
+    } else if (per_second >= 1e3) {
+        out << per_second / 1e3 << " k";
+    } else {
+        out << per_second << " ";
+    }
+    out << unit << "/s";
+    return out.str();
+}
+
+std::string json_escape(std::string_view text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string today() {
+    const std::time_t now = std::time(nullptr);
+    char buffer[32];
+    const std::size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S",
+                                        std::localtime(&now));
+    return std::string{buffer, n};
+}
+
+bool any_counters(const std::vector<Result>& results) {
+    return std::any_of(results.begin(), results.end(),
+                       [](const Result& r) { return r.has_counters; });
+}
+
+} // namespace
+
+void write_console(std::ostream& out, const std::vector<Result>& results, const Options& options) {
+    std::size_t width = 24;
+    for (const auto& r : results) {
+        width = std::max(width, r.name.size() + 2);
+    }
+    const bool counters = any_counters(results);
+
+    out << std::left << std::setw(static_cast<int>(width)) << "benchmark" << std::right
+        << std::setw(14) << "median" << std::setw(9) << "MAD" << std::setw(13) << "iterations"
+        << std::setw(16) << "throughput";
+    if (counters) {
+        out << std::setw(12) << "cycles" << std::setw(12) << "instr" << std::setw(10) << "IPC"
+            << std::setw(12) << "LLC miss" << std::setw(12) << "br miss";
+    }
+    out << "\n" << std::string(width + 52 + (counters ? 58 : 0), '-') << "\n";
+
+    for (const auto& r : results) {
+        std::ostringstream mad;
+        mad << std::fixed << std::setprecision(1) << r.time_ns.mad_percent() << "%";
+        std::string throughput;
+        if (r.bytes_per_second > 0.0) {
+            throughput = format_rate(r.bytes_per_second, "B");
+        } else if (r.items_per_second > 0.0) {
+            throughput = format_rate(r.items_per_second, "items");
+        }
+
+        out << std::left << std::setw(static_cast<int>(width)) << r.name << std::right
+            << std::setw(14) << format_time(r.time_ns.median) << std::setw(9) << mad.str()
+            << std::setw(13) << r.iterations << std::setw(16) << throughput;
+        if (r.has_counters) {
+            const double cycles = r.counters[PerfCounters::cycles];
+            const double instructions = r.counters[PerfCounters::instructions];
+            out << std::fixed << std::setprecision(1) << std::setw(12) << cycles
+                << std::setw(12) << instructions << std::setprecision(2) << std::setw(10)
+                << (cycles > 0.0 ? instructions / cycles : 0.0) << std::setprecision(1)
+                << std::setw(12) << r.counters[PerfCounters::cache_misses] << std::setw(12)
+                << r.counters[PerfCounters::branch_misses];
+            out.unsetf(std::ios::floatfield);
+        }
+        out << "\n";
+    }
+
+    out << "\n" << options.repetitions << " repetitions of at least " << options.min_time.count()
+        << " ms each; median time per iteration, MAD as % of median\n";
+    if (options.counters && !counters) {
+        out << "Hardware counters unavailable (perf_event_open not permitted here)\n";
+    }
+    if (!optimized_build) {
+        out << "Warning: built without optimization; timings are not representative\n";
+    }
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results, const Options& options) {
+    out << std::setprecision(10);
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << today() << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"optimized\": " << (optimized_build ? "true" : "false") << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << ",\n";
+    out << "    \"min_time_ms\": " << options.min_time.count() << ",\n";
+    out << "    \"warmup_ms\": " << options.warmup.count() << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n";
+        out << "      \"name\": \"" << json_escape(r.name) << "\",\n";
+        out << "      \"arg\": " << r.arg << ",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"median_ns\": " << r.time_ns.median << ",\n";
+        out << "      \"mad_ns\": " << r.time_ns.mad << ",\n";
+        out << "      \"mean_ns\": " << r.time_ns.mean << ",\n";
+        out << "      \"min_ns\": " << r.time_ns.min << ",\n";
+        out << "      \"max_ns\": " << r.time_ns.max << ",\n";
+        out << "      \"items_per_second\": " << r.items_per_second << ",\n";
+        out << "      \"bytes_per_second\": " << r.bytes_per_second << ",\n";
+        if (r.has_counters) {
+            out << "      \"counters\": {";
+            for (std::size_t c = 0; c < r.counters.size(); ++c) {
+                out << (c == 0 ? "" : ", ") << "\"" << PerfCounters::names[c]
+                    << "\": " << r.counters[c];
+            }
+            out << "},\n";
+        }
+        out << "      \"samples_ns\": [";
+        for (std::size_t s = 0; s < r.samples_ns.size(); ++s) {
+            out << (s == 0 ? "" : ", ") << r.samples_ns[s];
+        }
+        out << "]\n    }";
+    }
+    out << (results.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
+
+void write_csv(std::ostream& out, const std::vector<Result>& results) {
+    out << std::setprecision(10);
+    out << "name,arg,iterations,repetitions,median_ns,mad_ns,mean_ns,min_ns,max_ns,"
+           "items_per_second,bytes_per_second";
+    for (const auto name : PerfCounters::names) {
+        out << "," << name;
+    }
+    out << "\n";
+    for (const auto& r : results) {
+        out << "\"" << r.name << "\"," << r.arg << "," << r.iterations << ","
+            << r.samples_ns.size() << "," << r.time_ns.median << "," << r.time_ns.mad << ","
+            << r.time_ns.mean << "," << r.time_ns.min << "," << r.time_ns.max << ","
+            << r.items_per_second << "," << r.bytes_per_second;
+        for (const double value : r.counters) {
+            out << ",";
+            if (r.has_counters) {
+                out << value;
+            }
+        }
+        out << "\n";
+    }
+}
+
+// =============================================================================
+// Entry point
+// =============================================================================
+
+namespace {
+
+constexpr std::string_view usage =
+    "Options:\n"
+    "  --format=console|json|csv  report format (default console)\n"
+    "  --out=FILE                 write the report to FILE instead of stdout\n"
+    "  --filter=TEXT              run only benchmarks whose name contains TEXT\n"
+    "  --repetitions=N            measured runs per benchmark (default 10)\n"
+    "  --min-time=MS              minimum duration of each run (default 100)\n"
+    "  --warmup=MS                warm-up time before measuring (default 50)\n"
+    "  --counters                 collect hardware counters (Linux perf_event_open)\n"
+    "  --list                     print benchmark names and exit\n";
+
+} // namespace
+
+int run_main(int argc, const char* const* argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    // Expand arguments into concrete runs before measuring anything
+    struct Job {
+        std::string name;
+        const Benchmark* benchmark;
+        std::int64_t arg;
+    };
+    std::vector<Job> jobs;
+    for (const auto& b : registered_benchmarks()) {
+        if (b->arguments().empty()) {
+            jobs.push_back({b->name(), b.get(), 0});
+        }
+        for (const auto arg : b->arguments()) {
+            jobs.push_back({b->name() + "/" + std::to_string(arg), b.get(), arg});
+        }
+    }
+    std::erase_if(jobs, [&](const Job& job) {
+        return job.name.find(options.filter) == std::string::npos;
+    });
+
+    if (options.list) {
+        for (const auto& job : jobs) {
+            std::cout << job.name << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for (const auto& job : jobs) {
+        if (options.format != Format::console || !options.output.empty()) {
+            std::cerr << "Running " << job.name << "...\n";
+        }
+        try {
+            results.push_back(run(job.name, job.benchmark->body(), job.arg, options));
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << job.name << " threw: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Error: cannot write to " << options.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    switch (options.format) {
+    case Format::console:
+        write_console(out, results, options);
+        break;
+    case Format::json:
+        write_json(out, results, options);
+        break;
+    case Format::csv:
+        write_csv(out, results);
+        break;
+    }
+    return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,267 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "perf_counters.h"
+#include "stats.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace bench {
+
+// =============================================================================
+// Optimization barriers
+// =============================================================================
+
+namespace detail {
+void use_char_pointer(const volatile char* p) noexcept;
+} // namespace detail
+
+/**
+ * Makes the compiler believe `value` is read by something it cannot see,
+ * so the computation that produced it cannot be deleted as dead code.
+ *
+ * It does not stop the compiler from computing `value` once and hoisting
+ * it out of the benchmark loop when its inputs do not change; pass the
+ * inputs through do_not_optimize too, or vary them per iteration.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    detail::use_char_pointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#endif
+}
+
+// Non-const overload: the compiler must also assume `value` was modified
+template <typename T>
+inline void do_not_optimize(T& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+    #if defined(__clang__)
+        asm volatile("" : "+r,m"(value) : : "memory");
+    #else
+        asm volatile("" : "+m,r"(value) : : "memory");
+    #endif
+    } else {
+        asm volatile("" : "+m"(value) : : "memory");
+    }
+#else
+    detail::use_char_pointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#endif
+}
+
+/**
+ * Forces every pending store to memory to be treated as observable:
+ * writes before this point cannot be removed or moved past it. Use after
+ * filling a buffer nothing else reads.
+ */
+inline void clobber_memory() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+// =============================================================================
+// Benchmark state
+// =============================================================================
+
+/**
+ * Handed to a benchmark body; drives the timed loop.
+ *
+ *     void sort_doubles(bench::State& state) {
+ *         const auto input = random_doubles(state.arg());
+ *         while (state.keep_running()) {
+ *             state.pause_timing();
+ *             auto v = input;
+ *             state.resume_timing();
+ *             std::sort(v.begin(), v.end());
+ *             bench::do_not_optimize(v.data());
+ *         }
+ *         state.set_items_per_iteration(state.arg());
+ *     }
+ *
+ * Only the loop is timed: set-up before the first keep_running() call and
+ * tear-down after the last one are free. The runner decides how many
+ * iterations the loop makes.
+ */
+class State {
+public:
+    State(std::uint64_t iterations, std::int64_t arg, PerfCounters* counters) noexcept
+        : iterations_{iterations}, arg_{arg}, counters_{counters} {}
+
+    State(const State&) = delete;
+    State& operator=(const State&) = delete;
+
+    // True once per iteration; starts the clock on the first call and stops
+    // it when the loop ends
+    bool keep_running() noexcept {
+        if (remaining_ != 0) [[likely]] {
+            --remaining_;
+            return true;
+        }
+        return keep_running_slow();
+    }
+
+    // Excludes per-iteration set-up from the measurement. Each pause costs
+    // two clock reads, so it only suits iterations of a microsecond or more.
+    void pause_timing() noexcept;
+    void resume_timing() noexcept;
+
+    // For throughput: work done by one iteration of the loop
+    void set_items_per_iteration(std::int64_t items) noexcept { items_ = items; }
+    void set_bytes_per_iteration(std::int64_t bytes) noexcept { bytes_ = bytes; }
+
+    [[nodiscard]] std::uint64_t iterations() const noexcept { return iterations_; }
+    [[nodiscard]] std::int64_t arg() const noexcept { return arg_; }
+
+    [[nodiscard]] std::chrono::nanoseconds elapsed() const noexcept { return elapsed_; }
+    [[nodiscard]] const PerfCounters::Values& counter_values() const noexcept {
+        return counted_;
+    }
+    [[nodiscard]] std::int64_t items_per_iteration() const noexcept { return items_; }
+    [[nodiscard]] std::int64_t bytes_per_iteration() const noexcept { return bytes_; }
+
+private:
+    bool keep_running_slow() noexcept;
+    void start_clock() noexcept;
+    void stop_clock() noexcept;
+
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t remaining_ = 0;
+    std::uint64_t iterations_;
+    std::int64_t arg_;
+    PerfCounters* counters_;
+    bool started_ = false;
+    bool running_ = false;
+
+    Clock::time_point resumed_at_{};
+    std::chrono::nanoseconds elapsed_{0};
+    PerfCounters::Values counted_{};
+    std::int64_t items_ = 0;
+    std::int64_t bytes_ = 0;
+};
+
+// =============================================================================
+// Running and reporting
+// =============================================================================
+
+using Function = std::function<void(State&)>;
+
+enum class Format { console, json, csv };
+
+struct Options {
+    std::chrono::milliseconds min_time{100};  // per repetition
+    std::chrono::milliseconds warmup{50};
+    int repetitions = 10;
+    bool counters = false;  // hardware counters, if the OS allows
+    Format format = Format::console;
+    std::string filter;  // run only benchmarks whose name contains this
+    std::string output;  // file to write to; empty for stdout
+    bool list = false;   // print the names and exit
+};
+
+struct Result {
+    std::string name;
+    std::int64_t arg = 0;
+    std::uint64_t iterations = 0;   // per repetition
+    std::vector<double> samples_ns; // nanoseconds per iteration, one per repetition
+    Summary time_ns;
+
+    // Derived from the median time; zero unless the body set them
+    double items_per_second = 0.0;
+    double bytes_per_second = 0.0;
+
+    // Median events per iteration, when counters were requested and available
+    bool has_counters = false;
+    std::array<double, PerfCounters::event_count> counters{};
+};
+
+/**
+ * Measures one benchmark body:
+ *
+ *  1. Calibrate: run with 1, 10, 100... iterations until one run takes at
+ *     least `min_time`. This also fills caches and trains branch predictors.
+ *  2. Warm up: keep running at that count for `warmup` longer, so lazy
+ *     initialization and CPU frequency ramp-up are behind us.
+ *  3. Measure: `repetitions` runs, each recording nanoseconds per iteration.
+ *
+ * The result reports the median and MAD of the repetitions rather than
+ * their mean, which a single interrupted run would skew.
+ */
+Result run(const std::string& name, const Function& body, std::int64_t arg,
+           const Options& options);
+
+// A registered benchmark: a body and the arguments to run it with
+class Benchmark {
+public:
+    Benchmark(std::string name, Function body) : name_{std::move(name)}, body_{std::move(body)} {}
+
+    Benchmark* arg(std::int64_t value) {
+        args_.push_back(value);
+        return this;
+    }
+
+    Benchmark* args(std::initializer_list<std::int64_t> values) {
+        args_.insert(args_.end(), values);
+        return this;
+    }
+
+    // lo, lo * multiplier, ... up to and including hi
+    Benchmark* range(std::int64_t lo, std::int64_t hi, std::int64_t multiplier = 8);
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const Function& body() const noexcept { return body_; }
+    [[nodiscard]] const std::vector<std::int64_t>& arguments() const noexcept { return args_; }
+
+private:
+    std::string name_;
+    Function body_;
+    std::vector<std::int64_t> args_;
+};
+
+// Adds a benchmark to the program-wide list that run_main() runs
+Benchmark* register_benchmark(std::string name, Function body);
+
+[[nodiscard]] const std::vector<std::unique_ptr<Benchmark>>& registered_benchmarks();
+
+// Throws std::invalid_argument for an unknown or malformed flag
+[[nodiscard]] Options parse_options(int argc, const char* const* argv);
+
+void write_console(std::ostream& out, const std::vector<Result>& results, const Options& options);
+void write_json(std::ostream& out, const std::vector<Result>& results, const Options& options);
+void write_csv(std::ostream& out, const std::vector<Result>& results);
+
+// Parses the command line, runs every registered benchmark that matches
+// the filter and writes the report; returns the process exit code
+int run_main(int argc, const char* const* argv);
+
+} // namespace bench
+
+#define TOUR_BENCH_CONCAT_INNER(a, b) a##b
+#define TOUR_BENCH_CONCAT(a, b) TOUR_BENCH_CONCAT_INNER(a, b)
+
+// Registers a function `void fn(bench::State&)` under its own name; chain
+// ->arg(n), ->args({...}) or ->range(lo, hi) to run it once per argument
+#define TOUR_BENCHMARK(fn)                                                                 \
+    [[maybe_unused]] static ::bench::Benchmark* const TOUR_BENCH_CONCAT(                   \
+        tour_benchmark_, __LINE__) = ::bench::register_benchmark(#fn, fn)
+
+#endif // BENCH_H
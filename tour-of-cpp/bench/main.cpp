@@ -0,0 +1,8 @@
+// Entry point for benchmark executables: link against tour_bench_main and
+// register benchmarks with TOUR_BENCHMARK instead of writing main()
+
+#include "bench.h"
+
+int main(int argc, char** argv) {
+    return bench::run_main(argc, argv);
+}
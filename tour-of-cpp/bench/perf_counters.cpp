@@ -0,0 +1,95 @@
+#include "perf_counters.h"
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <cstring>
+#endif
+
+namespace bench {
+
+#if defined(__linux__)
+
+namespace {
+
+int open_event(std::uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;  // the leader starts the group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    constexpr std::array<std::uint64_t, event_count> configs{
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (std::size_t i = 0; i < event_count; ++i) {
+        fds_[i] = open_event(configs[i], i == 0 ? -1 : fds_[0]);
+        if (fds_[i] < 0) {
+            // All or nothing: a partial group would report misleading zeros
+            for (std::size_t j = 0; j < i; ++j) {
+                close(fds_[j]);
+                fds_[j] = -1;
+            }
+            return;
+        }
+    }
+    leader_ = fds_[0];
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounters::start() noexcept {
+    if (!available()) {
+        return;
+    }
+    ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::Values PerfCounters::stop() noexcept {
+    Values values{};
+    if (!available()) {
+        return values;
+    }
+    ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP layout: { nr, value[nr] }
+    std::array<std::uint64_t, 1 + event_count> buffer{};
+    const auto bytes = read(leader_, buffer.data(), sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(sizeof(std::uint64_t)) || buffer[0] != event_count) {
+        return values;
+    }
+    for (std::size_t i = 0; i < event_count; ++i) {
+        values[i] = buffer[1 + i];
+    }
+    return values;
+}
+
+#else
+
+PerfCounters::PerfCounters() = default;
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::start() noexcept {}
+PerfCounters::Values PerfCounters::stop() noexcept { return {}; }
+
+#endif
+
+} // namespace bench
@@ -0,0 +1,54 @@
+#ifndef BENCH_PERF_COUNTERS_H
+#define BENCH_PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace bench {
+
+/**
+ * Hardware performance counters for the calling thread, via Linux
+ * perf_event_open(2).
+ *
+ * Counts CPU cycles, retired instructions, last-level cache misses and
+ * mispredicted branches as one group, so all four cover exactly the same
+ * interval. Opening fails without error on other platforms, inside most
+ * containers, and when /proc/sys/kernel/perf_event_paranoid forbids it;
+ * check available() and carry on without counters.
+ *
+ * Only the thread that opened the counters is measured: work handed to
+ * other threads (a parallel algorithm, a thread pool) is not counted.
+ */
+class PerfCounters {
+public:
+    enum Event : std::size_t { cycles, instructions, cache_misses, branch_misses, event_count };
+
+    using Values = std::array<std::uint64_t, event_count>;
+
+    static constexpr std::array<std::string_view, event_count> names{
+        "cycles", "instructions", "cache_misses", "branch_misses"};
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const noexcept { return leader_ >= 0; }
+
+    // Resets and starts all counters
+    void start() noexcept;
+
+    // Stops the counters and returns what they counted since start()
+    Values stop() noexcept;
+
+private:
+    int leader_ = -1;
+    std::array<int, event_count> fds_{-1, -1, -1, -1};
+};
+
+} // namespace bench
+
+#endif // BENCH_PERF_COUNTERS_H
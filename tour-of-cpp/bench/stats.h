@@ -0,0 +1,88 @@
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace bench {
+
+/**
+ * Robust summary statistics for a handful of repeated measurements.
+ *
+ * Timing samples are not normally distributed: they have a hard floor (the
+ * code cannot run faster than it does) and a long tail of interruptions -
+ * page faults, interrupts, another process on the same core. The mean and
+ * standard deviation are pulled around by that tail; the median and the
+ * median absolute deviation (MAD) are not. One sample in ten can be wild
+ * without moving either.
+ */
+
+// Median of `values`; 0 for an empty sample
+[[nodiscard]] inline double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const std::size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(mid),
+                     values.end());
+    const double upper = values[mid];
+    if (values.size() % 2 != 0) {
+        return upper;
+    }
+    const double lower = *std::max_element(values.begin(),
+                                           values.begin() + static_cast<std::ptrdiff_t>(mid));
+    return (lower + upper) / 2.0;
+}
+
+// Median absolute deviation from the median
+[[nodiscard]] inline double median_absolute_deviation(const std::vector<double>& values) {
+    const double center = median(values);
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (const double v : values) {
+        deviations.push_back(std::abs(v - center));
+    }
+    return median(std::move(deviations));
+}
+
+[[nodiscard]] inline double mean(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(values.begin(), values.end(), 0.0) /
+           static_cast<double>(values.size());
+}
+
+struct Summary {
+    double median = 0.0;
+    double mad = 0.0;
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    // MAD relative to the median, in percent: a quick noise indicator
+    [[nodiscard]] double mad_percent() const noexcept {
+        return median == 0.0 ? 0.0 : 100.0 * mad / median;
+    }
+};
+
+[[nodiscard]] inline Summary summarize(const std::vector<double>& values) {
+    if (values.empty()) {
+        return {};
+    }
+    const auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+    return Summary{
+        .median = median(values),
+        .mad = median_absolute_deviation(values),
+        .mean = mean(values),
+        .min = *lo,
+        .max = *hi,
+    };
+}
+
+} // namespace bench
+
+#endif // BENCH_STATS_H
@@ -0,0 +1,189 @@
+// Benchmark harness tests: statistics, the timed loop, the runner and the
+// report formats
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "bench.h"
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+TEST_CASE("median and MAD", "[bench][stats]") {
+    SECTION("odd and even sample sizes") {
+        REQUIRE(bench::median({3.0, 1.0, 2.0}) == 2.0);
+        REQUIRE(bench::median({4.0, 1.0, 3.0, 2.0}) == 2.5);
+        REQUIRE(bench::median({}) == 0.0);
+    }
+
+    SECTION("an outlier moves the mean but not the median or MAD") {
+        const std::vector<double> calm{10.0, 11.0, 9.0, 10.0, 10.0};
+        std::vector<double> noisy = calm;
+        noisy.push_back(1000.0);
+        noisy.push_back(10.0);
+
+        REQUIRE(bench::median(noisy) == 10.0);
+        REQUIRE(bench::median_absolute_deviation(noisy) == 0.0);
+        REQUIRE(bench::mean(noisy) > 100.0);
+    }
+
+    SECTION("summarize") {
+        const auto s = bench::summarize({1.0, 2.0, 3.0, 4.0, 100.0});
+        REQUIRE(s.median == 3.0);
+        REQUIRE(s.mad == 1.0);
+        REQUIRE(s.min == 1.0);
+        REQUIRE(s.max == 100.0);
+        REQUIRE_THAT(s.mean, WithinAbs(22.0, 1e-9));
+        REQUIRE_THAT(s.mad_percent(), WithinAbs(100.0 / 3.0, 1e-9));
+    }
+}
+
+// ============================================================================
+// State
+// ============================================================================
+
+TEST_CASE("State runs the loop the requested number of times", "[bench][state]") {
+    SECTION("iterations") {
+        bench::State state{1000, 7, nullptr};
+        std::uint64_t count = 0;
+        while (state.keep_running()) {
+            ++count;
+        }
+        REQUIRE(count == 1000);
+        REQUIRE(state.arg() == 7);
+        REQUIRE_FALSE(state.keep_running());
+    }
+
+    SECTION("zero iterations") {
+        bench::State state{0, 0, nullptr};
+        REQUIRE_FALSE(state.keep_running());
+    }
+
+    SECTION("paused time is excluded") {
+        using namespace std::chrono_literals;
+        bench::State state{2, 0, nullptr};
+        while (state.keep_running()) {
+            state.pause_timing();
+            std::this_thread::sleep_for(20ms);
+            state.resume_timing();
+        }
+        REQUIRE(state.elapsed() < 20ms);
+    }
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+TEST_CASE("run scales iterations to the minimum time", "[bench][run]") {
+    using namespace std::chrono_literals;
+    bench::Options options;
+    options.min_time = 5ms;
+    options.warmup = 0ms;
+    options.repetitions = 3;
+
+    const auto result = bench::run(
+        "spin",
+        [](bench::State& state) {
+            std::uint64_t x = 0;
+            while (state.keep_running()) {
+                ++x;
+                bench::do_not_optimize(x);
+            }
+            state.set_items_per_iteration(1);
+        },
+        42, options);
+
+    REQUIRE(result.name == "spin");
+    REQUIRE(result.arg == 42);
+    REQUIRE(result.iterations > 1);
+    REQUIRE(result.samples_ns.size() == 3);
+    REQUIRE(result.time_ns.median > 0.0);
+    REQUIRE(result.items_per_second > 0.0);
+    REQUIRE_FALSE(result.has_counters);
+}
+
+TEST_CASE("Benchmark::range", "[bench][registry]") {
+    bench::Benchmark b{"b", [](bench::State&) {}};
+    b.range(1, 100, 8);
+    REQUIRE(b.arguments() == std::vector<std::int64_t>{1, 8, 64, 100});
+
+    bench::Benchmark exact{"exact", [](bench::State&) {}};
+    exact.range(16, 1024, 4);
+    REQUIRE(exact.arguments() == std::vector<std::int64_t>{16, 64, 256, 1024});
+
+    REQUIRE_THROWS_AS(b.range(0, 10), std::invalid_argument);
+}
+
+// ============================================================================
+// Command line and reports
+// ============================================================================
+
+TEST_CASE("parse_options", "[bench][options]") {
+    SECTION("flags") {
+        const char* argv[] = {"bench", "--format=csv", "--repetitions=3", "--min-time=20",
+                              "--filter=sort", "--counters"};
+        const auto options = bench::parse_options(6, argv);
+        REQUIRE(options.format == bench::Format::csv);
+        REQUIRE(options.repetitions == 3);
+        REQUIRE(options.min_time == std::chrono::milliseconds{20});
+        REQUIRE(options.filter == "sort");
+        REQUIRE(options.counters);
+    }
+
+    SECTION("bad input") {
+        const char* unknown[] = {"bench", "--fast"};
+        REQUIRE_THROWS_AS(bench::parse_options(2, unknown), std::invalid_argument);
+        const char* format[] = {"bench", "--format=xml"};
+        REQUIRE_THROWS_AS(bench::parse_options(2, format), std::invalid_argument);
+        const char* number[] = {"bench", "--repetitions=ten"};
+        REQUIRE_THROWS_AS(bench::parse_options(2, number), std::invalid_argument);
+    }
+}
+
+TEST_CASE("report formats", "[bench][report]") {
+    bench::Result r;
+    r.name = "sort/1024";
+    r.arg = 1024;
+    r.iterations = 100;
+    r.samples_ns = {10.0, 12.0, 11.0};
+    r.time_ns = bench::summarize(r.samples_ns);
+    const std::vector<bench::Result> results{r};
+    const bench::Options options;
+
+    SECTION("json") {
+        std::ostringstream out;
+        bench::write_json(out, results, options);
+        const auto text = out.str();
+        REQUIRE(text.find("\"name\": \"sort/1024\"") != std::string::npos);
+        REQUIRE(text.find("\"median_ns\": 11") != std::string::npos);
+        REQUIRE(text.find("\"samples_ns\": [10, 12, 11]") != std::string::npos);
+    }
+
+    SECTION("csv") {
+        std::ostringstream out;
+        bench::write_csv(out, results);
+        std::istringstream lines{out.str()};
+        std::string header;
+        std::string row;
+        std::getline(lines, header);
+        std::getline(lines, row);
+        REQUIRE(header.rfind("name,arg,iterations,repetitions,median_ns", 0) == 0);
+        REQUIRE(row.rfind("\"sort/1024\",1024,100,3,11,", 0) == 0);
+    }
+
+    SECTION("console") {
+        std::ostringstream out;
+        bench::write_console(out, results, options);
+        REQUIRE(out.str().find("sort/1024") != std::string::npos);
+        REQUIRE(out.str().find("11.00 ns") != std::string::npos);
+    }
+}
@@ -14,6 +14,10 @@
 #include <vector>
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <initializer_list>
+#include <iterator>
 
 // =============================================================================
 // Class Invariants
@@ -136,7 +140,7 @@ public:
                 std::to_string(amount));
         }
 
-        double old_balance = balance_;  // Store for postcondition check
+        [[maybe_unused]] double old_balance = balance_;  // Store for postcondition check
         balance_ += amount;
 
         // Verify postcondition in debug builds
@@ -169,7 +173,7 @@ public:
                 ", available " + std::to_string(balance_));
         }
 
-        double old_balance = balance_;
+        [[maybe_unused]] double old_balance = balance_;
         balance_ -= amount;
 
         // Verify postcondition
@@ -226,23 +230,82 @@ void demonstrate_bank_account() {
 // Container with Strong Invariants
 // =============================================================================
 
+/**
+ * Whether SortedVector checks its invariant. Checking is on in debug
+ * builds and compiled out when NDEBUG is defined, as assert is. Define
+ * SORTED_VECTOR_CHECK_INVARIANTS as 1 to keep the checks in a release
+ * build, or as 0 to drop them from a debug build.
+ */
+#ifndef SORTED_VECTOR_CHECK_INVARIANTS
+#ifdef NDEBUG
+#define SORTED_VECTOR_CHECK_INVARIANTS 0
+#else
+#define SORTED_VECTOR_CHECK_INVARIANTS 1
+#endif
+#endif
+
 /**
  * A sorted vector that maintains the invariant of being sorted.
  *
- * Invariant: elements are always in sorted order
+ * Invariant: elements are always in sorted order (duplicates allowed)
+ *
+ * Inserting one element shifts the larger ones, so building the vector
+ * element by element is O(n^2). insert_range() adds many elements at
+ * O(n + m log m) instead, which makes the vector a read-optimized index
+ * for millions of elements: build it in bulk, then binary-search it.
+ *
+ * Checking the invariant costs as much as the cheapest operation allows.
+ * After a single insert or remove only the neighbours of the changed
+ * position can be out of order, so only they are compared. The full O(n)
+ * scan runs only after bulk operations, which are O(n) anyway.
  */
 template<typename T>
 class SortedVector {
 public:
     SortedVector() = default;
 
+    /**
+     * Build from unsorted elements with a single sort.
+     * Postcondition: is_sorted() returns true
+     */
+    template<std::input_iterator It>
+    SortedVector(It first, It last) : data_(first, last) {
+        std::sort(data_.begin(), data_.end());
+        check_invariant();
+    }
+
+    SortedVector(std::initializer_list<T> init)
+        : SortedVector(init.begin(), init.end()) {}
+
     /**
      * Insert an element while maintaining sorted order.
      * Postcondition: is_sorted() returns true
      */
     void insert(const T& value) {
         auto pos = std::lower_bound(data_.begin(), data_.end(), value);
-        data_.insert(pos, value);
+        pos = data_.insert(pos, value);
+        // The new element against both of its neighbours
+        check_neighbours(pos, 2);
+    }
+
+    /**
+     * Insert many elements at once: append them, sort only the new tail,
+     * and merge the two sorted runs in place. O(n + m log m) for m new
+     * elements, against O(m * n) for m calls to insert().
+     * Postcondition: is_sorted() returns true
+     */
+    template<std::input_iterator It>
+    void insert_range(It first, It last) {
+        const auto old_size = static_cast<std::ptrdiff_t>(data_.size());
+        data_.insert(data_.end(), first, last);
+        const auto middle = data_.begin() + old_size;
+        std::sort(middle, data_.end());
+
+        // Nothing to merge when the new elements all sort after the old ones
+        if (middle != data_.begin() && middle != data_.end() &&
+            *middle < *std::prev(middle)) {
+            std::inplace_merge(data_.begin(), middle, data_.end());
+        }
         check_invariant();
     }
 
@@ -255,8 +318,9 @@ public:
         if (it == data_.end() || *it != value) {
             throw std::out_of_range("Element not found in sorted vector");
         }
-        data_.erase(it);
-        check_invariant();
+        it = data_.erase(it);
+        // The elements that are now adjacent across the gap
+        check_neighbours(it, 1);
     }
 
     /**
@@ -268,8 +332,40 @@ public:
         return std::binary_search(data_.begin(), data_.end(), value);
     }
 
+    // =========================================================================
+    // Set operations: one linear pass over both inputs, whose output is
+    // sorted by construction. Duplicates are treated as by std::set_union
+    // and friends: an element present k times in one and j in the other
+    // appears max(k, j), min(k, j) or k - j times.
+    // =========================================================================
+
+    SortedVector unite(const SortedVector& other) const {
+        std::vector<T> out;
+        out.reserve(data_.size() + other.data_.size());
+        std::set_union(data_.begin(), data_.end(), other.data_.begin(), other.data_.end(),
+                       std::back_inserter(out));
+        return SortedVector(std::move(out));
+    }
+
+    SortedVector intersect(const SortedVector& other) const {
+        std::vector<T> out;
+        out.reserve(std::min(data_.size(), other.data_.size()));
+        std::set_intersection(data_.begin(), data_.end(), other.data_.begin(),
+                              other.data_.end(), std::back_inserter(out));
+        return SortedVector(std::move(out));
+    }
+
+    SortedVector difference(const SortedVector& other) const {
+        std::vector<T> out;
+        out.reserve(data_.size());
+        std::set_difference(data_.begin(), data_.end(), other.data_.begin(),
+                            other.data_.end(), std::back_inserter(out));
+        return SortedVector(std::move(out));
+    }
+
     size_t size() const noexcept { return data_.size(); }
     bool empty() const noexcept { return data_.empty(); }
+    void reserve(size_t n) { data_.reserve(n); }
 
     // Iterator access (const only to prevent invariant violation)
     auto begin() const { return data_.cbegin(); }
@@ -281,13 +377,78 @@ public:
     }
 
 private:
+    // Adopts elements that are already sorted, as the set operations produce
+    explicit SortedVector(std::vector<T> sorted) : data_(std::move(sorted)) {
+        check_invariant();
+    }
+
+    static constexpr bool check_invariants = SORTED_VECTOR_CHECK_INVARIANTS != 0;
+
+    // Throws rather than asserts, so the check also works in a release
+    // build that opts in with SORTED_VECTOR_CHECK_INVARIANTS
     void check_invariant() const {
-        assert(is_sorted() && "Invariant violated: vector is not sorted");
+        if constexpr (check_invariants) {
+            if (!is_sorted()) {
+                throw std::logic_error("Invariant violated: vector is not sorted");
+            }
+        }
+    }
+
+    // After a change at pos, only the elements around it can be out of
+    // order: checks [prev(pos), pos + count), clamped to the vector
+    void check_neighbours(typename std::vector<T>::const_iterator pos,
+                          std::ptrdiff_t count) const {
+        if constexpr (check_invariants) {
+            const auto first = pos == data_.begin() ? pos : std::prev(pos);
+            const auto last = std::next(pos, std::min(count, data_.cend() - pos));
+            if (!std::is_sorted(first, last)) {
+                throw std::logic_error("Invariant violated: vector is not sorted");
+            }
+        }
     }
 
     std::vector<T> data_;
 };
 
+/**
+ * An element whose comparison can be told to lie, standing in for a bug
+ * that makes insert() pick the wrong position.
+ */
+struct Unreliable {
+    int value;
+    static inline int lies = 0;  // This many comparisons answer false
+
+    friend bool operator<(const Unreliable& a, const Unreliable& b) {
+        if (lies > 0) {
+            --lies;
+            return false;
+        }
+        return a.value < b.value;
+    }
+};
+
+// Returns false if a misplaced insert went unnoticed
+bool demonstrate_neighbour_check() {
+    std::cout << "=== Invariant: catching a misplaced insert ===\n\n";
+    if (!SORTED_VECTOR_CHECK_INVARIANTS) {
+        std::cout << "Invariant checks are compiled out\n\n";
+        return true;
+    }
+
+    // lower_bound makes one comparison in a one-element vector; its lie
+    // puts 10 in front of 1, where only the right neighbour is wrong
+    SortedVector<Unreliable> sv{Unreliable{1}};
+    Unreliable::lies = 1;
+    try {
+        sv.insert(Unreliable{10});
+    } catch (const std::logic_error& e) {
+        std::cout << "insert(10) before 1 caught: " << e.what() << "\n\n";
+        return true;
+    }
+    std::cout << "insert(10) before 1 went unnoticed\n\n";
+    return false;
+}
+
 void demonstrate_sorted_vector() {
     std::cout << "=== Invariant: SortedVector ===\n\n";
 
@@ -317,6 +478,47 @@ void demonstrate_sorted_vector() {
     }
     std::cout << '\n';
 
+    // Bulk insert: one sort of the new elements, one merge
+    const std::vector<int> batch{7, 3, 10, 4};
+    sv.insert_range(batch.begin(), batch.end());
+    std::cout << "After insert_range(7, 3, 10, 4): ";
+    for (int val : sv) {
+        std::cout << val << ' ';
+    }
+    std::cout << '\n';
+
+    // Set operations produce new sorted vectors in one pass
+    const SortedVector<int> evens{2, 4, 6, 8, 10};
+    const auto print = [](const char* label, const SortedVector<int>& v) {
+        std::cout << label;
+        for (int val : v) {
+            std::cout << val << ' ';
+        }
+        std::cout << '\n';
+    };
+    print("\nUnion with {2, 4, 6, 8, 10}:        ", sv.unite(evens));
+    print("Intersection with {2, 4, 6, 8, 10}: ", sv.intersect(evens));
+    print("Difference with {2, 4, 6, 8, 10}:   ", sv.difference(evens));
+
+    // An index of a million keys, built in bulk
+    constexpr int n = 1'000'000;
+    std::vector<int> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        keys.push_back(static_cast<int>((static_cast<long long>(i) * 7919) % n));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    SortedVector<int> index;
+    index.insert_range(keys.begin(), keys.begin() + n / 2);
+    index.insert_range(keys.begin() + n / 2, keys.end());
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "\nBuilt an index of " << index.size() << " keys in two insert_range calls: "
+              << elapsed.count() << " ms\n";
+    std::cout << "(One insert() per key would shift ~n/2 elements each time: O(n^2))\n";
+    std::cout << "Invariant checks: "
+              << (SORTED_VECTOR_CHECK_INVARIANTS ? "on" : "compiled out") << '\n';
+
     std::cout << '\n';
 }
 
@@ -462,6 +664,9 @@ int main() {
     demonstrate_vector_invariant();
     demonstrate_bank_account();
     demonstrate_sorted_vector();
+    if (!demonstrate_neighbour_check()) {
+        return 1;
+    }
     demonstrate_design_by_contract();
 
     std::cout << "All invariant demonstrations completed.\n";
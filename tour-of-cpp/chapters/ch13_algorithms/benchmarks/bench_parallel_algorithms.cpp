@@ -0,0 +1,134 @@
+// Benchmark: standard algorithms under each execution policy
+// Book reference: 13.6 Parallel Algorithms
+//
+// The same comparisons as examples/parallel_algorithms.cpp, measured with
+// the benchmark harness instead of a one-shot Timer: each case is warmed
+// up, run enough times to be timed reliably and repeated, and the median
+// is reported with its spread. Sizes sweep from cache-resident to
+// memory-bound, which shows where parallelism starts to pay off.
+//
+//   ./ch13_bench_parallel_algorithms --filter=sort
+//   ./ch13_bench_parallel_algorithms --format=json --out=ch13.json
+
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One random input per size, shared by every benchmark and repetition
+const std::vector<double>& random_doubles(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<double>> inputs;
+    auto& data = inputs[n];
+    if (data.empty()) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<> dist{0.0, 100.0};
+        data.resize(static_cast<std::size_t>(n));
+        std::generate(data.begin(), data.end(), [&] { return dist(gen); });
+    }
+    return data;
+}
+
+double expensive_computation(double x) {
+    double result = x;
+    for (int i = 0; i < 100; ++i) {
+        result = std::sin(result) * std::cos(result) + std::sqrt(std::abs(result) + 1.0);
+    }
+    return result;
+}
+
+template <typename Policy>
+void sort_doubles(bench::State& state, Policy policy) {
+    const auto& input = random_doubles(state.arg());
+    std::vector<double> v;
+    while (state.keep_running()) {
+        state.pause_timing();
+        v = input;
+        state.resume_timing();
+        std::sort(policy, v.begin(), v.end());
+        bench::do_not_optimize(v.data());
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Policy>
+void transform_expensive(bench::State& state, Policy policy) {
+    const auto& input = random_doubles(state.arg());
+    std::vector<double> out(input.size());
+    while (state.keep_running()) {
+        std::transform(policy, input.begin(), input.end(), out.begin(), expensive_computation);
+        bench::clobber_memory();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Policy>
+void reduce(bench::State& state, Policy policy) {
+    const auto& input = random_doubles(state.arg());
+    while (state.keep_running()) {
+        double sum = std::reduce(policy, input.begin(), input.end(), 0.0);
+        bench::do_not_optimize(sum);
+    }
+    state.set_bytes_per_iteration(state.arg() * static_cast<std::int64_t>(sizeof(double)));
+}
+
+template <typename Policy>
+void find_near_end(bench::State& state, Policy policy) {
+    std::vector<double> haystack(static_cast<std::size_t>(state.arg()), 1.0);
+    haystack[haystack.size() - 1] = -1.0;
+    while (state.keep_running()) {
+        auto it = std::find(policy, haystack.begin(), haystack.end(), -1.0);
+        bench::do_not_optimize(it);
+    }
+    state.set_bytes_per_iteration(state.arg() * static_cast<std::int64_t>(sizeof(double)));
+}
+
+template <typename Policy>
+void count_above_half(bench::State& state, Policy policy) {
+    const auto& input = random_doubles(state.arg());
+    while (state.keep_running()) {
+        auto count = std::count_if(policy, input.begin(), input.end(),
+                                   [](double x) { return x > 50.0; });
+        bench::do_not_optimize(count);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+// Registers `body` once per execution policy, e.g. sort/seq, sort/par
+template <typename Body>
+void register_policies(const std::string& name, Body body, std::int64_t lo, std::int64_t hi) {
+    bench::register_benchmark(name + "/seq", [body](bench::State& s) {
+        body(s, std::execution::seq);
+    })->range(lo, hi, 16);
+    bench::register_benchmark(name + "/par", [body](bench::State& s) {
+        body(s, std::execution::par);
+    })->range(lo, hi, 16);
+    bench::register_benchmark(name + "/par_unseq", [body](bench::State& s) {
+        body(s, std::execution::par_unseq);
+    })->range(lo, hi, 16);
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 12;
+    constexpr std::int64_t large = 1 << 20;
+
+    register_policies("sort", [](bench::State& s, auto p) { sort_doubles(s, p); }, small, large);
+    register_policies("transform", [](bench::State& s, auto p) { transform_expensive(s, p); },
+                      small, 1 << 16);
+    register_policies("reduce", [](bench::State& s, auto p) { reduce(s, p); }, small, large);
+    register_policies("find", [](bench::State& s, auto p) { find_near_end(s, p); }, small, large);
+    register_policies("count_if", [](bench::State& s, auto p) { count_above_half(s, p); }, small,
+                      large);
+    return true;
+}();
+
+} // namespace
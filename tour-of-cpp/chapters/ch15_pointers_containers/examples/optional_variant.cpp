@@ -11,6 +11,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -277,12 +278,18 @@ class Config {
 public:
     using Value = std::variant<bool, int, double, std::string>;
 
-    void set(const std::string& key, Value value) {
-        settings_[key] = std::move(value);
+    void set(std::string_view key, Value value) {
+        if (auto it = settings_.find(key); it != settings_.end()) {
+            it->second = std::move(value);
+        } else {
+            settings_.emplace(std::string(key), std::move(value));
+        }
     }
 
+    // Takes a string_view: the transparent comparator below lets find()
+    // compare it with the stored keys, so a lookup builds no std::string
     template<typename T>
-    std::optional<T> get(const std::string& key) const {
+    std::optional<T> get(std::string_view key) const {
         auto it = settings_.find(key);
         if (it == settings_.end()) {
             return std::nullopt;
@@ -302,7 +309,7 @@ public:
     }
 
 private:
-    std::map<std::string, Value> settings_;
+    std::map<std::string, Value, std::less<>> settings_;
 };
 
 void config_demo() {
@@ -340,6 +347,13 @@ void config_demo() {
     } else {
         std::cout << "Key 'nonexistent' not found\n";
     }
+
+    // Lookup by a slice of a larger string: no std::string is built
+    std::string_view request = "timeout=45";
+    std::string_view name = request.substr(0, request.find('='));
+    if (auto timeout = config.get<double>(name)) {
+        std::cout << "Looked up '" << name << "' by string_view: " << *timeout << "\n";
+    }
 }
 
 // ============================================================================
@@ -9,9 +9,10 @@
 
 #include <functional>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 // ============================================================================
@@ -287,15 +288,39 @@ void mem_fn_demo() {
 // Practical: Event System
 // ============================================================================
 
+// Transparent hash and equality, as in Chapter 12: with both declaring
+// is_transparent, unordered_map::find accepts a std::string_view
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sv) const {
+        return std::hash<std::string_view>{}(sv);
+    }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a == b;
+    }
+};
+
 class EventEmitter {
 public:
     using Handler = std::function<void(const std::string&)>;
 
-    void on(const std::string& event, Handler handler) {
-        handlers_[event].push_back(std::move(handler));
+    void on(std::string_view event, Handler handler) {
+        auto it = handlers_.find(event);
+        if (it == handlers_.end()) {
+            it = handlers_.emplace(std::string(event), std::vector<Handler>{}).first;
+        }
+        it->second.push_back(std::move(handler));
     }
 
-    void emit(const std::string& event, const std::string& data = "") {
+    // Emitting is the hot path: the event name is looked up as a view,
+    // with no std::string built for it
+    void emit(std::string_view event, const std::string& data = "") const {
         if (auto it = handlers_.find(event); it != handlers_.end()) {
             for (const auto& handler : it->second) {
                 handler(data);
@@ -304,7 +329,7 @@ public:
     }
 
 private:
-    std::map<std::string, std::vector<Handler>> handlers_;
+    std::unordered_map<std::string, std::vector<Handler>, StringHash, StringEqual> handlers_;
 };
 
 void event_system_demo() {
@@ -0,0 +1,81 @@
+# Benchmark.cmake - Registering microbenchmarks
+#
+# tour_add_benchmark(<name> <source>... [LIBRARIES <lib>...])
+#
+# Builds a benchmark executable on the shared harness in bench/, which
+# provides main(), warm-up, iteration scaling and median/MAD reporting.
+# Each benchmark also gets:
+# - a place in the `benchmarks` target, which builds them all
+# - a `run_<name>` target writing ${CMAKE_BINARY_DIR}/benchmarks/<name>.json;
+#   `run_benchmarks` runs every one of them, sequentially
+# - a ctest smoke test (one iteration, label "benchmark") so benchmarks keep
+#   compiling and running; skip them with `ctest -LE benchmark`
+#
+# Benchmarks measure nothing useful in a Debug build: use the release preset.
+
+include_guard(GLOBAL)
+
+# Declared here too for projects that include this file on their own
+option(TOUR_BUILD_BENCHMARKS "Build the benchmarks" ON)
+
+if(NOT TARGET tour_bench)
+    add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/../bench ${CMAKE_BINARY_DIR}/tour_bench)
+endif()
+
+set(TOUR_BENCHMARK_REPORT_DIR ${CMAKE_BINARY_DIR}/benchmarks)
+
+function(tour_add_benchmark name)
+    if(NOT TOUR_BUILD_BENCHMARKS)
+        return()
+    endif()
+
+    cmake_parse_arguments(PARSE_ARGV 1 TOUR_BENCH "" "" "LIBRARIES")
+
+    add_executable(${name} ${TOUR_BENCH_UNPARSED_ARGUMENTS})
+    target_link_libraries(${name} PRIVATE tour_bench_main ${TOUR_BENCH_LIBRARIES})
+    if(COMMAND tour_apply_warnings)
+        tour_apply_warnings(${name})
+    endif()
+
+    add_custom_target(run_${name}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${TOUR_BENCHMARK_REPORT_DIR}
+        COMMAND ${name} --format=json --out=${TOUR_BENCHMARK_REPORT_DIR}/${name}.json
+        USES_TERMINAL
+        COMMENT "Running ${name}"
+    )
+    set_property(GLOBAL APPEND PROPERTY TOUR_BENCHMARK_TARGETS ${name})
+
+    if(TOUR_BUILD_TESTS OR BUILD_TESTS)
+        add_test(NAME benchmark::${name}
+                 COMMAND ${name} --min-time=0 --warmup=0 --repetitions=1)
+        set_tests_properties(benchmark::${name} PROPERTIES LABELS benchmark)
+    endif()
+endfunction()
+
+# Creates `benchmarks` and `run_benchmarks` once every directory has
+# registered its benchmarks
+function(_tour_add_benchmark_aggregates)
+    get_property(targets GLOBAL PROPERTY TOUR_BENCHMARK_TARGETS)
+    if(NOT targets)
+        return()
+    endif()
+
+    add_custom_target(benchmarks)
+    add_dependencies(benchmarks ${targets})
+
+    # One command after another, never in parallel: concurrent benchmarks
+    # would compete for cores and caches and skew each other's numbers
+    set(commands)
+    foreach(target ${targets})
+        list(APPEND commands
+            COMMAND ${target} --format=json --out=${TOUR_BENCHMARK_REPORT_DIR}/${target}.json)
+    endforeach()
+    add_custom_target(run_benchmarks
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${TOUR_BENCHMARK_REPORT_DIR}
+        ${commands}
+        USES_TERMINAL
+        COMMENT "Running all benchmarks"
+    )
+endfunction()
+
+cmake_language(DEFER DIRECTORY ${CMAKE_SOURCE_DIR} CALL _tour_add_benchmark_aggregates)
@@ -0,0 +1,293 @@
+#ifndef ARC_CACHE_H
+#define ARC_CACHE_H
+
+#include "cache_common.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace cache {
+
+/**
+ * An adaptive replacement cache (Megiddo and Modha, 2003): like LruCache,
+ * but it also keeps entries that were used more than once safe from a
+ * flood of entries used only once, such as a scan over every key.
+ *
+ * Entries seen once live on T1, entries hit again move to T2, and each
+ * list evicts from its least recently used end. Evicted keys are kept,
+ * without their values, as "ghosts" on B1 and B2. A miss that finds a
+ * ghost in B1 means T1 was too small, and one in B2 that T2 was, so each
+ * such miss shifts the target split between T1 and T2 - no tuning
+ * parameter to choose.
+ *
+ * The interface, complexity and weighing are those of LruCache. Ghosts
+ * count towards neither the capacity nor size(), but their keys stay in
+ * memory: the lists are bounded so that live entries and ghosts together
+ * weigh at most twice the capacity.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>, Weigher<K, V> W = EntryCount>
+class ArcCache {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using weigher = W;
+
+    explicit ArcCache(size_type capacity, const W& weigh = W{}, const Hash& hash = Hash{},
+                      const KeyEqual& equal = KeyEqual{})
+        : capacity_{capacity}, table_{hash, equal}, weigh_{weigh} {}
+
+    // The value for `key`, or nullptr; a hit moves the entry to the front of T2
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    [[nodiscard]] V* get(const Q& key) {
+        const auto i = table_.find(key);
+        if (i == detail::npos || !resident(i)) {
+            ++stats_.misses;
+            return nullptr;
+        }
+        ++stats_.hits;
+        move(i, t2);
+        return &*table_[i].value;
+    }
+
+    [[nodiscard]] V* get(const K& key) { return get<K>(key); }
+
+    // The value for `key` without counting the lookup or touching recency
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    [[nodiscard]] const V* peek(const Q& key) const {
+        const auto i = table_.find(key);
+        return i == detail::npos || !resident(i) ? nullptr : &*table_[i].value;
+    }
+
+    [[nodiscard]] const V* peek(const K& key) const { return peek<K>(key); }
+
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    [[nodiscard]] bool contains(const Q& key) const {
+        return peek(key) != nullptr;
+    }
+
+    [[nodiscard]] bool contains(const K& key) const { return contains<K>(key); }
+
+    /**
+     * Inserts or replaces the value for `key`: onto T1 if the key is new,
+     * onto T2 if it is cached or a ghost. Returns false, leaving no entry
+     * for `key`, if the value alone weighs more than the capacity.
+     */
+    template <typename Q, typename M>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    bool put(Q&& key, M&& value) {
+        V stored_value(std::forward<M>(value));
+        const auto i = table_.find(key);
+        if (i == detail::npos) {
+            return insert_new(K(std::forward<Q>(key)), std::move(stored_value));
+        }
+
+        auto& node = table_[i];
+        const size_type weight = weigh_(node.key, stored_value);
+        if (weight > capacity_) {
+            remove(i);
+            return false;
+        }
+        const bool was_resident = resident(i);
+        const bool in_b2 = node.list == b2;
+        if (!was_resident) {
+            adapt(node.list, weight);
+            ++stats_.insertions;
+        }
+        table_.unlink(lists_[node.list], i);
+        node.weight = weight;
+        node.value = std::move(stored_value);
+        make_room(weight, in_b2);
+        node.list = t2;
+        table_.push_front(lists_[t2], i);
+        return true;
+    }
+
+    template <typename M>
+    bool put(const K& key, M&& value) {
+        return put<const K&, M>(key, std::forward<M>(value));
+    }
+
+    // The value for `key`, calling load(key) and caching the result on a
+    // miss; returns a copy, as LruCache::get_or_load does
+    template <typename Q, std::invocable<const Q&> F>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    V get_or_load(const Q& key, F&& load) {
+        if (const V* cached = get(key)) {
+            return *cached;
+        }
+        V value = std::invoke(std::forward<F>(load), key);
+        put(key, value);
+        return value;
+    }
+
+    template <std::invocable<const K&> F>
+    V get_or_load(const K& key, F&& load) {
+        return get_or_load<K, F>(key, std::forward<F>(load));
+    }
+
+    // Removes the entry for `key` (or forgets its ghost); true if it was cached
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    bool erase(const Q& key) {
+        const auto i = table_.find(key);
+        if (i == detail::npos) {
+            return false;
+        }
+        const bool was_resident = resident(i);
+        remove(i);
+        return was_resident;
+    }
+
+    bool erase(const K& key) { return erase<K>(key); }
+
+    void clear() noexcept {
+        table_.clear();
+        lists_ = {};
+        target_ = 0;
+    }
+
+    // Calls fn(key, value) for every cached entry: T2, then T1, each from
+    // the most to the least recently used
+    template <std::invocable<const K&, const V&> F>
+    void for_each(F&& fn) const {
+        for (const std::uint8_t l : {t2, t1}) {
+            for (auto i = lists_[l].head; i != detail::npos; i = table_[i].next) {
+                std::invoke(fn, table_[i].key, *table_[i].value);
+            }
+        }
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return lists_[t1].size + lists_[t2].size; }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] size_type weight() const noexcept {
+        return lists_[t1].weight + lists_[t2].weight;
+    }
+    [[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+
+    // The weight T1 is currently allowed, out of capacity()
+    [[nodiscard]] size_type recency_target() const noexcept { return target_; }
+
+    // Keys remembered without values, on B1 and B2
+    [[nodiscard]] size_type ghost_count() const noexcept {
+        return lists_[b1].size + lists_[b2].size;
+    }
+
+    // Evicts at once if the cache has become too heavy
+    void set_capacity(size_type capacity) {
+        capacity_ = capacity;
+        target_ = std::min(target_, capacity_);
+        make_room(0, false);
+        trim_ghosts(0);
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+    void reset_stats() noexcept { stats_ = {}; }
+
+private:
+    // Node::list values
+    static constexpr std::uint8_t t1 = 0;  // cached, seen once
+    static constexpr std::uint8_t t2 = 1;  // cached, seen again
+    static constexpr std::uint8_t b1 = 2;  // ghosts evicted from T1
+    static constexpr std::uint8_t b2 = 3;  // ghosts evicted from T2
+
+    [[nodiscard]] bool resident(detail::index_t i) const noexcept { return table_[i].list <= t2; }
+
+    void move(detail::index_t i, std::uint8_t to) noexcept {
+        auto& node = table_[i];
+        table_.move_to_front(lists_[node.list], lists_[to], i);
+        node.list = to;
+    }
+
+    void remove(detail::index_t i) {
+        table_.unlink(lists_[table_[i].list], i);
+        table_.erase(i);
+    }
+
+    bool insert_new(K key, V value) {
+        const size_type weight = weigh_(key, value);
+        if (weight > capacity_) {
+            return false;
+        }
+        // At most `capacity` of T1 and B1 together: forget B1's oldest
+        // ghosts first, then evict from T1 without leaving ghosts
+        auto& recent = lists_[t1];
+        auto& recent_ghosts = lists_[b1];
+        while (recent.weight + recent_ghosts.weight + weight > capacity_ &&
+               recent_ghosts.size != 0) {
+            remove(recent_ghosts.tail);
+        }
+        while (recent.weight + weight > capacity_) {
+            remove(recent.tail);
+            ++stats_.evictions;
+        }
+        trim_ghosts(weight);
+        make_room(weight, false);
+
+        const auto i = table_.insert(std::move(key), std::move(value), weight, t1);
+        table_.push_front(recent, i);
+        ++stats_.insertions;
+        return true;
+    }
+
+    // A ghost hit: grow the target of the list the ghost was evicted from,
+    // by more when the other ghost list is the larger one
+    void adapt(std::uint8_t ghost_list, size_type weight) noexcept {
+        const auto& hit = lists_[ghost_list];
+        const auto& other = lists_[ghost_list == b1 ? b2 : b1];
+        const size_type ratio = other.weight / std::max<size_type>(hit.weight, 1);
+        const size_type delta = std::max<size_type>(weight, 1) * std::max<size_type>(ratio, 1);
+        if (ghost_list == b1) {
+            target_ = std::min(capacity_, target_ + delta);
+        } else {
+            target_ = target_ > delta ? target_ - delta : 0;
+        }
+    }
+
+    // Demotes entries to ghosts until `weight` more fits
+    void make_room(size_type weight, bool ghost_was_in_b2) {
+        while (lists_[t1].weight + lists_[t2].weight + weight > capacity_) {
+            const auto& recent = lists_[t1];
+            const bool from_t1 =
+                recent.size != 0 &&
+                (recent.weight > target_ || (ghost_was_in_b2 && recent.weight == target_) ||
+                 lists_[t2].size == 0);
+            const auto i = from_t1 ? recent.tail : lists_[t2].tail;
+            table_[i].value.reset();
+            move(i, from_t1 ? b1 : b2);
+            ++stats_.evictions;
+        }
+    }
+
+    // Keeps every list together within twice the capacity
+    void trim_ghosts(size_type weight) {
+        const auto total = [this] {
+            return lists_[t1].weight + lists_[t2].weight + lists_[b1].weight + lists_[b2].weight;
+        };
+        while (total() + weight > 2 * capacity_ && ghost_count() != 0) {
+            remove(lists_[b2].size != 0 ? lists_[b2].tail : lists_[b1].tail);
+        }
+    }
+
+    size_type capacity_;
+    size_type target_ = 0;
+    detail::EntryTable<K, V, Hash, KeyEqual> table_;
+    std::array<detail::List, 4> lists_{};
+    Stats stats_;
+    [[no_unique_address]] W weigh_;
+};
+
+} // namespace cache
+
+#endif // ARC_CACHE_H
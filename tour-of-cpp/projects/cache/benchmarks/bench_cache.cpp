@@ -0,0 +1,164 @@
+// Benchmark: cache lookups against hand-rolled caches
+//
+// Each iteration replays one access trace: get(key), and put(key) on a
+// miss, as in front of a backing lookup. Keys follow a Zipf distribution
+// over ten times as many keys as the cache holds. The argument is the
+// capacity in entries.
+//
+//   recent_deque  - Chapter 12's create_recent_cache(): a std::deque of the
+//                   last N items, searched linearly (only up to 4K entries)
+//   list_map      - the textbook LRU: std::list in recency order plus a
+//                   std::unordered_map of list iterators
+//   lru, arc      - LruCache and ArcCache
+//   sharded_lru   - ShardedCache<LruCache> on one thread: the cost of the locks
+//
+// Hit ratios depend only on the trace, not on the machine; the demo
+// program prints them for LRU and ARC.
+
+#include "arc_cache.h"
+#include "bench.h"
+#include "lru_cache.h"
+#include "sharded_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t trace_length = 1 << 16;
+
+// A Zipf(0.9) trace over 10 * capacity keys, built once per capacity
+const std::vector<std::uint64_t>& trace(std::int64_t capacity) {
+    static std::map<std::int64_t, std::vector<std::uint64_t>> cache;
+    auto& out = cache[capacity];
+    if (out.empty()) {
+        const auto keys = static_cast<std::size_t>(10 * capacity);
+        std::vector<double> weights(keys);
+        for (std::size_t r = 0; r < keys; ++r) {
+            weights[r] = 1.0 / std::pow(static_cast<double>(r + 1), 0.9);
+        }
+        std::discrete_distribution<std::uint64_t> pick{weights.begin(), weights.end()};
+        std::mt19937_64 gen{42};
+        // Scatter the ranks, so popular keys are not also small numbers
+        std::vector<std::uint64_t> names(keys);
+        std::generate(names.begin(), names.end(), gen);
+        out.resize(trace_length);
+        for (auto& key : out) {
+            key = names[pick(gen)];
+        }
+    }
+    return out;
+}
+
+class RecentDeque {
+public:
+    explicit RecentDeque(std::size_t capacity) : capacity_{capacity} {}
+
+    const std::uint64_t* get(std::uint64_t key) const {
+        const auto it = std::find_if(items_.begin(), items_.end(),
+                                     [key](const auto& item) { return item.first == key; });
+        return it == items_.end() ? nullptr : &it->second;
+    }
+
+    void put(std::uint64_t key, std::uint64_t value) {
+        items_.emplace_back(key, value);
+        if (items_.size() > capacity_) {
+            items_.pop_front();
+        }
+    }
+
+private:
+    std::size_t capacity_;
+    std::deque<std::pair<std::uint64_t, std::uint64_t>> items_;
+};
+
+class ListMap {
+public:
+    explicit ListMap(std::size_t capacity) : capacity_{capacity} {}
+
+    const std::uint64_t* get(std::uint64_t key) {
+        const auto it = where_.find(key);
+        if (it == where_.end()) {
+            return nullptr;
+        }
+        order_.splice(order_.begin(), order_, it->second);
+        return &it->second->second;
+    }
+
+    void put(std::uint64_t key, std::uint64_t value) {
+        order_.emplace_front(key, value);
+        where_[key] = order_.begin();
+        if (order_.size() > capacity_) {
+            where_.erase(order_.back().first);
+            order_.pop_back();
+        }
+    }
+
+private:
+    std::size_t capacity_;
+    std::list<std::pair<std::uint64_t, std::uint64_t>> order_;
+    std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, std::uint64_t>>::iterator>
+        where_;
+};
+
+// Adapts ShardedCache's optional-returning get() to the loop below
+class ShardedLru {
+public:
+    explicit ShardedLru(std::size_t capacity) : cache_{capacity, 8} {}
+
+    std::optional<std::uint64_t> get(std::uint64_t key) { return cache_.get(key); }
+    void put(std::uint64_t key, std::uint64_t value) { cache_.put(key, value); }
+
+private:
+    cache::ShardedCache<cache::LruCache<std::uint64_t, std::uint64_t>> cache_;
+};
+
+template <typename Cache>
+void replay(bench::State& state) {
+    const auto& keys = trace(state.arg());
+    std::optional<Cache> c;
+    while (state.keep_running()) {
+        state.pause_timing();
+        c.emplace(static_cast<std::size_t>(state.arg()));
+        state.resume_timing();
+        std::uint64_t hits = 0;
+        for (const auto key : keys) {
+            if (c->get(key)) {
+                ++hits;
+            } else {
+                c->put(key, key);
+            }
+        }
+        bench::do_not_optimize(hits);
+        state.pause_timing();
+        c.reset();
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(trace_length));
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 8;
+    constexpr std::int64_t large = 1 << 16;
+
+    bench::register_benchmark("replay/recent_deque", replay<RecentDeque>)
+        ->range(small, large / 16, 16);
+    bench::register_benchmark("replay/list_map", replay<ListMap>)->range(small, large, 16);
+    bench::register_benchmark("replay/lru", replay<cache::LruCache<std::uint64_t, std::uint64_t>>)
+        ->range(small, large, 16);
+    bench::register_benchmark("replay/arc", replay<cache::ArcCache<std::uint64_t, std::uint64_t>>)
+        ->range(small, large, 16);
+    bench::register_benchmark("replay/sharded_lru", replay<ShardedLru>)->range(small, large, 16);
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,224 @@
+#ifndef CACHE_COMMON_H
+#define CACHE_COMMON_H
+
+#include "flat_hash_map.h"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cache {
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t insertions = 0;
+    std::uint64_t evictions = 0;
+
+    [[nodiscard]] double hit_ratio() const noexcept {
+        const auto lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+
+    Stats& operator+=(const Stats& other) noexcept {
+        hits += other.hits;
+        misses += other.misses;
+        insertions += other.insertions;
+        evictions += other.evictions;
+        return *this;
+    }
+
+    bool operator==(const Stats&) const = default;
+};
+
+// =============================================================================
+// Weighers: what the capacity counts
+// =============================================================================
+
+/**
+ * Approximate memory owned by a value: its own size, plus the heap buffer
+ * of a contiguous container (std::string, std::vector) unless the elements
+ * live inside the object itself (the small-string buffer).
+ */
+template <typename T>
+[[nodiscard]] std::size_t byte_size(const T& value) noexcept {
+    if constexpr (requires {
+                      typename T::value_type;
+                      { value.data() } -> std::convertible_to<const typename T::value_type*>;
+                      { value.capacity() } -> std::convertible_to<std::size_t>;
+                  }) {
+        const auto* data = reinterpret_cast<const unsigned char*>(value.data());
+        const auto* self = reinterpret_cast<const unsigned char*>(&value);
+        const bool inline_buffer =
+            std::less_equal<>{}(self, data) && std::less<>{}(data, self + sizeof(T));
+        return sizeof(T) +
+               (inline_buffer ? 0 : value.capacity() * sizeof(typename T::value_type));
+    } else {
+        return sizeof(T);
+    }
+}
+
+// Capacity in entries: every entry weighs 1 (the default)
+struct EntryCount {
+    template <typename K, typename V>
+    std::size_t operator()(const K&, const V&) const noexcept {
+        return 1;
+    }
+};
+
+// Capacity in bytes of keys and values, as measured by byte_size(). The
+// cache's own bookkeeping (links, index slot, a second copy of the key) is
+// not counted.
+struct EntryBytes {
+    template <typename K, typename V>
+    std::size_t operator()(const K& key, const V& value) const noexcept {
+        return byte_size(key) + byte_size(value);
+    }
+};
+
+template <typename W, typename K, typename V>
+concept Weigher = std::is_invocable_r_v<std::size_t, const W&, const K&, const V&>;
+
+namespace detail {
+
+// =============================================================================
+// Entry table: nodes on intrusive lists, indexed by a FlatHashMap
+// =============================================================================
+
+using index_t = std::uint32_t;
+inline constexpr index_t npos = std::numeric_limits<index_t>::max();
+
+// A doubly linked list threaded through the nodes' own links; front is
+// the most recently used end
+struct List {
+    index_t head = npos;
+    index_t tail = npos;
+    std::size_t size = 0;
+    std::size_t weight = 0;
+};
+
+/**
+ * The storage shared by the cache policies. Nodes live in one vector,
+ * linked by index rather than pointer so the vector may grow, and freed
+ * slots are reused through a free list. A FlatHashMap maps each key to
+ * its node; the key is stored in both.
+ *
+ * A node's value is empty while it is a ghost: remembered by key, but
+ * holding no data (ArcCache's B1 and B2 lists).
+ */
+template <typename K, typename V, typename Hash, typename KeyEqual>
+class EntryTable {
+public:
+    struct Node {
+        K key;
+        std::optional<V> value;
+        std::size_t weight = 0;
+        index_t prev = npos;
+        index_t next = npos;
+        std::uint8_t list = 0;  // which of the policy's lists holds the node
+    };
+
+    explicit EntryTable(const Hash& hash, const KeyEqual& equal) : index_{0, hash, equal} {}
+
+    template <typename Q>
+    [[nodiscard]] index_t find(const Q& key) const {
+        const auto it = index_.find(key);
+        return it == index_.end() ? npos : it->second;
+    }
+
+    [[nodiscard]] Node& operator[](index_t i) noexcept { return *nodes_[i]; }
+    [[nodiscard]] const Node& operator[](index_t i) const noexcept { return *nodes_[i]; }
+
+    // Adds a node for a key that is not yet present
+    template <typename Q>
+    index_t insert(Q&& key, std::optional<V> value, std::size_t weight, std::uint8_t list) {
+        index_t i;
+        if (free_.empty()) {
+            i = static_cast<index_t>(nodes_.size());
+            nodes_.emplace_back();
+        } else {
+            i = free_.back();
+            free_.pop_back();
+        }
+        nodes_[i].emplace(
+            Node{K(std::forward<Q>(key)), std::move(value), weight, npos, npos, list});
+        try {
+            index_.try_emplace(nodes_[i]->key, i);
+        } catch (...) {
+            release(i);
+            throw;
+        }
+        return i;
+    }
+
+    // Removes an unlinked node
+    void erase(index_t i) {
+        index_.erase(nodes_[i]->key);
+        release(i);
+    }
+
+    void clear() noexcept {
+        nodes_.clear();
+        free_.clear();
+        index_.clear();
+    }
+
+    void push_front(List& list, index_t i) noexcept {
+        Node& node = *nodes_[i];
+        node.prev = npos;
+        node.next = list.head;
+        if (list.head != npos) {
+            nodes_[list.head]->prev = i;
+        } else {
+            list.tail = i;
+        }
+        list.head = i;
+        ++list.size;
+        list.weight += node.weight;
+    }
+
+    void unlink(List& list, index_t i) noexcept {
+        Node& node = *nodes_[i];
+        (node.prev != npos ? nodes_[node.prev]->next : list.head) = node.next;
+        (node.next != npos ? nodes_[node.next]->prev : list.tail) = node.prev;
+        node.prev = node.next = npos;
+        --list.size;
+        list.weight -= node.weight;
+    }
+
+    void move_to_front(List& from, List& to, index_t i) noexcept {
+        unlink(from, i);
+        push_front(to, i);
+    }
+
+private:
+    void release(index_t i) noexcept {
+        nodes_[i].reset();
+        free_.push_back(i);
+    }
+
+    std::vector<std::optional<Node>> nodes_;
+    std::vector<index_t> free_;
+    flat::FlatHashMap<K, index_t, Hash, KeyEqual> index_;
+};
+
+// Whether a policy's lookups accept Q: K itself, or anything the
+// transparent functors take
+template <typename Q, typename K, typename Hash, typename KeyEqual>
+concept lookup_key = std::same_as<std::remove_cvref_t<Q>, K> ||
+                     flat::detail::heterogeneous_key<std::remove_cvref_t<Q>, K, Hash, KeyEqual>;
+
+} // namespace detail
+
+} // namespace cache
+
+#endif // CACHE_COMMON_H
@@ -0,0 +1,204 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include "cache_common.h"
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace cache {
+
+/**
+ * A least-recently-used cache: once the entries weigh more than the
+ * capacity, the ones read or written longest ago are evicted.
+ *
+ *     LruCache<std::string, User> users{1000};
+ *     if (User* u = users.get(name)) { ... }
+ *     users.put(name, load_user(name));
+ *
+ * get, put and erase are O(1): the entries sit on an intrusive list in
+ * recency order, found through a FlatHashMap index. Every get() moves its
+ * entry to the front.
+ *
+ * The Weigher decides what the capacity counts - entries (EntryCount, the
+ * default) or bytes (EntryBytes) - and an entry heavier than the whole
+ * capacity is not stored. Pointers returned by get() stay valid until the
+ * next call that modifies the cache. Not thread-safe; see ShardedCache.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>, Weigher<K, V> W = EntryCount>
+class LruCache {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using weigher = W;
+
+    explicit LruCache(size_type capacity, const W& weigh = W{}, const Hash& hash = Hash{},
+                      const KeyEqual& equal = KeyEqual{})
+        : capacity_{capacity}, table_{hash, equal}, weigh_{weigh} {}
+
+    /**
+     * The value for `key`, or nullptr. Counts a hit or a miss, and makes
+     * the entry the most recently used.
+     */
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    [[nodiscard]] V* get(const Q& key) {
+        const auto i = table_.find(key);
+        if (i == detail::npos) {
+            ++stats_.misses;
+            return nullptr;
+        }
+        ++stats_.hits;
+        table_.move_to_front(list_, list_, i);
+        return &*table_[i].value;
+    }
+
+    [[nodiscard]] V* get(const K& key) { return get<K>(key); }
+
+    // The value for `key` without counting the lookup or touching recency
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    [[nodiscard]] const V* peek(const Q& key) const {
+        const auto i = table_.find(key);
+        return i == detail::npos ? nullptr : &*table_[i].value;
+    }
+
+    [[nodiscard]] const V* peek(const K& key) const { return peek<K>(key); }
+
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    [[nodiscard]] bool contains(const Q& key) const {
+        return table_.find(key) != detail::npos;
+    }
+
+    [[nodiscard]] bool contains(const K& key) const { return contains<K>(key); }
+
+    /**
+     * Inserts or replaces the value for `key` as the most recently used
+     * entry, then evicts from the least recently used end until the cache
+     * fits its capacity. Returns false, leaving no entry for `key`, if the
+     * value alone weighs more than the capacity.
+     */
+    template <typename Q, typename M>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    bool put(Q&& key, M&& value) {
+        V stored_value(std::forward<M>(value));
+        if (const auto i = table_.find(key); i != detail::npos) {
+            const size_type weight = weigh_(table_[i].key, stored_value);
+            if (weight > capacity_) {
+                remove(i);
+                return false;
+            }
+            table_.unlink(list_, i);
+            table_[i].value = std::move(stored_value);
+            table_[i].weight = weight;
+            table_.push_front(list_, i);
+        } else {
+            K stored_key(std::forward<Q>(key));
+            const size_type weight = weigh_(stored_key, stored_value);
+            if (weight > capacity_) {
+                return false;
+            }
+            table_.push_front(list_, table_.insert(std::move(stored_key),
+                                                   std::move(stored_value), weight, 0));
+            ++stats_.insertions;
+        }
+        evict_to(capacity_);
+        return true;
+    }
+
+    template <typename M>
+    bool put(const K& key, M&& value) {
+        return put<const K&, M>(key, std::forward<M>(value));
+    }
+
+    /**
+     * The value for `key`, calling load(key) and caching the result on a
+     * miss. Returns a copy, since an entry that is too heavy to cache has
+     * nowhere else to live.
+     */
+    template <typename Q, std::invocable<const Q&> F>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    V get_or_load(const Q& key, F&& load) {
+        if (const V* cached = get(key)) {
+            return *cached;
+        }
+        V value = std::invoke(std::forward<F>(load), key);
+        put(key, value);
+        return value;
+    }
+
+    template <std::invocable<const K&> F>
+    V get_or_load(const K& key, F&& load) {
+        return get_or_load<K, F>(key, std::forward<F>(load));
+    }
+
+    template <typename Q>
+        requires detail::lookup_key<Q, K, Hash, KeyEqual>
+    bool erase(const Q& key) {
+        const auto i = table_.find(key);
+        if (i == detail::npos) {
+            return false;
+        }
+        remove(i);
+        return true;
+    }
+
+    bool erase(const K& key) { return erase<K>(key); }
+
+    void clear() noexcept {
+        table_.clear();
+        list_ = {};
+    }
+
+    // Calls fn(key, value) from the most to the least recently used
+    template <std::invocable<const K&, const V&> F>
+    void for_each(F&& fn) const {
+        for (auto i = list_.head; i != detail::npos; i = table_[i].next) {
+            std::invoke(fn, table_[i].key, *table_[i].value);
+        }
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return list_.size; }
+    [[nodiscard]] bool empty() const noexcept { return list_.size == 0; }
+    [[nodiscard]] size_type weight() const noexcept { return list_.weight; }
+    [[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+
+    // Evicts at once if the cache has become too heavy
+    void set_capacity(size_type capacity) {
+        capacity_ = capacity;
+        evict_to(capacity_);
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+    void reset_stats() noexcept { stats_ = {}; }
+
+private:
+    void remove(detail::index_t i) {
+        table_.unlink(list_, i);
+        table_.erase(i);
+    }
+
+    void evict_to(size_type limit) {
+        while (list_.weight > limit) {
+            remove(list_.tail);
+            ++stats_.evictions;
+        }
+    }
+
+    size_type capacity_;
+    detail::EntryTable<K, V, Hash, KeyEqual> table_;
+    detail::List list_;
+    Stats stats_;
+    [[no_unique_address]] W weigh_;
+};
+
+} // namespace cache
+
+#endif // LRU_CACHE_H
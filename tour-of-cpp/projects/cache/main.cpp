@@ -0,0 +1,146 @@
+#include "arc_cache.h"
+#include "lru_cache.h"
+#include "sharded_cache.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Demonstrates the caches, starting from Chapter 12's create_recent_cache()
+ * exercise: keep the last N items, but with O(1) lookups.
+ */
+
+namespace {
+
+// Stands in for a slow backing lookup (a database, a remote service)
+std::string fetch_profile(int user_id) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    return "profile-" + std::to_string(user_id);
+}
+
+// A Zipf-distributed access pattern with a one-off scan in the middle
+std::vector<int> workload() {
+    std::mt19937 gen{1};
+    std::vector<double> weights(10'000);
+    for (std::size_t r = 0; r < weights.size(); ++r) {
+        weights[r] = 1.0 / std::pow(static_cast<double>(r + 1), 0.8);
+    }
+    std::discrete_distribution<int> pick{weights.begin(), weights.end()};
+
+    std::vector<int> keys;
+    for (int i = 0; i < 100'000; ++i) {
+        keys.push_back(pick(gen));
+    }
+    for (int k = 100'000; k < 105'000; ++k) {
+        keys.push_back(k);
+    }
+    for (int i = 0; i < 100'000; ++i) {
+        keys.push_back(pick(gen));
+    }
+    return keys;
+}
+
+template <typename Cache>
+double hit_ratio(const std::vector<int>& keys, std::size_t capacity) {
+    Cache c{capacity};
+    for (const int k : keys) {
+        if (c.get(k) == nullptr) {
+            c.put(k, k);
+        }
+    }
+    return c.stats().hit_ratio();
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Cache Demo ===\n\n";
+
+    // 1. create_recent_cache, as an LRU cache
+    std::cout << "1. The 3 most recent items:\n";
+    {
+        cache::LruCache<std::string, int> recent{3};
+        int position = 0;
+        for (const auto* item : {"a", "b", "c", "d", "e", "f"}) {
+            recent.put(item, position++);
+        }
+        std::cout << "   most recent first:";
+        recent.for_each([](const std::string& item, int) { std::cout << ' ' << item; });
+        std::cout << "\n   evictions: " << recent.stats().evictions << "\n\n";
+    }
+
+    // 2. In front of a slow lookup
+    std::cout << "2. get_or_load in front of a slow lookup:\n";
+    {
+        cache::LruCache<int, std::string> profiles{100};
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 10; ++round) {
+            for (int user = 0; user < 50; ++user) {
+                profiles.get_or_load(user, fetch_profile);
+            }
+        }
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        const auto& stats = profiles.stats();
+        std::cout << "   " << stats.hits << " hits, " << stats.misses << " misses in "
+                  << std::fixed << std::setprecision(0) << elapsed.count()
+                  << " ms (500 lookups at 1 ms each would take 500 ms)\n\n";
+    }
+
+    // 3. Capacity in bytes
+    std::cout << "3. Capacity in bytes:\n";
+    {
+        cache::LruCache<int, std::string, std::hash<int>, std::equal_to<int>, cache::EntryBytes>
+            pages{16 * 1024};
+        for (int i = 0; i < 100; ++i) {
+            pages.put(i, std::string(static_cast<std::size_t>(100 + 50 * (i % 10)), 'x'));
+        }
+        std::cout << "   " << pages.size() << " pages in " << pages.weight() << " of "
+                  << pages.capacity() << " bytes\n\n";
+    }
+
+    // 4. LRU vs. ARC
+    std::cout << "4. Hit ratio, Zipf accesses with a scan of 5000 cold keys:\n";
+    {
+        const auto keys = workload();
+        std::cout << "   capacity       LRU       ARC\n";
+        for (const std::size_t capacity : {100, 1000, 5000}) {
+            std::cout << "   " << std::setw(8) << capacity << std::setprecision(1)
+                      << std::setw(9)
+                      << 100 * hit_ratio<cache::LruCache<int, int>>(keys, capacity) << '%'
+                      << std::setw(9)
+                      << 100 * hit_ratio<cache::ArcCache<int, int>>(keys, capacity) << "%\n";
+        }
+        std::cout << "\n";
+    }
+
+    // 5. Shared between threads
+    std::cout << "5. ShardedCache from 4 threads:\n";
+    {
+        cache::ShardedCache<cache::ArcCache<int, std::string>> shared{1000, 8};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&shared, t] {
+                // Each thread starts at a different user, so most misses
+                // are loaded by one thread and hit by the others
+                for (int i = 0; i < 120; ++i) {
+                    shared.get_or_load((10 * t + i) % 40, fetch_profile);
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        const auto stats = shared.stats();
+        std::cout << "   " << shared.size() << " entries over " << shared.shard_count()
+                  << " shards; " << stats.hits << " hits, " << stats.misses << " misses\n";
+    }
+
+    std::cout << "\n=== Demo Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,238 @@
+#ifndef SHARDED_CACHE_H
+#define SHARDED_CACHE_H
+
+#include "cache_common.h"
+#include "cache_line.h"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cache {
+
+/**
+ * A thread-safe cache: `shards` independent caches of type Cache
+ * (LruCache or ArcCache), each behind its own lock and given an equal
+ * part of the capacity. A key's hash picks its shard, so threads working
+ * on different keys rarely wait for each other.
+ *
+ *     ShardedCache<LruCache<std::string, Profile>> profiles{100'000};
+ *     Profile p = profiles.get_or_load(id, fetch_profile);   // any thread
+ *
+ * Each shard evicts on its own, so the cache as a whole is only
+ * approximately LRU (or ARC), and an entry heavier than one shard's
+ * capacity is not stored. Values are returned by copy: a reference
+ * could outlive the lock.
+ */
+template <typename Cache, typename Mutex = std::mutex>
+class ShardedCache {
+public:
+    using key_type = typename Cache::key_type;
+    using mapped_type = typename Cache::mapped_type;
+    using size_type = std::size_t;
+    using hasher = typename Cache::hasher;
+    using key_equal = typename Cache::key_equal;
+    using weigher = typename Cache::weigher;
+
+    // Two shards per hardware thread, rounded up to a power of two
+    [[nodiscard]] static size_type default_shard_count() noexcept {
+        return std::bit_ceil(2 * std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    /**
+     * `shards` is rounded up to a power of two, but kept at most the
+     * capacity so every shard can hold something.
+     */
+    explicit ShardedCache(size_type capacity, size_type shards = default_shard_count(),
+                          const weigher& weigh = weigher{}, const hasher& hash = hasher{},
+                          const key_equal& equal = key_equal{})
+        : shard_bits_{static_cast<unsigned>(std::countr_zero(
+              std::min(std::bit_ceil(std::max<size_type>(shards, 1)),
+                       std::bit_floor(std::max<size_type>(capacity, 1)))))},
+          hash_{hash} {
+        const size_type n = size_type{1} << shard_bits_;
+        shards_.reserve(n);
+        for (size_type s = 0; s < n; ++s) {
+            // The first capacity % n shards take one unit of the remainder
+            const size_type share = capacity / n + (s < capacity % n ? 1 : 0);
+            shards_.push_back(std::make_unique<Shard>(share, weigh, hash, equal));
+        }
+    }
+
+    ShardedCache(const ShardedCache&) = delete;
+    ShardedCache& operator=(const ShardedCache&) = delete;
+
+    // A copy of the value for `key`, if cached; counts a hit or a miss
+    template <typename Q>
+        requires detail::lookup_key<Q, key_type, hasher, key_equal>
+    [[nodiscard]] std::optional<mapped_type> get(const Q& key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        if (const auto* value = shard.cache.get(key)) {
+            return *value;
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::optional<mapped_type> get(const key_type& key) {
+        return get<key_type>(key);
+    }
+
+    // Calls fn(value) under the shard's lock on a hit, without copying
+    template <typename Q, std::invocable<const mapped_type&> F>
+        requires detail::lookup_key<Q, key_type, hasher, key_equal>
+    bool visit(const Q& key, F&& fn) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        const auto* value = shard.cache.get(key);
+        if (value == nullptr) {
+            return false;
+        }
+        std::invoke(fn, *value);
+        return true;
+    }
+
+    template <std::invocable<const mapped_type&> F>
+    bool visit(const key_type& key, F&& fn) {
+        return visit<key_type, F>(key, std::forward<F>(fn));
+    }
+
+    template <typename Q>
+        requires detail::lookup_key<Q, key_type, hasher, key_equal>
+    [[nodiscard]] bool contains(const Q& key) const {
+        const Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        return shard.cache.contains(key);
+    }
+
+    [[nodiscard]] bool contains(const key_type& key) const { return contains<key_type>(key); }
+
+    template <typename Q, typename M>
+        requires detail::lookup_key<Q, key_type, hasher, key_equal>
+    bool put(Q&& key, M&& value) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        return shard.cache.put(std::forward<Q>(key), std::forward<M>(value));
+    }
+
+    template <typename M>
+    bool put(const key_type& key, M&& value) {
+        return put<const key_type&, M>(key, std::forward<M>(value));
+    }
+
+    /**
+     * The value for `key`, calling load(key) and caching the result on a
+     * miss. load() runs without the lock held, so a slow backing lookup
+     * does not block the shard - but two threads missing the same key at
+     * once will both load it, and the second result replaces the first.
+     */
+    template <typename Q, std::invocable<const Q&> F>
+        requires detail::lookup_key<Q, key_type, hasher, key_equal>
+    mapped_type get_or_load(const Q& key, F&& load) {
+        Shard& shard = shard_for(key);
+        {
+            std::lock_guard lock{shard.mutex};
+            if (const auto* value = shard.cache.get(key)) {
+                return *value;
+            }
+        }
+        mapped_type value = std::invoke(std::forward<F>(load), key);
+        std::lock_guard lock{shard.mutex};
+        shard.cache.put(key, value);
+        return value;
+    }
+
+    template <std::invocable<const key_type&> F>
+    mapped_type get_or_load(const key_type& key, F&& load) {
+        return get_or_load<key_type, F>(key, std::forward<F>(load));
+    }
+
+    template <typename Q>
+        requires detail::lookup_key<Q, key_type, hasher, key_equal>
+    bool erase(const Q& key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        return shard.cache.erase(key);
+    }
+
+    bool erase(const key_type& key) { return erase<key_type>(key); }
+
+    void clear() {
+        for_each_shard([](Cache& cache) { cache.clear(); });
+    }
+
+    // Totals over the shards, each read under its lock
+    [[nodiscard]] size_type size() const {
+        size_type total = 0;
+        for_each_shard([&total](const Cache& cache) { total += cache.size(); });
+        return total;
+    }
+
+    [[nodiscard]] size_type weight() const {
+        size_type total = 0;
+        for_each_shard([&total](const Cache& cache) { total += cache.weight(); });
+        return total;
+    }
+
+    [[nodiscard]] size_type capacity() const {
+        size_type total = 0;
+        for_each_shard([&total](const Cache& cache) { total += cache.capacity(); });
+        return total;
+    }
+
+    [[nodiscard]] Stats stats() const {
+        Stats total;
+        for_each_shard([&total](const Cache& cache) { total += cache.stats(); });
+        return total;
+    }
+
+    void reset_stats() {
+        for_each_shard([](Cache& cache) { cache.reset_stats(); });
+    }
+
+    [[nodiscard]] size_type shard_count() const noexcept { return shards_.size(); }
+
+private:
+    struct alignas(concurrent::cache_line_size) Shard {
+        Shard(size_type capacity, const weigher& weigh, const hasher& hash,
+              const key_equal& equal)
+            : cache{capacity, weigh, hash, equal} {}
+
+        mutable Mutex mutex;
+        Cache cache;
+    };
+
+    // The top bits of the mixed hash, as in concurrent::ShardedHashMap
+    template <typename Q>
+    [[nodiscard]] Shard& shard_for(const Q& key) const {
+        if (shard_bits_ == 0) {
+            return *shards_[0];
+        }
+        const auto h = flat::detail::mix(static_cast<size_type>(hash_(key)));
+        return *shards_[h >> (std::numeric_limits<size_type>::digits - shard_bits_)];
+    }
+
+    template <typename F>
+    void for_each_shard(F&& fn) const {
+        for (const auto& shard : shards_) {
+            std::lock_guard lock{shard->mutex};
+            std::invoke(fn, shard->cache);
+        }
+    }
+
+    const unsigned shard_bits_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    [[no_unique_address]] hasher hash_;
+};
+
+} // namespace cache
+
+#endif // SHARDED_CACHE_H
@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+#include "arc_cache.h"
+#include "lru_cache.h"
+#include <random>
+#include <string>
+
+using cache::ArcCache;
+using cache::LruCache;
+
+TEST_CASE("ArcCache basic operations", "[arc_cache][basic]") {
+    ArcCache<std::string, int> c{3};
+
+    SECTION("put, get, replace and erase") {
+        REQUIRE(c.get("a") == nullptr);
+        REQUIRE(c.put("a", 1));
+        REQUIRE(*c.get("a") == 1);
+        REQUIRE(c.put("a", 2));
+        REQUIRE(*c.get("a") == 2);
+        REQUIRE(c.erase("a"));
+        REQUIRE_FALSE(c.contains("a"));
+        REQUIRE(c.stats().hits == 2);
+        REQUIRE(c.stats().misses == 1);
+    }
+
+    SECTION("a full T1 evicts without leaving ghosts") {
+        for (const auto* item : {"a", "b", "c", "d"}) {
+            c.put(item, 0);
+        }
+        REQUIRE(c.size() == 3);
+        REQUIRE_FALSE(c.contains("a"));
+        REQUIRE(c.ghost_count() == 0);
+        REQUIRE(c.stats().evictions == 1);
+    }
+
+    SECTION("evicted keys become ghosts, and a B1 ghost hit grows the recency target") {
+        c.put("a", 0);
+        (void)c.get("a");  // a is frequent (T2)
+        for (const auto* item : {"b", "c", "d"}) {
+            c.put(item, 0);
+        }
+        REQUIRE(c.size() == 3);
+        REQUIRE(c.ghost_count() == 1);
+        REQUIRE(c.get("b") == nullptr);  // a ghost is still a miss
+        REQUIRE(c.recency_target() == 0);
+
+        c.put("b", 1);
+        REQUIRE(c.recency_target() > 0);
+        REQUIRE(*c.get("b") == 1);
+        REQUIRE(c.size() == 3);
+    }
+
+    SECTION("a ghost hit on B2 shrinks it again") {
+        ArcCache<int, int> small{2};
+        small.put(1, 0);
+        (void)small.get(1);  // 1 is frequent (T2)
+        small.put(2, 0);
+        small.put(3, 0);     // evicts 2 from T1 into B1
+        small.put(2, 0);     // B1 hit: target grows; 1 is evicted into B2
+        const auto grown = small.recency_target();
+        REQUIRE(grown > 0);
+        REQUIRE_FALSE(small.contains(1));
+        small.put(1, 0);     // B2 hit
+        REQUIRE(small.recency_target() < grown);
+    }
+
+    SECTION("clear forgets ghosts too") {
+        c.put("a", 0);
+        (void)c.get("a");
+        for (const auto* item : {"b", "c", "d", "b"}) {
+            c.put(item, 0);
+        }
+        REQUIRE(c.ghost_count() != 0);
+        REQUIRE(c.recency_target() != 0);
+        c.clear();
+        REQUIRE(c.empty());
+        REQUIRE(c.ghost_count() == 0);
+        REQUIRE(c.recency_target() == 0);
+    }
+}
+
+TEST_CASE("ArcCache resists scans", "[arc_cache]") {
+    constexpr int capacity = 100;
+    constexpr int hot = 50;
+
+    ArcCache<int, int> arc{capacity};
+    LruCache<int, int> lru{capacity};
+    const auto access = [&](int key) {
+        if (arc.get(key) == nullptr) {
+            arc.put(key, key);
+        }
+        if (lru.get(key) == nullptr) {
+            lru.put(key, key);
+        }
+    };
+
+    // A hot set used repeatedly, then one pass over many cold keys
+    for (int round = 0; round < 3; ++round) {
+        for (int k = 0; k < hot; ++k) {
+            access(k);
+        }
+    }
+    for (int k = 1000; k < 2000; ++k) {
+        access(k);
+    }
+
+    int arc_hot = 0;
+    int lru_hot = 0;
+    for (int k = 0; k < hot; ++k) {
+        arc_hot += arc.contains(k) ? 1 : 0;
+        lru_hot += lru.contains(k) ? 1 : 0;
+    }
+    REQUIRE(arc_hot == hot);
+    REQUIRE(lru_hot == 0);
+}
+
+TEST_CASE("ArcCache stays within its bounds", "[arc_cache]") {
+    constexpr std::size_t capacity = 50;
+    ArcCache<int, int> c{capacity};
+    std::mt19937 gen{11};
+    // Two overlapping key ranges, so both recency and frequency matter
+    std::uniform_int_distribution<int> narrow{0, 60};
+    std::uniform_int_distribution<int> wide{0, 500};
+
+    for (int step = 0; step < 50'000; ++step) {
+        const int k = step % 4 == 0 ? wide(gen) : narrow(gen);
+        switch (step % 7) {
+        case 0:
+            c.erase(k);
+            break;
+        default:
+            if (c.get(k) == nullptr) {
+                REQUIRE(c.put(k, k));
+                REQUIRE(*c.peek(k) == k);
+            }
+        }
+        REQUIRE(c.size() <= capacity);
+        REQUIRE(c.weight() == c.size());
+        REQUIRE(c.recency_target() <= capacity);
+        REQUIRE(c.size() + c.ghost_count() <= 2 * capacity);
+    }
+    REQUIRE(c.stats().hit_ratio() > 0.3);
+
+    c.set_capacity(10);
+    REQUIRE(c.size() <= 10);
+    REQUIRE(c.size() + c.ghost_count() <= 20);
+}
+
+TEST_CASE("ArcCache capacity in bytes", "[arc_cache][bytes]") {
+    using BytesCache = ArcCache<int, std::string, std::hash<int>, std::equal_to<int>,
+                                cache::EntryBytes>;
+    BytesCache c{10'000};
+    std::mt19937 gen{5};
+    std::uniform_int_distribution<int> key{0, 100};
+    std::uniform_int_distribution<std::size_t> length{100, 2000};
+    for (int step = 0; step < 5000; ++step) {
+        const int k = key(gen);
+        if (c.get(k) == nullptr) {
+            c.put(k, std::string(length(gen), 'x'));
+        }
+        REQUIRE(c.weight() <= c.capacity());
+    }
+    REQUIRE_FALSE(c.put(1, std::string(20'000, 'x')));
+    REQUIRE_FALSE(c.contains(1));
+}
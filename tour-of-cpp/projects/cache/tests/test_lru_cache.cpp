@@ -0,0 +1,218 @@
+#include <catch2/catch_test_macros.hpp>
+#include "lru_cache.h"
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using cache::LruCache;
+
+namespace {
+
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+template <typename Cache>
+std::vector<typename Cache::key_type> keys_by_recency(const Cache& c) {
+    std::vector<typename Cache::key_type> out;
+    c.for_each([&out](const auto& key, const auto&) { out.push_back(key); });
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("LruCache basic operations", "[lru_cache][basic]") {
+    LruCache<std::string, int> c{3};
+
+    SECTION("starts empty") {
+        REQUIRE(c.empty());
+        REQUIRE(c.capacity() == 3);
+        REQUIRE(c.get("a") == nullptr);
+        REQUIRE(c.stats().misses == 1);
+    }
+
+    SECTION("put, get, replace and erase") {
+        REQUIRE(c.put("a", 1));
+        REQUIRE(c.put("b", 2));
+        REQUIRE(*c.get("a") == 1);
+        REQUIRE(c.put("a", 10));
+        REQUIRE(*c.get("a") == 10);
+        REQUIRE(c.size() == 2);
+
+        REQUIRE(c.erase("a"));
+        REQUIRE_FALSE(c.erase("a"));
+        REQUIRE_FALSE(c.contains("a"));
+        REQUIRE(c.size() == 1);
+    }
+
+    SECTION("keeps the most recent items, like create_recent_cache") {
+        for (const auto* item : {"a", "b", "c", "d", "e", "f"}) {
+            c.put(item, 0);
+        }
+        REQUIRE(keys_by_recency(c) == std::vector<std::string>{"f", "e", "d"});
+        REQUIRE(c.stats().evictions == 3);
+        REQUIRE(c.stats().insertions == 6);
+    }
+
+    SECTION("get refreshes recency, peek does not") {
+        c.put("a", 1);
+        c.put("b", 2);
+        c.put("c", 3);
+        REQUIRE(c.get("a") != nullptr);     // a is now the most recent
+        REQUIRE(c.peek("b") != nullptr);    // b stays the least recent
+        c.put("d", 4);
+        REQUIRE_FALSE(c.contains("b"));
+        REQUIRE(keys_by_recency(c) == std::vector<std::string>{"d", "a", "c"});
+    }
+
+    SECTION("stats count hits and misses") {
+        c.put("a", 1);
+        (void)c.get("a");
+        (void)c.get("a");
+        (void)c.get("z");
+        REQUIRE(c.stats().hits == 2);
+        REQUIRE(c.stats().misses == 1);
+        REQUIRE(c.stats().hit_ratio() == 2.0 / 3.0);
+        c.reset_stats();
+        REQUIRE(c.stats() == cache::Stats{});
+    }
+
+    SECTION("set_capacity evicts at once") {
+        c.put("a", 1);
+        c.put("b", 2);
+        c.put("c", 3);
+        c.set_capacity(1);
+        REQUIRE(keys_by_recency(c) == std::vector<std::string>{"c"});
+    }
+
+    SECTION("clear") {
+        c.put("a", 1);
+        c.clear();
+        REQUIRE(c.empty());
+        c.put("b", 2);
+        REQUIRE(c.size() == 1);
+    }
+}
+
+TEST_CASE("LruCache get_or_load", "[lru_cache]") {
+    LruCache<int, std::string> c{2};
+    int loads = 0;
+    const auto load = [&loads](int key) {
+        ++loads;
+        return std::to_string(key);
+    };
+
+    REQUIRE(c.get_or_load(1, load) == "1");
+    REQUIRE(c.get_or_load(1, load) == "1");
+    REQUIRE(loads == 1);
+    c.get_or_load(2, load);
+    c.get_or_load(3, load);  // evicts 1
+    REQUIRE(c.get_or_load(1, load) == "1");
+    REQUIRE(loads == 4);
+}
+
+TEST_CASE("LruCache capacity in bytes", "[lru_cache][bytes]") {
+    using BytesCache = LruCache<int, std::string, std::hash<int>, std::equal_to<int>,
+                                cache::EntryBytes>;
+    const std::string big(1000, 'x');
+    const auto entry = cache::byte_size(0) + cache::byte_size(big);
+    BytesCache c{3 * entry};
+
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(c.put(i, big));
+    }
+    REQUIRE(c.size() == 3);
+    REQUIRE(c.weight() == 3 * entry);
+    REQUIRE(c.weight() <= c.capacity());
+
+    SECTION("a heavier value evicts more") {
+        REQUIRE(c.put(9, std::string(1500, 'y')));
+        REQUIRE(c.size() == 2);
+        REQUIRE(c.weight() <= c.capacity());
+    }
+
+    SECTION("a value heavier than the capacity is rejected") {
+        REQUIRE_FALSE(c.put(4, std::string(5000, 'z')));
+        REQUIRE_FALSE(c.contains(4));  // the old value is gone too
+        REQUIRE(c.size() == 2);
+    }
+}
+
+TEST_CASE("byte_size counts heap buffers", "[lru_cache][bytes]") {
+    REQUIRE(cache::byte_size(42) == sizeof(int));
+    // A short string fits the small-string buffer on all three standard libraries
+    REQUIRE(cache::byte_size(std::string{"hi"}) == sizeof(std::string));
+    const std::string long_string(200, 'x');
+    REQUIRE(cache::byte_size(long_string) >= sizeof(std::string) + 200);
+    const std::vector<int> v(100);
+    REQUIRE(cache::byte_size(v) == sizeof(v) + v.capacity() * sizeof(int));
+}
+
+TEST_CASE("LruCache heterogeneous lookup", "[lru_cache][transparent]") {
+    LruCache<std::string, int, StringHash, StringEqual> c{4};
+    const std::string_view key = "hello";
+    REQUIRE(c.put(key, 1));
+    REQUIRE(c.get(key) != nullptr);
+    REQUIRE(c.contains(std::string_view{"hello"}));
+    REQUIRE(c.erase(std::string_view{"hello"}));
+}
+
+TEST_CASE("LruCache move-only values", "[lru_cache]") {
+    LruCache<int, std::unique_ptr<int>> c{2};
+    c.put(1, std::make_unique<int>(1));
+    c.put(2, std::make_unique<int>(2));
+    c.put(3, std::make_unique<int>(3));
+    REQUIRE(c.get(1) == nullptr);
+    REQUIRE(**c.get(3) == 3);
+}
+
+TEST_CASE("LruCache agrees with a std::list reference", "[lru_cache]") {
+    // The textbook LRU: a list in recency order plus a map into it
+    constexpr std::size_t capacity = 64;
+    std::list<std::pair<int, int>> order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> where;
+
+    LruCache<int, int> c{capacity};
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<int> key{0, 200};
+    for (int step = 0; step < 20'000; ++step) {
+        const int k = key(gen);
+        if (step % 3 == 0) {
+            const auto it = where.find(k);
+            const int* v = c.get(k);
+            REQUIRE((v != nullptr) == (it != where.end()));
+            if (it != where.end()) {
+                REQUIRE(*v == it->second->second);
+                order.splice(order.begin(), order, it->second);
+            }
+        } else {
+            c.put(k, step);
+            if (const auto it = where.find(k); it != where.end()) {
+                order.erase(it->second);
+            }
+            order.emplace_front(k, step);
+            where[k] = order.begin();
+            if (order.size() > capacity) {
+                where.erase(order.back().first);
+                order.pop_back();
+            }
+        }
+    }
+
+    std::vector<int> expected;
+    for (const auto& [k, v] : order) {
+        expected.push_back(k);
+    }
+    REQUIRE(keys_by_recency(c) == expected);
+}
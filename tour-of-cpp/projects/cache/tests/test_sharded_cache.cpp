@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include "arc_cache.h"
+#include "lru_cache.h"
+#include "sharded_cache.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cache::ArcCache;
+using cache::LruCache;
+using cache::ShardedCache;
+
+TEST_CASE("ShardedCache basic operations", "[sharded_cache][basic]") {
+    ShardedCache<LruCache<std::string, int>> c{100, 4};
+
+    SECTION("capacity is split across the shards") {
+        REQUIRE(c.shard_count() == 4);
+        REQUIRE(c.capacity() == 100);
+        REQUIRE(ShardedCache<LruCache<int, int>>{10, 3}.capacity() == 10);
+    }
+
+    SECTION("shard count is rounded, but never above the capacity") {
+        REQUIRE(ShardedCache<LruCache<int, int>>{100, 5}.shard_count() == 8);
+        REQUIRE(ShardedCache<LruCache<int, int>>{3, 64}.shard_count() == 2);
+        REQUIRE(ShardedCache<LruCache<int, int>>{0, 8}.shard_count() == 1);
+    }
+
+    SECTION("put, get, visit and erase") {
+        REQUIRE(c.put("a", 1));
+        REQUIRE(c.get("a") == 1);
+        REQUIRE_FALSE(c.get("b"));
+        int seen = 0;
+        REQUIRE(c.visit("a", [&seen](const int& v) { seen = v; }));
+        REQUIRE(seen == 1);
+        REQUIRE(c.contains("a"));
+        REQUIRE(c.erase("a"));
+        REQUIRE_FALSE(c.contains("a"));
+
+        const auto stats = c.stats();
+        REQUIRE(stats.hits == 2);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.insertions == 1);
+    }
+
+    SECTION("stays within its capacity") {
+        for (int i = 0; i < 1000; ++i) {
+            c.put(std::to_string(i), i);
+        }
+        REQUIRE(c.size() <= 100);
+        REQUIRE(c.size() == c.weight());
+        REQUIRE(c.stats().evictions == 1000 - c.size());
+        c.clear();
+        REQUIRE(c.size() == 0);
+        c.reset_stats();
+        REQUIRE(c.stats() == cache::Stats{});
+    }
+}
+
+TEST_CASE("ShardedCache from many threads", "[sharded_cache][concurrent]") {
+    constexpr int threads = 8;
+    constexpr int keys = 200;
+    ShardedCache<ArcCache<int, int>> c{1000, 8};
+    std::atomic<int> loads{0};
+    std::atomic<bool> wrong{false};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int round = 0; round < 50; ++round) {
+                for (int k = 0; k < keys; ++k) {
+                    const int v = c.get_or_load(k, [&loads](int key) {
+                        ++loads;
+                        return key * 2;
+                    });
+                    if (v != k * 2) {
+                        wrong = true;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    REQUIRE_FALSE(wrong);
+    REQUIRE(c.size() == keys);
+    // Every key loads at least once; concurrent misses may load it again
+    REQUIRE(loads >= keys);
+    REQUIRE(loads <= keys * threads);
+    const auto stats = c.stats();
+    REQUIRE(stats.hits + stats.misses == static_cast<std::uint64_t>(threads) * 50 * keys);
+}
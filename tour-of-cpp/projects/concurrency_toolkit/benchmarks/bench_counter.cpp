@@ -0,0 +1,150 @@
+// Benchmark: counter scalability - mutex vs. atomic vs. sharded
+//
+// N threads each perform increments_per_thread increments on one shared
+// counter. MutexCounter is ThreadSafeCounter from
+// chapters/ch18_concurrency/examples/sharing_data.cpp; AtomicCounter is the
+// same class with a single std::atomic in place of the mutex.
+//
+// Throughput of the first two drops as threads are added because every
+// increment needs exclusive ownership of the same cache line. The sharded
+// counters should scale with the number of cores until threads outnumber
+// them.
+
+#include "sharded_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+constexpr long long increments_per_thread = 1'000'000;
+constexpr int runs = 3;
+
+class MutexCounter {
+public:
+    void increment() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        ++value_;
+    }
+
+    long long value() const {
+        std::lock_guard<std::mutex> lock{mutex_};
+        return value_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    long long value_ = 0;
+};
+
+class AtomicCounter {
+public:
+    void increment() { value_.fetch_add(1, std::memory_order_relaxed); }
+    long long value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<long long> value_{0};
+};
+
+// Returns increments per second for one run with `threads` writers
+template <typename Counter>
+double measure(int threads) {
+    Counter counter;
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (long long i = 0; i < increments_per_thread; ++i) {
+                counter.increment();
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) {
+        w.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const long long expected = increments_per_thread * threads;
+    if (counter.value() != expected) {
+        std::cerr << "count mismatch: " << counter.value() << " != " << expected << "\n";
+    }
+    return static_cast<double>(expected) / elapsed.count();
+}
+
+template <typename Counter>
+void report(const std::string& name, int threads) {
+    double best = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        best = std::max(best, measure<Counter>(threads));
+    }
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::setw(10)
+              << std::fixed << std::setprecision(1) << best / 1e6 << " M incr/s\n";
+}
+
+// Cost of one aggregated read, which sums every slot
+void report_reads() {
+    ShardedCounter<> counter;
+    counter.increment();
+
+    constexpr int reads = 1'000'000;
+    long long sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; ++i) {
+        sink += counter.value();
+    }
+    const std::chrono::duration<double, std::nano> exact =
+        std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reads; ++i) {
+        sink += counter.approximate_value(std::chrono::milliseconds{1});
+    }
+    const std::chrono::duration<double, std::nano> approx =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << "\nReads (" << counter.shard_count() << " slots):\n"
+              << "  value()              " << std::setprecision(1) << exact.count() / reads
+              << " ns\n"
+              << "  approximate_value()  " << approx.count() / reads << " ns\n";
+    if (sink != 2LL * reads) {
+        std::cerr << "read mismatch\n";
+    }
+}
+
+} // namespace
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== Counters: " << increments_per_thread << " increments per thread, best of "
+              << runs << ", " << cores << " hardware threads ===\n";
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        std::cout << "\n" << threads << " thread(s):\n";
+        report<MutexCounter>("ThreadSafeCounter (mutex)", threads);
+        report<AtomicCounter>("std::atomic", threads);
+        report<ShardedCounter<long long, ShardBy::thread>>("ShardedCounter (per thread)",
+                                                           threads);
+        report<ShardedCounter<long long, ShardBy::cpu>>("ShardedCounter (per CPU)", threads);
+    }
+
+    report_reads();
+    return 0;
+}
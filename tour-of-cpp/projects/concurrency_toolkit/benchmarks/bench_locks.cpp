@@ -0,0 +1,172 @@
+// Benchmark: lock throughput and fairness, and event round trips
+//
+// Lock part: N threads repeatedly take a lock, increment a shared counter
+// and release it, for a fixed time. The critical section is a few
+// nanoseconds, the case where the cost of the lock itself dominates.
+// "fairness" is the least busy thread's share divided by the busiest
+// thread's: 1.0 means every thread got the lock equally often.
+//
+// Event part: two threads bounce control back and forth. Signal is the
+// mutex + condition_variable class from
+// chapters/ch18_concurrency/examples/condition_variables.cpp, with a
+// reset() added so it can be reused.
+
+#include "event.h"
+#include "locks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto run_time = 200ms;
+constexpr int round_trips = 20'000;
+
+// Adapts every lock to one "run fn while holding it" call
+template <typename Lock>
+struct Locked {
+    Lock lock;
+
+    template <typename F>
+    void run(F fn) {
+        std::lock_guard<Lock> guard{lock};
+        fn();
+    }
+};
+
+template <>
+struct Locked<McsLock> {
+    McsLock lock;
+
+    template <typename F>
+    void run(F fn) {
+        McsLock::Guard guard{lock};
+        fn();
+    }
+};
+
+template <typename Lock>
+void report_lock(const std::string& name, int threads) {
+    Locked<Lock> locked;
+    long long shared = 0;
+    std::atomic<bool> go{false};
+    std::atomic<bool> done{false};
+    std::vector<long long> acquisitions(static_cast<std::size_t>(threads));
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            long long mine = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                locked.run([&shared] { ++shared; });
+                ++mine;
+            }
+            acquisitions[static_cast<std::size_t>(t)] = mine;
+        });
+    }
+
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(run_time);
+    done = true;
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    const auto [least, most] = std::minmax_element(acquisitions.begin(), acquisitions.end());
+    const double seconds = std::chrono::duration<double>(run_time).count();
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::setw(9)
+              << std::fixed << std::setprecision(1) << static_cast<double>(shared) / seconds / 1e6
+              << " M locks/s   fairness " << std::setprecision(2)
+              << (*most > 0 ? static_cast<double>(*least) / static_cast<double>(*most) : 1.0)
+              << "\n";
+}
+
+class Signal {
+public:
+    void set() {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            signaled_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        signaled_ = false;
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cv_.wait(lock, [this] { return signaled_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool signaled_ = false;
+};
+
+template <typename E>
+void report_round_trip(const std::string& name) {
+    E ping;
+    E pong;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread other{[&] {
+        for (int i = 0; i < round_trips; ++i) {
+            ping.wait();
+            ping.reset();
+            pong.set();
+        }
+    }};
+    for (int i = 0; i < round_trips; ++i) {
+        ping.set();
+        pong.wait();
+        pong.reset();
+    }
+    other.join();
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::setw(9)
+              << std::fixed << std::setprecision(2) << elapsed.count() / round_trips
+              << " us per round trip\n";
+}
+
+} // namespace
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== Locks: " << std::chrono::milliseconds{run_time}.count()
+              << "ms per run, " << cores << " hardware threads ===\n";
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        std::cout << "\n" << threads << " thread(s):\n";
+        report_lock<std::mutex>("std::mutex", threads);
+        report_lock<AdaptiveMutex>("AdaptiveMutex", threads);
+        report_lock<TicketLock>("TicketLock", threads);
+        report_lock<McsLock>("McsLock", threads);
+    }
+
+    std::cout << "\n=== Events: " << round_trips << " round trips ===\n";
+    report_round_trip<Signal>("Signal (cv)");
+    report_round_trip<Event>("Event");
+
+    return 0;
+}
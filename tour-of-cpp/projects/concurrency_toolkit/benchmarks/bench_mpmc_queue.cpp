@@ -0,0 +1,147 @@
+// Benchmark: MPMC queues x wait strategies vs. a single-lock queue
+//
+// P producers and P consumers move items_per_run integers with blocking
+// push/pop. ThreadSafeQueue is the std::queue + mutex + condition_variable
+// class from chapters/ch18_concurrency/examples/condition_variables.cpp.
+//
+// BusySpin is only measured when every thread can have its own core;
+// otherwise spinning threads steal the time slices of the threads they
+// are waiting for and the numbers mean nothing.
+
+#include "mpmc_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+constexpr long long items_per_run = 2'000'000;
+constexpr int runs = 3;
+
+template <typename T>
+class ThreadSafeQueue {
+public:
+    using value_type = T;
+
+    bool try_push(T value) {
+        push(std::move(value));
+        return true;
+    }
+
+    void push(T value) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            queue_.push(std::move(value));
+        }
+        cv_.notify_one();
+    }
+
+    std::optional<T> try_pop() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        T value = std::move(queue_.front());
+        queue_.pop();
+        return value;
+    }
+
+    T pop() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cv_.wait(lock, [this] { return !queue_.empty(); });
+        T value = std::move(queue_.front());
+        queue_.pop();
+        return value;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::queue<T> queue_;
+};
+
+// Returns items per second for one run with `pairs` producers and consumers
+template <typename Queue, typename... Args>
+double measure(int pairs, Args... args) {
+    Queue queue{args...};
+    const long long per_producer = items_per_run / pairs;
+    std::atomic<long long> remaining{per_producer * pairs};
+    std::atomic<long long> checksum{0};
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < pairs; ++p) {
+        threads.emplace_back([&queue, per_producer] {
+            for (long long i = 0; i < per_producer; ++i) {
+                queue.push(i);
+            }
+        });
+        threads.emplace_back([&] {
+            long long sum = 0;
+            while (remaining.fetch_sub(1, std::memory_order_relaxed) > 0) {
+                sum += queue.pop();
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (checksum.load() != pairs * (per_producer * (per_producer - 1) / 2)) {
+        std::cerr << "checksum mismatch\n";
+    }
+    return static_cast<double>(per_producer * pairs) / elapsed.count();
+}
+
+template <typename Queue, typename... Args>
+void report(const std::string& name, int pairs, Args... args) {
+    double best = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        best = std::max(best, measure<Queue>(pairs, args...));
+    }
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::setw(8)
+              << std::fixed << std::setprecision(2) << best / 1e6 << " M items/s\n";
+}
+
+template <typename Wait>
+void report_strategy(const std::string& wait_name, int pairs) {
+    report<BoundedMpmcQueue<long long, Wait>>("Bounded(1024) + " + wait_name, pairs,
+                                               std::size_t{1024});
+    report<UnboundedMpmcQueue<long long, Wait>>("Unbounded + " + wait_name, pairs);
+}
+
+} // namespace
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== MPMC queues: " << items_per_run << " items, best of " << runs
+              << ", " << cores << " hardware threads ===\n";
+
+    for (int pairs : {1, 2, 4}) {
+        std::cout << "\n" << pairs << " producer(s) / " << pairs << " consumer(s):\n";
+        report<ThreadSafeQueue<long long>>("ThreadSafeQueue (single lock)", pairs);
+        if (static_cast<unsigned>(2 * pairs) <= cores) {
+            report_strategy<BusySpin>("BusySpin", pairs);
+        }
+        report_strategy<SpinThenYield>("SpinThenYield", pairs);
+        report_strategy<AtomicWait>("AtomicWait", pairs);
+        report_strategy<CondVarWait>("CondVarWait", pairs);
+    }
+
+    return 0;
+}
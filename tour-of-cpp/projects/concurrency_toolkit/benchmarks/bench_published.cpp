@@ -0,0 +1,137 @@
+// Benchmark: read-mostly data - std::shared_mutex vs. Published<T>
+//
+// N reader threads look up entries in a 256-entry routing table for a fixed
+// time while one writer replaces the table every millisecond. The
+// shared_mutex variant follows shared_mutex_demo in
+// chapters/ch18_concurrency/examples/sharing_data.cpp: readers take a
+// shared_lock, the writer a unique_lock.
+//
+// Every shared_lock writes the mutex's lock word, so reader throughput
+// stops growing once that line becomes the bottleneck. Published readers
+// write only to their own stripe.
+
+#include "published.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+using namespace std::chrono_literals;
+
+namespace {
+
+using RoutingTable = std::vector<int>;
+
+constexpr std::size_t table_size = 256;
+constexpr auto run_time = 200ms;
+constexpr auto update_interval = 1ms;
+
+RoutingTable make_table(int generation) {
+    RoutingTable table(table_size);
+    for (std::size_t i = 0; i < table_size; ++i) {
+        table[i] = generation + static_cast<int>(i);
+    }
+    return table;
+}
+
+class SharedMutexTable {
+public:
+    int lookup(std::size_t key) const {
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+        return table_[key % table_size];
+    }
+
+    void replace(RoutingTable table) {
+        std::unique_lock<std::shared_mutex> lock{mutex_};
+        table_ = std::move(table);
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    RoutingTable table_ = make_table(0);
+};
+
+class PublishedTable {
+public:
+    int lookup(std::size_t key) const { return (*table_.read())[key % table_size]; }
+
+    void replace(RoutingTable table) { table_.publish(std::move(table)); }
+
+private:
+    Published<RoutingTable> table_{make_table(0)};
+};
+
+// Returns lookups per second with `readers` reader threads
+template <typename Table>
+double measure(int readers) {
+    Table table;
+    std::atomic<bool> done{false};
+    std::atomic<long long> total_reads{0};
+    std::atomic<long long> sink{0};
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            long long reads = 0;
+            long long sum = 0;
+            std::size_t key = static_cast<std::size_t>(r);
+            while (!done.load(std::memory_order_relaxed)) {
+                sum += table.lookup(key);
+                key += 7;
+                ++reads;
+            }
+            total_reads.fetch_add(reads);
+            sink.fetch_add(sum);
+        });
+    }
+
+    std::thread writer{[&] {
+        int generation = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            table.replace(make_table(++generation));
+            std::this_thread::sleep_for(update_interval);
+        }
+    }};
+
+    std::this_thread::sleep_for(run_time);
+    done = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    writer.join();
+
+    const std::chrono::duration<double> elapsed = run_time;
+    return static_cast<double>(total_reads.load()) / elapsed.count();
+}
+
+template <typename Table>
+void report(const std::string& name, int readers) {
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::setw(10)
+              << std::fixed << std::setprecision(1) << measure<Table>(readers) / 1e6
+              << " M lookups/s\n";
+}
+
+} // namespace
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== Read-mostly table: " << run_time.count() << "ms per run, one update every "
+              << update_interval.count() << "ms, " << cores << " hardware threads ===\n";
+
+    for (int readers : {1, 2, 4, 8, 16, 32, 64}) {
+        std::cout << "\n" << readers << " reader(s):\n";
+        report<SharedMutexTable>("std::shared_mutex", readers);
+        report<PublishedTable>("Published<T>", readers);
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Benchmark: rate limiter throughput under contention
+//
+// N threads call try_acquire() as fast as they can for a fixed time. The
+// rate is set high enough that every call is granted, so what is measured
+// is the cost of the limiter's bookkeeping, not the limit. MutexTokenBucket
+// is the straightforward version: a token count and a last-refill time
+// behind a std::mutex.
+
+#include "rate_limiter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto run_time = 200ms;
+constexpr auto token_interval = 1ns;  // 1e9 tokens/s: effectively unlimited
+constexpr std::uint32_t burst = 1'000'000;
+
+class MutexTokenBucket {
+public:
+    bool try_acquire() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        const auto now = std::chrono::steady_clock::now();
+        const auto earned = (now - last_refill_) / token_interval;
+        if (earned > 0) {
+            tokens_ = std::min<double>(burst, tokens_ + static_cast<double>(earned));
+            last_refill_ = now;
+        }
+        if (tokens_ < 1.0) {
+            return false;
+        }
+        tokens_ -= 1.0;
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    double tokens_ = burst;
+    std::chrono::steady_clock::time_point last_refill_ = std::chrono::steady_clock::now();
+};
+
+template <typename Acquire>
+void report(const std::string& name, int threads, Acquire acquire) {
+    std::atomic<bool> go{false};
+    std::atomic<bool> done{false};
+    std::atomic<long long> granted{0};
+    std::atomic<long long> calls{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            long long mine = 0;
+            long long ok = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                ok += acquire(t) ? 1 : 0;
+                ++mine;
+            }
+            calls.fetch_add(mine);
+            granted.fetch_add(ok);
+        });
+    }
+
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(run_time);
+    done = true;
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    const double seconds = std::chrono::duration<double>(run_time).count();
+    std::cout << "  " << std::left << std::setw(26) << name << std::right << std::setw(9)
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(calls.load()) / seconds / 1e6 << " M calls/s ("
+              << std::setprecision(0)
+              << 100.0 * static_cast<double>(granted.load()) /
+                     static_cast<double>(std::max(1LL, calls.load()))
+              << "% granted)\n";
+}
+
+} // namespace
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== Rate limiters: " << std::chrono::milliseconds{run_time}.count()
+              << "ms per run, " << cores << " hardware threads ===\n";
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        std::cout << "\n" << threads << " thread(s):\n";
+        {
+            MutexTokenBucket bucket;
+            report("MutexTokenBucket", threads, [&](int) { return bucket.try_acquire(); });
+        }
+        {
+            RateLimiter limiter{token_interval, burst};
+            report("RateLimiter (CAS)", threads, [&](int) { return limiter.try_acquire(); });
+        }
+        {
+            CachedRateLimiter limiter{token_interval, burst, 256};
+            report("CachedRateLimiter (256)", threads,
+                   [&](int) { return limiter.try_acquire(); });
+        }
+        {
+            KeyedRateLimiter<int> limiter{token_interval, burst, 4096};
+            report("KeyedRateLimiter (key/thr)", threads,
+                   [&](int t) { return limiter.try_acquire(t); });
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Benchmark: multi-threaded word counting - one locked map vs. sharded
+//
+// The corpus is words_total words drawn from a vocabulary of vocabulary
+// words with Zipf-like frequencies (a few words are very common, as in real
+// text). The argument is the number of threads; each counts one contiguous
+// slice of the corpus into a shared map:
+//
+//   std::map + mutex       - Chapter 12's increment_counter() behind one lock
+//   unordered_map + mutex  - the same with a hash map
+//   ShardedHashMap upsert  - one upsert() per word, std::mutex or
+//                            AdaptiveMutex shards
+//   local maps + merge     - each thread counts into its own FlatHashMap,
+//                            then merge()s it once
+//
+// Words are std::string_view slices of the corpus; the sharded variants
+// look them up without building a std::string. The single-lock maps stop
+// scaling at one thread. Per-word upserts scale until the most common
+// words' shards saturate; merging local maps touches each shard once per
+// thread and should scale with the number of cores.
+
+#include "bench.h"
+#include "locks.h"
+#include "sharded_hash_map.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+constexpr std::size_t words_total = 1'000'000;
+constexpr std::size_t vocabulary = 50'000;
+
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+// The corpus text and views of its words, built once
+struct Corpus {
+    std::string text;
+    std::vector<std::string_view> words;
+};
+
+const Corpus& corpus() {
+    static const Corpus c = [] {
+        std::mt19937_64 gen{42};
+
+        std::vector<std::string> vocab;
+        std::uniform_int_distribution<int> length{2, 10};
+        std::uniform_int_distribution<int> letter{'a', 'z'};
+        for (std::size_t i = 0; i < vocabulary; ++i) {
+            std::string w(static_cast<std::size_t>(length(gen)), ' ');
+            for (auto& ch : w) {
+                ch = static_cast<char>(letter(gen));
+            }
+            vocab.push_back(std::move(w));
+        }
+
+        // Zipf: the word of rank r has weight 1/r
+        std::vector<double> weights(vocabulary);
+        for (std::size_t r = 0; r < vocabulary; ++r) {
+            weights[r] = 1.0 / static_cast<double>(r + 1);
+        }
+        std::discrete_distribution<std::size_t> pick{weights.begin(), weights.end()};
+
+        Corpus out;
+        std::vector<std::size_t> offsets;
+        for (std::size_t i = 0; i < words_total; ++i) {
+            const auto& w = vocab[pick(gen)];
+            offsets.push_back(out.text.size());
+            out.text += w;
+            out.text += ' ';
+        }
+        // Views are taken after the text stops growing
+        for (const auto offset : offsets) {
+            const auto end = out.text.find(' ', offset);
+            out.words.push_back(std::string_view{out.text}.substr(offset, end - offset));
+        }
+        return out;
+    }();
+    return c;
+}
+
+template <typename Map>
+class LockedCounter {
+public:
+    void count(std::span<const std::string_view> words) {
+        for (const auto w : words) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            ++counts_[std::string{w}];
+        }
+    }
+
+    long long total() const {
+        long long sum = 0;
+        for (const auto& [word, n] : counts_) {
+            sum += n;
+        }
+        return sum;
+    }
+
+private:
+    std::mutex mutex_;
+    Map counts_;
+};
+
+using StdMapCounter = LockedCounter<std::map<std::string, long long>>;
+using UnorderedCounter = LockedCounter<std::unordered_map<std::string, long long>>;
+
+template <typename Mutex>
+class UpsertCounter {
+public:
+    void count(std::span<const std::string_view> words) {
+        for (const auto w : words) {
+            counts_.upsert(w, [](long long& n) { ++n; });
+        }
+    }
+
+    long long total() const {
+        long long sum = 0;
+        counts_.for_each([&sum](const std::string&, const long long& n) { sum += n; });
+        return sum;
+    }
+
+private:
+    ShardedHashMap<std::string, long long, StringHash, StringEqual, Mutex> counts_;
+};
+
+class MergeCounter {
+public:
+    void count(std::span<const std::string_view> words) {
+        Map::local_map local;
+        for (const auto w : words) {
+            const auto it = local.find(w);
+            if (it != local.end()) {
+                ++it->second;
+            } else {
+                local.try_emplace(std::string{w}, 1);
+            }
+        }
+        counts_.merge(std::move(local));
+    }
+
+    long long total() const {
+        long long sum = 0;
+        counts_.for_each([&sum](const std::string&, const long long& n) { sum += n; });
+        return sum;
+    }
+
+private:
+    using Map = ShardedHashMap<std::string, long long, StringHash, StringEqual>;
+    Map counts_;
+};
+
+// Counts the whole corpus with state.arg() threads per iteration. Only
+// the counting is timed: starting the threads, checking the total and
+// destroying the map are not.
+template <typename Counter>
+void count_words(bench::State& state) {
+    const auto& words = corpus().words;
+    const auto threads = static_cast<std::size_t>(state.arg());
+    const std::size_t slice = words.size() / threads;
+    while (state.keep_running()) {
+        state.pause_timing();
+        {
+            Counter counter;
+            std::atomic<bool> go{false};
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t) {
+                const std::size_t begin = t * slice;
+                const std::size_t end = t + 1 == threads ? words.size() : begin + slice;
+                workers.emplace_back([&, begin, end] {
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    counter.count(std::span{words}.subspan(begin, end - begin));
+                });
+            }
+
+            state.resume_timing();
+            go.store(true, std::memory_order_release);
+            for (auto& w : workers) {
+                w.join();
+            }
+            state.pause_timing();
+
+            const auto expected = static_cast<long long>(words.size());
+            if (counter.total() != expected) {
+                std::cerr << "count mismatch: " << counter.total() << " != " << expected << "\n";
+                std::abort();
+            }
+        }
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(words.size()));
+}
+
+[[maybe_unused]] const bool registered = [] {
+    // 1, 4, 16 and 64 threads
+    constexpr std::int64_t few = 1;
+    constexpr std::int64_t many = 64;
+
+    bench::register_benchmark("count/std_map_mutex", count_words<StdMapCounter>)
+        ->range(few, many, 4);
+    bench::register_benchmark("count/unordered_map_mutex", count_words<UnorderedCounter>)
+        ->range(few, many, 4);
+    bench::register_benchmark("count/upsert_mutex", count_words<UpsertCounter<std::mutex>>)
+        ->range(few, many, 4);
+    bench::register_benchmark("count/upsert_adaptive", count_words<UpsertCounter<AdaptiveMutex>>)
+        ->range(few, many, 4);
+    bench::register_benchmark("count/local_merge", count_words<MergeCounter>)
+        ->range(few, many, 4);
+    return true;
+}();
+
+} // namespace
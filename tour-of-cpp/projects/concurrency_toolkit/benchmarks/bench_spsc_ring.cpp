@@ -0,0 +1,181 @@
+// Benchmark: SpscRing vs. the mutex/condition_variable BoundedBuffer
+//
+// One producer thread hands items_per_run integers to one consumer thread.
+// BoundedBuffer is the class from chapters/ch18_concurrency/examples/
+// condition_variables.cpp, copied here because examples are not libraries.
+
+#include "spsc_ring.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <span>
+#include <string_view>
+#include <thread>
+
+using namespace concurrent;
+
+namespace {
+
+constexpr std::size_t capacity = 1024;
+constexpr std::int64_t items_per_run = 10'000'000;
+constexpr int runs = 3;
+
+template <typename T, std::size_t Capacity>
+class BoundedBuffer {
+public:
+    void push(T value) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        not_full_.wait(lock, [this] { return buffer_.size() < Capacity; });
+        buffer_.push(std::move(value));
+        not_empty_.notify_one();
+    }
+
+    T pop() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        not_empty_.wait(lock, [this] { return !buffer_.empty(); });
+        T value = std::move(buffer_.front());
+        buffer_.pop();
+        not_full_.notify_one();
+        return value;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::queue<T> buffer_;
+};
+
+// Runs producer and consumer on two threads; returns items per second.
+// The consumer checks the sum so the work cannot be optimized away.
+template <typename Producer, typename Consumer>
+double measure(Producer producer, Consumer consumer) {
+    const auto start = std::chrono::steady_clock::now();
+    std::thread t{producer};
+    const std::int64_t sum = consumer();
+    t.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (sum != items_per_run * (items_per_run - 1) / 2) {
+        std::cerr << "checksum mismatch\n";
+    }
+    return static_cast<double>(items_per_run) / elapsed.count();
+}
+
+template <typename Setup>
+void report(std::string_view name, Setup run_once) {
+    double best = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        best = std::max(best, run_once());
+    }
+    std::cout << std::left << std::setw(36) << name << std::right << std::setw(10)
+              << std::fixed << std::setprecision(1) << best / 1e6 << " M items/s\n";
+}
+
+double run_bounded_buffer() {
+    auto buffer = std::make_unique<BoundedBuffer<std::int64_t, capacity>>();
+    return measure(
+        [&] {
+            for (std::int64_t i = 0; i < items_per_run; ++i) {
+                buffer->push(i);
+            }
+        },
+        [&] {
+            std::int64_t sum = 0;
+            for (std::int64_t i = 0; i < items_per_run; ++i) {
+                sum += buffer->pop();
+            }
+            return sum;
+        });
+}
+
+double run_spsc_spinning() {
+    auto ring = std::make_unique<SpscRing<std::int64_t, capacity>>();
+    return measure(
+        [&] {
+            for (std::int64_t i = 0; i < items_per_run; ++i) {
+                while (!ring->try_push(i)) {
+                }
+            }
+        },
+        [&] {
+            std::int64_t sum = 0;
+            for (std::int64_t i = 0; i < items_per_run;) {
+                if (auto value = ring->try_pop()) {
+                    sum += *value;
+                    ++i;
+                }
+            }
+            return sum;
+        });
+}
+
+double run_spsc_blocking() {
+    auto ring = std::make_unique<SpscRing<std::int64_t, capacity, SpscMode::blocking>>();
+    return measure(
+        [&] {
+            for (std::int64_t i = 0; i < items_per_run; ++i) {
+                ring->push(i);
+            }
+        },
+        [&] {
+            std::int64_t sum = 0;
+            for (std::int64_t i = 0; i < items_per_run; ++i) {
+                sum += ring->pop();
+            }
+            return sum;
+        });
+}
+
+double run_spsc_batched() {
+    constexpr std::size_t batch = 64;
+    auto ring = std::make_unique<SpscRing<std::int64_t, capacity>>();
+    return measure(
+        [&] {
+            std::array<std::int64_t, batch> chunk{};
+            for (std::int64_t i = 0; i < items_per_run;) {
+                std::size_t n = 0;
+                for (; n < batch && i < items_per_run; ++n, ++i) {
+                    chunk[n] = i;
+                }
+                std::span<const std::int64_t> pending{chunk.data(), n};
+                while (!pending.empty()) {
+                    pending = pending.subspan(ring->try_push_batch(pending));
+                }
+            }
+        },
+        [&] {
+            std::array<std::int64_t, batch> out{};
+            std::int64_t sum = 0;
+            for (std::int64_t received = 0; received < items_per_run;) {
+                const std::size_t n = ring->try_pop_batch(out);
+                for (std::size_t k = 0; k < n; ++k) {
+                    sum += out[k];
+                }
+                received += static_cast<std::int64_t>(n);
+            }
+            return sum;
+        });
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== SPSC handoff: " << items_per_run << " items, capacity " << capacity
+              << ", best of " << runs << " ===\n\n";
+
+    report("BoundedBuffer (mutex + condvar)", run_bounded_buffer);
+    report("SpscRing try_push/try_pop (spin)", run_spsc_spinning);
+    report("SpscRing push/pop (atomic::wait)", run_spsc_blocking);
+    report("SpscRing batch of 64", run_spsc_batched);
+
+    return 0;
+}
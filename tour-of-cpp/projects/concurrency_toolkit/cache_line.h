@@ -0,0 +1,25 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#include <cstddef>
+
+namespace concurrent {
+
+/**
+ * Alignment used to keep data written by different threads on separate
+ * cache lines (avoiding false sharing).
+ *
+ * std::hardware_destructive_interference_size is the standard spelling, but
+ * GCC warns that its value may change between compiler versions, which makes
+ * it a poor choice for a class layout. Apple Silicon prefetches lines in
+ * pairs, so 128 bytes is used there; 64 bytes covers x86-64 and most ARM cores.
+ */
+#if defined(__APPLE__) && defined(__aarch64__)
+inline constexpr std::size_t cache_line_size = 128;
+#else
+inline constexpr std::size_t cache_line_size = 64;
+#endif
+
+} // namespace concurrent
+
+#endif // CACHE_LINE_H
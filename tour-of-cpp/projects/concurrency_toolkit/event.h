@@ -0,0 +1,106 @@
+#ifndef EVENT_H
+#define EVENT_H
+
+#include "wait_strategy.h"
+#include <atomic>
+#include <cstdint>
+
+namespace concurrent {
+
+/**
+ * A manual-reset event: Chapter 18's Signal without the mutex and
+ * condition_variable.
+ *
+ * The whole state is one 32-bit atomic, and waiters sleep on it with
+ * std::atomic::wait. set() on an event nobody waits for costs one atomic
+ * exchange; the standard library skips the wake-up call when it has no
+ * sleepers registered.
+ */
+class Event {
+public:
+    static constexpr int spin_limit = 64;
+
+    explicit Event(bool initially_set = false) noexcept : state_{initially_set ? 1u : 0u} {}
+
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    // Wakes every waiter; the event stays set until reset()
+    void set() noexcept {
+        if (state_.exchange(1, std::memory_order_release) == 0) {
+            state_.notify_all();
+        }
+    }
+
+    void reset() noexcept { state_.store(0, std::memory_order_relaxed); }
+
+    [[nodiscard]] bool is_set() const noexcept {
+        return state_.load(std::memory_order_acquire) != 0;
+    }
+
+    void wait() const noexcept {
+        for (int spins = 0; spins < spin_limit; ++spins) {
+            if (is_set()) {
+                return;
+            }
+            cpu_relax();
+        }
+        while (state_.load(std::memory_order_acquire) == 0) {
+            state_.wait(0, std::memory_order_acquire);
+        }
+    }
+
+private:
+    std::atomic<std::uint32_t> state_;
+};
+
+/**
+ * A single-use countdown: wait() blocks until count_down() has been called
+ * `expected` times in total. Same contract as std::latch, with a brief
+ * spin before sleeping for waiters that arrive just before the count
+ * reaches zero.
+ */
+class Latch {
+public:
+    static constexpr int spin_limit = 64;
+
+    explicit Latch(std::uint32_t expected) noexcept : remaining_{expected} {}
+
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    void count_down(std::uint32_t n = 1) noexcept {
+        if (remaining_.fetch_sub(n, std::memory_order_release) == n) {
+            remaining_.notify_all();
+        }
+    }
+
+    [[nodiscard]] bool try_wait() const noexcept {
+        return remaining_.load(std::memory_order_acquire) == 0;
+    }
+
+    void wait() const noexcept {
+        for (int spins = 0; spins < spin_limit; ++spins) {
+            if (try_wait()) {
+                return;
+            }
+            cpu_relax();
+        }
+        for (std::uint32_t current = remaining_.load(std::memory_order_acquire); current != 0;
+             current = remaining_.load(std::memory_order_acquire)) {
+            remaining_.wait(current, std::memory_order_acquire);
+        }
+    }
+
+    void arrive_and_wait(std::uint32_t n = 1) noexcept {
+        count_down(n);
+        wait();
+    }
+
+private:
+    std::atomic<std::uint32_t> remaining_;
+};
+
+} // namespace concurrent
+
+#endif // EVENT_H
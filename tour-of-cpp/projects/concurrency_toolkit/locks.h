@@ -0,0 +1,241 @@
+#ifndef LOCKS_H
+#define LOCKS_H
+
+#include "cache_line.h"
+#include "wait_strategy.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace concurrent {
+
+/**
+ * A mutex that spins briefly before sleeping in the kernel.
+ *
+ * Three states, after Drepper's "Futexes Are Tricky": unlocked, locked, and
+ * locked with (possibly) sleeping waiters. unlock() only makes a system
+ * call in the last state. Sleeping uses std::atomic::wait, which is a
+ * futex on Linux.
+ *
+ * How long lock() spins adapts to recent history, like glibc's
+ * PTHREAD_MUTEX_ADAPTIVE_NP: a running average of how many spins past
+ * acquisitions needed. Short critical sections keep the estimate low and
+ * the lock is usually taken before the spin budget runs out; long ones
+ * push it up to max_spins, after which waiting threads go to sleep. On a
+ * single-core machine it never spins - the owner cannot make progress
+ * while we do.
+ *
+ * Satisfies Lockable, so it works with std::lock_guard, std::unique_lock
+ * and std::condition_variable_any.
+ */
+class AdaptiveMutex {
+public:
+    static constexpr int max_spins = 1000;
+
+    AdaptiveMutex() = default;
+    AdaptiveMutex(const AdaptiveMutex&) = delete;
+    AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+    void lock() noexcept {
+        if (!try_lock()) {
+            lock_slow();
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept {
+        std::uint32_t expected = unlocked;
+        return state_.compare_exchange_strong(expected, locked, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        if (state_.exchange(unlocked, std::memory_order_release) == contended) {
+            state_.notify_one();
+        }
+    }
+
+private:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t contended = 2;
+
+    void lock_slow() noexcept {
+        static const bool multi_core = std::thread::hardware_concurrency() > 1;
+
+        if (multi_core) {
+            const int estimate = spin_estimate_.load(std::memory_order_relaxed);
+            const int limit = std::min(max_spins, 2 * estimate + 10);
+            for (int spins = 0; spins < limit; ++spins) {
+                if (state_.load(std::memory_order_relaxed) == unlocked && try_lock()) {
+                    spin_estimate_.store(estimate + (spins - estimate) / 8,
+                                         std::memory_order_relaxed);
+                    return;
+                }
+                cpu_relax();
+            }
+            spin_estimate_.store(estimate + (limit - estimate) / 8, std::memory_order_relaxed);
+        }
+
+        // Taking the lock in the contended state is conservative: the next
+        // unlock() wakes someone even if we were the last waiter.
+        while (state_.exchange(contended, std::memory_order_acquire) != unlocked) {
+            state_.wait(contended, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint32_t> state_{unlocked};
+    std::atomic<int> spin_estimate_{0};
+};
+
+/**
+ * A FIFO-fair lock: threads are served in the order they called lock().
+ *
+ * Each locker takes a ticket and waits until now_serving_ reaches it. The
+ * two counters live on separate cache lines so taking a ticket does not
+ * disturb the waiters polling now_serving_. Waiters back off in proportion
+ * to their distance from the front of the line, and sleep after a while,
+ * so oversubscribed threads do not spin away the owner's time slice.
+ *
+ * Fairness has a price: when the next ticket holder is descheduled, nobody
+ * else can take the lock either. Prefer AdaptiveMutex unless starvation
+ * under heavy contention is the actual problem.
+ */
+class TicketLock {
+public:
+    static constexpr int spin_limit = 64;
+
+    TicketLock() = default;
+    TicketLock(const TicketLock&) = delete;
+    TicketLock& operator=(const TicketLock&) = delete;
+
+    void lock() noexcept {
+        const std::uint32_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+        for (int spins = 0;; ++spins) {
+            const std::uint32_t serving = now_serving_.load(std::memory_order_acquire);
+            if (serving == ticket) {
+                return;
+            }
+            if (spins < spin_limit) {
+                for (std::uint32_t i = 0; i < ticket - serving; ++i) {
+                    cpu_relax();
+                }
+            } else {
+                now_serving_.wait(serving, std::memory_order_acquire);
+            }
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept {
+        std::uint32_t serving = now_serving_.load(std::memory_order_acquire);
+        return next_ticket_.compare_exchange_strong(serving, serving + 1,
+                                                    std::memory_order_acquire,
+                                                    std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        now_serving_.store(now_serving_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_release);
+        // Every sleeper wakes, but only the next ticket holder proceeds
+        now_serving_.notify_all();
+    }
+
+private:
+    alignas(cache_line_size) std::atomic<std::uint32_t> next_ticket_{0};
+    alignas(cache_line_size) std::atomic<std::uint32_t> now_serving_{0};
+};
+
+/**
+ * The Mellor-Crummey/Scott queue lock: FIFO-fair, and each waiter spins on
+ * a flag in its own queue node instead of on a shared word, so a release
+ * touches only the cache line of the next waiter.
+ *
+ * The queue node must live until unlock(), so MCS does not fit the
+ * Lockable interface; lock through a Guard, which keeps the node on the
+ * caller's stack:
+ *
+ *   McsLock lock;
+ *   {
+ *       McsLock::Guard guard{lock};
+ *       // critical section
+ *   }
+ *
+ * Waiters spin, then yield. They never sleep on their node's flag: the
+ * releasing thread would have to notify after handing over the lock, by
+ * which time the woken waiter may already have destroyed the node.
+ */
+class McsLock {
+public:
+    static constexpr int spin_limit = 128;
+
+    struct alignas(cache_line_size) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> waiting{false};
+    };
+
+    class Guard {
+    public:
+        explicit Guard(McsLock& lock) noexcept : lock_{lock} { lock_.lock(node_); }
+        ~Guard() { lock_.unlock(node_); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        McsLock& lock_;
+        Node node_;
+    };
+
+    McsLock() = default;
+    McsLock(const McsLock&) = delete;
+    McsLock& operator=(const McsLock&) = delete;
+
+    void lock(Node& node) noexcept {
+        node.next.store(nullptr, std::memory_order_relaxed);
+        node.waiting.store(true, std::memory_order_relaxed);
+
+        Node* const prev = tail_.exchange(&node, std::memory_order_acq_rel);
+        if (prev == nullptr) {
+            return;
+        }
+        prev->next.store(&node, std::memory_order_release);
+
+        for (int spins = 0; node.waiting.load(std::memory_order_acquire); ++spins) {
+            if (spins < spin_limit) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    [[nodiscard]] bool try_lock(Node& node) noexcept {
+        node.next.store(nullptr, std::memory_order_relaxed);
+        Node* expected = nullptr;
+        return tail_.compare_exchange_strong(expected, &node, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void unlock(Node& node) noexcept {
+        Node* next = node.next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            Node* expected = &node;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                return;
+            }
+            // A successor swapped itself into tail_ but has not linked yet
+            while ((next = node.next.load(std::memory_order_acquire)) == nullptr) {
+                cpu_relax();
+            }
+        }
+        next->waiting.store(false, std::memory_order_release);
+    }
+
+private:
+    alignas(cache_line_size) std::atomic<Node*> tail_{nullptr};
+};
+
+} // namespace concurrent
+
+#endif // LOCKS_H
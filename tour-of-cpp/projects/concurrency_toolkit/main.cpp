@@ -0,0 +1,205 @@
+#include "event.h"
+#include "locks.h"
+#include "mpmc_queue.h"
+#include "published.h"
+#include "rate_limiter.h"
+#include "sharded_counter.h"
+#include "spsc_ring.h"
+#include <array>
+#include <chrono>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+/**
+ * Demonstrates the concurrency toolkit building blocks.
+ */
+
+int main() {
+    std::cout << "=== Concurrency Toolkit Demo ===\n\n";
+
+    // 1. SPSC ring: non-blocking handoff
+    std::cout << "1. SpscRing try_push/try_pop:\n";
+    {
+        SpscRing<std::string, 4> ring;
+        std::cout << "   Capacity: " << ring.capacity() << "\n";
+
+        for (const char* word : {"alpha", "beta", "gamma", "delta", "epsilon"}) {
+            const bool pushed = ring.try_push(word);
+            std::cout << "   push " << word << ": " << (pushed ? "ok" : "full") << "\n";
+        }
+
+        while (auto word = ring.try_pop()) {
+            std::cout << "   popped " << *word << "\n";
+        }
+    }
+
+    // 2. SPSC ring: blocking two-stage pipeline
+    std::cout << "\n2. Blocking pipeline stage handoff:\n";
+    {
+        SpscRing<int, 8, SpscMode::blocking> ring;
+        constexpr int count = 1000;
+
+        std::thread producer{[&ring] {
+            for (int i = 1; i <= count; ++i) {
+                ring.push(i);
+            }
+        }};
+
+        long long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += ring.pop();
+        }
+        producer.join();
+
+        std::cout << "   Sum of 1.." << count << " through an 8-slot ring: " << sum << "\n";
+    }
+
+    // 3. SPSC ring: batch transfer
+    std::cout << "\n3. Batch push/pop:\n";
+    {
+        SpscRing<int, 16> ring;
+        std::array<int, 10> in{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        std::array<int, 4> out{};
+
+        std::cout << "   Pushed " << ring.try_push_batch(in) << " items with one publish\n";
+        std::cout << "   Popped " << ring.try_pop_batch(out) << " items:";
+        for (int x : out) {
+            std::cout << ' ' << x;
+        }
+        std::cout << "\n   Remaining: " << ring.size() << "\n";
+    }
+
+    // 4. MPMC queue with a sleeping wait strategy
+    std::cout << "\n4. BoundedMpmcQueue with AtomicWait (3 producers, 2 consumers):\n";
+    {
+        BoundedMpmcQueue<int, AtomicWait> queue{16};
+        constexpr int per_producer = 1000;
+        std::atomic<int> remaining{3 * per_producer};
+        std::atomic<long long> sum{0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < 3; ++p) {
+            threads.emplace_back([&queue] {
+                for (int i = 1; i <= per_producer; ++i) {
+                    queue.push(i);
+                }
+            });
+        }
+        for (int c = 0; c < 2; ++c) {
+            threads.emplace_back([&] {
+                while (remaining.fetch_sub(1) > 0) {
+                    sum += queue.pop();
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        std::cout << "   Sum: " << sum.load() << " (expected " << 3 * 500500 << ")\n";
+    }
+
+    // 5. Sharded counter for hot metrics
+    std::cout << "\n5. ShardedCounter (4 threads x 10000 increments):\n";
+    {
+        ShardedCounter<> events;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&events] {
+                for (int i = 0; i < 10000; ++i) {
+                    events.increment();
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        std::cout << "   Slots: " << events.shard_count() << "\n";
+        std::cout << "   Total: " << events.value() << " (expected 40000)\n";
+    }
+
+    // 6. RCU-style publication of a routing table
+    std::cout << "\n6. Published<T> snapshots:\n";
+    {
+        Published<std::map<std::string, std::string>> routes{{{"/api", "backend-1"}}};
+
+        auto before = routes.read();
+        routes.update([](auto& table) {
+            table["/api"] = "backend-2";
+            table["/static"] = "cdn";
+        });
+        auto after = routes.read();
+
+        std::cout << "   Old snapshot: /api -> " << before->at("/api") << " (" << before->size()
+                  << " route)\n";
+        std::cout << "   New snapshot: /api -> " << after->at("/api") << " (" << after->size()
+                  << " routes)\n";
+        std::cout << "   Versions awaiting reclamation: " << routes.retired_count() << "\n";
+    }
+
+    // 7. Lightweight synchronization primitives
+    std::cout << "\n7. AdaptiveMutex, McsLock and Latch (4 workers):\n";
+    {
+        AdaptiveMutex mutex;
+        McsLock mcs;
+        Latch start{1};
+        Latch finished{4};
+        long long guarded_by_mutex = 0;
+        long long guarded_by_mcs = 0;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                start.wait();
+                for (int i = 0; i < 10000; ++i) {
+                    {
+                        std::lock_guard<AdaptiveMutex> lock{mutex};
+                        ++guarded_by_mutex;
+                    }
+                    McsLock::Guard guard{mcs};
+                    ++guarded_by_mcs;
+                }
+                finished.count_down();
+            });
+        }
+
+        start.count_down();  // release all workers at once
+        finished.wait();
+        std::cout << "   AdaptiveMutex count: " << guarded_by_mutex << " (expected 40000)\n";
+        std::cout << "   McsLock count:       " << guarded_by_mcs << " (expected 40000)\n";
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    // 8. Token-bucket rate limiting
+    std::cout << "\n8. RateLimiter (10 per second, burst 3):\n";
+    {
+        using namespace std::chrono_literals;
+        RateLimiter limiter{100ms, 3};
+        const auto t0 = RateLimiter::clock::now();
+
+        for (auto at : {0ms, 0ms, 0ms, 0ms, 50ms, 100ms, 150ms}) {
+            const bool granted = limiter.try_acquire(1, t0 + at);
+            std::cout << "   t=" << at.count() << "ms: " << (granted ? "granted" : "throttled")
+                      << "\n";
+        }
+
+        KeyedRateLimiter<std::string> per_tenant{1s, 2, 1024};
+        std::cout << std::boolalpha << "   tenant-a: " << per_tenant.try_acquire("tenant-a", 2)
+                  << ", tenant-a: " << per_tenant.try_acquire("tenant-a") << ", tenant-b: "
+                  << per_tenant.try_acquire("tenant-b") << "\n";
+    }
+
+    std::cout << "\n=== Demo Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,428 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include "cache_line.h"
+#include "thread_index.h"
+#include "wait_strategy.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+/**
+ * The interface shared by every multi-producer/multi-consumer queue here.
+ *
+ * try_push/try_pop never wait. push/pop wait using the queue's
+ * WaitStrategy (push only waits on bounded queues).
+ */
+template <typename Q>
+concept ConcurrentQueue = requires(Q q, typename Q::value_type v) {
+    { q.try_push(std::move(v)) } -> std::same_as<bool>;
+    { q.try_pop() } -> std::same_as<std::optional<typename Q::value_type>>;
+    q.push(std::move(v));
+    { q.pop() } -> std::same_as<typename Q::value_type>;
+};
+
+// ============================================================================
+// Bounded MPMC queue
+// ============================================================================
+
+/**
+ * A bounded, lock-free MPMC queue (Dmitry Vyukov's sequence-number ring).
+ *
+ * Every cell carries a sequence number that tells producers and consumers
+ * whose turn it is:
+ *   sequence == pos          cell is free for the producer claiming pos
+ *   sequence == pos + 1      cell holds the element for the consumer at pos
+ * A thread claims a position with one CAS on the shared enqueue/dequeue
+ * counter and then owns the cell; no thread ever waits for another to
+ * finish a half-done operation on a different cell.
+ *
+ * Example:
+ *   BoundedMpmcQueue<Job, AtomicWait> jobs{1024};
+ *   jobs.push(job);          // any thread; sleeps while full
+ *   Job next = jobs.pop();   // any thread; sleeps while empty
+ */
+template <typename T, WaitStrategy Wait = SpinThenYield>
+class BoundedMpmcQueue {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /**
+     * @param capacity Minimum capacity; rounded up to a power of two (>= 2)
+     */
+    explicit BoundedMpmcQueue(size_type capacity)
+        : mask_{std::bit_ceil(capacity < 2 ? size_type{2} : capacity) - 1},
+          cells_{std::make_unique<Cell[]>(mask_ + 1)}
+    {
+        for (size_type i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedMpmcQueue() {
+        while (try_pop_impl()) {
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue(BoundedMpmcQueue&&) = delete;
+    BoundedMpmcQueue& operator=(BoundedMpmcQueue&&) = delete;
+
+    /**
+     * @return false if the queue is full; value is then left untouched
+     */
+    [[nodiscard]] bool try_push(const T& value) { return try_push_and_notify(value); }
+    [[nodiscard]] bool try_push(T&& value) { return try_push_and_notify(std::move(value)); }
+
+    [[nodiscard]] std::optional<T> try_pop() {
+        auto value = try_pop_impl();
+        if (value) {
+            not_full_.notify_one();
+        }
+        return value;
+    }
+
+    void push(T value) {
+        not_full_.wait_until([&] { return try_push_impl(std::move(value)); });
+        not_empty_.notify_one();
+    }
+
+    [[nodiscard]] T pop() {
+        std::optional<T> value;
+        not_empty_.wait_until([&] {
+            value = try_pop_impl();
+            return value.has_value();
+        });
+        not_full_.notify_one();
+        return std::move(*value);
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept { return mask_ + 1; }
+
+    /**
+     * Approximate number of elements (exact when no thread is mid-operation).
+     */
+    [[nodiscard]] size_type size() const noexcept {
+        const size_type tail = enqueue_pos_.load(std::memory_order_acquire);
+        const size_type head = dequeue_pos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_type> sequence;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T* get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    template <typename U>
+    bool try_push_and_notify(U&& value) {
+        if (!try_push_impl(std::forward<U>(value))) {
+            return false;
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Constructs from value only once a cell has been claimed
+    template <typename U>
+    bool try_push_impl(U&& value) {
+        size_type pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            const size_type seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::construct_at(reinterpret_cast<T*>(cell.storage), std::forward<U>(value));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full: the cell still holds last lap's element
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> try_pop_impl() {
+        size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            const size_type seq = cell.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* p = cell.get();
+                    std::optional<T> value{std::move(*p)};
+                    std::destroy_at(p);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // Empty: producer for pos has not published
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_type mask_;
+    const std::unique_ptr<Cell[]> cells_;
+
+    alignas(cache_line_size) std::atomic<size_type> enqueue_pos_{0};
+    alignas(cache_line_size) std::atomic<size_type> dequeue_pos_{0};
+    alignas(cache_line_size) Wait not_empty_;
+    alignas(cache_line_size) Wait not_full_;
+};
+
+// ============================================================================
+// Unbounded MPMC queue
+// ============================================================================
+
+/**
+ * An unbounded, lock-free MPMC queue made of linked fixed-size segments.
+ *
+ * Each segment is an array of SegmentSize slots that is filled exactly once:
+ * producers claim a slot with fetch_add on the segment's tail, consumers
+ * claim one with a CAS on its head. A producer that overruns a segment links
+ * a fresh one (one allocation per SegmentSize elements) and moves on.
+ *
+ * Reclamation: a consumed segment is unlinked and retired, and freed once
+ * every operation that might still hold a pointer to it has finished.
+ * In-flight operations are counted in per-thread-striped, cache-line padded
+ * counters so that the accounting itself does not become a shared hot spot.
+ * Under uninterrupted load, retired segments accumulate until some moment
+ * at which all stripes are idle.
+ */
+template <typename T, WaitStrategy Wait = SpinThenYield, std::size_t SegmentSize = 1024>
+class UnboundedMpmcQueue {
+    static_assert(SegmentSize >= 2, "UnboundedMpmcQueue segments need at least two slots");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    UnboundedMpmcQueue() {
+        auto* first = new Segment;
+        head_segment_.store(first, std::memory_order_relaxed);
+        tail_segment_.store(first, std::memory_order_relaxed);
+    }
+
+    ~UnboundedMpmcQueue() {
+        while (try_pop_impl()) {
+        }
+        Segment* segment = head_segment_.load(std::memory_order_relaxed);
+        while (segment) {
+            delete std::exchange(segment, segment->next.load(std::memory_order_relaxed));
+        }
+        for (Segment* retired : retired_) {
+            delete retired;
+        }
+    }
+
+    UnboundedMpmcQueue(const UnboundedMpmcQueue&) = delete;
+    UnboundedMpmcQueue& operator=(const UnboundedMpmcQueue&) = delete;
+    UnboundedMpmcQueue(UnboundedMpmcQueue&&) = delete;
+    UnboundedMpmcQueue& operator=(UnboundedMpmcQueue&&) = delete;
+
+    /**
+     * Always succeeds (allocation failure aside); returns bool for the
+     * ConcurrentQueue interface.
+     */
+    bool try_push(T value) {
+        push(std::move(value));
+        return true;
+    }
+
+    void push(T value) {
+        {
+            OperationGuard guard{*this};
+            push_impl(value);
+        }
+        not_empty_.notify_one();
+    }
+
+    [[nodiscard]] std::optional<T> try_pop() { return try_pop_impl(); }
+
+    [[nodiscard]] T pop() {
+        std::optional<T> value;
+        not_empty_.wait_until([&] {
+            value = try_pop_impl();
+            return value.has_value();
+        });
+        return std::move(*value);
+    }
+
+private:
+    struct Slot {
+        std::atomic<bool> ready{false};
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T* get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    struct Segment {
+        alignas(cache_line_size) std::atomic<size_type> tail{0};
+        alignas(cache_line_size) std::atomic<size_type> head{0};
+        std::atomic<Segment*> next{nullptr};
+        std::array<Slot, SegmentSize> slots;
+    };
+
+    struct alignas(cache_line_size) Stripe {
+        std::atomic<size_type> active{0};
+    };
+
+    static constexpr size_type stripe_count = 16;
+
+    // Marks the calling thread as possibly holding segment pointers
+    class OperationGuard {
+    public:
+        explicit OperationGuard(UnboundedMpmcQueue& queue)
+            : queue_{queue}, stripe_{queue.stripes_[this_thread_index() % stripe_count]}
+        {
+            stripe_.active.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~OperationGuard() {
+            stripe_.active.fetch_sub(1, std::memory_order_seq_cst);
+            if (queue_.retired_count_.load(std::memory_order_relaxed) != 0) {
+                queue_.try_reclaim();
+            }
+        }
+
+        OperationGuard(const OperationGuard&) = delete;
+        OperationGuard& operator=(const OperationGuard&) = delete;
+
+    private:
+        UnboundedMpmcQueue& queue_;
+        Stripe& stripe_;
+    };
+
+    void push_impl(T& value) {
+        while (true) {
+            Segment* segment = tail_segment_.load(std::memory_order_seq_cst);
+            const size_type index = segment->tail.fetch_add(1, std::memory_order_acq_rel);
+            if (index < SegmentSize) {
+                Slot& slot = segment->slots[index];
+                std::construct_at(reinterpret_cast<T*>(slot.storage), std::move(value));
+                slot.ready.store(true, std::memory_order_release);
+                return;
+            }
+            advance_tail(segment, next_or_link(segment));
+        }
+    }
+
+    std::optional<T> try_pop_impl() {
+        OperationGuard guard{*this};
+        while (true) {
+            Segment* segment = head_segment_.load(std::memory_order_seq_cst);
+            size_type index = segment->head.load(std::memory_order_acquire);
+
+            if (index >= SegmentSize) {
+                // Fully consumed: move on if a successor exists
+                Segment* next = segment->next.load(std::memory_order_acquire);
+                if (!next) {
+                    return std::nullopt;
+                }
+                advance_tail(segment, next);
+                if (head_segment_.compare_exchange_strong(segment, next,
+                                                          std::memory_order_seq_cst)) {
+                    retire(segment);
+                }
+                continue;
+            }
+
+            Slot& slot = segment->slots[index];
+            if (!slot.ready.load(std::memory_order_acquire)) {
+                if (index >= segment->tail.load(std::memory_order_acquire)) {
+                    return std::nullopt;  // Nobody has claimed this slot yet
+                }
+                cpu_relax();  // Claimed; the producer is still constructing
+                continue;
+            }
+
+            if (segment->head.compare_exchange_weak(index, index + 1,
+                                                    std::memory_order_acq_rel)) {
+                T* p = slot.get();
+                std::optional<T> value{std::move(*p)};
+                std::destroy_at(p);
+                return value;
+            }
+        }
+    }
+
+    // Returns segment->next, linking a new segment if there is none yet
+    Segment* next_or_link(Segment* segment) {
+        Segment* next = segment->next.load(std::memory_order_acquire);
+        if (next) {
+            return next;
+        }
+        auto fresh = std::make_unique<Segment>();
+        if (segment->next.compare_exchange_strong(next, fresh.get(),
+                                                  std::memory_order_acq_rel)) {
+            return fresh.release();
+        }
+        return next;  // Another producer linked one first
+    }
+
+    void advance_tail(Segment* from, Segment* to) {
+        tail_segment_.compare_exchange_strong(from, to, std::memory_order_seq_cst);
+    }
+
+    void retire(Segment* segment) {
+        std::lock_guard<std::mutex> lock{retire_mutex_};
+        retired_.push_back(segment);
+        retired_count_.store(retired_.size(), std::memory_order_relaxed);
+    }
+
+    // Frees retired segments if no operation could still be using them.
+    // A stripe reading zero after the segments were unlinked proves that
+    // every operation counted in it that started earlier has finished.
+    void try_reclaim() {
+        std::unique_lock<std::mutex> lock{retire_mutex_, std::try_to_lock};
+        if (!lock.owns_lock() || retired_.empty()) {
+            return;
+        }
+        for (const Stripe& stripe : stripes_) {
+            if (stripe.active.load(std::memory_order_seq_cst) != 0) {
+                return;
+            }
+        }
+        for (Segment* segment : retired_) {
+            delete segment;
+        }
+        retired_.clear();
+        retired_count_.store(0, std::memory_order_relaxed);
+    }
+
+    alignas(cache_line_size) std::atomic<Segment*> head_segment_{nullptr};
+    alignas(cache_line_size) std::atomic<Segment*> tail_segment_{nullptr};
+    alignas(cache_line_size) Wait not_empty_;
+
+    std::array<Stripe, stripe_count> stripes_{};
+
+    alignas(cache_line_size) std::atomic<size_type> retired_count_{0};
+    std::mutex retire_mutex_;
+    std::vector<Segment*> retired_;
+};
+
+} // namespace concurrent
+
+#endif // MPMC_QUEUE_H
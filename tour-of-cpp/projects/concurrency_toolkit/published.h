@@ -0,0 +1,224 @@
+#ifndef PUBLISHED_H
+#define PUBLISHED_H
+
+#include "cache_line.h"
+#include "thread_index.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+/**
+ * RCU-style publication of read-mostly data.
+ *
+ * Readers call read() and get a Snapshot: a pointer to an immutable
+ * version of T that stays valid until the Snapshot is destroyed, however
+ * many new versions are published meanwhile. Entering and leaving a read
+ * section is an increment and a decrement of a counter striped by thread,
+ * plus one load of the current pointer - no loops, no locks, so readers
+ * are wait-free and, unlike with the lock word of std::shared_mutex, do
+ * not all write to the same cache line.
+ *
+ * Writers are serialized by a mutex. publish() swaps in a new version and
+ * retires the old one; it never waits for readers.
+ *
+ * Reclamation uses epochs. Each stripe counts the readers that entered in
+ * an even and in an odd epoch. The epoch may only advance from e to e + 1
+ * when no reader is still counted under the parity of e + 1 (those entered
+ * in e - 1 or earlier). A version retired in epoch E can no longer be seen
+ * by anyone once the epoch reaches E + 2, because each of the two
+ * advances had to find the parity its last possible reader counted under
+ * empty. Writers try to advance the epoch and free what they can on every
+ * publish(); synchronize() waits until everything retired is freed.
+ */
+template <typename T>
+class Published {
+    struct alignas(cache_line_size) Stripe {
+        std::atomic<std::int64_t> readers[2]{};
+    };
+
+public:
+    using value_type = T;
+
+    /**
+     * Keeps one version alive while it is being read.
+     *
+     * A thread holding a Snapshot may publish(), but must not call
+     * synchronize(): it would wait for its own read section to end.
+     */
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept
+            : counter_{std::exchange(other.counter_, nullptr)}, value_{other.value_} {}
+
+        Snapshot& operator=(Snapshot&& other) noexcept {
+            if (this != &other) {
+                release();
+                counter_ = std::exchange(other.counter_, nullptr);
+                value_ = other.value_;
+            }
+            return *this;
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        ~Snapshot() { release(); }
+
+        [[nodiscard]] const T& operator*() const noexcept { return *value_; }
+        [[nodiscard]] const T* operator->() const noexcept { return value_; }
+        [[nodiscard]] const T* get() const noexcept { return value_; }
+
+    private:
+        friend class Published;
+
+        Snapshot(std::atomic<std::int64_t>* counter, const T* value) noexcept
+            : counter_{counter}, value_{value} {}
+
+        void release() noexcept {
+            if (counter_ != nullptr) {
+                counter_->fetch_sub(1, std::memory_order_release);
+                counter_ = nullptr;
+            }
+        }
+
+        std::atomic<std::int64_t>* counter_;
+        const T* value_;
+    };
+
+    explicit Published(T initial)
+        : stripe_mask_{std::bit_ceil(std::max(1u, std::thread::hardware_concurrency())) - 1},
+          stripes_{std::make_unique<Stripe[]>(stripe_mask_ + 1)},
+          current_{new T(std::move(initial))} {}
+
+    template <typename... Args>
+    explicit Published(std::in_place_t, Args&&... args)
+        : stripe_mask_{std::bit_ceil(std::max(1u, std::thread::hardware_concurrency())) - 1},
+          stripes_{std::make_unique<Stripe[]>(stripe_mask_ + 1)},
+          current_{new T(std::forward<Args>(args)...)} {}
+
+    // No Snapshot may outlive the Published it came from
+    ~Published() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    // ========================================================================
+    // Readers (wait-free)
+    // ========================================================================
+
+    [[nodiscard]] Snapshot read() const noexcept {
+        const std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        auto& counter = stripes_[this_thread_index() & stripe_mask_].readers[epoch & 1];
+        // seq_cst orders the increment before the pointer load for any
+        // writer that later scans the counters
+        counter.fetch_add(1, std::memory_order_seq_cst);
+        return Snapshot{&counter, current_.load(std::memory_order_seq_cst)};
+    }
+
+    // ========================================================================
+    // Writers (serialized)
+    // ========================================================================
+
+    void publish(T value) {
+        publish_ptr(std::make_unique<T>(std::move(value)));
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        publish_ptr(std::make_unique<T>(std::forward<Args>(args)...));
+    }
+
+    // Read-copy-update: copies the current version, lets fn modify the
+    // copy and publishes it. Concurrent update() calls never lose changes.
+    template <typename F>
+    void update(F&& fn) {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        auto next = std::make_unique<T>(*current_.load(std::memory_order_relaxed));
+        std::forward<F>(fn)(*next);
+        publish_locked(std::move(next));
+    }
+
+    // Blocks until every retired version has been freed, i.e. until every
+    // read section that started before the call has ended
+    void synchronize() {
+        std::unique_lock<std::mutex> lock{writer_mutex_};
+        while (!retired_.empty()) {
+            try_advance();
+            reclaim();
+            if (!retired_.empty()) {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+        }
+    }
+
+    // Number of versions waiting for readers to move on
+    [[nodiscard]] std::size_t retired_count() const {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        return retired_.size();
+    }
+
+private:
+    struct Retired {
+        std::unique_ptr<const T> value;
+        std::uint64_t epoch;
+    };
+
+    void publish_ptr(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        publish_locked(std::move(next));
+    }
+
+    void publish_locked(std::unique_ptr<T> next) {
+        const T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        retired_.push_back({std::unique_ptr<const T>{old}, epoch_.load(std::memory_order_seq_cst)});
+
+        // Two advances free `old` right away when no reader is active
+        try_advance();
+        try_advance();
+        reclaim();
+    }
+
+    // Moves to the next epoch if no reader is left from the one before the
+    // current epoch. Called with writer_mutex_ held.
+    void try_advance() {
+        const std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        const std::size_t stale = (epoch + 1) & 1;
+        for (std::size_t i = 0; i <= stripe_mask_; ++i) {
+            if (stripes_[i].readers[stale].load(std::memory_order_seq_cst) != 0) {
+                return;
+            }
+        }
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+    }
+
+    void reclaim() {
+        const std::uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+        std::erase_if(retired_, [epoch](const Retired& r) { return r.epoch + 2 <= epoch; });
+    }
+
+    const std::size_t stripe_mask_;
+    const std::unique_ptr<Stripe[]> stripes_;
+
+    alignas(cache_line_size) std::atomic<const T*> current_;
+    std::atomic<std::uint64_t> epoch_{0};
+
+    alignas(cache_line_size) mutable std::mutex writer_mutex_;
+    std::vector<Retired> retired_;
+};
+
+} // namespace concurrent
+
+#endif // PUBLISHED_H
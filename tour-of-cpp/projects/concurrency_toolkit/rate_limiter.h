@@ -0,0 +1,308 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include "cache_line.h"
+#include "thread_index.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace concurrent {
+
+/**
+ * A token bucket implemented as GCRA (the generic cell rate algorithm).
+ *
+ * A token is earned every `interval`, up to `burst` tokens banked. Rather
+ * than a token count plus a last-refill time, GCRA keeps a single number:
+ * the theoretical arrival time (TAT) at which the bucket will be full
+ * again. Taking n tokens moves TAT n intervals into the future (starting
+ * from now if TAT is in the past); the request is refused if that would put
+ * TAT more than burst intervals ahead of now.
+ *
+ * One number means one atomic, so try_acquire() is a load, some
+ * arithmetic and a compare-exchange - no lock. A refused request writes
+ * nothing.
+ *
+ * RateLimiter{100ms} (burst 1) is the "minimum interval between actions"
+ * limiter from Chapter 16's chrono exercise.
+ */
+class RateLimiter {
+public:
+    using clock = std::chrono::steady_clock;
+    using duration = std::chrono::nanoseconds;
+
+    explicit RateLimiter(duration interval, std::uint32_t burst = 1)
+        : interval_{interval.count()}, burst_{burst} {
+        if (interval <= duration::zero()) {
+            throw std::invalid_argument("RateLimiter: interval must be positive");
+        }
+        if (burst == 0) {
+            throw std::invalid_argument("RateLimiter: burst must be at least 1");
+        }
+    }
+
+    // `rate` tokens per second, at most `burst` at once
+    [[nodiscard]] static RateLimiter per_second(double rate, std::uint32_t burst = 1) {
+        return RateLimiter{interval_for(rate), burst};
+    }
+
+    // Takes n tokens if all n are available; never takes some of them
+    [[nodiscard]] bool try_acquire(std::uint32_t n = 1) noexcept {
+        return try_acquire(n, clock::now());
+    }
+
+    [[nodiscard]] bool try_acquire(std::uint32_t n, clock::time_point now) noexcept {
+        if (n > burst_) {
+            return false;
+        }
+        const std::int64_t t = ticks(now);
+        const std::int64_t cost = static_cast<std::int64_t>(n) * interval_;
+        const std::int64_t limit = t + static_cast<std::int64_t>(burst_) * interval_;
+
+        std::int64_t tat = tat_.load(std::memory_order_relaxed);
+        while (true) {
+            const std::int64_t next = std::max(tat, t) + cost;
+            if (next > limit) {
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // How long until try_acquire(n) can succeed (zero if it can now)
+    [[nodiscard]] duration
+    time_until_available(std::uint32_t n = 1,
+                         clock::time_point now = clock::now()) const noexcept {
+        if (n > burst_) {
+            return duration::max();
+        }
+        const std::int64_t t = ticks(now);
+        const std::int64_t tat = tat_.load(std::memory_order_relaxed);
+        const std::int64_t wait =
+            std::max(tat, t) +
+            (static_cast<std::int64_t>(n) - static_cast<std::int64_t>(burst_)) * interval_ - t;
+        return duration{std::max<std::int64_t>(wait, 0)};
+    }
+
+    [[nodiscard]] duration interval() const noexcept { return duration{interval_}; }
+    [[nodiscard]] std::uint32_t burst() const noexcept { return burst_; }
+
+    [[nodiscard]] static duration interval_for(double rate) {
+        if (!(rate > 0.0)) {
+            throw std::invalid_argument("RateLimiter: rate must be positive");
+        }
+        return duration{std::max<std::int64_t>(1, static_cast<std::int64_t>(1e9 / rate))};
+    }
+
+private:
+    [[nodiscard]] static std::int64_t ticks(clock::time_point now) noexcept {
+        return std::chrono::duration_cast<duration>(now.time_since_epoch()).count();
+    }
+
+    const std::int64_t interval_;
+    const std::uint32_t burst_;
+    alignas(cache_line_size) std::atomic<std::int64_t> tat_{
+        std::numeric_limits<std::int64_t>::min() / 2};
+};
+
+/**
+ * A RateLimiter that hands out tokens to threads in batches.
+ *
+ * With many threads calling at a high rate, the single TAT word of
+ * RateLimiter becomes a contended cache line. Here each thread stripe
+ * takes `batch` tokens from the shared limiter at once and serves later
+ * requests from its own cache line until they run out.
+ *
+ * The price is precision. Cached tokens have already been charged, so a
+ * stripe may spend them later than the shared limiter would have allowed.
+ * A batch therefore expires after batch * interval, the time it took to
+ * earn it, which limits the overshoot in any window to about one batch per
+ * stripe. Tokens left in an expired or too-small batch are dropped, not
+ * returned. Requests larger than a batch go straight to the shared
+ * limiter.
+ */
+class CachedRateLimiter {
+public:
+    using clock = RateLimiter::clock;
+    using duration = RateLimiter::duration;
+
+    static constexpr std::uint32_t max_batch = 0xFFFF;
+
+    // batch is capped at burst, since no more than burst tokens can ever
+    // be taken from the shared limiter at once
+    CachedRateLimiter(duration interval, std::uint32_t burst, std::uint32_t batch)
+        : shared_{interval, burst},
+          batch_{std::clamp<std::uint32_t>(batch, 1, std::min(std::max(burst, 1u), max_batch))},
+          ttl_us_{std::max<std::int64_t>(
+              1, std::chrono::duration_cast<std::chrono::microseconds>(interval * batch_).count())},
+          stripe_mask_{std::bit_ceil(std::max(1u, std::thread::hardware_concurrency())) - 1},
+          stripes_{std::make_unique<Stripe[]>(stripe_mask_ + 1)},
+          start_{clock::now()} {}
+
+    [[nodiscard]] bool try_acquire(std::uint32_t n = 1) noexcept {
+        return try_acquire(n, clock::now());
+    }
+
+    [[nodiscard]] bool try_acquire(std::uint32_t n, clock::time_point now) noexcept {
+        if (n > batch_) {
+            return shared_.try_acquire(n, now);
+        }
+
+        auto& cache = stripes_[this_thread_index() & stripe_mask_].cache;
+        const std::uint64_t now_us = micros_since_start(now);
+
+        // Packed cache word: expiry (microseconds since start_) << 16 | tokens
+        std::uint64_t word = cache.load(std::memory_order_relaxed);
+        while ((word >> 16) > now_us && (word & max_batch) >= n) {
+            if (cache.compare_exchange_weak(word, word - n, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+
+        if (!shared_.try_acquire(batch_, now)) {
+            // Not a full batch left: fall back to exactly what was asked for
+            return shared_.try_acquire(n, now);
+        }
+        cache.store(((now_us + static_cast<std::uint64_t>(ttl_us_)) << 16) | (batch_ - n),
+                    std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] std::uint32_t batch() const noexcept { return batch_; }
+
+private:
+    struct alignas(cache_line_size) Stripe {
+        std::atomic<std::uint64_t> cache{0};
+    };
+
+    [[nodiscard]] std::uint64_t micros_since_start(clock::time_point now) const noexcept {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+        return static_cast<std::uint64_t>(std::max<std::int64_t>(us, 0));
+    }
+
+    RateLimiter shared_;
+    const std::uint32_t batch_;
+    const std::int64_t ttl_us_;
+    const std::size_t stripe_mask_;
+    const std::unique_ptr<Stripe[]> stripes_;
+    const clock::time_point start_;
+};
+
+/**
+ * Independent GCRA limits per key (tenant, client address, API token...)
+ * in a fixed amount of memory.
+ *
+ * Keys live in a set-associative table: each key hashes to one bucket of
+ * `ways` slots. The low bits of the bucket index pick its shard mutex, so
+ * buckets are interleaved across the shards and neighbours take different
+ * locks.
+ * A key whose TAT is in the past has a full bucket of tokens - exactly the
+ * state of a key never seen - so such slots are reused first. Only when
+ * every slot in the bucket still holds a limited key is one evicted: the
+ * one closest to full. That key's next request starts from a full bucket,
+ * so memory pressure can make the limiter more lenient, never stricter.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class KeyedRateLimiter {
+public:
+    using clock = RateLimiter::clock;
+    using duration = RateLimiter::duration;
+
+    static constexpr std::size_t ways = 8;
+
+    KeyedRateLimiter(duration interval, std::uint32_t burst, std::size_t capacity)
+        : interval_{interval.count()}, burst_{burst},
+          bucket_count_{std::bit_ceil(std::max<std::size_t>(capacity / ways, 1))},
+          slots_(bucket_count_ * ways),
+          shard_mask_{std::min<std::size_t>(bucket_count_, shard_count) - 1} {
+        if (interval <= duration::zero()) {
+            throw std::invalid_argument("KeyedRateLimiter: interval must be positive");
+        }
+        if (burst == 0) {
+            throw std::invalid_argument("KeyedRateLimiter: burst must be at least 1");
+        }
+    }
+
+    [[nodiscard]] bool try_acquire(const Key& key, std::uint32_t n = 1) {
+        return try_acquire(key, n, clock::now());
+    }
+
+    [[nodiscard]] bool try_acquire(const Key& key, std::uint32_t n, clock::time_point now) {
+        if (n > burst_) {
+            return false;
+        }
+        const std::int64_t t = std::chrono::duration_cast<duration>(now.time_since_epoch()).count();
+        const std::size_t bucket = Hash{}(key) & (bucket_count_ - 1);
+
+        std::lock_guard<std::mutex> lock{shards_[bucket & shard_mask_].mutex};
+        Slot& slot = find_or_claim(bucket, key, t);
+
+        const std::int64_t next = std::max(slot.tat, t) + static_cast<std::int64_t>(n) * interval_;
+        if (next > t + static_cast<std::int64_t>(burst_) * interval_) {
+            return false;
+        }
+        slot.tat = next;
+        return true;
+    }
+
+    // Maximum number of keys tracked at once
+    [[nodiscard]] std::size_t capacity() const noexcept { return slots_.size(); }
+
+private:
+    static constexpr std::size_t shard_count = 64;
+
+    struct Slot {
+        Key key{};
+        std::int64_t tat = 0;
+        bool used = false;
+    };
+
+    struct alignas(cache_line_size) Shard {
+        std::mutex mutex;
+    };
+
+    Slot& find_or_claim(std::size_t bucket, const Key& key, std::int64_t now) {
+        // Prefer unused, then expired (tat <= now), then the smallest tat
+        const auto rank = [now](const Slot& s) {
+            return s.used ? std::max(s.tat, now) : std::numeric_limits<std::int64_t>::min();
+        };
+
+        Slot* const first = &slots_[bucket * ways];
+        Slot* victim = first;
+        for (Slot* slot = first; slot != first + ways; ++slot) {
+            if (slot->used && slot->key == key) {
+                return *slot;
+            }
+            if (rank(*slot) < rank(*victim)) {
+                victim = slot;
+            }
+        }
+        victim->key = key;
+        victim->tat = now;
+        victim->used = true;
+        return *victim;
+    }
+
+    const std::int64_t interval_;
+    const std::uint32_t burst_;
+    const std::size_t bucket_count_;
+    std::vector<Slot> slots_;
+    const std::size_t shard_mask_;
+    std::unique_ptr<Shard[]> shards_ = std::make_unique<Shard[]>(shard_count);
+};
+
+} // namespace concurrent
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,152 @@
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include "cache_line.h"
+#include "thread_index.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace concurrent {
+
+/**
+ * How a ShardedCounter picks the slot an update goes to.
+ *
+ * thread: by this_thread_index(). A thread always hits the same slot, so
+ *         with at least as many slots as threads no two writers share a
+ *         cache line.
+ * cpu:    by the CPU the thread is currently running on (sched_getcpu on
+ *         Linux, thread index elsewhere). Bounds the slot count by the core
+ *         count no matter how many threads exist, at the cost of one cheap
+ *         call per update and occasional sharing after a migration.
+ */
+enum class ShardBy { thread, cpu };
+
+/**
+ * A counter for write-heavy metrics.
+ *
+ * Each update is a relaxed fetch_add on one cache-line-sized slot instead
+ * of on a single shared word, so concurrent writers on different cores do
+ * not bounce the same line between them. Reads pay instead: value() sums
+ * every slot.
+ *
+ * value() is exact once writers have stopped. While they are running it
+ * returns some total between the values at the start and end of the call,
+ * which is what a metric needs. approximate_value() additionally caches
+ * that total for callers that read often and can tolerate staleness.
+ */
+template <std::integral T = long long, ShardBy By = ShardBy::thread>
+class ShardedCounter {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // One slot per hardware thread, rounded up to a power of two
+    [[nodiscard]] static size_type default_shard_count() noexcept {
+        return std::bit_ceil(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    explicit ShardedCounter(size_type shards = default_shard_count())
+        : mask_{std::bit_ceil(std::max<size_type>(shards, 1)) - 1},
+          slots_{std::make_unique<Slot[]>(mask_ + 1)} {}
+
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    // ========================================================================
+    // Writers
+    // ========================================================================
+
+    void add(T n) noexcept {
+        slots_[slot_index()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void increment() noexcept { add(1); }
+    void decrement() noexcept {
+        slots_[slot_index()].value.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Not atomic with respect to concurrent add(): updates racing with
+    // reset() may survive it or be lost.
+    void reset() noexcept {
+        for (size_type i = 0; i <= mask_; ++i) {
+            slots_[i].value.store(0, std::memory_order_relaxed);
+        }
+        cached_at_.store(never, std::memory_order_relaxed);
+    }
+
+    // ========================================================================
+    // Readers
+    // ========================================================================
+
+    [[nodiscard]] T value() const noexcept {
+        T total = 0;
+        for (size_type i = 0; i <= mask_; ++i) {
+            total += slots_[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Returns a total at most max_age old, summing the slots only when the
+    // cached one has expired. Concurrent readers that all find it expired
+    // each refresh it; the last store wins, which is harmless.
+    [[nodiscard]] T approximate_value(std::chrono::nanoseconds max_age) const noexcept {
+        const rep now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            clock::now().time_since_epoch())
+                            .count();
+        const auto cached_at = cached_at_.load(std::memory_order_acquire);
+        if (cached_at != never && now - cached_at <= max_age.count()) {
+            return cached_.load(std::memory_order_relaxed);
+        }
+
+        const T total = value();
+        cached_.store(total, std::memory_order_relaxed);
+        cached_at_.store(now, std::memory_order_release);
+        return total;
+    }
+
+    [[nodiscard]] size_type shard_count() const noexcept { return mask_ + 1; }
+
+private:
+    using clock = std::chrono::steady_clock;
+    using rep = std::chrono::nanoseconds::rep;
+
+    static constexpr rep never = std::numeric_limits<rep>::min();
+
+    struct alignas(cache_line_size) Slot {
+        std::atomic<T> value{0};
+    };
+
+    [[nodiscard]] size_type slot_index() const noexcept {
+#if defined(__linux__)
+        if constexpr (By == ShardBy::cpu) {
+            const int cpu = sched_getcpu();
+            if (cpu >= 0) {
+                return static_cast<size_type>(cpu) & mask_;
+            }
+        }
+#endif
+        return this_thread_index() & mask_;
+    }
+
+    const size_type mask_;
+    const std::unique_ptr<Slot[]> slots_;
+
+    // Reader-side cache, kept off the slots' lines
+    alignas(cache_line_size) mutable std::atomic<T> cached_{0};
+    mutable std::atomic<rep> cached_at_{never};
+};
+
+} // namespace concurrent
+
+#endif // SHARDED_COUNTER_H
@@ -0,0 +1,323 @@
+#ifndef SHARDED_HASH_MAP_H
+#define SHARDED_HASH_MAP_H
+
+#include "cache_line.h"
+#include "flat_hash_map.h"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace concurrent {
+
+// A mutex with a reader mode, like std::shared_mutex
+template <typename M>
+concept SharedLockable = requires(M& m) {
+    m.lock_shared();
+    m.unlock_shared();
+};
+
+/**
+ * A hash map for many threads updating it at once: `shards` independent
+ * FlatHashMaps, each behind its own lock. The hash of a key picks its
+ * shard, so threads updating different keys rarely wait for each other,
+ * and with a few shards per core, rarely even share a lock.
+ *
+ * Every operation is atomic with respect to its key. There is no
+ * iterator - another thread could change the shard underneath it - but
+ * for_each() and snapshot() visit everything, one shard at a time.
+ *
+ *     ShardedHashMap<std::string, long> counts;
+ *     counts.upsert(word, [](long& n) { ++n; });   // from any thread
+ *
+ * For the heaviest update loads, let each thread count into its own
+ * local_map and merge() it when done: one lock per shard per merge
+ * instead of one per update.
+ *
+ * With a transparent Hash and KeyEqual (see flat::FlatHashMap), lookups
+ * and upsert() accept e.g. a std::string_view for a std::string key, and
+ * only construct a key when inserting it.
+ *
+ * Mutex may be any Lockable, e.g. AdaptiveMutex from locks.h. If it is
+ * also SharedLockable (std::shared_mutex), readers share a shard.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>, typename Mutex = std::mutex>
+class ShardedHashMap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using local_map = flat::FlatHashMap<K, V, Hash, KeyEqual>;
+
+    // A key type lookups accept: K, or anything the functors take directly
+    template <typename Q>
+    static constexpr bool lookup_key =
+        std::same_as<std::remove_cvref_t<Q>, K> ||
+        flat::detail::heterogeneous_key<std::remove_cvref_t<Q>, K, Hash, KeyEqual>;
+
+    // Four shards per hardware thread, rounded up to a power of two
+    [[nodiscard]] static size_type default_shard_count() noexcept {
+        return std::bit_ceil(4 * std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    explicit ShardedHashMap(size_type shards = default_shard_count(), const Hash& hash = Hash{})
+        : shard_bits_{static_cast<unsigned>(
+              std::countr_zero(std::bit_ceil(std::max<size_type>(shards, 1))))},
+          shards_{std::make_unique<Shard[]>(size_type{1} << shard_bits_)},
+          hash_{hash} {}
+
+    ShardedHashMap(const ShardedHashMap&) = delete;
+    ShardedHashMap& operator=(const ShardedHashMap&) = delete;
+
+    // =========================================================================
+    // Updates
+    // =========================================================================
+
+    /**
+     * Calls fn(value) on the value for `key` under the shard's lock,
+     * inserting a value-initialized V first if the key is absent. Returns
+     * true if it inserted.
+     */
+    template <typename Q, std::invocable<V&> F>
+        requires lookup_key<Q>
+    bool upsert(Q&& key, F&& fn) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        if (const auto it = shard.map.find(key); it != shard.map.end()) {
+            std::invoke(fn, it->second);
+            return false;
+        }
+        auto& value = shard.map.try_emplace(make_key(std::forward<Q>(key))).first->second;
+        std::invoke(fn, value);
+        return true;
+    }
+
+    template <std::invocable<V&> F>
+    bool upsert(const K& key, F&& fn) {
+        return upsert<const K&, F>(key, std::forward<F>(fn));
+    }
+
+    // Inserts V(args...) if `key` is absent; returns true if it did
+    template <typename Q, typename... Args>
+        requires lookup_key<Q>
+    bool try_emplace(Q&& key, Args&&... args) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        if (shard.map.contains(key)) {
+            return false;
+        }
+        shard.map.try_emplace(make_key(std::forward<Q>(key)), std::forward<Args>(args)...);
+        return true;
+    }
+
+    template <typename... Args>
+    bool try_emplace(const K& key, Args&&... args) {
+        return try_emplace<const K&, Args...>(key, std::forward<Args>(args)...);
+    }
+
+    // Sets the value for `key`; returns true if the key was new
+    template <typename M>
+    bool insert_or_assign(const K& key, M&& value) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        return shard.map.insert_or_assign(key, std::forward<M>(value)).second;
+    }
+
+    template <typename Q>
+        requires lookup_key<Q>
+    bool erase(const Q& key) {
+        Shard& shard = shard_for(key);
+        std::lock_guard lock{shard.mutex};
+        return shard.map.erase(key) != 0;
+    }
+
+    bool erase(const K& key) { return erase<K>(key); }
+
+    /**
+     * Moves every element of `local` into this map, combining values for
+     * keys present in both with combine(existing, incoming), and leaves
+     * `local` empty.
+     *
+     * The elements are grouped by shard first, so each shard is locked
+     * once per merge rather than once per element. Any number of threads
+     * may merge at the same time; they only wait for each other on the
+     * shards they both have elements for.
+     */
+    template <typename Combine = std::plus<>>
+    void merge(local_map&& local, Combine combine = {}) {
+        // Taken out as nodes, whose keys can be moved: an element's key in
+        // local is const, and try_emplace would copy it
+        using node_type = typename local_map::node_type;
+        std::vector<node_type> nodes;
+        nodes.reserve(local.size());
+        local.extract_all([&nodes](node_type&& node) { nodes.push_back(std::move(node)); });
+
+        std::vector<std::vector<node_type*>> by_shard(shard_count());
+        for (node_type& node : nodes) {
+            by_shard[shard_index(hash_(node.key()))].push_back(&node);
+        }
+        for (size_type s = 0; s < by_shard.size(); ++s) {
+            if (by_shard[s].empty()) {
+                continue;
+            }
+            Shard& shard = shards_[s];
+            std::lock_guard lock{shard.mutex};
+            for (node_type* node : by_shard[s]) {
+                auto [it, inserted] =
+                    shard.map.try_emplace(std::move(node->key()), std::move(node->mapped()));
+                if (!inserted) {
+                    it->second =
+                        std::invoke(combine, std::move(it->second), std::move(node->mapped()));
+                }
+            }
+        }
+    }
+
+    void clear() {
+        for (size_type s = 0; s < shard_count(); ++s) {
+            std::lock_guard lock{shards_[s].mutex};
+            shards_[s].map.clear();
+        }
+    }
+
+    // =========================================================================
+    // Reads
+    // =========================================================================
+
+    // A copy of the value for `key`, if present
+    template <typename Q>
+        requires lookup_key<Q>
+    [[nodiscard]] std::optional<V> get(const Q& key) const {
+        std::optional<V> result;
+        visit(key, [&result](const V& value) { result = value; });
+        return result;
+    }
+
+    [[nodiscard]] std::optional<V> get(const K& key) const { return get<K>(key); }
+
+    // Calls fn(value) under the shard's lock if `key` is present, without
+    // copying the value out; returns whether it was
+    template <typename Q, std::invocable<const V&> F>
+        requires lookup_key<Q>
+    bool visit(const Q& key, F&& fn) const {
+        const Shard& shard = shard_for(key);
+        auto lock = read_lock(shard);
+        const auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        std::invoke(fn, it->second);
+        return true;
+    }
+
+    template <std::invocable<const V&> F>
+    bool visit(const K& key, F&& fn) const {
+        return visit<K>(key, std::forward<F>(fn));
+    }
+
+    template <typename Q>
+        requires lookup_key<Q>
+    [[nodiscard]] bool contains(const Q& key) const {
+        const Shard& shard = shard_for(key);
+        auto lock = read_lock(shard);
+        return shard.map.contains(key);
+    }
+
+    [[nodiscard]] bool contains(const K& key) const { return contains<K>(key); }
+
+    /**
+     * Calls fn(key, value) for every element, holding one shard's lock at
+     * a time. Updates made meanwhile to shards already visited are missed,
+     * so this is a consistent view only once writers have stopped.
+     */
+    template <std::invocable<const K&, const V&> F>
+    void for_each(F&& fn) const {
+        for (size_type s = 0; s < shard_count(); ++s) {
+            auto lock = read_lock(shards_[s]);
+            for (const auto& [key, value] : shards_[s].map) {
+                std::invoke(fn, key, value);
+            }
+        }
+    }
+
+    // Every element, copied into one single-threaded map
+    [[nodiscard]] local_map snapshot() const {
+        local_map out;
+        out.reserve(size());
+        for_each([&out](const K& key, const V& value) { out.try_emplace(key, value); });
+        return out;
+    }
+
+    // The sum of the shard sizes, each read under its lock
+    [[nodiscard]] size_type size() const {
+        size_type total = 0;
+        for (size_type s = 0; s < shard_count(); ++s) {
+            auto lock = read_lock(shards_[s]);
+            total += shards_[s].map.size();
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] size_type shard_count() const noexcept { return size_type{1} << shard_bits_; }
+
+private:
+    struct alignas(cache_line_size) Shard {
+        mutable Mutex mutex;
+        local_map map;
+    };
+
+    // The top bits of the mixed hash; FlatHashMap probes with the low ones,
+    // so keys in one shard still spread over its whole table
+    [[nodiscard]] size_type shard_index(size_type hash) const noexcept {
+        if (shard_bits_ == 0) {
+            return 0;
+        }
+        return flat::detail::mix(hash) >> (std::numeric_limits<size_type>::digits - shard_bits_);
+    }
+
+    template <typename Q>
+    [[nodiscard]] Shard& shard_for(const Q& key) const {
+        return shards_[shard_index(static_cast<size_type>(hash_(key)))];
+    }
+
+    [[nodiscard]] static auto read_lock(const Shard& shard) {
+        if constexpr (SharedLockable<Mutex>) {
+            return std::shared_lock{shard.mutex};
+        } else {
+            return std::unique_lock{shard.mutex};
+        }
+    }
+
+    // Keys of type K pass through; others are converted only on insert
+    template <typename Q>
+    static decltype(auto) make_key(Q&& key) {
+        if constexpr (std::same_as<std::remove_cvref_t<Q>, K>) {
+            return std::forward<Q>(key);
+        } else {
+            return K(std::forward<Q>(key));
+        }
+    }
+
+    const unsigned shard_bits_;
+    const std::unique_ptr<Shard[]> shards_;
+    [[no_unique_address]] Hash hash_;
+};
+
+} // namespace concurrent
+
+#endif // SHARDED_HASH_MAP_H
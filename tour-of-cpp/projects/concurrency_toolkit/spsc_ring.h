@@ -0,0 +1,268 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "cache_line.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace concurrent {
+
+/**
+ * Whether an SpscRing offers blocking push()/pop().
+ *
+ * Blocking rings notify the other side after every publish, which costs an
+ * extra atomic check per operation even when nobody is waiting. Rings that
+ * are only ever polled with try_push()/try_pop() should stay non-blocking.
+ */
+enum class SpscMode {
+    non_blocking,
+    blocking
+};
+
+/**
+ * A bounded, lock-free single-producer/single-consumer ring buffer.
+ *
+ * Exactly one thread may call the producer functions (try_push, try_emplace,
+ * try_push_batch, push) and exactly one thread may call the consumer
+ * functions (try_pop, try_pop_batch, pop) at any time.
+ *
+ * Design:
+ * - Monotonic head/tail indices, masked with Capacity - 1 (power of two)
+ * - Tail is published with release and read with acquire (and vice versa),
+ *   so element construction happens-before the consumer reads it
+ * - Producer and consumer state live on separate cache lines
+ * - Each side keeps a cached copy of the other side's index and only
+ *   reloads it (a cache miss) when the ring looks full or empty
+ * - Batch functions publish many elements with a single index store
+ * - Optional blocking via std::atomic::wait/notify_one on the indices
+ *
+ * Example:
+ *   SpscRing<int, 1024> ring;
+ *   ring.try_push(42);            // producer thread
+ *   auto value = ring.try_pop();  // consumer thread, value == 42
+ */
+template <typename T, std::size_t Capacity, SpscMode Mode = SpscMode::non_blocking>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+    static_assert(std::is_nothrow_destructible_v<T>,
+                  "SpscRing elements must not throw on destruction");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    SpscRing() : slots_{std::allocator<T>{}.allocate(Capacity)} {}
+
+    /**
+     * Destroys any elements still in the ring.
+     * No producer or consumer may be running.
+     */
+    ~SpscRing() {
+        size_type head = head_.load(std::memory_order_relaxed);
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        for (; head != tail; ++head) {
+            std::destroy_at(slot(head));
+        }
+        std::allocator<T>{}.deallocate(slots_, Capacity);
+    }
+
+    // Non-copyable, non-movable (threads hold references to the indices)
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    SpscRing(SpscRing&&) = delete;
+    SpscRing& operator=(SpscRing&&) = delete;
+
+    // =========================================================================
+    // Producer side
+    // =========================================================================
+
+    /**
+     * Construct an element in place at the tail.
+     * @return false if the ring is full (nothing is constructed)
+     */
+    template <typename... Args>
+    [[nodiscard]] bool try_emplace(Args&&... args) {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity) {
+                return false;
+            }
+        }
+        std::construct_at(slot(tail), std::forward<Args>(args)...);
+        publish_tail(tail + 1);
+        return true;
+    }
+
+    [[nodiscard]] bool try_push(const T& value) { return try_emplace(value); }
+    [[nodiscard]] bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    /**
+     * Copy as many items as fit, publishing them with one index store.
+     * If a copy throws, the copies already made are destroyed and nothing
+     * is pushed.
+     * @return number of items pushed (a prefix of items)
+     */
+    [[nodiscard]] size_type try_push_batch(std::span<const T> items) {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if (Capacity - (tail - head_cache_) < items.size()) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+        }
+        const size_type count = std::min(Capacity - (tail - head_cache_), items.size());
+        size_type built = 0;
+        try {
+            for (; built < count; ++built) {
+                std::construct_at(slot(tail + built), items[built]);
+            }
+        } catch (...) {
+            for (size_type i = 0; i < built; ++i) {
+                std::destroy_at(slot(tail + i));
+            }
+            throw;
+        }
+        if (count > 0) {
+            publish_tail(tail + count);
+        }
+        return count;
+    }
+
+    /**
+     * Push, waiting with std::atomic::wait while the ring is full.
+     */
+    void push(T value)
+        requires(Mode == SpscMode::blocking)
+    {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        while (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity) {
+                head_.wait(head_cache_, std::memory_order_acquire);
+            }
+        }
+        std::construct_at(slot(tail), std::move(value));
+        publish_tail(tail + 1);
+    }
+
+    // =========================================================================
+    // Consumer side
+    // =========================================================================
+
+    /**
+     * Pop the head element.
+     * @return std::nullopt if the ring is empty
+     */
+    [[nodiscard]] std::optional<T> try_pop() {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return std::nullopt;
+            }
+        }
+        std::optional<T> value{take(head)};
+        publish_head(head + 1);
+        return value;
+    }
+
+    /**
+     * Move up to out.size() elements into out, releasing their slots with
+     * one index store.
+     * @return number of elements written to the front of out
+     */
+    [[nodiscard]] size_type try_pop_batch(std::span<T> out) {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < out.size()) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        }
+        const size_type count = std::min(tail_cache_ - head, out.size());
+        for (size_type i = 0; i < count; ++i) {
+            out[i] = take(head + i);
+        }
+        if (count > 0) {
+            publish_head(head + count);
+        }
+        return count;
+    }
+
+    /**
+     * Pop, waiting with std::atomic::wait while the ring is empty.
+     */
+    [[nodiscard]] T pop()
+        requires(Mode == SpscMode::blocking)
+    {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        while (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                tail_.wait(tail_cache_, std::memory_order_acquire);
+            }
+        }
+        T value = take(head);
+        publish_head(head + 1);
+        return value;
+    }
+
+    // =========================================================================
+    // Observers (approximate while both threads are running)
+    // =========================================================================
+
+    [[nodiscard]] size_type size() const noexcept {
+        const size_type head = head_.load(std::memory_order_acquire);
+        const size_type tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] static constexpr size_type capacity() noexcept { return Capacity; }
+
+private:
+    [[nodiscard]] T* slot(size_type index) const noexcept {
+        return slots_ + (index & (Capacity - 1));
+    }
+
+    // Move the element out of its slot and end its lifetime
+    [[nodiscard]] T take(size_type index) {
+        T* p = slot(index);
+        T value = std::move(*p);
+        std::destroy_at(p);
+        return value;
+    }
+
+    void publish_tail(size_type tail) {
+        tail_.store(tail, std::memory_order_release);
+        if constexpr (Mode == SpscMode::blocking) {
+            tail_.notify_one();
+        }
+    }
+
+    void publish_head(size_type head) {
+        head_.store(head, std::memory_order_release);
+        if constexpr (Mode == SpscMode::blocking) {
+            head_.notify_one();
+        }
+    }
+
+    // Shared, read-only after construction
+    T* const slots_;
+
+    // Producer-owned line: written by the producer, tail_ read by the consumer
+    alignas(cache_line_size) std::atomic<size_type> tail_{0};
+    size_type head_cache_{0};
+
+    // Consumer-owned line: written by the consumer, head_ read by the producer
+    alignas(cache_line_size) std::atomic<size_type> head_{0};
+    size_type tail_cache_{0};
+};
+
+} // namespace concurrent
+
+#endif // SPSC_RING_H
@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include "event.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+TEST_CASE("Event", "[event]") {
+    SECTION("starts in the requested state") {
+        REQUIRE_FALSE(Event{}.is_set());
+        REQUIRE(Event{true}.is_set());
+    }
+
+    SECTION("set and reset") {
+        Event event;
+        event.set();
+        REQUIRE(event.is_set());
+        event.wait();  // returns immediately
+        event.reset();
+        REQUIRE_FALSE(event.is_set());
+    }
+
+    SECTION("set wakes every waiter") {
+        Event event;
+        std::atomic<int> woken{0};
+
+        std::vector<std::thread> waiters;
+        for (int i = 0; i < 4; ++i) {
+            waiters.emplace_back([&] {
+                event.wait();
+                ++woken;
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        REQUIRE(woken == 0);
+
+        event.set();
+        for (auto& w : waiters) {
+            w.join();
+        }
+        REQUIRE(woken == 4);
+    }
+
+    SECTION("ping-pong between two threads") {
+        Event ping;
+        Event pong;
+        constexpr int rounds = 1000;
+
+        std::thread other{[&] {
+            for (int i = 0; i < rounds; ++i) {
+                ping.wait();
+                ping.reset();
+                pong.set();
+            }
+        }};
+        for (int i = 0; i < rounds; ++i) {
+            ping.set();
+            pong.wait();
+            pong.reset();
+        }
+        other.join();
+        REQUIRE_FALSE(ping.is_set());
+    }
+}
+
+TEST_CASE("Latch", "[event][latch]") {
+    SECTION("zero count is already open") {
+        Latch latch{0};
+        REQUIRE(latch.try_wait());
+        latch.wait();
+    }
+
+    SECTION("opens after the expected count") {
+        Latch latch{3};
+        latch.count_down();
+        REQUIRE_FALSE(latch.try_wait());
+        latch.count_down(2);
+        REQUIRE(latch.try_wait());
+    }
+
+    SECTION("releases waiting threads together") {
+        constexpr int workers = 4;
+        Latch start{1};
+        Latch done{workers};
+        std::atomic<int> started{0};
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < workers; ++i) {
+            threads.emplace_back([&] {
+                start.wait();
+                ++started;
+                done.count_down();
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        REQUIRE(started == 0);
+
+        start.count_down();
+        done.wait();
+        REQUIRE(started == workers);
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    SECTION("arrive_and_wait acts as a one-shot barrier") {
+        constexpr int parties = 4;
+        Latch barrier{parties};
+        std::atomic<int> arrived{0};
+        std::atomic<bool> all_seen{true};
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < parties; ++i) {
+            threads.emplace_back([&] {
+                ++arrived;
+                barrier.arrive_and_wait();
+                if (arrived != parties) {
+                    all_seen = false;
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE(all_seen);
+    }
+}
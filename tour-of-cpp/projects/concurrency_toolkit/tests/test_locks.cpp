@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+#include "locks.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+constexpr int threads = 8;
+constexpr int per_thread = 20'000;
+
+// Runs `threads` workers that each increment an unprotected counter
+// per_thread times inside `critical(fn)`; returns the final count
+template <typename Critical>
+long long contend(Critical critical) {
+    long long counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                critical([&counter] { ++counter; });
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return counter;
+}
+
+} // namespace
+
+TEST_CASE("AdaptiveMutex", "[locks][adaptive]") {
+    AdaptiveMutex mutex;
+
+    SECTION("try_lock fails while held") {
+        REQUIRE(mutex.try_lock());
+        REQUIRE_FALSE(mutex.try_lock());
+        mutex.unlock();
+        REQUIRE(mutex.try_lock());
+        mutex.unlock();
+    }
+
+    SECTION("works with standard lock guards") {
+        {
+            std::lock_guard<AdaptiveMutex> lock{mutex};
+            REQUIRE_FALSE(mutex.try_lock());
+        }
+        std::unique_lock<AdaptiveMutex> lock{mutex, std::try_to_lock};
+        REQUIRE(lock.owns_lock());
+    }
+
+    SECTION("provides mutual exclusion") {
+        const long long count = contend([&mutex](auto fn) {
+            std::lock_guard<AdaptiveMutex> lock{mutex};
+            fn();
+        });
+        REQUIRE(count == static_cast<long long>(threads) * per_thread);
+    }
+
+    SECTION("wakes sleeping waiters") {
+        std::condition_variable_any cv;
+        bool ready = false;
+
+        std::thread waiter{[&] {
+            std::unique_lock<AdaptiveMutex> lock{mutex};
+            cv.wait(lock, [&ready] { return ready; });
+        }};
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        {
+            std::lock_guard<AdaptiveMutex> lock{mutex};
+            ready = true;
+        }
+        cv.notify_one();
+        waiter.join();
+        REQUIRE(ready);
+    }
+}
+
+TEST_CASE("TicketLock", "[locks][ticket]") {
+    TicketLock lock;
+
+    SECTION("try_lock fails while held") {
+        REQUIRE(lock.try_lock());
+        REQUIRE_FALSE(lock.try_lock());
+        lock.unlock();
+        REQUIRE(lock.try_lock());
+        lock.unlock();
+    }
+
+    SECTION("provides mutual exclusion") {
+        const long long count = contend([&lock](auto fn) {
+            std::lock_guard<TicketLock> guard{lock};
+            fn();
+        });
+        REQUIRE(count == static_cast<long long>(threads) * per_thread);
+    }
+
+    SECTION("serves waiters in arrival order") {
+        std::vector<int> order;
+        std::mutex order_mutex;
+        lock.lock();
+
+        // Start waiters one at a time so their tickets are in index order
+        std::vector<std::thread> waiters;
+        for (int i = 0; i < 4; ++i) {
+            waiters.emplace_back([&, i] {
+                lock.lock();
+                {
+                    std::lock_guard<std::mutex> g{order_mutex};
+                    order.push_back(i);
+                }
+                lock.unlock();
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        }
+        lock.unlock();
+        for (auto& w : waiters) {
+            w.join();
+        }
+
+        REQUIRE(order == std::vector<int>{0, 1, 2, 3});
+    }
+}
+
+TEST_CASE("McsLock", "[locks][mcs]") {
+    McsLock lock;
+
+    SECTION("try_lock fails while held") {
+        McsLock::Node a;
+        McsLock::Node b;
+        REQUIRE(lock.try_lock(a));
+        REQUIRE_FALSE(lock.try_lock(b));
+        lock.unlock(a);
+        REQUIRE(lock.try_lock(b));
+        lock.unlock(b);
+    }
+
+    SECTION("provides mutual exclusion") {
+        const long long count = contend([&lock](auto fn) {
+            McsLock::Guard guard{lock};
+            fn();
+        });
+        REQUIRE(count == static_cast<long long>(threads) * per_thread);
+    }
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include "mpmc_queue.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+static_assert(WaitStrategy<BusySpin>);
+static_assert(WaitStrategy<SpinThenYield>);
+static_assert(WaitStrategy<AtomicWait>);
+static_assert(WaitStrategy<CondVarWait>);
+static_assert(ConcurrentQueue<BoundedMpmcQueue<int>>);
+static_assert(ConcurrentQueue<UnboundedMpmcQueue<int>>);
+
+namespace {
+
+// Pushes producers * per_producer distinct values through queue with
+// blocking push/pop and returns true if every value arrived exactly once.
+template <ConcurrentQueue Queue>
+bool transfer_all(Queue& queue, int producers, int consumers, int per_producer) {
+    const int total = producers * per_producer;
+    std::vector<std::atomic<int>> seen(static_cast<std::size_t>(total));
+    std::atomic<int> remaining{total};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p, per_producer] {
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push(p * per_producer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (remaining.fetch_sub(1) > 0) {
+                const int value = queue.pop();
+                seen[static_cast<std::size_t>(value)].fetch_add(1);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& count : seen) {
+        if (count.load() != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("BoundedMpmcQueue single-threaded behaviour", "[mpmc][bounded]") {
+    SECTION("capacity rounds up to a power of two") {
+        BoundedMpmcQueue<int> queue{5};
+        REQUIRE(queue.capacity() == 8);
+        BoundedMpmcQueue<int> tiny{0};
+        REQUIRE(tiny.capacity() == 2);
+    }
+
+    SECTION("FIFO order and full/empty detection") {
+        BoundedMpmcQueue<int> queue{4};
+        REQUIRE_FALSE(queue.try_pop().has_value());
+
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.try_push(i));
+        }
+        REQUIRE_FALSE(queue.try_push(4));
+        REQUIRE(queue.size() == 4);
+
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(queue.try_pop() == i);
+        }
+        REQUIRE(queue.size() == 0);
+    }
+
+    SECTION("failed try_push leaves a move-only value intact") {
+        BoundedMpmcQueue<std::unique_ptr<int>> queue{2};
+        REQUIRE(queue.try_push(std::make_unique<int>(1)));
+        REQUIRE(queue.try_push(std::make_unique<int>(2)));
+
+        auto extra = std::make_unique<int>(3);
+        REQUIRE_FALSE(queue.try_push(std::move(extra)));
+        REQUIRE(extra != nullptr);
+        REQUIRE(**queue.try_pop() == 1);
+    }
+}
+
+TEST_CASE("UnboundedMpmcQueue single-threaded behaviour", "[mpmc][unbounded]") {
+    UnboundedMpmcQueue<std::string, SpinThenYield, 4> queue;
+
+    SECTION("starts empty") {
+        REQUIRE_FALSE(queue.try_pop().has_value());
+    }
+
+    SECTION("grows across many segments in FIFO order") {
+        for (int i = 0; i < 50; ++i) {
+            REQUIRE(queue.try_push(std::to_string(i)));
+        }
+        for (int i = 0; i < 50; ++i) {
+            REQUIRE(queue.try_pop() == std::to_string(i));
+        }
+        REQUIRE_FALSE(queue.try_pop().has_value());
+    }
+
+    SECTION("interleaved pushes and pops") {
+        for (int round = 0; round < 20; ++round) {
+            queue.push("a");
+            queue.push("b");
+            REQUIRE(queue.pop() == "a");
+            REQUIRE(queue.pop() == "b");
+        }
+    }
+}
+
+TEST_CASE("MPMC queues deliver every element exactly once", "[mpmc][concurrent]") {
+    constexpr int per_producer = 20'000;
+
+    SECTION("bounded with spin-then-yield") {
+        BoundedMpmcQueue<int, SpinThenYield> queue{64};
+        REQUIRE(transfer_all(queue, 3, 3, per_producer));
+    }
+
+    SECTION("bounded with atomic wait") {
+        BoundedMpmcQueue<int, AtomicWait> queue{16};
+        REQUIRE(transfer_all(queue, 2, 4, per_producer));
+    }
+
+    SECTION("bounded with condition variable") {
+        BoundedMpmcQueue<int, CondVarWait> queue{16};
+        REQUIRE(transfer_all(queue, 4, 2, per_producer));
+    }
+
+    SECTION("unbounded with atomic wait and small segments") {
+        UnboundedMpmcQueue<int, AtomicWait, 32> queue;
+        REQUIRE(transfer_all(queue, 3, 3, per_producer));
+    }
+
+    SECTION("unbounded with condition variable") {
+        UnboundedMpmcQueue<int, CondVarWait, 64> queue;
+        REQUIRE(transfer_all(queue, 2, 2, per_producer));
+    }
+}
@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+#include "published.h"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+// Counts live instances so tests can verify reclamation
+struct Version {
+    static inline std::atomic<int> live{0};
+
+    int value = 0;
+    int check = 0;  // always equal to -value in a published version
+
+    explicit Version(int v) : value{v}, check{-v} { ++live; }
+    Version(const Version& other) : value{other.value}, check{other.check} { ++live; }
+    Version& operator=(const Version&) = default;
+    ~Version() { --live; }
+};
+
+} // namespace
+
+TEST_CASE("Published basic operations", "[published][basic]") {
+    SECTION("reads the initial value") {
+        Published<std::string> text{"hello"};
+        auto snapshot = text.read();
+        REQUIRE(*snapshot == "hello");
+        REQUIRE(snapshot->size() == 5);
+    }
+
+    SECTION("in-place construction") {
+        Published<std::string> text{std::in_place, std::size_t{3}, 'x'};
+        REQUIRE(*text.read() == "xxx");
+    }
+
+    SECTION("publish replaces the value for new readers") {
+        Published<int> value{1};
+        value.publish(2);
+        REQUIRE(*value.read() == 2);
+        value.emplace(3);
+        REQUIRE(*value.read() == 3);
+    }
+
+    SECTION("update modifies a copy") {
+        Published<std::map<std::string, int>> routes{{{"a", 1}}};
+        auto before = routes.read();
+
+        routes.update([](auto& table) { table["b"] = 2; });
+
+        REQUIRE(before->size() == 1);
+        REQUIRE(routes.read()->size() == 2);
+        REQUIRE(routes.read()->at("b") == 2);
+    }
+
+    SECTION("moved-from snapshots release nothing") {
+        Published<int> value{1};
+        auto a = value.read();
+        auto b = std::move(a);
+        REQUIRE(*b == 1);
+        a = value.read();
+        REQUIRE(*a == 1);
+    }
+}
+
+TEST_CASE("Published reclaims old versions", "[published][reclaim]") {
+    Version::live = 0;
+
+    SECTION("versions nobody reads are freed immediately") {
+        {
+            Published<Version> p{Version{0}};
+            for (int i = 1; i <= 10; ++i) {
+                p.emplace(i);
+            }
+            REQUIRE(p.retired_count() == 0);
+            REQUIRE(Version::live == 1);
+        }
+        REQUIRE(Version::live == 0);
+    }
+
+    SECTION("a snapshot keeps its version alive") {
+        Published<Version> p{Version{0}};
+        {
+            auto old = p.read();
+            p.emplace(1);
+            p.emplace(2);
+
+            REQUIRE(old->value == 0);
+            REQUIRE(p.read()->value == 2);
+            REQUIRE(p.retired_count() >= 1);
+        }
+        p.synchronize();
+        REQUIRE(p.retired_count() == 0);
+        REQUIRE(Version::live == 1);
+    }
+
+    SECTION("synchronize waits for a reader on another thread") {
+        Published<Version> p{Version{0}};
+        std::atomic<bool> reading{false};
+        std::atomic<bool> release{false};
+        std::atomic<bool> saw_zero{false};
+
+        std::thread reader{[&] {
+            auto snapshot = p.read();
+            reading = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+            saw_zero = snapshot->value == 0 && snapshot->check == 0;
+        }};
+        while (!reading) {
+            std::this_thread::yield();
+        }
+
+        p.emplace(1);
+        std::thread writer{[&] { p.synchronize(); }};
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        REQUIRE(Version::live == 2);
+
+        release = true;
+        reader.join();
+        writer.join();
+
+        REQUIRE(saw_zero);
+        REQUIRE(Version::live == 1);
+    }
+}
+
+TEST_CASE("Published concurrent readers and writers", "[published][concurrent]") {
+    Version::live = 0;
+    {
+        Published<Version> p{Version{0}};
+        std::atomic<bool> done{false};
+        std::atomic<bool> consistent{true};
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([&] {
+                int last = 0;
+                while (!done.load()) {
+                    auto snapshot = p.read();
+                    // A freed or half-written version would break one of these
+                    if (snapshot->check != -snapshot->value || snapshot->value < last) {
+                        consistent = false;
+                    }
+                    last = snapshot->value;
+                }
+            });
+        }
+
+        std::vector<std::thread> writers;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&p] {
+                for (int i = 0; i < 2000; ++i) {
+                    p.update([](Version& v) {
+                        ++v.value;
+                        v.check = -v.value;
+                    });
+                }
+            });
+        }
+        for (auto& w : writers) {
+            w.join();
+        }
+        done = true;
+        for (auto& r : readers) {
+            r.join();
+        }
+
+        REQUIRE(consistent);
+        REQUIRE(p.read()->value == 4000);
+
+        p.synchronize();
+        REQUIRE(Version::live == 1);
+    }
+    REQUIRE(Version::live == 0);
+}
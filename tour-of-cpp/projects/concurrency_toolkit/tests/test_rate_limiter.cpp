@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+#include "rate_limiter.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+using namespace std::chrono_literals;
+
+TEST_CASE("RateLimiter token bucket", "[rate_limiter][basic]") {
+    const auto t0 = RateLimiter::clock::now();
+
+    SECTION("burst 1 enforces a minimum interval") {
+        RateLimiter limiter{100ms};
+        REQUIRE(limiter.try_acquire(1, t0));
+        REQUIRE_FALSE(limiter.try_acquire(1, t0));
+        REQUIRE_FALSE(limiter.try_acquire(1, t0 + 99ms));
+        REQUIRE(limiter.try_acquire(1, t0 + 100ms));
+    }
+
+    SECTION("a full bucket allows a burst, then the steady rate") {
+        RateLimiter limiter{10ms, 5};
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(limiter.try_acquire(1, t0));
+        }
+        REQUIRE_FALSE(limiter.try_acquire(1, t0));
+        REQUIRE(limiter.try_acquire(1, t0 + 10ms));
+        REQUIRE_FALSE(limiter.try_acquire(1, t0 + 10ms));
+    }
+
+    SECTION("tokens refill up to the burst only") {
+        RateLimiter limiter{10ms, 3};
+        REQUIRE(limiter.try_acquire(3, t0));
+        // A long idle period banks at most `burst` tokens
+        REQUIRE(limiter.try_acquire(3, t0 + 1s));
+        REQUIRE_FALSE(limiter.try_acquire(1, t0 + 1s));
+    }
+
+    SECTION("batch acquire is all or nothing") {
+        RateLimiter limiter{10ms, 4};
+        REQUIRE(limiter.try_acquire(3, t0));
+        REQUIRE_FALSE(limiter.try_acquire(2, t0));
+        REQUIRE(limiter.try_acquire(1, t0));
+        REQUIRE_FALSE(limiter.try_acquire(5, t0 + 1s));
+    }
+
+    SECTION("time_until_available") {
+        RateLimiter limiter{100ms};
+        REQUIRE(limiter.time_until_available(1, t0) == 0ns);
+        REQUIRE(limiter.try_acquire(1, t0));
+        REQUIRE(limiter.time_until_available(1, t0 + 30ms) == 70ms);
+        REQUIRE(limiter.time_until_available(1, t0 + 200ms) == 0ns);
+        REQUIRE(limiter.time_until_available(2, t0) == RateLimiter::duration::max());
+    }
+
+    SECTION("per_second and invalid arguments") {
+        auto limiter = RateLimiter::per_second(1000.0, 10);
+        REQUIRE(limiter.interval() == 1ms);
+        REQUIRE(limiter.burst() == 10);
+
+        REQUIRE_THROWS_AS(RateLimiter(0ns), std::invalid_argument);
+        REQUIRE_THROWS_AS(RateLimiter(1ms, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(RateLimiter::per_second(0.0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("RateLimiter across threads", "[rate_limiter][concurrent]") {
+    // No time passes, so exactly `burst` acquisitions may succeed in total
+    const auto t0 = RateLimiter::clock::now();
+    constexpr std::uint32_t burst = 10'000;
+    RateLimiter limiter{1s, burst};
+    std::atomic<long long> granted{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 5000; ++i) {
+                if (limiter.try_acquire(1, t0)) {
+                    ++granted;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    REQUIRE(granted == burst);
+}
+
+TEST_CASE("CachedRateLimiter", "[rate_limiter][cached]") {
+    const auto t0 = RateLimiter::clock::now();
+
+    SECTION("serves a batch from the cache") {
+        CachedRateLimiter limiter{1s, 8, 4};
+        REQUIRE(limiter.batch() == 4);
+        // Two batches of four exhaust the shared bucket
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(limiter.try_acquire(1, t0));
+        }
+        REQUIRE_FALSE(limiter.try_acquire(1, t0));
+    }
+
+    SECTION("batch is capped at burst") {
+        CachedRateLimiter limiter{1s, 2, 100};
+        REQUIRE(limiter.batch() == 2);
+    }
+
+    SECTION("falls back to single tokens when a batch is unavailable") {
+        CachedRateLimiter limiter{1s, 6, 4};
+        for (int i = 0; i < 6; ++i) {
+            REQUIRE(limiter.try_acquire(1, t0));
+        }
+        REQUIRE_FALSE(limiter.try_acquire(1, t0));
+    }
+
+    SECTION("cached tokens expire") {
+        CachedRateLimiter limiter{10ms, 4, 4};
+        REQUIRE(limiter.try_acquire(1, t0));  // takes the whole batch
+        // After batch * interval the three cached tokens are gone, but the
+        // shared bucket has refilled
+        REQUIRE(limiter.try_acquire(4, t0 + 40ms));
+        REQUIRE_FALSE(limiter.try_acquire(1, t0 + 41ms));
+    }
+
+    SECTION("never grants more than the shared limiter") {
+        constexpr std::uint32_t burst = 10'000;
+        CachedRateLimiter limiter{1s, burst, 64};
+        std::atomic<long long> granted{0};
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 5000; ++i) {
+                    if (limiter.try_acquire(1, t0)) {
+                        ++granted;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE(granted <= burst);
+        REQUIRE(granted > 0);
+    }
+}
+
+TEST_CASE("KeyedRateLimiter", "[rate_limiter][keyed]") {
+    const auto t0 = RateLimiter::clock::now();
+
+    SECTION("keys are limited independently") {
+        KeyedRateLimiter<std::string> limiter{100ms, 2, 64};
+        REQUIRE(limiter.try_acquire("alice", 2, t0));
+        REQUIRE_FALSE(limiter.try_acquire("alice", 1, t0));
+        REQUIRE(limiter.try_acquire("bob", 1, t0));
+        REQUIRE(limiter.try_acquire("bob", 1, t0));
+        REQUIRE_FALSE(limiter.try_acquire("bob", 1, t0));
+        REQUIRE(limiter.try_acquire("alice", 1, t0 + 100ms));
+    }
+
+    SECTION("memory stays bounded with many keys") {
+        KeyedRateLimiter<int> limiter{1s, 1, 16};
+        REQUIRE(limiter.capacity() == 16);
+        // Every new key evicts an older one and starts with a full bucket
+        int granted = 0;
+        for (int key = 0; key < 10'000; ++key) {
+            granted += limiter.try_acquire(key, 1, t0) ? 1 : 0;
+        }
+        REQUIRE(granted == 10'000);
+        REQUIRE(limiter.capacity() == 16);
+    }
+
+    SECTION("a tracked key stays limited while its bucket has room") {
+        KeyedRateLimiter<int> limiter{1s, 1, 1024};
+        REQUIRE(limiter.try_acquire(7, 1, t0));
+        for (int key = 100; key < 104; ++key) {
+            REQUIRE(limiter.try_acquire(key, 1, t0));
+        }
+        REQUIRE_FALSE(limiter.try_acquire(7, 1, t0));
+    }
+
+    SECTION("expired entries are reused before limited ones are evicted") {
+        // One bucket of `ways` slots
+        KeyedRateLimiter<int> limiter{10ms, 1, KeyedRateLimiter<int>::ways};
+        REQUIRE(limiter.try_acquire(0, 1, t0));  // limited until t0 + 10ms
+        bool all_granted = true;
+        for (int key = 1; key < 100; ++key) {
+            // Each of these is already expired by the time the next arrives
+            all_granted =
+                all_granted &&
+                limiter.try_acquire(key, 1, t0 + 5ms + std::chrono::milliseconds{10 * key});
+        }
+        REQUIRE(all_granted);
+        // Key 0 expired long ago, so whether it was evicted or not it is allowed
+        REQUIRE(limiter.try_acquire(0, 1, t0 + 2s));
+    }
+}
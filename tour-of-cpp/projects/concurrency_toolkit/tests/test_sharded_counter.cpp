@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+#include "sharded_counter.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+TEST_CASE("ShardedCounter basic operations", "[sharded_counter][basic]") {
+    ShardedCounter<> counter{8};
+
+    SECTION("starts at zero") {
+        REQUIRE(counter.value() == 0);
+        REQUIRE(counter.shard_count() == 8);
+    }
+
+    SECTION("adds and subtracts") {
+        counter.increment();
+        counter.increment();
+        counter.add(40);
+        counter.decrement();
+        REQUIRE(counter.value() == 41);
+
+        counter.add(-50);
+        REQUIRE(counter.value() == -9);
+    }
+
+    SECTION("reset returns to zero") {
+        counter.add(123);
+        counter.reset();
+        REQUIRE(counter.value() == 0);
+    }
+
+    SECTION("shard count is rounded up to a power of two") {
+        REQUIRE(ShardedCounter<>{5}.shard_count() == 8);
+        REQUIRE(ShardedCounter<>{0}.shard_count() == 1);
+        REQUIRE(ShardedCounter<>{}.shard_count() >= 1);
+    }
+
+    SECTION("unsigned counters wrap like the underlying type") {
+        ShardedCounter<unsigned> u{2};
+        u.increment();
+        u.decrement();
+        u.decrement();
+        REQUIRE(u.value() == static_cast<unsigned>(-1));
+    }
+}
+
+TEST_CASE("ShardedCounter approximate reads", "[sharded_counter][approximate]") {
+    ShardedCounter<> counter{4};
+    counter.add(10);
+
+    SECTION("first read fills the cache") {
+        REQUIRE(counter.approximate_value(std::chrono::hours{1}) == 10);
+    }
+
+    SECTION("a fresh cached total is returned without re-summing") {
+        REQUIRE(counter.approximate_value(std::chrono::hours{1}) == 10);
+        counter.add(5);
+        REQUIRE(counter.approximate_value(std::chrono::hours{1}) == 10);
+        REQUIRE(counter.value() == 15);
+    }
+
+    SECTION("an expired cached total is refreshed") {
+        REQUIRE(counter.approximate_value(std::chrono::nanoseconds{0}) == 10);
+        counter.add(5);
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        REQUIRE(counter.approximate_value(std::chrono::nanoseconds{0}) == 15);
+    }
+
+    SECTION("reset invalidates the cache") {
+        REQUIRE(counter.approximate_value(std::chrono::hours{1}) == 10);
+        counter.reset();
+        REQUIRE(counter.approximate_value(std::chrono::hours{1}) == 0);
+    }
+}
+
+TEST_CASE("ShardedCounter concurrent updates", "[sharded_counter][concurrent]") {
+    constexpr int threads = 8;
+    constexpr int per_thread = 100'000;
+
+    auto hammer = [](auto& counter) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&counter, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    counter.increment();
+                }
+                // Every other thread takes some back
+                if (t % 2 == 1) {
+                    counter.add(-1000);
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    };
+
+    constexpr long long expected = static_cast<long long>(threads) * per_thread - 4 * 1000;
+
+    SECTION("per-thread slots, fewer slots than threads") {
+        ShardedCounter<long long, ShardBy::thread> counter{2};
+        hammer(counter);
+        REQUIRE(counter.value() == expected);
+    }
+
+    SECTION("per-thread slots, one slot per thread") {
+        ShardedCounter<long long, ShardBy::thread> counter{threads};
+        hammer(counter);
+        REQUIRE(counter.value() == expected);
+    }
+
+    SECTION("per-CPU slots") {
+        ShardedCounter<long long, ShardBy::cpu> counter;
+        hammer(counter);
+        REQUIRE(counter.value() == expected);
+    }
+
+    SECTION("reads while writers run are monotonic for increment-only use") {
+        ShardedCounter<> counter;
+        std::atomic<bool> done{false};
+        bool monotonic = true;
+
+        std::thread reader{[&] {
+            long long last = 0;
+            while (!done.load()) {
+                const long long now = counter.value();
+                monotonic = monotonic && now >= last;
+                last = now;
+                std::this_thread::yield();
+            }
+        }};
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&counter] {
+                for (int i = 0; i < per_thread; ++i) {
+                    counter.increment();
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        done = true;
+        reader.join();
+
+        REQUIRE(monotonic);
+        REQUIRE(counter.value() == static_cast<long long>(threads) * per_thread);
+    }
+}
@@ -0,0 +1,291 @@
+#include <catch2/catch_test_macros.hpp>
+#include "locks.h"
+#include "sharded_hash_map.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+// A key that cannot be copied, so merge() must move every key
+struct MoveOnlyKey {
+    std::string name;
+    explicit MoveOnlyKey(std::string n) : name{std::move(n)} {}
+    MoveOnlyKey(MoveOnlyKey&&) noexcept = default;
+    MoveOnlyKey& operator=(MoveOnlyKey&&) noexcept = default;
+    bool operator==(const MoveOnlyKey&) const = default;
+};
+
+struct MoveOnlyKeyHash {
+    std::size_t operator()(const MoveOnlyKey& key) const {
+        return std::hash<std::string>{}(key.name);
+    }
+};
+
+} // namespace
+
+TEST_CASE("ShardedHashMap basic operations", "[sharded_hash_map][basic]") {
+    ShardedHashMap<std::string, int> m{8};
+
+    SECTION("starts empty") {
+        REQUIRE(m.empty());
+        REQUIRE(m.shard_count() == 8);
+        REQUIRE_FALSE(m.get("missing"));
+        REQUIRE_FALSE(m.contains("missing"));
+    }
+
+    SECTION("upsert inserts, then updates") {
+        REQUIRE(m.upsert("a", [](int& n) { n += 5; }));
+        REQUIRE_FALSE(m.upsert("a", [](int& n) { n *= 2; }));
+        REQUIRE(m.get("a") == 10);
+        REQUIRE(m.size() == 1);
+    }
+
+    SECTION("try_emplace, insert_or_assign and erase") {
+        REQUIRE(m.try_emplace("x", 1));
+        REQUIRE_FALSE(m.try_emplace("x", 2));
+        REQUIRE(m.get("x") == 1);
+        REQUIRE_FALSE(m.insert_or_assign("x", 3));
+        REQUIRE(m.insert_or_assign("y", 4));
+        REQUIRE(m.get("x") == 3);
+
+        REQUIRE(m.erase("x"));
+        REQUIRE_FALSE(m.erase("x"));
+        REQUIRE(m.size() == 1);
+    }
+
+    SECTION("visit reads in place") {
+        m.insert_or_assign("k", 7);
+        int seen = 0;
+        REQUIRE(m.visit("k", [&](const int& v) { seen = v; }));
+        REQUIRE(seen == 7);
+        REQUIRE_FALSE(m.visit("other", [&](const int&) { seen = -1; }));
+        REQUIRE(seen == 7);
+    }
+
+    SECTION("for_each, snapshot and clear") {
+        for (int i = 0; i < 1000; ++i) {
+            m.insert_or_assign(std::to_string(i), i);
+        }
+        long long sum = 0;
+        m.for_each([&](const std::string&, const int& v) { sum += v; });
+        REQUIRE(sum == 999 * 1000 / 2);
+
+        const auto copy = m.snapshot();
+        REQUIRE(copy.size() == 1000);
+        REQUIRE(copy.at("500") == 500);
+
+        m.clear();
+        REQUIRE(m.empty());
+        REQUIRE(copy.size() == 1000);
+    }
+
+    SECTION("shard count is rounded up to a power of two") {
+        REQUIRE(ShardedHashMap<int, int>{5}.shard_count() == 8);
+        REQUIRE(ShardedHashMap<int, int>{0}.shard_count() == 1);
+        REQUIRE(ShardedHashMap<int, int>{}.shard_count() >= 1);
+    }
+
+    SECTION("a single shard still works") {
+        ShardedHashMap<int, int> one{1};
+        for (int i = 0; i < 100; ++i) {
+            one.upsert(i % 10, [](int& n) { ++n; });
+        }
+        REQUIRE(one.size() == 10);
+        REQUIRE(one.get(3) == 10);
+    }
+
+    SECTION("key-typed overloads with lvalue arguments of the key type") {
+        ShardedHashMap<int, int> ints{2};
+        const int key = 1;
+        const int value = 2;
+        REQUIRE(ints.try_emplace(key, value));
+        REQUIRE(ints.get(key) == 2);
+    }
+}
+
+TEST_CASE("ShardedHashMap heterogeneous lookup", "[sharded_hash_map][transparent]") {
+    ShardedHashMap<std::string, int, StringHash, StringEqual> m{4};
+    const std::string text = "the cat and the hat";
+
+    // Counting words straight from views into the text
+    for (const std::string_view word : {std::string_view{text}.substr(0, 3),
+                                        std::string_view{text}.substr(12, 3)}) {
+        m.upsert(word, [](int& n) { ++n; });
+    }
+    REQUIRE(m.size() == 1);
+    REQUIRE(m.get(std::string_view{"the"}) == 2);
+    REQUIRE(m.contains(std::string_view{"the"}));
+    REQUIRE(m.try_emplace(std::string_view{"cat"}, 1));
+    REQUIRE(m.erase(std::string_view{"cat"}));
+    REQUIRE_FALSE(m.contains(std::string_view{"cat"}));
+}
+
+TEST_CASE("ShardedHashMap move-only values", "[sharded_hash_map]") {
+    ShardedHashMap<int, std::unique_ptr<int>> m{4};
+    m.upsert(1, [](std::unique_ptr<int>& p) { p = std::make_unique<int>(42); });
+    int seen = 0;
+    m.visit(1, [&](const std::unique_ptr<int>& p) { seen = *p; });
+    REQUIRE(seen == 42);
+}
+
+TEST_CASE("ShardedHashMap merge", "[sharded_hash_map][merge]") {
+    ShardedHashMap<std::string, int> m{8};
+    m.insert_or_assign("a", 1);
+    m.insert_or_assign("b", 2);
+
+    SECTION("sums by default and empties the local map") {
+        ShardedHashMap<std::string, int>::local_map local{{"b", 10}, {"c", 20}};
+        m.merge(std::move(local));
+        REQUIRE(local.empty());  // NOLINT(bugprone-use-after-move)
+        REQUIRE(m.get("a") == 1);
+        REQUIRE(m.get("b") == 12);
+        REQUIRE(m.get("c") == 20);
+    }
+
+    SECTION("custom combine") {
+        m.merge({{"a", 5}, {"b", 1}, {"d", 3}}, [](int x, int y) { return std::max(x, y); });
+        REQUIRE(m.get("a") == 5);
+        REQUIRE(m.get("b") == 2);
+        REQUIRE(m.get("d") == 3);
+    }
+
+    SECTION("merging an empty map changes nothing") {
+        m.merge({});
+        REQUIRE(m.size() == 2);
+    }
+}
+
+TEST_CASE("ShardedHashMap merge moves keys", "[sharded_hash_map][merge]") {
+    using Map = ShardedHashMap<MoveOnlyKey, int, MoveOnlyKeyHash>;
+    Map m{4};
+    Map::local_map first;
+    first.try_emplace(MoveOnlyKey{"a"}, 1);
+    first.try_emplace(MoveOnlyKey{"b"}, 2);
+    m.merge(std::move(first));
+
+    Map::local_map second;
+    second.try_emplace(MoveOnlyKey{"b"}, 10);
+    second.try_emplace(MoveOnlyKey{"c"}, 20);
+    m.merge(std::move(second));
+
+    REQUIRE(m.size() == 3);
+    REQUIRE(m.get(MoveOnlyKey{"a"}) == 1);
+    REQUIRE(m.get(MoveOnlyKey{"b"}) == 12);
+    REQUIRE(m.get(MoveOnlyKey{"c"}) == 20);
+}
+
+TEST_CASE("ShardedHashMap concurrent updates", "[sharded_hash_map][concurrent]") {
+    constexpr int threads = 8;
+    constexpr int keys = 500;
+    constexpr int rounds = 20;
+
+    SECTION("upsert from every thread") {
+        ShardedHashMap<int, long> m;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                for (int r = 0; r < rounds; ++r) {
+                    for (int k = 0; k < keys; ++k) {
+                        m.upsert(k, [](long& n) { ++n; });
+                    }
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        REQUIRE(m.size() == keys);
+        m.for_each([](const int&, const long& n) { REQUIRE(n == threads * rounds); });
+    }
+
+    SECTION("per-thread local maps merged concurrently") {
+        ShardedHashMap<int, long> m{16};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                ShardedHashMap<int, long>::local_map local;
+                for (int r = 0; r < rounds; ++r) {
+                    for (int k = 0; k < keys; ++k) {
+                        ++local[k + t];  // overlapping key ranges
+                    }
+                }
+                m.merge(std::move(local));
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        REQUIRE(m.size() == keys + threads - 1);
+        long total = 0;
+        m.for_each([&](const int&, const long& n) { total += n; });
+        REQUIRE(total == static_cast<long>(threads) * keys * rounds);
+        REQUIRE(m.get(threads - 1) == threads * rounds);
+    }
+
+    SECTION("readers alongside writers with a shared_mutex") {
+        ShardedHashMap<int, long, std::hash<int>, std::equal_to<int>, std::shared_mutex> m{4};
+        std::atomic<bool> done{false};
+        std::atomic<bool> torn{false};
+        std::thread reader{[&] {
+            while (!done.load()) {
+                for (int k = 0; k < keys; ++k) {
+                    const auto v = m.get(k);
+                    if (v && (*v < 1 || *v > threads * rounds)) {
+                        torn = true;
+                    }
+                }
+            }
+        }};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                for (int r = 0; r < rounds; ++r) {
+                    for (int k = 0; k < keys; ++k) {
+                        m.upsert(k, [](long& n) { ++n; });
+                    }
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        done = true;
+        reader.join();
+        REQUIRE_FALSE(torn);
+        REQUIRE(m.get(0) == threads * rounds);
+    }
+
+    SECTION("AdaptiveMutex shards") {
+        ShardedHashMap<int, long, std::hash<int>, std::equal_to<int>, AdaptiveMutex> m{4};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                for (int k = 0; k < keys; ++k) {
+                    m.upsert(k, [](long& n) { ++n; });
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        REQUIRE(m.get(keys - 1) == threads);
+    }
+}
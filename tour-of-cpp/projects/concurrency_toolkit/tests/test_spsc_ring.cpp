@@ -0,0 +1,262 @@
+#include <catch2/catch_test_macros.hpp>
+#include "spsc_ring.h"
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace concurrent;
+
+namespace {
+
+// Counts live instances so tests can verify element lifetimes
+struct Tracked {
+    static inline int live = 0;
+
+    int value = 0;
+
+    explicit Tracked(int v) : value{v} { ++live; }
+    Tracked(const Tracked& other) : value{other.value} { ++live; }
+    Tracked(Tracked&& other) noexcept : value{other.value} { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked() { --live; }
+};
+
+// A Tracked whose copy constructor throws once copies_left runs out
+struct ThrowsOnCopy : Tracked {
+    static inline int copies_left = 0;
+
+    explicit ThrowsOnCopy(int v) : Tracked{v} {}
+    ThrowsOnCopy(const ThrowsOnCopy& other) : Tracked{other} {
+        if (copies_left-- == 0) {
+            throw std::runtime_error{"copy failed"};
+        }
+    }
+    ThrowsOnCopy(ThrowsOnCopy&&) noexcept = default;
+    ThrowsOnCopy& operator=(const ThrowsOnCopy&) = default;
+    ThrowsOnCopy& operator=(ThrowsOnCopy&&) noexcept = default;
+};
+
+} // namespace
+
+TEST_CASE("SpscRing basic operations", "[spsc_ring][basic]") {
+    SpscRing<int, 4> ring;
+
+    SECTION("starts empty") {
+        REQUIRE(ring.empty());
+        REQUIRE(ring.size() == 0);
+        REQUIRE(ring.capacity() == 4);
+        REQUIRE_FALSE(ring.try_pop().has_value());
+    }
+
+    SECTION("pops in FIFO order") {
+        REQUIRE(ring.try_push(1));
+        REQUIRE(ring.try_push(2));
+        REQUIRE(ring.try_push(3));
+        REQUIRE(ring.size() == 3);
+
+        REQUIRE(ring.try_pop() == 1);
+        REQUIRE(ring.try_pop() == 2);
+        REQUIRE(ring.try_pop() == 3);
+        REQUIRE(ring.empty());
+    }
+
+    SECTION("rejects pushes when full") {
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(ring.try_push(i));
+        }
+        REQUIRE_FALSE(ring.try_push(99));
+
+        REQUIRE(ring.try_pop() == 0);
+        REQUIRE(ring.try_push(4));
+        REQUIRE(ring.size() == 4);
+    }
+
+    SECTION("wraps around the buffer many times") {
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(ring.try_push(i));
+            REQUIRE(ring.try_pop() == i);
+        }
+        REQUIRE(ring.empty());
+    }
+}
+
+TEST_CASE("SpscRing move-only and non-trivial types", "[spsc_ring][types]") {
+    SECTION("move-only elements") {
+        SpscRing<std::unique_ptr<int>, 8> ring;
+        REQUIRE(ring.try_push(std::make_unique<int>(7)));
+        REQUIRE(ring.try_emplace(new int{8}));
+
+        auto first = ring.try_pop();
+        REQUIRE(first.has_value());
+        REQUIRE(**first == 7);
+        REQUIRE(**ring.try_pop() == 8);
+    }
+
+    SECTION("strings survive the round trip") {
+        SpscRing<std::string, 2> ring;
+        REQUIRE(ring.try_push(std::string(100, 'x')));
+        REQUIRE(ring.try_pop() == std::string(100, 'x'));
+    }
+
+    SECTION("remaining elements are destroyed with the ring") {
+        Tracked::live = 0;
+        {
+            SpscRing<Tracked, 8> ring;
+            REQUIRE(ring.try_emplace(1));
+            REQUIRE(ring.try_emplace(2));
+            REQUIRE(ring.try_emplace(3));
+            REQUIRE(Tracked::live == 3);
+
+            REQUIRE(ring.try_pop()->value == 1);
+            REQUIRE(Tracked::live == 2);
+        }
+        REQUIRE(Tracked::live == 0);
+    }
+}
+
+TEST_CASE("SpscRing batch operations", "[spsc_ring][batch]") {
+    SpscRing<int, 8> ring;
+
+    SECTION("batch push is limited by free space") {
+        std::vector<int> items{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        REQUIRE(ring.try_push_batch(items) == 8);
+        REQUIRE(ring.try_push_batch(items) == 0);
+        REQUIRE(ring.size() == 8);
+    }
+
+    SECTION("batch pop is limited by available elements") {
+        std::vector<int> items{1, 2, 3};
+        REQUIRE(ring.try_push_batch(items) == 3);
+
+        std::array<int, 5> out{};
+        REQUIRE(ring.try_pop_batch(out) == 3);
+        REQUIRE(out[0] == 1);
+        REQUIRE(out[1] == 2);
+        REQUIRE(out[2] == 3);
+        REQUIRE(ring.try_pop_batch(out) == 0);
+    }
+
+    SECTION("batches across the wrap point") {
+        std::array<int, 6> in{10, 11, 12, 13, 14, 15};
+        std::array<int, 6> out{};
+
+        REQUIRE(ring.try_push_batch(in) == 6);
+        REQUIRE(ring.try_pop_batch(out) == 6);
+        REQUIRE(ring.try_push_batch(in) == 6);
+        REQUIRE(ring.try_pop_batch(out) == 6);
+        REQUIRE(out == in);
+    }
+}
+
+TEST_CASE("SpscRing batch push that throws pushes nothing", "[spsc_ring][batch]") {
+    {
+        SpscRing<ThrowsOnCopy, 8> ring;
+        std::vector<ThrowsOnCopy> items;
+        for (int i = 0; i < 5; ++i) {
+            items.emplace_back(i);
+        }
+        REQUIRE(Tracked::live == 5);
+
+        // The fourth copy throws; the three made before it are destroyed
+        ThrowsOnCopy::copies_left = 3;
+        REQUIRE_THROWS_AS(ring.try_push_batch(items), std::runtime_error);
+        REQUIRE(Tracked::live == 5);
+        REQUIRE(ring.empty());
+
+        ThrowsOnCopy::copies_left = 5;
+        REQUIRE(ring.try_push_batch(items) == 5);
+        REQUIRE(ring.try_pop()->value == 0);
+    }
+    REQUIRE(Tracked::live == 0);
+}
+
+TEST_CASE("SpscRing cross-thread transfer", "[spsc_ring][concurrent]") {
+    constexpr int count = 200'000;
+
+    SECTION("non-blocking ring preserves order") {
+        SpscRing<int, 64> ring;
+
+        std::thread producer{[&ring] {
+            for (int i = 0; i < count; ++i) {
+                while (!ring.try_push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        }};
+
+        bool in_order = true;
+        for (int expected = 0; expected < count;) {
+            if (auto value = ring.try_pop()) {
+                in_order = in_order && (*value == expected);
+                ++expected;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        REQUIRE(in_order);
+        REQUIRE(ring.empty());
+    }
+
+    SECTION("blocking ring preserves order") {
+        SpscRing<int, 16, SpscMode::blocking> ring;
+
+        std::thread producer{[&ring] {
+            for (int i = 0; i < count; ++i) {
+                ring.push(i);
+            }
+        }};
+
+        bool in_order = true;
+        for (int expected = 0; expected < count; ++expected) {
+            in_order = in_order && (ring.pop() == expected);
+        }
+        producer.join();
+
+        REQUIRE(in_order);
+    }
+
+    SECTION("batches transfer every element exactly once") {
+        SpscRing<long long, 256> ring;
+
+        std::thread producer{[&ring] {
+            std::vector<long long> chunk(32);
+            long long next = 0;
+            while (next < count) {
+                for (auto& v : chunk) {
+                    v = next++;
+                }
+                std::span<const long long> pending{chunk};
+                while (!pending.empty()) {
+                    const auto pushed = ring.try_push_batch(pending);
+                    if (pushed == 0) {
+                        std::this_thread::yield();
+                    }
+                    pending = pending.subspan(pushed);
+                }
+            }
+        }};
+
+        long long sum = 0;
+        long long received = 0;
+        std::array<long long, 64> out{};
+        while (received < count) {
+            const auto n = ring.try_pop_batch(out);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += out[i];
+            }
+            received += static_cast<long long>(n);
+        }
+        producer.join();
+
+        REQUIRE(sum == static_cast<long long>(count) * (count - 1) / 2);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef THREAD_INDEX_H
+#define THREAD_INDEX_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace concurrent {
+
+/**
+ * A small, dense, process-wide index for the calling thread.
+ *
+ * Threads are numbered 0, 1, 2, ... in the order they first call this
+ * function. Structures that stripe state per thread use it modulo their
+ * stripe count, which spreads threads evenly (unlike hashing thread ids).
+ */
+[[nodiscard]] inline std::size_t this_thread_index() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace concurrent
+
+#endif // THREAD_INDEX_H
@@ -0,0 +1,201 @@
+#ifndef WAIT_STRATEGY_H
+#define WAIT_STRATEGY_H
+
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace concurrent {
+
+/**
+ * Tell the CPU we are in a spin loop.
+ *
+ * On x86 PAUSE stops the core from speculating through the loop and yields
+ * pipeline resources to a hyper-threaded sibling; on ARM YIELD is the
+ * equivalent hint. It does not give up the time slice.
+ */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#elif defined(_MSC_VER)
+    _mm_pause();
+#endif
+}
+
+/**
+ * How a blocked thread waits for another thread to change some state.
+ *
+ * wait_until(ready) returns once ready() is true; ready() may have side
+ * effects (queues pass "try to pop" as the predicate). notify_one() is
+ * called after every state change that could make ready() true.
+ *
+ * The strategies trade CPU for wake-up latency:
+ *
+ *   BusySpin       lowest latency, burns a core while waiting
+ *   SpinThenYield  spins briefly, then lets other threads run
+ *   AtomicWait     spins briefly, then sleeps in the kernel (futex on Linux)
+ *   CondVarWait    sleeps on a mutex + condition_variable (classic)
+ */
+template <typename W>
+concept WaitStrategy = std::default_initializable<W> && requires(W w, bool (*ready)()) {
+    w.wait_until(ready);
+    w.notify_one();
+    w.notify_all();
+};
+
+/**
+ * Spin with cpu_relax() until ready. No notification cost at all.
+ * Only use when every waiting thread has a dedicated core.
+ */
+class BusySpin {
+public:
+    template <std::predicate Ready>
+    void wait_until(Ready ready) {
+        while (!ready()) {
+            cpu_relax();
+        }
+    }
+
+    void notify_one() noexcept {}
+    void notify_all() noexcept {}
+};
+
+/**
+ * Spin for a bounded number of attempts, then std::this_thread::yield()
+ * between attempts. Behaves well when threads outnumber cores.
+ */
+class SpinThenYield {
+public:
+    static constexpr int spin_limit = 128;
+
+    template <std::predicate Ready>
+    void wait_until(Ready ready) {
+        for (int spins = 0; !ready(); ++spins) {
+            if (spins < spin_limit) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void notify_one() noexcept {}
+    void notify_all() noexcept {}
+};
+
+/**
+ * Spin briefly, then sleep with std::atomic::wait on an epoch counter.
+ *
+ * Notifiers only touch the epoch (and the kernel) when a waiter has
+ * registered, so the uncontended cost of notify is one fence and one load.
+ * Waiter registration and the notifier's publish are both followed by a
+ * seq_cst fence, so at least one side always sees the other.
+ */
+class AtomicWait {
+public:
+    static constexpr int spin_limit = 64;
+
+    template <std::predicate Ready>
+    void wait_until(Ready ready) {
+        for (int spins = 0; spins < spin_limit; ++spins) {
+            if (ready()) {
+                return;
+            }
+            cpu_relax();
+        }
+
+        while (true) {
+            waiters_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::uint32_t epoch = epoch_.load(std::memory_order_relaxed);
+            if (ready()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            epoch_.wait(epoch, std::memory_order_relaxed);
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void notify_one() noexcept {
+        if (has_waiters()) {
+            epoch_.fetch_add(1, std::memory_order_relaxed);
+            epoch_.notify_one();
+        }
+    }
+
+    void notify_all() noexcept {
+        if (has_waiters()) {
+            epoch_.fetch_add(1, std::memory_order_relaxed);
+            epoch_.notify_all();
+        }
+    }
+
+private:
+    [[nodiscard]] bool has_waiters() const noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return waiters_.load(std::memory_order_relaxed) != 0;
+    }
+
+    std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> waiters_{0};
+};
+
+/**
+ * Sleep on a std::condition_variable, like Chapter 18's ThreadSafeQueue.
+ *
+ * The queue state itself stays lock-free; the mutex only orders the
+ * "check, then sleep" of a waiter against a notifier, and notifiers skip it
+ * entirely while nobody is waiting.
+ */
+class CondVarWait {
+public:
+    template <std::predicate Ready>
+    void wait_until(Ready ready) {
+        if (ready()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock{mutex_};
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv_.wait(lock, ready);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() {
+        if (has_waiters()) {
+            { std::lock_guard<std::mutex> lock{mutex_}; }
+            cv_.notify_one();
+        }
+    }
+
+    void notify_all() {
+        if (has_waiters()) {
+            { std::lock_guard<std::mutex> lock{mutex_}; }
+            cv_.notify_all();
+        }
+    }
+
+private:
+    [[nodiscard]] bool has_waiters() const noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return waiters_.load(std::memory_order_relaxed) != 0;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<std::uint32_t> waiters_{0};
+};
+
+} // namespace concurrent
+
+#endif // WAIT_STRATEGY_H
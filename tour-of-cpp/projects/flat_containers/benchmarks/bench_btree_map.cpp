@@ -0,0 +1,234 @@
+// Benchmark: BTreeMap vs. std::map and FlatMap
+//
+// Operations on 64-bit keys and values:
+//   bulk_load    - n elements from sorted pairs; std::map's range constructor
+//                  is linear for sorted input too, and FlatMap's includes
+//                  splitting the pairs into its two arrays
+//   insert       - n elements in random order, one at a time (FlatMap is
+//                  left out: each insert shifts half the array)
+//   find_hit     - n lookups of keys that are present, in random order
+//   find_miss    - n lookups of keys that are absent
+//   range_scan   - n / 64 scans of the 64 elements from a random key on,
+//                  summing their values; each one a lower_bound and a walk
+//   full_scan    - summing every value
+//
+// The range workloads are the reason for the B+-tree: std::map follows a
+// pointer per element, FlatMap and BTreeMap read arrays. BTreeMap is timed
+// twice there - through its iterators ("btree") and through for_each_in
+// ("btree_scan"), which walks a leaf at a time.
+//
+// Sizes stop at 256K to keep the smoke test short; the maps that the
+// lookups and scans read are built once per size.
+
+#include "bench.h"
+#include "btree_map.h"
+#include "flat_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Std = std::map<std::uint64_t, std::uint64_t>;
+using Flat = flat::FlatMap<std::uint64_t, std::uint64_t>;
+using BTree = flat::BTreeMap<std::uint64_t, std::uint64_t>;
+
+// Distinct keys in random order; the second half is never inserted and
+// serves as misses
+const std::vector<std::uint64_t>& keys(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::uint64_t>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937_64 gen{42};
+        out.resize(static_cast<std::size_t>(2 * n));
+        std::generate(out.begin(), out.end(), gen);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        std::shuffle(out.begin(), out.end(), gen);
+        out.resize(static_cast<std::size_t>(2 * n), 0);  // duplicates are vanishingly rare
+    }
+    return out;
+}
+
+// The inserted elements, sorted by key
+const std::vector<std::pair<std::uint64_t, std::uint64_t>>& sorted_pairs(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::pair<std::uint64_t, std::uint64_t>>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        const auto& ks = keys(n);
+        for (std::size_t i = 0; i < static_cast<std::size_t>(n); ++i) {
+            out.emplace_back(ks[i], i);
+        }
+        std::sort(out.begin(), out.end());
+    }
+    return out;
+}
+
+constexpr std::size_t scan_length = 64;
+
+// [from, to) ranges holding scan_length elements each, at random places
+const std::vector<std::pair<std::uint64_t, std::uint64_t>>& ranges(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::pair<std::uint64_t, std::uint64_t>>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        const auto& sorted = sorted_pairs(n);
+        std::mt19937_64 gen{7};
+        std::uniform_int_distribution<std::size_t> start{0, sorted.size() - scan_length - 1};
+        for (std::size_t i = 0; i < sorted.size() / scan_length; ++i) {
+            const auto s = start(gen);
+            out.emplace_back(sorted[s].first, sorted[s + scan_length].first);
+        }
+    }
+    return out;
+}
+
+template <typename Map>
+const Map& built(std::int64_t n) {
+    static std::map<std::int64_t, Map> cache;
+    auto it = cache.find(n);
+    if (it == cache.end()) {
+        const auto& input = sorted_pairs(n);
+        it = cache.emplace(n, Map(input.begin(), input.end())).first;
+    }
+    return it->second;
+}
+
+template <typename Map>
+void bulk_load(bench::State& state) {
+    const auto& input = sorted_pairs(state.arg());
+    while (state.keep_running()) {
+        Map m = [&] {
+            if constexpr (std::is_same_v<Map, Std>) {
+                return Map(input.begin(), input.end());
+            } else if constexpr (std::is_same_v<Map, Flat>) {
+                std::vector<std::uint64_t> ks;
+                std::vector<std::uint64_t> vs;
+                ks.reserve(input.size());
+                vs.reserve(input.size());
+                for (const auto& [k, v] : input) {
+                    ks.push_back(k);
+                    vs.push_back(v);
+                }
+                return Map(flat::sorted_unique, std::move(ks), std::move(vs));
+            } else {
+                return Map(flat::sorted_unique, input.begin(), input.end());
+            }
+        }();
+        bench::do_not_optimize(m.size());
+        state.pause_timing();
+        m = Map{};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void insert(bench::State& state) {
+    const auto& ks = keys(state.arg());
+    const auto n = static_cast<std::size_t>(state.arg());
+    while (state.keep_running()) {
+        Map m;
+        for (std::size_t i = 0; i < n; ++i) {
+            m.try_emplace(ks[i], i);
+        }
+        bench::do_not_optimize(m.size());
+        state.pause_timing();
+        m = Map{};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void find(bench::State& state, bool hit) {
+    const auto& ks = keys(state.arg());
+    const Map& m = built<Map>(state.arg());
+    const auto n = static_cast<std::size_t>(state.arg());
+    const std::size_t offset = hit ? 0 : n;
+    while (state.keep_running()) {
+        std::uint64_t found = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            found += m.count(ks[offset + i]);
+        }
+        bench::do_not_optimize(found);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void range_scan(bench::State& state) {
+    const auto& queries = ranges(state.arg());
+    const Map& m = built<Map>(state.arg());
+    while (state.keep_running()) {
+        std::uint64_t sum = 0;
+        for (const auto& [from, to] : queries) {
+            for (auto it = m.lower_bound(from); it != m.end() && it->first < to; ++it) {
+                sum += it->second;
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(queries.size() * scan_length));
+}
+
+void range_scan_leaves(bench::State& state) {
+    const auto& queries = ranges(state.arg());
+    const BTree& m = built<BTree>(state.arg());
+    while (state.keep_running()) {
+        std::uint64_t sum = 0;
+        for (const auto& [from, to] : queries) {
+            m.for_each_in(from, to, [&](std::uint64_t, std::uint64_t value) { sum += value; });
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(queries.size() * scan_length));
+}
+
+template <typename Map>
+void full_scan(bench::State& state) {
+    const Map& m = built<Map>(state.arg());
+    while (state.keep_running()) {
+        std::uint64_t sum = 0;
+        for (const auto& kv : m) {
+            sum += kv.second;
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 18;
+
+    const auto add = [&](const std::string& name, auto fn) {
+        bench::register_benchmark(name, fn)->range(small, large, 16);
+    };
+    add("bulk_load/std", bulk_load<Std>);
+    add("bulk_load/flat", bulk_load<Flat>);
+    add("bulk_load/btree", bulk_load<BTree>);
+    add("insert/std", insert<Std>);
+    add("insert/btree", insert<BTree>);
+    add("find_hit/std", [](bench::State& s) { find<Std>(s, true); });
+    add("find_hit/flat", [](bench::State& s) { find<Flat>(s, true); });
+    add("find_hit/btree", [](bench::State& s) { find<BTree>(s, true); });
+    add("find_miss/std", [](bench::State& s) { find<Std>(s, false); });
+    add("find_miss/flat", [](bench::State& s) { find<Flat>(s, false); });
+    add("find_miss/btree", [](bench::State& s) { find<BTree>(s, false); });
+    add("range_scan/std", range_scan<Std>);
+    add("range_scan/flat", range_scan<Flat>);
+    add("range_scan/btree", range_scan<BTree>);
+    add("range_scan/btree_scan", range_scan_leaves);
+    add("full_scan/std", full_scan<Std>);
+    add("full_scan/flat", full_scan<Flat>);
+    add("full_scan/btree", full_scan<BTree>);
+    return true;
+}();
+
+} // namespace
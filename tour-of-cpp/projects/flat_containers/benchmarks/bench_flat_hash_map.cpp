@@ -0,0 +1,168 @@
+// Benchmark: FlatHashMap vs. std::unordered_map
+//
+// Operations, each on 64-bit integer keys and on std::string keys:
+//   insert      - n inserts into an empty map (including every rehash)
+//   find_hit    - n lookups of keys that are present, in random order
+//   find_miss   - n lookups of keys that are absent
+//   iterate     - summing every value
+//   erase       - erasing every key, in random order
+//
+// Lookups in a std::unordered_map follow a pointer from the bucket array
+// to a node, which is a cache miss of its own once the map outgrows the
+// cache; FlatHashMap reads a control-byte group and then the slot. The gap
+// therefore widens with size. Sizes stop at 256K (64K for strings) to
+// keep the smoke test short; raise `large` (memory permitting, to 1 << 27)
+// for the big end.
+
+#include "bench.h"
+#include "flat_hash_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Distinct keys; the second half of the vector is never inserted and
+// serves as misses
+template <typename K>
+const std::vector<K>& keys(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<K>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937_64 gen{42};
+        std::vector<std::uint64_t> raw(static_cast<std::size_t>(2 * n));
+        std::generate(raw.begin(), raw.end(), gen);
+        std::sort(raw.begin(), raw.end());
+        raw.erase(std::unique(raw.begin(), raw.end()), raw.end());
+        std::shuffle(raw.begin(), raw.end(), gen);
+        raw.resize(static_cast<std::size_t>(2 * n), 0);  // duplicates are vanishingly rare
+        for (const auto k : raw) {
+            if constexpr (std::is_same_v<K, std::string>) {
+                out.push_back("key-" + std::to_string(k));
+            } else {
+                out.push_back(k);
+            }
+        }
+    }
+    return out;
+}
+
+template <typename Map>
+Map filled(std::int64_t n) {
+    using K = typename Map::key_type;
+    const auto& ks = keys<K>(n);
+    Map m;
+    for (std::int64_t i = 0; i < n; ++i) {
+        m[ks[static_cast<std::size_t>(i)]] = static_cast<std::uint64_t>(i);
+    }
+    return m;
+}
+
+template <typename Map>
+void insert(bench::State& state) {
+    using K = typename Map::key_type;
+    const auto& ks = keys<K>(state.arg());
+    while (state.keep_running()) {
+        Map m;
+        for (std::int64_t i = 0; i < state.arg(); ++i) {
+            m[ks[static_cast<std::size_t>(i)]] = static_cast<std::uint64_t>(i);
+        }
+        bench::do_not_optimize(m.size());
+        state.pause_timing();
+        m = Map{};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void find(bench::State& state, bool hit) {
+    using K = typename Map::key_type;
+    const auto& ks = keys<K>(state.arg());
+    const auto m = filled<Map>(state.arg());
+    const std::size_t offset = hit ? 0 : static_cast<std::size_t>(state.arg());
+    // A different order than insertion, so lookups don't walk memory in step
+    std::vector<std::size_t> order(static_cast<std::size_t>(state.arg()));
+    std::iota(order.begin(), order.end(), offset);
+    std::shuffle(order.begin(), order.end(), std::mt19937{7});
+    while (state.keep_running()) {
+        std::uint64_t found = 0;
+        for (const auto i : order) {
+            found += m.count(ks[i]);
+        }
+        bench::do_not_optimize(found);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void iterate(bench::State& state) {
+    const auto m = filled<Map>(state.arg());
+    while (state.keep_running()) {
+        std::uint64_t sum = 0;
+        for (const auto& kv : m) {
+            sum += kv.second;
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void erase(bench::State& state) {
+    using K = typename Map::key_type;
+    const auto& ks = keys<K>(state.arg());
+    const auto full = filled<Map>(state.arg());
+    std::vector<std::size_t> order(static_cast<std::size_t>(state.arg()));
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937{7});
+    while (state.keep_running()) {
+        state.pause_timing();
+        auto m = full;
+        state.resume_timing();
+        for (const auto i : order) {
+            m.erase(ks[i]);
+        }
+        bench::do_not_optimize(m.size());
+        state.pause_timing();
+        m = Map{};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename K>
+void register_key_type(const std::string& type, std::int64_t lo, std::int64_t hi) {
+    using Std = std::unordered_map<K, std::uint64_t>;
+    using Flat = flat::FlatHashMap<K, std::uint64_t>;
+
+    const auto both = [&](const std::string& op, auto std_fn, auto flat_fn) {
+        bench::register_benchmark(op + "/" + type + "/std", std_fn)->range(lo, hi, 16);
+        bench::register_benchmark(op + "/" + type + "/flat", flat_fn)->range(lo, hi, 16);
+    };
+    both("insert", insert<Std>, insert<Flat>);
+    both("find_hit", [](bench::State& s) { find<Std>(s, true); },
+         [](bench::State& s) { find<Flat>(s, true); });
+    both("find_miss", [](bench::State& s) { find<Std>(s, false); },
+         [](bench::State& s) { find<Flat>(s, false); });
+    both("iterate", iterate<Std>, iterate<Flat>);
+    both("erase", erase<Std>, erase<Flat>);
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 18;
+
+    register_key_type<std::uint64_t>("u64", small, large);
+    register_key_type<std::string>("string", small, large / 4);
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,182 @@
+// Benchmark: FlatMap vs. std::map
+//
+// Operations, each on 64-bit integer keys and on std::string keys:
+//   build       - n elements in random order into an empty map; FlatMap
+//                 sorts them once in its constructor
+//   find_hit    - n lookups of keys that are present, in random order
+//   find_miss   - n lookups of keys that are absent
+//   iterate     - summing every value
+//
+// Besides std::map, lookups are timed on a sorted std::vector of pairs
+// searched with std::lower_bound ("sorted_vector"): the same memory layout
+// as a hand-rolled table, with the usual branchy binary search. FlatMap
+// differs from it in two ways - the keys are searched without the values
+// in between, and the search is branchless - so the three together show
+// what each step is worth. Memory use is printed by the demo program.
+//
+// Sizes stop at 256K (16K for strings) to keep the smoke test short; the
+// maps that find and iterate read are built once per size.
+
+#include "bench.h"
+#include "flat_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Distinct keys in random order; the second half of the vector is never
+// inserted and serves as misses
+template <typename K>
+const std::vector<K>& keys(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<K>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937_64 gen{42};
+        std::vector<std::uint64_t> raw(static_cast<std::size_t>(2 * n));
+        std::generate(raw.begin(), raw.end(), gen);
+        std::sort(raw.begin(), raw.end());
+        raw.erase(std::unique(raw.begin(), raw.end()), raw.end());
+        std::shuffle(raw.begin(), raw.end(), gen);
+        raw.resize(static_cast<std::size_t>(2 * n), 0);  // duplicates are vanishingly rare
+        for (const auto k : raw) {
+            if constexpr (std::is_same_v<K, std::string>) {
+                out.push_back("key-" + std::to_string(k));
+            } else {
+                out.push_back(k);
+            }
+        }
+    }
+    return out;
+}
+
+template <typename K>
+std::vector<std::pair<K, std::uint64_t>> pairs(std::int64_t n) {
+    const auto& ks = keys<K>(n);
+    std::vector<std::pair<K, std::uint64_t>> out;
+    out.reserve(static_cast<std::size_t>(n));
+    for (std::int64_t i = 0; i < n; ++i) {
+        out.emplace_back(ks[static_cast<std::size_t>(i)], static_cast<std::uint64_t>(i));
+    }
+    return out;
+}
+
+// std::lower_bound over one sorted array of pairs
+template <typename K>
+class SortedVector {
+public:
+    using key_type = K;
+
+    template <typename It>
+    SortedVector(It first, It last) : elements_(first, last) {
+        std::sort(elements_.begin(), elements_.end());
+    }
+
+    [[nodiscard]] std::size_t count(const K& key) const {
+        const auto it = std::lower_bound(
+            elements_.begin(), elements_.end(), key,
+            [](const auto& element, const K& k) { return element.first < k; });
+        return it != elements_.end() && it->first == key ? 1 : 0;
+    }
+
+private:
+    std::vector<std::pair<K, std::uint64_t>> elements_;
+};
+
+// The map under test for n elements, built once and shared by the
+// benchmarks that only read it
+template <typename Map>
+const Map& built(std::int64_t n) {
+    static std::map<std::int64_t, Map> cache;
+    auto it = cache.find(n);
+    if (it == cache.end()) {
+        const auto input = pairs<typename Map::key_type>(n);
+        it = cache.emplace(n, Map(input.begin(), input.end())).first;
+    }
+    return it->second;
+}
+
+template <typename Map>
+void build(bench::State& state) {
+    using K = typename Map::key_type;
+    const auto input = pairs<K>(state.arg());
+    while (state.keep_running()) {
+        Map m(input.begin(), input.end());
+        bench::do_not_optimize(m.size());
+        state.pause_timing();
+        m = Map{};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void find(bench::State& state, bool hit) {
+    using K = typename Map::key_type;
+    const auto& ks = keys<K>(state.arg());
+    const Map& m = built<Map>(state.arg());
+    const std::size_t offset = hit ? 0 : static_cast<std::size_t>(state.arg());
+    std::vector<std::size_t> order(static_cast<std::size_t>(state.arg()));
+    std::iota(order.begin(), order.end(), offset);
+    std::shuffle(order.begin(), order.end(), std::mt19937{7});
+    while (state.keep_running()) {
+        std::uint64_t found = 0;
+        for (const auto i : order) {
+            found += m.count(ks[i]);
+        }
+        bench::do_not_optimize(found);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void iterate(bench::State& state) {
+    const Map& m = built<Map>(state.arg());
+    while (state.keep_running()) {
+        std::uint64_t sum = 0;
+        for (const auto& kv : m) {
+            sum += kv.second;
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename K>
+void register_key_type(const std::string& type, std::int64_t lo, std::int64_t hi) {
+    using Std = std::map<K, std::uint64_t>;
+    using Sorted = SortedVector<K>;
+    using Flat = flat::FlatMap<K, std::uint64_t>;
+
+    const auto add = [&](const std::string& name, auto fn) {
+        bench::register_benchmark(name, fn)->range(lo, hi, 16);
+    };
+    add("build/" + type + "/std", build<Std>);
+    add("build/" + type + "/flat", build<Flat>);
+    add("find_hit/" + type + "/std", [](bench::State& s) { find<Std>(s, true); });
+    add("find_hit/" + type + "/sorted_vector", [](bench::State& s) { find<Sorted>(s, true); });
+    add("find_hit/" + type + "/flat", [](bench::State& s) { find<Flat>(s, true); });
+    add("find_miss/" + type + "/std", [](bench::State& s) { find<Std>(s, false); });
+    add("find_miss/" + type + "/sorted_vector", [](bench::State& s) { find<Sorted>(s, false); });
+    add("find_miss/" + type + "/flat", [](bench::State& s) { find<Flat>(s, false); });
+    add("iterate/" + type + "/std", iterate<Std>);
+    add("iterate/" + type + "/flat", iterate<Flat>);
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 18;
+
+    register_key_type<std::uint64_t>("u64", small, large);
+    register_key_type<std::string>("string", small, large / 16);
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,1023 @@
+#ifndef BTREE_MAP_H
+#define BTREE_MAP_H
+
+#include "flat_map.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flat {
+
+namespace detail {
+
+inline constexpr std::size_t cache_line_size = 64;
+
+// How many entries of entry_bytes fit in node_bytes after overhead_bytes,
+// and never fewer than four so that splitting and merging keep working
+[[nodiscard]] constexpr std::size_t node_capacity(std::size_t node_bytes,
+                                                  std::size_t overhead_bytes,
+                                                  std::size_t entry_bytes) noexcept {
+    const std::size_t room = node_bytes > overhead_bytes ? node_bytes - overhead_bytes : 0;
+    return std::max<std::size_t>(4, room / entry_bytes);
+}
+
+} // namespace detail
+
+/**
+ * An ordered map kept in a B+-tree: the elements sit in sorted arrays in
+ * the leaves, the leaves are linked into a list, and inner nodes hold only
+ * separator keys and child pointers.
+ *
+ *     BTreeMap<std::uint64_t, Order> orders;
+ *     orders.insert_or_assign(id, order);
+ *     for (auto it = orders.lower_bound(from); it != orders.end() && it->first < to; ++it) {
+ *         ...   // walks arrays, following one pointer per leaf
+ *     }
+ *
+ * std::map spends a node and a pointer chase on every element, which makes
+ * a range scan a chain of cache misses. Here a node is NodeBytes long
+ * (512 by default, eight cache lines) and holds dozens of elements, so a
+ * lookup touches a few nodes, and a scan reads leaves front to back. Unlike
+ * FlatMap, inserting and erasing stay O(log n): a full node splits in two
+ * and a node less than half full borrows from or merges with a neighbour.
+ *
+ * The interface is that of std::map, with FlatMap's pair-of-references
+ * iterators, since a leaf keeps its keys apart from its values so that
+ * searching one reads only keys. Keys are unique. K and V must be default
+ * constructible, because nodes hold fixed arrays of them. Any insert or
+ * erase invalidates all iterators.
+ */
+template <typename K, typename V, typename Compare = std::less<K>, std::size_t NodeBytes = 512>
+class BTreeMap {
+    static_assert(NodeBytes % detail::cache_line_size == 0 && NodeBytes >= 128,
+                  "BTreeMap: NodeBytes must be a multiple of the cache line, at least 128");
+    static_assert(std::default_initializable<K> && std::default_initializable<V>,
+                  "BTreeMap: nodes hold arrays of keys and values");
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using reference = std::pair<const K&, V&>;
+    using const_reference = std::pair<const K&, const V&>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Entries per node: a leaf holds keys, values and two links, an inner
+    // node keys and one more child than keys
+    static constexpr size_type leaf_capacity =
+        detail::node_capacity(NodeBytes, 8 + 2 * sizeof(void*), sizeof(K) + sizeof(V));
+    static constexpr size_type inner_capacity =
+        detail::node_capacity(NodeBytes, 8 + sizeof(void*), sizeof(K) + sizeof(void*));
+
+private:
+    static constexpr size_type min_leaf = leaf_capacity / 2;
+    static constexpr size_type min_inner = inner_capacity / 2;
+
+    struct Node {
+        explicit Node(bool leaf) noexcept : is_leaf{leaf} {}
+        std::uint32_t count = 0;
+        bool is_leaf;
+    };
+
+    // Keys first, so a search reads only the first cache lines of a node
+    struct alignas(detail::cache_line_size) Leaf : Node {
+        Leaf() noexcept(std::is_nothrow_default_constructible_v<K> &&
+                        std::is_nothrow_default_constructible_v<V>)
+            : Node{true} {}
+        std::array<K, leaf_capacity> keys;
+        std::array<V, leaf_capacity> values;
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+    };
+
+    // keys[i] separates children[i] (keys less than it) from children[i + 1]
+    struct alignas(detail::cache_line_size) Inner : Node {
+        Inner() noexcept(std::is_nothrow_default_constructible_v<K>) : Node{false} {}
+        std::array<K, inner_capacity> keys;
+        std::array<Node*, inner_capacity + 1> children{};
+    };
+
+public:
+    /**
+     * Walks a leaf's arrays and then follows its link to the next leaf.
+     * Dereferencing yields a pair of references, as FlatMap's iterators
+     * do: `it->second = x` and `auto& [k, v] = *it` work, but
+     * `value_type& p = *it` does not.
+     */
+    template <bool Const>
+    class basic_iterator {
+        using leaf_pointer = std::conditional_t<Const, const Leaf*, Leaf*>;
+
+    public:
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const_reference, BTreeMap::reference>;
+
+        // Holds the pair of references, so operator-> has something to point to
+        class pointer {
+        public:
+            reference* operator->() noexcept { return &ref_; }
+
+        private:
+            friend class basic_iterator;
+            explicit pointer(reference ref) noexcept : ref_{ref} {}
+            reference ref_;
+        };
+
+        basic_iterator() = default;
+
+        // iterator converts to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            : leaf_{other.leaf_}, index_{other.index_} {}
+
+        reference operator*() const noexcept {
+            return {leaf_->keys[index_], leaf_->values[index_]};
+        }
+        pointer operator->() const noexcept { return pointer{**this}; }
+
+        basic_iterator& operator++() noexcept {
+            if (++index_ == leaf_->count && leaf_->next != nullptr) {
+                leaf_ = leaf_->next;
+                index_ = 0;
+            }
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        basic_iterator& operator--() noexcept {
+            if (index_ == 0) {
+                leaf_ = leaf_->prev;
+                index_ = leaf_->count;
+            }
+            --index_;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.leaf_ == b.leaf_ && a.index_ == b.index_;
+        }
+
+    private:
+        friend class BTreeMap;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(leaf_pointer leaf, size_type index) noexcept
+            : leaf_{leaf}, index_{index} {}
+
+        leaf_pointer leaf_ = nullptr;
+        size_type index_ = 0;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // =========================================================================
+    // Construction
+    // =========================================================================
+
+    BTreeMap() = default;
+
+    explicit BTreeMap(const Compare& comp) : comp_{comp} {}
+
+    /**
+     * Sorts the elements once and builds the tree bottom up, with nodes
+     * filled evenly - much faster than inserting them one by one. Of
+     * elements with equal keys, the first is kept.
+     */
+    template <std::input_iterator It>
+    BTreeMap(It first, It last, const Compare& comp = Compare{}) : comp_{comp} {
+        std::vector<value_type> elements(first, last);
+        std::stable_sort(elements.begin(), elements.end(), pair_less());
+        const auto equal = [this](const value_type& a, const value_type& b) {
+            return !comp_(a.first, b.first);
+        };
+        elements.erase(std::unique(elements.begin(), elements.end(), equal), elements.end());
+        build(std::move(elements));
+    }
+
+    // Elements already sorted by key and unique are loaded as they are
+    template <std::input_iterator It>
+    BTreeMap(sorted_unique_t, It first, It last, const Compare& comp = Compare{})
+        : comp_{comp} {
+        build(std::vector<value_type>(first, last));
+    }
+
+    BTreeMap(std::initializer_list<value_type> init, const Compare& comp = Compare{})
+        : BTreeMap(init.begin(), init.end(), comp) {}
+
+    BTreeMap(const BTreeMap& other) : comp_{other.comp_} {
+        std::vector<value_type> elements;
+        elements.reserve(other.size());
+        for (const auto& [key, value] : other) {
+            elements.emplace_back(key, value);
+        }
+        build(std::move(elements));
+    }
+
+    BTreeMap(BTreeMap&& other) noexcept { swap(other); }
+
+    BTreeMap& operator=(const BTreeMap& other) {
+        BTreeMap copy{other};
+        swap(copy);
+        return *this;
+    }
+
+    BTreeMap& operator=(BTreeMap&& other) noexcept {
+        BTreeMap moved{std::move(other)};
+        swap(moved);
+        return *this;
+    }
+
+    ~BTreeMap() { destroy(root_); }
+
+    // =========================================================================
+    // Iterators and capacity
+    // =========================================================================
+
+    [[nodiscard]] iterator begin() noexcept { return {head_, 0}; }
+    [[nodiscard]] const_iterator begin() const noexcept { return {head_, 0}; }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] iterator end() noexcept { return {tail_, tail_ ? tail_->count : 0}; }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return {tail_, tail_ ? tail_->count : 0};
+    }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator{end()};
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator{begin()};
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+
+    // Levels of nodes from the root down to the leaves; 0 when empty
+    [[nodiscard]] size_type height() const noexcept { return root_ ? height_ + 1 : 0; }
+
+    [[nodiscard]] key_compare key_comp() const { return comp_; }
+
+    // =========================================================================
+    // Lookup
+    // =========================================================================
+    //
+    // Each takes a key_type or, with a transparent comparison, any type
+    // that compares against it
+
+    [[nodiscard]] iterator lower_bound(const key_type& key) { return lower(key); }
+    [[nodiscard]] const_iterator lower_bound(const key_type& key) const { return lower(key); }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] iterator lower_bound(const Q& key) {
+        return lower(key);
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const_iterator lower_bound(const Q& key) const {
+        return lower(key);
+    }
+
+    [[nodiscard]] iterator upper_bound(const key_type& key) { return upper(key); }
+    [[nodiscard]] const_iterator upper_bound(const key_type& key) const { return upper(key); }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] iterator upper_bound(const Q& key) {
+        return upper(key);
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const_iterator upper_bound(const Q& key) const {
+        return upper(key);
+    }
+
+    [[nodiscard]] std::pair<iterator, iterator> equal_range(const key_type& key) {
+        return equal(key);
+    }
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& key) const {
+        return equal(key);
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] std::pair<iterator, iterator> equal_range(const Q& key) {
+        return equal(key);
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const Q& key) const {
+        return equal(key);
+    }
+
+    [[nodiscard]] iterator find(const key_type& key) { return find_key(key); }
+    [[nodiscard]] const_iterator find(const key_type& key) const { return find_key(key); }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] iterator find(const Q& key) {
+        return find_key(key);
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const_iterator find(const Q& key) const {
+        return find_key(key);
+    }
+
+    [[nodiscard]] bool contains(const key_type& key) const { return find(key) != end(); }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] bool contains(const Q& key) const {
+        return find(key) != end();
+    }
+
+    [[nodiscard]] size_type count(const key_type& key) const { return contains(key) ? 1u : 0u; }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] size_type count(const Q& key) const {
+        return contains(key) ? 1u : 0u;
+    }
+
+    [[nodiscard]] V& at(const key_type& key) { return checked(find(key))->second; }
+    [[nodiscard]] const V& at(const key_type& key) const { return checked(find(key))->second; }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] V& at(const Q& key) {
+        return checked(find(key))->second;
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const V& at(const Q& key) const {
+        return checked(find(key))->second;
+    }
+
+    V& operator[](const key_type& key) { return try_emplace(key).first->second; }
+    V& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+    /**
+     * Calls fn(key, value) for every element with from <= key < to, in
+     * order. The same as iterating from lower_bound(from), but a leaf at a
+     * time: the loop over a leaf's arrays has no end-of-leaf check per
+     * element, so the compiler can keep it tight.
+     */
+    template <typename F>
+    void for_each_in(const key_type& from, const key_type& to, F fn) const {
+        if (root_ == nullptr || !comp_(from, to)) {
+            return;
+        }
+        const Leaf* leaf = leaf_for(from);
+        size_type i = lower_index(leaf, from);
+        for (; leaf != nullptr; leaf = leaf->next, i = 0) {
+            // The last key of the leaf tells whether the whole leaf is in range
+            const size_type n = leaf->count;
+            if (n != 0 && comp_(leaf->keys[n - 1], to)) {
+                for (; i < n; ++i) {
+                    fn(leaf->keys[i], leaf->values[i]);
+                }
+                continue;
+            }
+            for (; i < n && comp_(leaf->keys[i], to); ++i) {
+                fn(leaf->keys[i], leaf->values[i]);
+            }
+            return;
+        }
+    }
+
+    // =========================================================================
+    // Modifiers
+    // =========================================================================
+
+    // Inserts unless the key is present; returns the element and whether
+    // it was inserted
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return emplace_at(value.first, value.second);
+    }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return emplace_at(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename... Args>
+        requires std::constructible_from<value_type, Args&&...>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type value(std::forward<Args>(args)...);
+        return emplace_at(std::move(value.first), std::move(value.second));
+    }
+
+    // Constructs the value in place only if the key is absent
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return emplace_at(key, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return emplace_at(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    // Into an empty map this bulk loads, as the constructor does;
+    // otherwise the elements are inserted one at a time
+    template <std::input_iterator It>
+    void insert(It first, It last) {
+        if (empty()) {
+            BTreeMap loaded(first, last, comp_);
+            swap(loaded);
+            return;
+        }
+        for (; first != last; ++first) {
+            insert(value_type(*first));
+        }
+    }
+
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    // Returns the element after the erased one, found again by its key
+    // because erasing may move elements between leaves
+    iterator erase(const_iterator pos) {
+        const auto next = std::next(pos);
+        if (next == cend()) {
+            erase_key(pos->first);
+            return end();
+        }
+        const K next_key = next->first;
+        erase_key(pos->first);
+        return lower_bound(next_key);
+    }
+    iterator erase(iterator pos) { return erase(const_iterator{pos}); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        if (last == cend()) {
+            while (first != cend()) {
+                first = erase(first);
+            }
+            return end();
+        }
+        const K stop = last->first;
+        iterator it = erase_to_mutable(first);
+        while (it != end() && comp_(it->first, stop)) {
+            it = erase(it);
+        }
+        return it;
+    }
+
+    size_type erase(const key_type& key) { return erase_key(key); }
+    template <detail::transparent_key<K, Compare> Q>
+    size_type erase(const Q& key) {
+        return erase_key(key);
+    }
+
+    void clear() noexcept {
+        destroy(root_);
+        root_ = nullptr;
+        head_ = tail_ = nullptr;
+        size_ = 0;
+        height_ = 0;
+    }
+
+    void swap(BTreeMap& other) noexcept {
+        using std::swap;
+        swap(root_, other.root_);
+        swap(head_, other.head_);
+        swap(tail_, other.tail_);
+        swap(size_, other.size_);
+        swap(height_, other.height_);
+        swap(comp_, other.comp_);
+    }
+
+    friend void swap(BTreeMap& a, BTreeMap& b) noexcept { a.swap(b); }
+
+    friend bool operator==(const BTreeMap& a, const BTreeMap& b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](const auto& x, const auto& y) {
+                   return x.first == y.first && x.second == y.second;
+               });
+    }
+
+private:
+    // The inner nodes passed on the way down, and which child was taken
+    struct Step {
+        Inner* node;
+        size_type child;
+    };
+    static constexpr size_type max_height = 64;
+    using Path = std::array<Step, max_height>;
+
+    // -------------------------------------------------------------------------
+    // Searching
+    // -------------------------------------------------------------------------
+
+    // The child of an inner node that holds keys equal to `key`: one past
+    // the last separator not greater than it
+    template <typename Q>
+    [[nodiscard]] size_type child_index(const Inner* inner, const Q& key) const {
+        return detail::branchless_partition_point(
+            inner->keys.data(), inner->count, [&](const K& k) { return !comp_(key, k); });
+    }
+
+    template <typename Q>
+    [[nodiscard]] size_type lower_index(const Leaf* leaf, const Q& key) const {
+        return detail::branchless_partition_point(
+            leaf->keys.data(), leaf->count, [&](const K& k) { return comp_(k, key); });
+    }
+
+    template <typename Q>
+    [[nodiscard]] size_type upper_index(const Leaf* leaf, const Q& key) const {
+        return detail::branchless_partition_point(
+            leaf->keys.data(), leaf->count, [&](const K& k) { return !comp_(key, k); });
+    }
+
+    template <typename Q>
+    [[nodiscard]] Leaf* leaf_for(const Q& key) const {
+        const Node* node = root_;
+        while (!node->is_leaf) {
+            const auto* inner = static_cast<const Inner*>(node);
+            node = inner->children[child_index(inner, key)];
+        }
+        return static_cast<Leaf*>(const_cast<Node*>(node));
+    }
+
+    // As leaf_for, recording the way down
+    template <typename Q>
+    [[nodiscard]] Leaf* leaf_for(const Q& key, Path& path) {
+        Node* node = root_;
+        for (size_type depth = 0; !node->is_leaf; ++depth) {
+            auto* inner = static_cast<Inner*>(node);
+            const auto child = child_index(inner, key);
+            path[depth] = {inner, child};
+            node = inner->children[child];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // Position i of a leaf, or the start of the next leaf when i is its end
+    [[nodiscard]] static iterator position(Leaf* leaf, size_type i) noexcept {
+        if (i == leaf->count && leaf->next != nullptr) {
+            return {leaf->next, 0};
+        }
+        return {leaf, i};
+    }
+
+    template <typename Q>
+    [[nodiscard]] iterator lower(const Q& key) const {
+        if (root_ == nullptr) {
+            return {};
+        }
+        Leaf* leaf = leaf_for(key);
+        return position(leaf, lower_index(leaf, key));
+    }
+
+    template <typename Q>
+    [[nodiscard]] iterator upper(const Q& key) const {
+        if (root_ == nullptr) {
+            return {};
+        }
+        Leaf* leaf = leaf_for(key);
+        return position(leaf, upper_index(leaf, key));
+    }
+
+    template <typename Q>
+    [[nodiscard]] std::pair<iterator, iterator> equal(const Q& key) const {
+        const iterator first = lower(key);
+        iterator last = first;
+        if (last != iterator{tail_, tail_ ? tail_->count : 0} && !comp_(key, last->first)) {
+            ++last;
+        }
+        return {first, last};
+    }
+
+    template <typename Q>
+    [[nodiscard]] iterator find_key(const Q& key) const {
+        if (root_ == nullptr) {
+            return {};
+        }
+        Leaf* leaf = leaf_for(key);
+        const size_type i = lower_index(leaf, key);
+        if (i == leaf->count || comp_(key, leaf->keys[i])) {
+            return {tail_, tail_->count};
+        }
+        return {leaf, i};
+    }
+
+    template <typename It>
+    [[nodiscard]] static It checked(It it) {
+        if (it == It{} || it.index_ == it.leaf_->count) {
+            throw std::out_of_range{"BTreeMap::at: key not found"};
+        }
+        return it;
+    }
+
+    [[nodiscard]] iterator erase_to_mutable(const_iterator it) noexcept {
+        return {const_cast<Leaf*>(it.leaf_), it.index_};
+    }
+
+    // -------------------------------------------------------------------------
+    // Inserting: a full node splits, and the split travels up the path
+    // -------------------------------------------------------------------------
+
+    template <typename KK, typename... Args>
+    std::pair<iterator, bool> emplace_at(KK&& key, Args&&... args) {
+        if (root_ == nullptr) {
+            root_ = head_ = tail_ = new Leaf;
+        }
+        Path path;
+        Leaf* leaf = leaf_for(key, path);
+        size_type i = lower_index(leaf, key);
+        if (i < leaf->count && !comp_(key, leaf->keys[i])) {
+            return {{leaf, i}, false};
+        }
+
+        // Both are built before the tree changes, in case either throws
+        K new_key(std::forward<KK>(key));
+        V new_value(std::forward<Args>(args)...);
+
+        if (leaf->count == leaf_capacity) {
+            Leaf* right = split_leaf(leaf);
+            K separator = right->keys[0];
+            insert_up(path, height_, std::move(separator), right);
+            if (i > leaf->count) {
+                i -= leaf->count;
+                leaf = right;
+            }
+        }
+        std::move_backward(leaf->keys.begin() + i, leaf->keys.begin() + leaf->count,
+                           leaf->keys.begin() + leaf->count + 1);
+        std::move_backward(leaf->values.begin() + i, leaf->values.begin() + leaf->count,
+                           leaf->values.begin() + leaf->count + 1);
+        leaf->keys[i] = std::move(new_key);
+        leaf->values[i] = std::move(new_value);
+        ++leaf->count;
+        ++size_;
+        return {{leaf, i}, true};
+    }
+
+    // Moves the upper half of a full leaf into a new leaf after it
+    Leaf* split_leaf(Leaf* leaf) {
+        auto* right = new Leaf;
+        const size_type keep = leaf->count / 2;
+        std::move(leaf->keys.begin() + keep, leaf->keys.begin() + leaf->count,
+                  right->keys.begin());
+        std::move(leaf->values.begin() + keep, leaf->values.begin() + leaf->count,
+                  right->values.begin());
+        right->count = leaf->count - static_cast<std::uint32_t>(keep);
+        leaf->count = static_cast<std::uint32_t>(keep);
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        (leaf->next != nullptr ? leaf->next->prev : tail_) = right;
+        leaf->next = right;
+        return right;
+    }
+
+    // Adds `child` right after path[depth - 1]'s child, with `separator`
+    // between them, splitting inner nodes - and finally the root - as needed
+    void insert_up(const Path& path, size_type depth, K separator, Node* child) {
+        while (depth > 0) {
+            const auto [inner, index] = path[--depth];
+            if (inner->count < inner_capacity) {
+                insert_child(inner, index, std::move(separator), child);
+                return;
+            }
+            // Split around the middle key, which moves up a level
+            auto* right = new Inner;
+            const size_type mid = inner->count / 2;
+            K up = std::move(inner->keys[mid]);
+            std::move(inner->keys.begin() + mid + 1, inner->keys.begin() + inner->count,
+                      right->keys.begin());
+            std::copy(inner->children.begin() + mid + 1,
+                      inner->children.begin() + inner->count + 1, right->children.begin());
+            right->count = inner->count - static_cast<std::uint32_t>(mid) - 1;
+            inner->count = static_cast<std::uint32_t>(mid);
+
+            if (index <= mid) {
+                insert_child(inner, index, std::move(separator), child);
+            } else {
+                insert_child(right, index - mid - 1, std::move(separator), child);
+            }
+            separator = std::move(up);
+            child = right;
+        }
+        auto* root = new Inner;
+        root->keys[0] = std::move(separator);
+        root->children[0] = root_;
+        root->children[1] = child;
+        root->count = 1;
+        root_ = root;
+        ++height_;
+    }
+
+    static void insert_child(Inner* inner, size_type index, K separator, Node* child) {
+        std::move_backward(inner->keys.begin() + index, inner->keys.begin() + inner->count,
+                           inner->keys.begin() + inner->count + 1);
+        std::copy_backward(inner->children.begin() + index + 1,
+                           inner->children.begin() + inner->count + 1,
+                           inner->children.begin() + inner->count + 2);
+        inner->keys[index] = std::move(separator);
+        inner->children[index + 1] = child;
+        ++inner->count;
+    }
+
+    // -------------------------------------------------------------------------
+    // Erasing: a node under half full borrows from a neighbour, or merges
+    // with it, and a merge may leave the parent under half full in turn
+    // -------------------------------------------------------------------------
+
+    template <typename Q>
+    size_type erase_key(const Q& key) {
+        if (root_ == nullptr) {
+            return 0;
+        }
+        Path path;
+        Leaf* leaf = leaf_for(key, path);
+        const size_type i = lower_index(leaf, key);
+        if (i == leaf->count || comp_(key, leaf->keys[i])) {
+            return 0;
+        }
+        std::move(leaf->keys.begin() + i + 1, leaf->keys.begin() + leaf->count,
+                  leaf->keys.begin() + i);
+        std::move(leaf->values.begin() + i + 1, leaf->values.begin() + leaf->count,
+                  leaf->values.begin() + i);
+        --leaf->count;
+        release(leaf, leaf->count);
+        --size_;
+        if (height_ > 0 && leaf->count < min_leaf) {
+            rebalance_leaf(path, leaf);
+        }
+        return 1;
+    }
+
+    // Resets a vacated slot, so it no longer holds on to a moved-from
+    // value's resources
+    static void release(Leaf* leaf, size_type i) {
+        leaf->keys[i] = K{};
+        leaf->values[i] = V{};
+    }
+
+    void rebalance_leaf(const Path& path, Leaf* leaf) {
+        const auto [parent, index] = path[height_ - 1];
+        auto* left = index > 0 ? static_cast<Leaf*>(parent->children[index - 1]) : nullptr;
+        auto* right =
+            index < parent->count ? static_cast<Leaf*>(parent->children[index + 1]) : nullptr;
+
+        if (left != nullptr && left->count > min_leaf) {
+            // The left neighbour's last element becomes this leaf's first
+            std::move_backward(leaf->keys.begin(), leaf->keys.begin() + leaf->count,
+                               leaf->keys.begin() + leaf->count + 1);
+            std::move_backward(leaf->values.begin(), leaf->values.begin() + leaf->count,
+                               leaf->values.begin() + leaf->count + 1);
+            --left->count;
+            leaf->keys[0] = std::move(left->keys[left->count]);
+            leaf->values[0] = std::move(left->values[left->count]);
+            release(left, left->count);
+            ++leaf->count;
+            parent->keys[index - 1] = leaf->keys[0];
+            return;
+        }
+        if (right != nullptr && right->count > min_leaf) {
+            // The right neighbour's first element becomes this leaf's last
+            leaf->keys[leaf->count] = std::move(right->keys[0]);
+            leaf->values[leaf->count] = std::move(right->values[0]);
+            ++leaf->count;
+            std::move(right->keys.begin() + 1, right->keys.begin() + right->count,
+                      right->keys.begin());
+            std::move(right->values.begin() + 1, right->values.begin() + right->count,
+                      right->values.begin());
+            --right->count;
+            release(right, right->count);
+            parent->keys[index] = right->keys[0];
+            return;
+        }
+        if (left != nullptr) {
+            merge_leaves(left, leaf);
+            remove_child(parent, index - 1);
+        } else {
+            merge_leaves(leaf, right);
+            remove_child(parent, index);
+        }
+        rebalance_inner(path, height_ - 1);
+    }
+
+    // Appends `right` to `left` and frees it
+    void merge_leaves(Leaf* left, Leaf* right) {
+        std::move(right->keys.begin(), right->keys.begin() + right->count,
+                  left->keys.begin() + left->count);
+        std::move(right->values.begin(), right->values.begin() + right->count,
+                  left->values.begin() + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        (right->next != nullptr ? right->next->prev : tail_) = left;
+        delete right;
+    }
+
+    // Removes separator `index` and the child after it
+    static void remove_child(Inner* inner, size_type index) {
+        std::move(inner->keys.begin() + index + 1, inner->keys.begin() + inner->count,
+                  inner->keys.begin() + index);
+        std::copy(inner->children.begin() + index + 2,
+                  inner->children.begin() + inner->count + 1,
+                  inner->children.begin() + index + 1);
+        --inner->count;
+        inner->keys[inner->count] = K{};
+    }
+
+    // path[depth].node may have fallen under half full
+    void rebalance_inner(const Path& path, size_type depth) {
+        for (;; --depth) {
+            Inner* node = path[depth].node;
+            if (depth == 0) {
+                // The root may run down to a single child, which replaces it
+                if (node->count == 0) {
+                    root_ = node->children[0];
+                    delete node;
+                    --height_;
+                }
+                return;
+            }
+            if (node->count >= min_inner) {
+                return;
+            }
+            const auto [parent, index] = path[depth - 1];
+            auto* left = index > 0 ? static_cast<Inner*>(parent->children[index - 1]) : nullptr;
+            auto* right =
+                index < parent->count ? static_cast<Inner*>(parent->children[index + 1]) : nullptr;
+
+            if (left != nullptr && left->count > min_inner) {
+                // Rotate right through the parent's separator
+                std::move_backward(node->keys.begin(), node->keys.begin() + node->count,
+                                   node->keys.begin() + node->count + 1);
+                std::copy_backward(node->children.begin(),
+                                   node->children.begin() + node->count + 1,
+                                   node->children.begin() + node->count + 2);
+                node->keys[0] = std::move(parent->keys[index - 1]);
+                node->children[0] = left->children[left->count];
+                ++node->count;
+                --left->count;
+                parent->keys[index - 1] = std::move(left->keys[left->count]);
+                return;
+            }
+            if (right != nullptr && right->count > min_inner) {
+                // Rotate left through the parent's separator
+                node->keys[node->count] = std::move(parent->keys[index]);
+                node->children[node->count + 1] = right->children[0];
+                ++node->count;
+                parent->keys[index] = std::move(right->keys[0]);
+                std::move(right->keys.begin() + 1, right->keys.begin() + right->count,
+                          right->keys.begin());
+                std::copy(right->children.begin() + 1,
+                          right->children.begin() + right->count + 1, right->children.begin());
+                --right->count;
+                return;
+            }
+            if (left != nullptr) {
+                merge_inner(left, std::move(parent->keys[index - 1]), node);
+                remove_child(parent, index - 1);
+            } else {
+                merge_inner(node, std::move(parent->keys[index]), right);
+                remove_child(parent, index);
+            }
+        }
+    }
+
+    // Appends the separator and then `right` to `left`, and frees `right`
+    static void merge_inner(Inner* left, K separator, Inner* right) {
+        left->keys[left->count] = std::move(separator);
+        std::move(right->keys.begin(), right->keys.begin() + right->count,
+                  left->keys.begin() + left->count + 1);
+        std::copy(right->children.begin(), right->children.begin() + right->count + 1,
+                  left->children.begin() + left->count + 1);
+        left->count += right->count + 1;
+        delete right;
+    }
+
+    // -------------------------------------------------------------------------
+    // Bulk loading
+    // -------------------------------------------------------------------------
+
+    /**
+     * Builds the tree from sorted, unique elements a level at a time: the
+     * leaves first, then each level of inner nodes over the one below,
+     * until a level has a single node. Each level's n entries are spread
+     * evenly over ceil(n / capacity) nodes, so every node is at least
+     * half full and the nodes of a large tree almost full.
+     */
+    void build(std::vector<value_type> elements) {
+        if (elements.empty()) {
+            return;
+        }
+        std::vector<Node*> level;
+        std::vector<Node*> above;
+        std::vector<K> firsts;  // the smallest key under each node of the level
+        try {
+            const size_type leaves = (elements.size() + leaf_capacity - 1) / leaf_capacity;
+            Leaf* prev = nullptr;
+            size_type next = 0;
+            for (size_type l = 0; l < leaves; ++l) {
+                auto* leaf = new Leaf;
+                level.push_back(leaf);
+                const size_type n = share(elements.size(), leaves, l);
+                for (size_type i = 0; i < n; ++i, ++next) {
+                    leaf->keys[i] = std::move(elements[next].first);
+                    leaf->values[i] = std::move(elements[next].second);
+                }
+                leaf->count = static_cast<std::uint32_t>(n);
+                leaf->prev = prev;
+                (prev != nullptr ? prev->next : head_) = leaf;
+                prev = leaf;
+                firsts.push_back(leaf->keys[0]);
+            }
+            tail_ = prev;
+
+            while (level.size() > 1) {
+                const size_type parents =
+                    (level.size() + inner_capacity) / (inner_capacity + 1);
+                above.clear();
+                std::vector<K> above_firsts;
+                size_type child = 0;
+                for (size_type p = 0; p < parents; ++p) {
+                    auto* inner = new Inner;
+                    above.push_back(inner);
+                    const size_type n = share(level.size(), parents, p);
+                    above_firsts.push_back(std::move(firsts[child]));
+                    inner->children[0] = level[child++];
+                    for (size_type c = 1; c < n; ++c, ++child) {
+                        inner->keys[c - 1] = std::move(firsts[child]);
+                        inner->children[c] = level[child];
+                    }
+                    inner->count = static_cast<std::uint32_t>(n - 1);
+                }
+                level.swap(above);
+                above.clear();
+                firsts = std::move(above_firsts);
+                ++height_;
+            }
+        } catch (...) {
+            // Free what was built: the finished level owns the nodes below
+            // it, and a half-built level above it owns nothing yet
+            for (Node* node : above) {
+                delete static_cast<Inner*>(node);
+            }
+            for (Node* node : level) {
+                destroy(node);
+            }
+            head_ = tail_ = nullptr;
+            height_ = 0;
+            throw;
+        }
+        root_ = level.front();
+        size_ = elements.size();
+    }
+
+    // Entries for node i of `nodes` when `total` are spread evenly
+    [[nodiscard]] static size_type share(size_type total, size_type nodes, size_type i) noexcept {
+        return total / nodes + (i < total % nodes ? 1u : 0u);
+    }
+
+    static void destroy(Node* node) noexcept {
+        if (node == nullptr) {
+            return;
+        }
+        if (node->is_leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        auto* inner = static_cast<Inner*>(node);
+        for (size_type c = 0; c <= inner->count; ++c) {
+            destroy(inner->children[c]);
+        }
+        delete inner;
+    }
+
+    [[nodiscard]] auto pair_less() const {
+        return [this](const value_type& a, const value_type& b) { return comp_(a.first, b.first); };
+    }
+
+    Node* root_ = nullptr;
+    Leaf* head_ = nullptr;
+    Leaf* tail_ = nullptr;
+    size_type size_ = 0;
+    size_type height_ = 0;  // inner levels above the leaves
+    [[no_unique_address]] Compare comp_{};
+};
+
+} // namespace flat
+
+#endif // BTREE_MAP_H
@@ -0,0 +1,1181 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if !defined(FLAT_HASH_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#else
+#define FLAT_HASH_SSE2 0
+#endif
+
+namespace flat {
+
+namespace detail {
+
+// =============================================================================
+// Control bytes
+// =============================================================================
+//
+// Every slot has one control byte: `empty`, or the low 7 bits of the hash
+// of the key stored there ("H2"). A lookup compares H2 against a whole
+// group of control bytes at once and only looks at the slots that match -
+// on average far fewer than one false candidate per lookup.
+
+using ctrl_t = std::int8_t;
+inline constexpr ctrl_t ctrl_empty = -128;  // 0b1000'0000; full bytes are 0..127
+
+/**
+ * The set bits of a group comparison, one per matching control byte.
+ * Shift converts a bit position to a byte index: 0 for SSE2 masks (one
+ * bit per byte), 3 for the portable version (the top bit of each byte).
+ */
+template <typename T, int Shift>
+class BitMask {
+public:
+    explicit BitMask(T bits) noexcept : bits_{bits} {}
+
+    explicit operator bool() const noexcept { return bits_ != 0; }
+
+    [[nodiscard]] std::size_t lowest() const noexcept {
+        return static_cast<std::size_t>(std::countr_zero(bits_)) >> Shift;
+    }
+
+    // Iterates the byte indices of the set bits, lowest first
+    class iterator {
+    public:
+        explicit iterator(T bits) noexcept : bits_{bits} {}
+        std::size_t operator*() const noexcept {
+            return static_cast<std::size_t>(std::countr_zero(bits_)) >> Shift;
+        }
+        iterator& operator++() noexcept {
+            bits_ &= bits_ - 1;
+            return *this;
+        }
+        bool operator==(const iterator&) const = default;
+
+    private:
+        T bits_;
+    };
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator{bits_}; }
+    [[nodiscard]] iterator end() const noexcept { return iterator{0}; }
+
+private:
+    T bits_;
+};
+
+/**
+ * Eight control bytes in a 64-bit word, compared with integer arithmetic
+ * ("SIMD within a register"). Used where SSE2 is unavailable.
+ */
+class PortableGroup {
+public:
+    static constexpr std::size_t width = 8;
+
+    explicit PortableGroup(const ctrl_t* ctrl) noexcept {
+        // Byte by byte, so the result is the same on any endianness;
+        // compilers turn this into a single load
+        for (std::size_t i = 0; i < width; ++i) {
+            bytes_ |= std::uint64_t{static_cast<std::uint8_t>(ctrl[i])} << (8 * i);
+        }
+    }
+
+    // Bytes equal to h2. May report a false match next to a true one,
+    // which costs one extra key comparison and is otherwise harmless.
+    [[nodiscard]] BitMask<std::uint64_t, 3> match(ctrl_t h2) const noexcept {
+        const std::uint64_t x = bytes_ ^ (lsbs * static_cast<std::uint8_t>(h2));
+        return BitMask<std::uint64_t, 3>{(x - lsbs) & ~x & msbs};
+    }
+
+    // Only `empty` has its top bit set
+    [[nodiscard]] BitMask<std::uint64_t, 3> match_empty() const noexcept {
+        return BitMask<std::uint64_t, 3>{bytes_ & msbs};
+    }
+
+    [[nodiscard]] BitMask<std::uint64_t, 3> match_full() const noexcept {
+        return BitMask<std::uint64_t, 3>{~bytes_ & msbs};
+    }
+
+private:
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+    std::uint64_t bytes_ = 0;
+};
+
+#if FLAT_HASH_SSE2
+/**
+ * Sixteen control bytes in an SSE2 register: one compare and one movemask
+ * test a whole group.
+ */
+class Sse2Group {
+public:
+    static constexpr std::size_t width = 16;
+
+    explicit Sse2Group(const ctrl_t* ctrl) noexcept
+        : bytes_{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))} {}
+
+    [[nodiscard]] BitMask<std::uint32_t, 0> match(ctrl_t h2) const noexcept {
+        return mask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes_));
+    }
+
+    [[nodiscard]] BitMask<std::uint32_t, 0> match_empty() const noexcept {
+        return mask(bytes_);
+    }
+
+    [[nodiscard]] BitMask<std::uint32_t, 0> match_full() const noexcept {
+        return BitMask<std::uint32_t, 0>{
+            ~static_cast<std::uint32_t>(_mm_movemask_epi8(bytes_)) & 0xFFFFu};
+    }
+
+private:
+    static BitMask<std::uint32_t, 0> mask(__m128i v) noexcept {
+        return BitMask<std::uint32_t, 0>{static_cast<std::uint32_t>(_mm_movemask_epi8(v))};
+    }
+
+    __m128i bytes_;
+};
+
+using Group = Sse2Group;
+#else
+using Group = PortableGroup;
+#endif
+
+// A group's worth of `empty`, so an unallocated table needs no special case
+// in begin()
+alignas(16) inline constexpr ctrl_t empty_group[16] = {
+    ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+    ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+    ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty};
+
+// std::hash of an integer is often the integer itself; spread its entropy
+// over every bit before taking H1 from the high bits and H2 from the low
+[[nodiscard]] constexpr std::size_t mix(std::size_t h) noexcept {
+    if constexpr (sizeof(std::size_t) == 8) {
+        h *= 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    } else {
+        h *= 0x9E3779B9U;
+        return h ^ (h >> 16);
+    }
+}
+
+[[nodiscard]] constexpr std::size_t h1(std::size_t hash) noexcept { return hash >> 7; }
+[[nodiscard]] constexpr ctrl_t h2(std::size_t hash) noexcept {
+    return static_cast<ctrl_t>(hash & 0x7F);
+}
+
+// A key of another type than K that lookups can take directly: the hasher
+// and the equality both opt in with `is_transparent` and accept it
+template <typename Q, typename K, typename Hash, typename Eq>
+concept heterogeneous_key =
+    !std::same_as<Q, K> &&
+    requires(const Hash& hash, const Eq& eq, const Q& q, const K& k) {
+        typename Hash::is_transparent;
+        typename Eq::is_transparent;
+        { hash(q) } -> std::convertible_to<std::size_t>;
+        { eq(k, q) } -> std::convertible_to<bool>;
+    };
+
+// =============================================================================
+// Slot policies: what a slot holds and how to reach its key
+// =============================================================================
+
+template <typename K, typename V>
+struct MapPolicy {
+    using key_type = K;
+    using value_type = std::pair<const K, V>;
+
+    // Elements are handed out as pair<const K, V>, but the table must move
+    // them when it grows or closes a gap after erase, which a const key
+    // forbids. The slot therefore also holds them as pair<K, V>, and the
+    // table moves through that member.
+    union slot_type {
+        slot_type() {}
+        ~slot_type() {}
+        value_type value;
+        std::pair<K, V> mutable_value;
+    };
+
+    static const K& key(const slot_type& s) noexcept { return s.value.first; }
+    static value_type& element(slot_type& s) noexcept { return s.value; }
+
+    template <typename... Args>
+    static void construct(slot_type* s, Args&&... args) {
+        std::construct_at(&s->mutable_value, std::forward<Args>(args)...);
+    }
+    static void move_construct(slot_type* dst, slot_type* src) {
+        std::construct_at(&dst->mutable_value, std::move(src->mutable_value));
+    }
+    static void copy_construct(slot_type* dst, const slot_type* src) {
+        std::construct_at(&dst->mutable_value, src->value);
+    }
+    static void destroy(slot_type* s) noexcept { std::destroy_at(&s->mutable_value); }
+    // The element moved out, key included; the slot still needs destroy()
+    static std::pair<K, V> take(slot_type* s) { return std::move(s->mutable_value); }
+};
+
+template <typename K>
+struct SetPolicy {
+    using key_type = K;
+    using value_type = K;
+
+    union slot_type {
+        slot_type() {}
+        ~slot_type() {}
+        K value;
+    };
+
+    static const K& key(const slot_type& s) noexcept { return s.value; }
+    static const K& element(slot_type& s) noexcept { return s.value; }
+
+    template <typename... Args>
+    static void construct(slot_type* s, Args&&... args) {
+        std::construct_at(&s->value, std::forward<Args>(args)...);
+    }
+    static void move_construct(slot_type* dst, slot_type* src) {
+        std::construct_at(&dst->value, std::move(src->value));
+    }
+    static void copy_construct(slot_type* dst, const slot_type* src) {
+        std::construct_at(&dst->value, src->value);
+    }
+    static void destroy(slot_type* s) noexcept { std::destroy_at(&s->value); }
+    static K take(slot_type* s) { return std::move(s->value); }
+};
+
+// =============================================================================
+// RawTable
+// =============================================================================
+
+/**
+ * The open-addressing table under FlatHashMap and FlatHashSet.
+ *
+ * Layout: `capacity` slots (a power of two) stored inline, and one control
+ * byte per slot. The first Group::width - 1 control bytes are repeated
+ * after the last one, so a group can be loaded starting at any slot
+ * without wrapping.
+ *
+ * Probing is linear, one group at a time: starting at the slot picked by
+ * the high bits of the hash, each group is checked for control bytes
+ * equal to H2 (candidates, confirmed with the key comparison) and for
+ * empty bytes (the key is absent). Because probing is strictly linear,
+ * erase needs no tombstones: it closes the gap by moving later elements of
+ * the same run back ("backward-shift deletion"), so lookups never wade
+ * through deleted slots and the table never needs a cleanup rehash.
+ */
+template <typename Policy, typename Hash, typename Eq>
+class RawTable {
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using slot_type = typename Policy::slot_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+
+    // Grow once more than 7/8 of the slots are full
+    static constexpr size_type max_load_numerator = 7;
+    static constexpr size_type max_load_denominator = 8;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Policy::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&,
+                                             decltype(Policy::element(std::declval<slot_type&>()))>;
+        using pointer = std::add_pointer_t<reference>;
+
+        basic_iterator() = default;
+
+        // iterator -> const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            : ctrl_{other.ctrl_}, slot_{other.slot_}, end_{other.end_} {}
+
+        reference operator*() const noexcept { return Policy::element(*slot_); }
+        pointer operator->() const noexcept { return std::addressof(**this); }
+
+        basic_iterator& operator++() noexcept {
+            ++ctrl_;
+            ++slot_;
+            skip_empty();
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.ctrl_ == b.ctrl_;
+        }
+
+    private:
+        friend class RawTable;
+        template <bool>
+        friend class basic_iterator;
+
+        basic_iterator(const ctrl_t* ctrl, slot_type* slot, const ctrl_t* end) noexcept
+            : ctrl_{ctrl}, slot_{slot}, end_{end} {}
+
+        // Skips a group of empty slots per step
+        void skip_empty() noexcept {
+            while (ctrl_ < end_) {
+                const auto full = Group{ctrl_}.match_full();
+                const auto remaining = static_cast<std::size_t>(end_ - ctrl_);
+                const std::size_t step = full ? full.lowest() : Group::width;
+                if (step >= remaining) {
+                    break;
+                }
+                ctrl_ += step;
+                slot_ += step;
+                if (full) {
+                    return;
+                }
+            }
+            slot_ += end_ - ctrl_;
+            ctrl_ = end_;
+        }
+
+        const ctrl_t* ctrl_ = nullptr;
+        slot_type* slot_ = nullptr;
+        const ctrl_t* end_ = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // =========================================================================
+    // Construction
+    // =========================================================================
+
+    RawTable() = default;
+
+    explicit RawTable(size_type expected, const Hash& hash = Hash{}, const Eq& eq = Eq{})
+        : hash_{hash}, eq_{eq} {
+        reserve(expected);
+    }
+
+    RawTable(const RawTable& other) : hash_{other.hash_}, eq_{other.eq_} {
+        if (other.size_ == 0) {
+            return;
+        }
+        // Same capacity, same hash: every element keeps its slot
+        allocate(other.capacity_);
+        size_type copied = 0;
+        try {
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (other.ctrl_[i] != ctrl_empty) {
+                    Policy::copy_construct(slots_ + i, other.slots_ + i);
+                    ctrl_[i] = other.ctrl_[i];
+                    ++copied;
+                }
+            }
+        } catch (...) {
+            size_ = copied;
+            destroy_and_deallocate();
+            throw;
+        }
+        std::memcpy(ctrl_, other.ctrl_, capacity_ + Group::width);
+        size_ = other.size_;
+    }
+
+    RawTable(RawTable&& other) noexcept
+        : ctrl_{std::exchange(other.ctrl_, const_cast<ctrl_t*>(empty_group))},
+          slots_{std::exchange(other.slots_, nullptr)},
+          capacity_{std::exchange(other.capacity_, 0)},
+          size_{std::exchange(other.size_, 0)},
+          hash_{std::move(other.hash_)},
+          eq_{std::move(other.eq_)} {}
+
+    RawTable& operator=(const RawTable& other) {
+        if (this != &other) {
+            RawTable copy{other};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    RawTable& operator=(RawTable&& other) noexcept {
+        if (this != &other) {
+            destroy_and_deallocate();
+            ctrl_ = std::exchange(other.ctrl_, const_cast<ctrl_t*>(empty_group));
+            slots_ = std::exchange(other.slots_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            size_ = std::exchange(other.size_, 0);
+            hash_ = std::move(other.hash_);
+            eq_ = std::move(other.eq_);
+        }
+        return *this;
+    }
+
+    ~RawTable() { destroy_and_deallocate(); }
+
+    void swap(RawTable& other) noexcept {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+    }
+
+    // =========================================================================
+    // Iterators and capacity
+    // =========================================================================
+
+    [[nodiscard]] iterator begin() noexcept {
+        iterator it{ctrl_, slots_, ctrl_ + capacity_};
+        it.skip_empty();
+        return it;
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_cast<RawTable*>(this)->begin();
+    }
+    [[nodiscard]] iterator end() noexcept {
+        return iterator{ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_};
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_cast<RawTable*>(this)->end();
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] size_type capacity() const noexcept { return capacity_; }
+    [[nodiscard]] float load_factor() const noexcept {
+        return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+    [[nodiscard]] static constexpr float max_load_factor() noexcept {
+        return static_cast<float>(max_load_numerator) / static_cast<float>(max_load_denominator);
+    }
+
+    [[nodiscard]] hasher hash_function() const { return hash_; }
+    [[nodiscard]] key_equal key_eq() const { return eq_; }
+
+    // Makes room for `n` elements without further rehashing
+    void reserve(size_type n) {
+        if (n > growth_limit(capacity_)) {
+            rehash(capacity_for(n));
+        }
+    }
+
+    void clear() noexcept {
+        destroy_elements();
+        mark_all_empty();
+    }
+
+    // =========================================================================
+    // Lookup
+    // =========================================================================
+
+    template <typename K>
+    [[nodiscard]] iterator find(const K& key) {
+        const size_type i = find_index(key);
+        return i == npos ? end() : iterator_at(i);
+    }
+
+    template <typename K>
+    [[nodiscard]] const_iterator find(const K& key) const {
+        return const_cast<RawTable*>(this)->find(key);
+    }
+
+    template <typename K>
+    [[nodiscard]] bool contains(const K& key) const {
+        return find_index(key) != npos;
+    }
+
+    // =========================================================================
+    // Modifiers
+    // =========================================================================
+
+    /**
+     * Finds `key`, or constructs an element from `args` in the slot it
+     * belongs in. Returns the element and whether it was inserted.
+     */
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> find_or_emplace(const K& key, Args&&... args) {
+        const size_type hash = hash_of(key);
+        if (capacity_ != 0) {
+            if (const size_type i = find_index(key, hash); i != npos) {
+                return {iterator_at(i), false};
+            }
+        }
+        if (size_ + 1 > growth_limit(capacity_)) {
+            rehash(capacity_for(size_ + 1));
+        }
+        const size_type i = first_empty(hash);
+        Policy::construct(slots_ + i, std::forward<Args>(args)...);
+        set_ctrl(i, h2(hash));
+        ++size_;
+        return {iterator_at(i), true};
+    }
+
+    template <typename K>
+    size_type erase_key(const K& key) {
+        const size_type i = find_index(key);
+        if (i == npos) {
+            return 0;
+        }
+        erase_at(i);
+        return 1;
+    }
+
+    void erase(const_iterator pos) {
+        erase_at(static_cast<size_type>(pos.ctrl_ - ctrl_));
+    }
+
+    // Moves the element at pos out of the table, and erases its slot
+    auto take(const_iterator pos) {
+        const auto i = static_cast<size_type>(pos.ctrl_ - ctrl_);
+        auto element = Policy::take(slots_ + i);
+        erase_at(i);
+        return element;
+    }
+
+    /**
+     * Moves every element out, in slot order, passing each to f, and leaves
+     * the table empty. Nothing is erased one by one, so no gap is closed;
+     * take(begin()) in a loop would also rescan the emptied front of the
+     * table every time. If f throws, the elements it has not been given
+     * are destroyed.
+     */
+    template <typename F>
+    void take_all(F f) {
+        size_type i = 0;
+        try {
+            for (; i < capacity_; ++i) {
+                if (ctrl_[i] != ctrl_empty) {
+                    f(Policy::take(slots_ + i));
+                    Policy::destroy(slots_ + i);
+                }
+            }
+        } catch (...) {
+            for (; i < capacity_; ++i) {
+                if (ctrl_[i] != ctrl_empty) {
+                    Policy::destroy(slots_ + i);
+                }
+            }
+            mark_all_empty();
+            throw;
+        }
+        mark_all_empty();
+    }
+
+    /**
+     * Erases every element for which pred(element) is true; returns how
+     * many. The scan starts just after an empty slot: runs of full slots
+     * then never cross the starting point, so the elements that erase
+     * moves back into a gap are always ones the scan has yet to see.
+     */
+    template <typename Pred>
+    size_type erase_if(Pred pred) {
+        if (size_ == 0) {
+            return 0;
+        }
+        size_type start = 0;
+        while (ctrl_[start] != ctrl_empty) {
+            ++start;
+        }
+        const size_type before = size_;
+        size_type i = (start + 1) & mask();
+        for (size_type visited = 0; visited < capacity_; ++visited) {
+            // erase_at() may refill slot i; check it again before moving on
+            while (ctrl_[i] != ctrl_empty && pred(std::as_const(Policy::element(slots_[i])))) {
+                erase_at(i);
+            }
+            i = (i + 1) & mask();
+        }
+        return before - size_;
+    }
+
+    template <typename K>
+    [[nodiscard]] size_type hash_of(const K& key) const {
+        return mix(static_cast<size_type>(hash_(key)));
+    }
+
+private:
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    [[nodiscard]] size_type mask() const noexcept { return capacity_ - 1; }
+
+    // Every slot empty, once its element is destroyed or moved out
+    void mark_all_empty() noexcept {
+        if (capacity_ != 0) {
+            std::memset(ctrl_, static_cast<std::uint8_t>(ctrl_empty), capacity_ + Group::width);
+        }
+        size_ = 0;
+    }
+
+    [[nodiscard]] static constexpr size_type growth_limit(size_type capacity) noexcept {
+        return capacity / max_load_denominator * max_load_numerator;
+    }
+
+    [[nodiscard]] static size_type capacity_for(size_type n) noexcept {
+        size_type capacity = std::max<size_type>(Group::width, max_load_denominator);
+        while (growth_limit(capacity) < n) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    [[nodiscard]] iterator iterator_at(size_type i) noexcept {
+        return iterator{ctrl_ + i, slots_ + i, ctrl_ + capacity_};
+    }
+
+    void set_ctrl(size_type i, ctrl_t c) noexcept {
+        ctrl_[i] = c;
+        if (i < Group::width - 1) {
+            ctrl_[capacity_ + i] = c;  // the cloned copy
+        }
+    }
+
+    template <typename K>
+    [[nodiscard]] size_type find_index(const K& key) const {
+        return capacity_ == 0 ? npos : find_index(key, hash_of(key));
+    }
+
+    template <typename K>
+    [[nodiscard]] size_type find_index(const K& key, size_type hash) const {
+        size_type pos = h1(hash) & mask();
+        const ctrl_t tag = h2(hash);
+        while (true) {
+            const Group group{ctrl_ + pos};
+            for (const std::size_t offset : group.match(tag)) {
+                const size_type i = (pos + offset) & mask();
+                if (eq_(Policy::key(slots_[i]), key)) {
+                    return i;
+                }
+            }
+            if (group.match_empty()) {
+                return npos;
+            }
+            pos = (pos + Group::width) & mask();
+        }
+    }
+
+    // The first empty slot at or after the key's home; the load limit
+    // guarantees there is one
+    [[nodiscard]] size_type first_empty(size_type hash) const noexcept {
+        size_type pos = h1(hash) & mask();
+        while (true) {
+            if (const auto empties = Group{ctrl_ + pos}.match_empty()) {
+                return (pos + empties.lowest()) & mask();
+            }
+            pos = (pos + Group::width) & mask();
+        }
+    }
+
+    /**
+     * Backward-shift deletion. Linear probing keeps every element in the
+     * unbroken run of full slots that starts at its home slot, so the gap
+     * left at `i` would hide any later element of the run whose home is at
+     * or before `i`. Walk the rest of the run and move each such element
+     * into the gap, which moves the gap to where that element was.
+     */
+    void erase_at(size_type i) {
+        Policy::destroy(slots_ + i);
+        --size_;
+        size_type gap = i;
+        for (size_type j = (i + 1) & mask(); ctrl_[j] != ctrl_empty; j = (j + 1) & mask()) {
+            const size_type home = h1(hash_of(Policy::key(slots_[j]))) & mask();
+            // Stays put unless its home lies outside (gap, j]
+            if (((j - home) & mask()) >= ((j - gap) & mask())) {
+                Policy::move_construct(slots_ + gap, slots_ + j);
+                Policy::destroy(slots_ + j);
+                set_ctrl(gap, ctrl_[j]);
+                gap = j;
+            }
+        }
+        set_ctrl(gap, ctrl_empty);
+    }
+
+    void allocate(size_type capacity) {
+        // capacity_ + width - 1 control bytes are used; one more keeps the
+        // block a multiple of the group size
+        ctrl_ = new ctrl_t[capacity + Group::width];
+        try {
+            slots_ = std::allocator<slot_type>{}.allocate(capacity);
+        } catch (...) {
+            delete[] ctrl_;
+            ctrl_ = const_cast<ctrl_t*>(empty_group);
+            throw;
+        }
+        std::memset(ctrl_, static_cast<std::uint8_t>(ctrl_empty), capacity + Group::width);
+        capacity_ = capacity;
+    }
+
+    // Moves every element into a new table of `new_capacity` slots. If the
+    // allocation fails, the table is left as it was.
+    void rehash(size_type new_capacity) {
+        RawTable fresh{0, hash_, eq_};
+        fresh.allocate(new_capacity);
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] != ctrl_empty) {
+                const size_type hash = hash_of(Policy::key(slots_[i]));
+                const size_type j = fresh.first_empty(hash);
+                Policy::move_construct(fresh.slots_ + j, slots_ + i);
+                fresh.set_ctrl(j, h2(hash));
+                ++fresh.size_;
+            }
+        }
+        swap(fresh);  // `fresh` now destroys the moved-from elements
+    }
+
+    void destroy_elements() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < capacity_ && size_ != 0; ++i) {
+                if (ctrl_[i] != ctrl_empty) {
+                    Policy::destroy(slots_ + i);
+                }
+            }
+        }
+    }
+
+    void destroy_and_deallocate() noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        destroy_elements();
+        std::allocator<slot_type>{}.deallocate(slots_, capacity_);
+        delete[] ctrl_;
+        ctrl_ = const_cast<ctrl_t*>(empty_group);
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+    }
+
+    ctrl_t* ctrl_ = const_cast<ctrl_t*>(empty_group);  // never written while capacity_ == 0
+    slot_type* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    [[no_unique_address]] Hash hash_{};
+    [[no_unique_address]] Eq eq_{};
+};
+
+} // namespace detail
+
+// =============================================================================
+// FlatHashMap
+// =============================================================================
+
+/**
+ * A hash map that stores its elements inline in one array, SwissTable
+ * style, instead of in a node per element like std::unordered_map.
+ *
+ * A lookup hashes once, loads a group of 16 control bytes (8 without
+ * SSE2) and compares them all with one instruction; usually the first
+ * candidate is the key, so a hit costs about one cache miss for the
+ * control bytes and one for the slot. Inserts allocate only when the table
+ * grows.
+ *
+ * Differences from std::unordered_map:
+ * - Inserting may move elements: any rehash invalidates every iterator,
+ *   pointer and reference. So can erase, which closes the gap by moving
+ *   later elements back - use erase_if() to erase while iterating.
+ * - erase(iterator) returns nothing.
+ * - A node_type from extract() holds the element itself, not a heap node,
+ *   and extract_all() takes every element out in one pass.
+ * - No bucket interface.
+ *
+ * With a Hash and KeyEqual that both declare `is_transparent`, find(),
+ * contains(), count(), at() and erase() accept any key type they can hash
+ * and compare, e.g. std::string_view for a std::string key - without
+ * constructing a key.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class FlatHashMap {
+    using Table = detail::RawTable<detail::MapPolicy<K, V>, Hash, KeyEqual>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename Table::iterator;
+    using const_iterator = typename Table::const_iterator;
+
+    /**
+     * An element taken out of the map by extract(). Its key is not const,
+     * as the key of an element in the map is, so it can be moved on into
+     * another map instead of copied.
+     */
+    class node_type {
+    public:
+        node_type() = default;
+
+        [[nodiscard]] bool empty() const noexcept { return !element_.has_value(); }
+        explicit operator bool() const noexcept { return element_.has_value(); }
+
+        [[nodiscard]] K& key() noexcept { return element_->first; }
+        [[nodiscard]] V& mapped() noexcept { return element_->second; }
+
+    private:
+        friend class FlatHashMap;
+
+        explicit node_type(std::pair<K, V>&& element) : element_{std::move(element)} {}
+
+        std::optional<std::pair<K, V>> element_;
+    };
+
+    // =========================================================================
+    // Construction
+    // =========================================================================
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(size_type expected, const Hash& hash = Hash{},
+                         const KeyEqual& eq = KeyEqual{})
+        : table_{expected, hash, eq} {}
+
+    template <std::input_iterator It>
+    FlatHashMap(It first, It last, size_type expected = 0) : table_{expected} {
+        insert(first, last);
+    }
+
+    FlatHashMap(std::initializer_list<value_type> init) : table_{init.size()} {
+        insert(init.begin(), init.end());
+    }
+
+    // =========================================================================
+    // Iterators and capacity
+    // =========================================================================
+
+    [[nodiscard]] iterator begin() noexcept { return table_.begin(); }
+    [[nodiscard]] const_iterator begin() const noexcept { return table_.begin(); }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return table_.begin(); }
+    [[nodiscard]] iterator end() noexcept { return table_.end(); }
+    [[nodiscard]] const_iterator end() const noexcept { return table_.end(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return table_.end(); }
+
+    [[nodiscard]] bool empty() const noexcept { return table_.empty(); }
+    [[nodiscard]] size_type size() const noexcept { return table_.size(); }
+    [[nodiscard]] size_type capacity() const noexcept { return table_.capacity(); }
+    [[nodiscard]] float load_factor() const noexcept { return table_.load_factor(); }
+    [[nodiscard]] static constexpr float max_load_factor() noexcept {
+        return Table::max_load_factor();
+    }
+    void reserve(size_type n) { table_.reserve(n); }
+
+    [[nodiscard]] hasher hash_function() const { return table_.hash_function(); }
+    [[nodiscard]] key_equal key_eq() const { return table_.key_eq(); }
+
+    // =========================================================================
+    // Lookup
+    // =========================================================================
+
+    [[nodiscard]] iterator find(const K& key) { return table_.find(key); }
+    [[nodiscard]] const_iterator find(const K& key) const { return table_.find(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] iterator find(const Q& key) {
+        return table_.find(key);
+    }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] const_iterator find(const Q& key) const {
+        return table_.find(key);
+    }
+
+    [[nodiscard]] bool contains(const K& key) const { return table_.contains(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] bool contains(const Q& key) const {
+        return table_.contains(key);
+    }
+
+    [[nodiscard]] size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] size_type count(const Q& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    [[nodiscard]] V& at(const K& key) { return at_impl(*this, key); }
+    [[nodiscard]] const V& at(const K& key) const { return at_impl(*this, key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] V& at(const Q& key) {
+        return at_impl(*this, key);
+    }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] const V& at(const Q& key) const {
+        return at_impl(*this, key);
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+    V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+    // =========================================================================
+    // Modifiers
+    // =========================================================================
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return table_.find_or_emplace(value.first, value);
+    }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return table_.find_or_emplace(value.first, std::move(value));
+    }
+
+    template <std::input_iterator It>
+    void insert(It first, It last) {
+        if constexpr (std::forward_iterator<It>) {
+            table_.reserve(size() + static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return table_.find_or_emplace(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return table_.find_or_emplace(key, std::piecewise_construct,
+                                      std::forward_as_tuple(std::move(key)),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // Constructs the element first, to learn its key
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        std::pair<K, V> element(std::forward<Args>(args)...);
+        return table_.find_or_emplace(element.first, std::move(element));
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& value) {
+        auto result = try_emplace(std::move(key), std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    size_type erase(const K& key) { return table_.erase_key(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    size_type erase(const Q& key) {
+        return table_.erase_key(key);
+    }
+
+    // Invalidates every iterator; see the class comment
+    void erase(const_iterator pos) { table_.erase(pos); }
+    void erase(iterator pos) { table_.erase(pos); }
+
+    // Takes the element out of the map, erasing it; invalidates every
+    // iterator, as erase() does. By key, an empty node if it is absent.
+    [[nodiscard]] node_type extract(const_iterator pos) { return node_type{table_.take(pos)}; }
+    [[nodiscard]] node_type extract(iterator pos) { return node_type{table_.take(pos)}; }
+    [[nodiscard]] node_type extract(const K& key) { return extract_impl(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] node_type extract(const Q& key) {
+        return extract_impl(key);
+    }
+
+    // Takes every element out, passing each to f as a node_type&&, and
+    // leaves the map empty: one pass over the table
+    template <typename F>
+    void extract_all(F f) {
+        table_.take_all([&f](std::pair<K, V>&& element) { f(node_type{std::move(element)}); });
+    }
+
+    void clear() noexcept { table_.clear(); }
+    void swap(FlatHashMap& other) noexcept { table_.swap(other.table_); }
+
+    template <typename Pred>
+    friend size_type erase_if(FlatHashMap& map, Pred pred) {
+        return map.table_.erase_if(pred);
+    }
+
+    friend bool operator==(const FlatHashMap& a, const FlatHashMap& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        return std::all_of(a.begin(), a.end(), [&b](const value_type& element) {
+            const auto it = b.find(element.first);
+            return it != b.end() && it->second == element.second;
+        });
+    }
+
+private:
+    template <typename Q>
+    node_type extract_impl(const Q& key) {
+        const auto it = table_.find(key);
+        return it == table_.end() ? node_type{} : extract(it);
+    }
+
+    template <typename Self, typename Q>
+    static auto& at_impl(Self& self, const Q& key) {
+        const auto it = self.table_.find(key);
+        if (it == self.table_.end()) {
+            throw std::out_of_range{"FlatHashMap::at: key not found"};
+        }
+        return it->second;
+    }
+
+    Table table_;
+};
+
+// =============================================================================
+// FlatHashSet
+// =============================================================================
+
+/**
+ * The set counterpart of FlatHashMap, with the same layout, guarantees
+ * and heterogeneous lookup. Elements are immutable through iterators.
+ */
+template <typename K, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatHashSet {
+    using Table = detail::RawTable<detail::SetPolicy<K>, Hash, KeyEqual>;
+
+public:
+    using key_type = K;
+    using value_type = K;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = const K&;
+    using const_reference = const K&;
+    using iterator = typename Table::const_iterator;
+    using const_iterator = typename Table::const_iterator;
+
+    FlatHashSet() = default;
+
+    explicit FlatHashSet(size_type expected, const Hash& hash = Hash{},
+                         const KeyEqual& eq = KeyEqual{})
+        : table_{expected, hash, eq} {}
+
+    template <std::input_iterator It>
+    FlatHashSet(It first, It last, size_type expected = 0) : table_{expected} {
+        insert(first, last);
+    }
+
+    FlatHashSet(std::initializer_list<K> init) : table_{init.size()} {
+        insert(init.begin(), init.end());
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return table_.begin(); }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return table_.begin(); }
+    [[nodiscard]] const_iterator end() const noexcept { return table_.end(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return table_.end(); }
+
+    [[nodiscard]] bool empty() const noexcept { return table_.empty(); }
+    [[nodiscard]] size_type size() const noexcept { return table_.size(); }
+    [[nodiscard]] size_type capacity() const noexcept { return table_.capacity(); }
+    [[nodiscard]] float load_factor() const noexcept { return table_.load_factor(); }
+    [[nodiscard]] static constexpr float max_load_factor() noexcept {
+        return Table::max_load_factor();
+    }
+    void reserve(size_type n) { table_.reserve(n); }
+
+    [[nodiscard]] hasher hash_function() const { return table_.hash_function(); }
+    [[nodiscard]] key_equal key_eq() const { return table_.key_eq(); }
+
+    [[nodiscard]] const_iterator find(const K& key) const { return table_.find(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] const_iterator find(const Q& key) const {
+        return table_.find(key);
+    }
+
+    [[nodiscard]] bool contains(const K& key) const { return table_.contains(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] bool contains(const Q& key) const {
+        return table_.contains(key);
+    }
+
+    [[nodiscard]] size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    [[nodiscard]] size_type count(const Q& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    std::pair<const_iterator, bool> insert(const K& key) {
+        return table_.find_or_emplace(key, key);
+    }
+    std::pair<const_iterator, bool> insert(K&& key) {
+        return table_.find_or_emplace(key, std::move(key));
+    }
+
+    template <std::input_iterator It>
+    void insert(It first, It last) {
+        if constexpr (std::forward_iterator<It>) {
+            table_.reserve(size() + static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<K> init) { insert(init.begin(), init.end()); }
+
+    template <typename... Args>
+    std::pair<const_iterator, bool> emplace(Args&&... args) {
+        K key(std::forward<Args>(args)...);
+        return table_.find_or_emplace(key, std::move(key));
+    }
+
+    size_type erase(const K& key) { return table_.erase_key(key); }
+    template <detail::heterogeneous_key<K, Hash, KeyEqual> Q>
+    size_type erase(const Q& key) {
+        return table_.erase_key(key);
+    }
+
+    // Invalidates every iterator; see FlatHashMap
+    void erase(const_iterator pos) { table_.erase(pos); }
+
+    void clear() noexcept { table_.clear(); }
+    void swap(FlatHashSet& other) noexcept { table_.swap(other.table_); }
+
+    template <typename Pred>
+    friend size_type erase_if(FlatHashSet& set, Pred pred) {
+        return set.table_.erase_if(pred);
+    }
+
+    friend bool operator==(const FlatHashSet& a, const FlatHashSet& b) {
+        return a.size() == b.size() &&
+               std::all_of(a.begin(), a.end(), [&b](const K& key) { return b.contains(key); });
+    }
+
+private:
+    Table table_;
+};
+
+} // namespace flat
+
+#endif // FLAT_HASH_MAP_H
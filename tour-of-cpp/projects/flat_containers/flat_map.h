@@ -0,0 +1,802 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flat {
+
+// Tags for constructors that take containers already in order: the keys
+// are sorted and (for sorted_unique) free of duplicates, so nothing is
+// sorted again
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+struct sorted_equivalent_t {
+    explicit sorted_equivalent_t() = default;
+};
+inline constexpr sorted_equivalent_t sorted_equivalent{};
+
+namespace detail {
+
+/**
+ * The first index in [0, n) whose element fails pred, for elements
+ * partitioned by pred (all true, then all false).
+ *
+ * std::lower_bound branches on each comparison, and a binary search
+ * mispredicts about half of those branches. This version always halves
+ * the range and picks the half with a conditional move, so the loop runs
+ * exactly log2(n) times and never mispredicts. Both possible next
+ * midpoints are prefetched while the comparison is pending.
+ */
+template <typename T, typename Pred>
+[[nodiscard]] std::size_t branchless_partition_point(const T* base, std::size_t n, Pred pred) {
+    if (n == 0) {
+        return 0;
+    }
+    const T* first = base;
+    while (n > 1) {
+        const std::size_t half = n / 2;
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(first + half / 2);
+        __builtin_prefetch(first + half + half / 2);
+#endif
+        first = pred(first[half]) ? first + half : first;
+        n -= half;
+    }
+    return static_cast<std::size_t>(first - base) + (pred(*first) ? 1 : 0);
+}
+
+// A key of another type than K that lookups can take directly: the
+// comparison opts in with `is_transparent` and orders it against K
+template <typename Q, typename K, typename Compare>
+concept transparent_key =
+    !std::same_as<Q, K> &&
+    requires(const Compare& comp, const Q& q, const K& k) {
+        typename Compare::is_transparent;
+        { comp(k, q) } -> std::convertible_to<bool>;
+        { comp(q, k) } -> std::convertible_to<bool>;
+    };
+
+} // namespace detail
+
+/**
+ * An ordered map kept as two sorted arrays: all the keys in one
+ * std::vector, all the values in another, at the same positions.
+ *
+ *     FlatMap<std::string, int> ages{{"bob", 42}, {"alice", 37}};
+ *     ages.at("alice");          // binary search over the keys alone
+ *     for (const auto& [name, age] : ages) { ... }   // in key order
+ *
+ * Compared to std::map there are no nodes, no pointers and no per-element
+ * allocation, and a lookup touches only the key array. The price is O(n)
+ * insert and erase: FlatMap is for tables that are built once (or in
+ * bulk) and then mostly read.
+ *
+ * Multi selects between unique keys (FlatMap) and repeated keys
+ * (FlatMultimap); equal keys keep their insertion order.
+ */
+template <typename K, typename V, typename Compare, bool Multi>
+class BasicFlatMap {
+    static_assert(!std::is_same_v<V, bool>,
+                  "std::vector<bool> has no data(); use a FlatMap of char instead");
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using reference = std::pair<const K&, V&>;
+    using const_reference = std::pair<const K&, const V&>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_container_type = std::vector<K>;
+    using mapped_container_type = std::vector<V>;
+
+    struct containers {
+        key_container_type keys;
+        mapped_container_type values;
+    };
+
+    /**
+     * Walks both arrays in step. Dereferencing yields a pair of references
+     * rather than a reference to a pair, which is what lets the keys and
+     * values live apart: `it->second = x` and `auto& [k, v] = *it` work,
+     * but `value_type& p = *it` does not.
+     */
+    template <bool Const>
+    class basic_iterator {
+        using value_pointer = std::conditional_t<Const, const V*, V*>;
+
+    public:
+        // Random access for the classic algorithms too, as for the proxy
+        // iterators of std::vector<bool>
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const_reference, BasicFlatMap::reference>;
+
+        // Holds the pair of references, so operator-> has something to point to
+        class pointer {
+        public:
+            reference* operator->() noexcept { return &ref_; }
+
+        private:
+            friend class basic_iterator;
+            explicit pointer(reference ref) noexcept : ref_{ref} {}
+            reference ref_;
+        };
+
+        basic_iterator() = default;
+
+        // iterator converts to const_iterator
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            : key_{other.key_}, value_{other.value_} {}
+
+        reference operator*() const noexcept { return {*key_, *value_}; }
+        pointer operator->() const noexcept { return pointer{**this}; }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        basic_iterator& operator++() noexcept {
+            ++key_;
+            ++value_;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+        basic_iterator& operator--() noexcept {
+            --key_;
+            --value_;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+        basic_iterator& operator+=(difference_type n) noexcept {
+            key_ += n;
+            value_ += n;
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+        friend difference_type operator-(const basic_iterator& a,
+                                         const basic_iterator& b) noexcept {
+            return a.key_ - b.key_;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.key_ == b.key_;
+        }
+        friend std::strong_ordering operator<=>(const basic_iterator& a,
+                                                const basic_iterator& b) noexcept {
+            return a.key_ <=> b.key_;
+        }
+
+    private:
+        friend class BasicFlatMap;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(const K* key, value_pointer value) noexcept : key_{key}, value_{value} {}
+
+        const K* key_ = nullptr;
+        value_pointer value_ = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // =========================================================================
+    // Construction
+    // =========================================================================
+
+    BasicFlatMap() = default;
+
+    explicit BasicFlatMap(const Compare& comp) : comp_{comp} {}
+
+    /**
+     * Takes over the two containers, then sorts them by key once. Keys
+     * that compare equal keep their order; a FlatMap keeps the first of
+     * them. Throws std::invalid_argument if the sizes differ.
+     */
+    BasicFlatMap(key_container_type keys, mapped_container_type values,
+                 const Compare& comp = Compare{})
+        : keys_{std::move(keys)}, values_{std::move(values)}, comp_{comp} {
+        check_sizes(keys_, values_);
+        sort_and_dedup();
+    }
+
+    // Containers already sorted by key (and, for FlatMap, unique) are
+    // taken as they are
+    BasicFlatMap(sorted_unique_t, key_container_type keys, mapped_container_type values,
+                 const Compare& comp = Compare{})
+        requires(!Multi)
+        : keys_{std::move(keys)}, values_{std::move(values)}, comp_{comp} {
+        check_sizes(keys_, values_);
+    }
+
+    BasicFlatMap(sorted_equivalent_t, key_container_type keys, mapped_container_type values,
+                 const Compare& comp = Compare{})
+        requires Multi
+        : keys_{std::move(keys)}, values_{std::move(values)}, comp_{comp} {
+        check_sizes(keys_, values_);
+    }
+
+    template <std::input_iterator It>
+    BasicFlatMap(It first, It last, const Compare& comp = Compare{}) : comp_{comp} {
+        append(first, last);
+        sort_and_dedup();
+    }
+
+    BasicFlatMap(std::initializer_list<value_type> init, const Compare& comp = Compare{})
+        : BasicFlatMap(init.begin(), init.end(), comp) {}
+
+    // =========================================================================
+    // Iterators and capacity
+    // =========================================================================
+
+    [[nodiscard]] iterator begin() noexcept { return at_index(0); }
+    [[nodiscard]] const_iterator begin() const noexcept { return at_index(0); }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] iterator end() noexcept { return at_index(size()); }
+    [[nodiscard]] const_iterator end() const noexcept { return at_index(size()); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator{end()};
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator{begin()};
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+    [[nodiscard]] size_type size() const noexcept { return keys_.size(); }
+    [[nodiscard]] size_type capacity() const noexcept { return keys_.capacity(); }
+
+    void reserve(size_type n) {
+        keys_.reserve(n);
+        values_.reserve(n);
+    }
+
+    void shrink_to_fit() {
+        keys_.shrink_to_fit();
+        values_.shrink_to_fit();
+    }
+
+    // The underlying arrays, in key order
+    [[nodiscard]] const key_container_type& keys() const noexcept { return keys_; }
+    [[nodiscard]] const mapped_container_type& values() const noexcept { return values_; }
+
+    [[nodiscard]] key_compare key_comp() const { return comp_; }
+
+    // =========================================================================
+    // Lookup
+    // =========================================================================
+    //
+    // Each lookup comes twice: for key_type, and for any other type the
+    // comparison accepts when it is transparent (std::less<> for example).
+
+    [[nodiscard]] iterator lower_bound(const key_type& key) { return at_index(lower_index(key)); }
+    [[nodiscard]] const_iterator lower_bound(const key_type& key) const {
+        return at_index(lower_index(key));
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] iterator lower_bound(const Q& key) {
+        return at_index(lower_index(key));
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const_iterator lower_bound(const Q& key) const {
+        return at_index(lower_index(key));
+    }
+
+    [[nodiscard]] iterator upper_bound(const key_type& key) { return at_index(upper_index(key)); }
+    [[nodiscard]] const_iterator upper_bound(const key_type& key) const {
+        return at_index(upper_index(key));
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] iterator upper_bound(const Q& key) {
+        return at_index(upper_index(key));
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const_iterator upper_bound(const Q& key) const {
+        return at_index(upper_index(key));
+    }
+
+    [[nodiscard]] std::pair<iterator, iterator> equal_range(const key_type& key) {
+        const auto [lo, hi] = equal_indices(key);
+        return {at_index(lo), at_index(hi)};
+    }
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& key) const {
+        const auto [lo, hi] = equal_indices(key);
+        return {at_index(lo), at_index(hi)};
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] std::pair<iterator, iterator> equal_range(const Q& key) {
+        const auto [lo, hi] = equal_indices(key);
+        return {at_index(lo), at_index(hi)};
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const Q& key) const {
+        const auto [lo, hi] = equal_indices(key);
+        return {at_index(lo), at_index(hi)};
+    }
+
+    // For a FlatMultimap, the first of the equal keys
+    [[nodiscard]] iterator find(const key_type& key) { return at_index(find_index(key)); }
+    [[nodiscard]] const_iterator find(const key_type& key) const {
+        return at_index(find_index(key));
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] iterator find(const Q& key) {
+        return at_index(find_index(key));
+    }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] const_iterator find(const Q& key) const {
+        return at_index(find_index(key));
+    }
+
+    [[nodiscard]] bool contains(const key_type& key) const { return find_index(key) != size(); }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] bool contains(const Q& key) const {
+        return find_index(key) != size();
+    }
+
+    [[nodiscard]] size_type count(const key_type& key) const { return count_of(key); }
+    template <detail::transparent_key<K, Compare> Q>
+    [[nodiscard]] size_type count(const Q& key) const {
+        return count_of(key);
+    }
+
+    [[nodiscard]] V& at(const key_type& key)
+        requires(!Multi)
+    {
+        return values_[checked_index(key)];
+    }
+    [[nodiscard]] const V& at(const key_type& key) const
+        requires(!Multi)
+    {
+        return values_[checked_index(key)];
+    }
+    template <detail::transparent_key<K, Compare> Q>
+        requires(!Multi)
+    [[nodiscard]] V& at(const Q& key) {
+        return values_[checked_index(key)];
+    }
+    template <detail::transparent_key<K, Compare> Q>
+        requires(!Multi)
+    [[nodiscard]] const V& at(const Q& key) const {
+        return values_[checked_index(key)];
+    }
+
+    V& operator[](const key_type& key)
+        requires(!Multi)
+    {
+        return try_emplace(key).first->second;
+    }
+    V& operator[](key_type&& key)
+        requires(!Multi)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    // =========================================================================
+    // Modifiers
+    // =========================================================================
+    //
+    // A single insert or erase shifts every later element of both arrays,
+    // and invalidates all iterators. Prefer the bulk insert(first, last)
+    // for more than a handful of elements.
+
+    /**
+     * FlatMap: inserts unless the key is present, returning the element
+     * and whether it was inserted. FlatMultimap: always inserts, after any
+     * equal keys, and returns the new element.
+     */
+    auto insert(const value_type& value) { return emplace_at(value.first, value.second); }
+    auto insert(value_type&& value) {
+        return emplace_at(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename... Args>
+        requires std::constructible_from<value_type, Args&&...>
+    auto emplace(Args&&... args) {
+        value_type value(std::forward<Args>(args)...);
+        return emplace_at(std::move(value.first), std::move(value.second));
+    }
+
+    // Constructs the value in place only if the key is absent
+    template <typename... Args>
+        requires(!Multi)
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return emplace_at(key, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+        requires(!Multi)
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return emplace_at(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename M>
+        requires(!Multi)
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    /**
+     * Bulk insert: appends the new elements, sorts only them, and merges
+     * the two sorted runs in one pass - O(n + m log m) instead of the
+     * O(n * m) of inserting them one at a time. A FlatMap keeps its
+     * existing value for a key it already holds, and the first of any
+     * repeated new key.
+     */
+    template <std::input_iterator It>
+    void insert(It first, It last) {
+        const size_type old_size = size();
+        append(first, last);
+        if (size() == old_size) {
+            return;
+        }
+        if (old_size == 0) {
+            sort_and_dedup();
+            return;
+        }
+        sort_tail_and_merge(old_size);
+    }
+
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    // Returns the iterator after the erased element
+    iterator erase(const_iterator pos) {
+        const auto i = index_of(pos);
+        keys_.erase(keys_.begin() + i);
+        values_.erase(values_.begin() + i);
+        return at_index(static_cast<size_type>(i));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const auto lo = index_of(first);
+        const auto hi = index_of(last);
+        keys_.erase(keys_.begin() + lo, keys_.begin() + hi);
+        values_.erase(values_.begin() + lo, values_.begin() + hi);
+        return at_index(static_cast<size_type>(lo));
+    }
+
+    // Erases every element with this key; returns how many
+    size_type erase(const key_type& key) { return erase_key(key); }
+    template <detail::transparent_key<K, Compare> Q>
+    size_type erase(const Q& key) {
+        return erase_key(key);
+    }
+
+    void clear() noexcept {
+        keys_.clear();
+        values_.clear();
+    }
+
+    // Hands over the arrays and leaves the map empty
+    [[nodiscard]] containers extract() && {
+        containers out{std::move(keys_), std::move(values_)};
+        clear();
+        return out;
+    }
+
+    // Replaces the contents with arrays that are already in order, as for
+    // the sorted_unique / sorted_equivalent constructors
+    void replace(key_container_type keys, mapped_container_type values) {
+        check_sizes(keys, values);
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+    }
+
+    void swap(BasicFlatMap& other) noexcept {
+        using std::swap;
+        swap(keys_, other.keys_);
+        swap(values_, other.values_);
+        swap(comp_, other.comp_);
+    }
+
+    // Removes the elements for which pred(const_reference) is true, in one pass
+    template <typename Pred>
+    friend size_type erase_if(BasicFlatMap& map, Pred pred) {
+        size_type out = 0;
+        for (size_type i = 0; i < map.size(); ++i) {
+            if (pred(const_reference{map.keys_[i], map.values_[i]})) {
+                continue;
+            }
+            if (out != i) {
+                map.keys_[out] = std::move(map.keys_[i]);
+                map.values_[out] = std::move(map.values_[i]);
+            }
+            ++out;
+        }
+        const size_type removed = map.size() - out;
+        map.keys_.erase(map.keys_.begin() + static_cast<difference_type>(out), map.keys_.end());
+        map.values_.erase(map.values_.begin() + static_cast<difference_type>(out),
+                          map.values_.end());
+        return removed;
+    }
+
+    friend bool operator==(const BasicFlatMap& a, const BasicFlatMap& b) {
+        return a.keys_ == b.keys_ && a.values_ == b.values_;
+    }
+
+private:
+    [[nodiscard]] iterator at_index(size_type i) noexcept {
+        return iterator{keys_.data() + i, values_.data() + i};
+    }
+    [[nodiscard]] const_iterator at_index(size_type i) const noexcept {
+        return const_iterator{keys_.data() + i, values_.data() + i};
+    }
+
+    [[nodiscard]] difference_type index_of(const_iterator it) const noexcept {
+        return it.key_ - keys_.data();
+    }
+
+    template <typename Q>
+    [[nodiscard]] size_type lower_index(const Q& key) const {
+        return detail::branchless_partition_point(
+            keys_.data(), keys_.size(), [&](const K& k) { return comp_(k, key); });
+    }
+
+    template <typename Q>
+    [[nodiscard]] size_type upper_index(const Q& key) const {
+        return detail::branchless_partition_point(
+            keys_.data(), keys_.size(), [&](const K& k) { return !comp_(key, k); });
+    }
+
+    template <typename Q>
+    [[nodiscard]] std::pair<size_type, size_type> equal_indices(const Q& key) const {
+        const size_type lo = lower_index(key);
+        if constexpr (Multi) {
+            // Only the keys from lo on can be equal
+            const size_type hi =
+                lo + detail::branchless_partition_point(
+                         keys_.data() + lo, keys_.size() - lo,
+                         [&](const K& k) { return !comp_(key, k); });
+            return {lo, hi};
+        } else {
+            return {lo, lo + (found_at(lo, key) ? 1 : 0)};
+        }
+    }
+
+    template <typename Q>
+    [[nodiscard]] bool found_at(size_type i, const Q& key) const {
+        return i != size() && !comp_(key, keys_[i]);
+    }
+
+    // The index of the (first) element with this key, or size()
+    template <typename Q>
+    [[nodiscard]] size_type find_index(const Q& key) const {
+        const size_type i = lower_index(key);
+        return found_at(i, key) ? i : size();
+    }
+
+    template <typename Q>
+    [[nodiscard]] size_type count_of(const Q& key) const {
+        const auto [lo, hi] = equal_indices(key);
+        return hi - lo;
+    }
+
+    template <typename Q>
+    [[nodiscard]] size_type checked_index(const Q& key) const {
+        const size_type i = find_index(key);
+        if (i == size()) {
+            throw std::out_of_range{"FlatMap::at: key not found"};
+        }
+        return i;
+    }
+
+    template <typename Q>
+    size_type erase_key(const Q& key) {
+        const auto [lo, hi] = equal_indices(key);
+        erase(at_index(lo), at_index(hi));
+        return hi - lo;
+    }
+
+    // FlatMap: insert unless present. FlatMultimap: insert after equal keys.
+    template <typename KK, typename... Args>
+    auto emplace_at(KK&& key, Args&&... args) {
+        if constexpr (Multi) {
+            const size_type i = upper_index(key);
+            insert_at(i, std::forward<KK>(key), std::forward<Args>(args)...);
+            return at_index(i);
+        } else {
+            const size_type i = lower_index(key);
+            if (found_at(i, key)) {
+                return std::pair{at_index(i), false};
+            }
+            insert_at(i, std::forward<KK>(key), std::forward<Args>(args)...);
+            return std::pair{at_index(i), true};
+        }
+    }
+
+    // Keeps the arrays the same length if constructing the value throws
+    template <typename KK, typename... Args>
+    void insert_at(size_type i, KK&& key, Args&&... args) {
+        const auto offset = static_cast<difference_type>(i);
+        keys_.emplace(keys_.begin() + offset, std::forward<KK>(key));
+        try {
+            values_.emplace(values_.begin() + offset, std::forward<Args>(args)...);
+        } catch (...) {
+            keys_.erase(keys_.begin() + offset);
+            throw;
+        }
+    }
+
+    // Moves the key and value out of *first when it is an rvalue, as from
+    // a std::move_iterator, and copies them otherwise
+    template <typename It>
+    void append(It first, It last) {
+        if constexpr (std::forward_iterator<It>) {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            reserve(size() + n);
+        }
+        for (; first != last; ++first) {
+            auto&& element = *first;
+            using Element = decltype(element);
+            keys_.push_back(std::get<0>(std::forward<Element>(element)));
+            try {
+                values_.push_back(std::get<1>(std::forward<Element>(element)));
+            } catch (...) {
+                keys_.pop_back();
+                throw;
+            }
+        }
+    }
+
+    static void check_sizes(const key_container_type& keys, const mapped_container_type& values) {
+        if (keys.size() != values.size()) {
+            throw std::invalid_argument{"FlatMap: key and value counts differ"};
+        }
+    }
+
+    // Sorting two arrays by the first one: sort the pairs, then split them
+    // again. Skipped when the input is already in order.
+    void sort_and_dedup() {
+        const bool sorted = std::is_sorted(keys_.begin(), keys_.end(), std::cref(comp_));
+        if (!sorted) {
+            auto pairs = take_pairs(0);
+            std::stable_sort(pairs.begin(), pairs.end(), pair_less());
+            put_pairs(std::move(pairs));
+        }
+        if constexpr (!Multi) {
+            dedup();
+        }
+    }
+
+    // Removes all but the first of each run of equal keys
+    void dedup() {
+        if (empty()) {
+            return;
+        }
+        size_type out = 1;
+        for (size_type i = 1; i < size(); ++i) {
+            if (!comp_(keys_[out - 1], keys_[i])) {
+                continue;
+            }
+            if (out != i) {
+                keys_[out] = std::move(keys_[i]);
+                values_[out] = std::move(values_[i]);
+            }
+            ++out;
+        }
+        keys_.resize(out);
+        values_.resize(out);
+    }
+
+    // [0, old_size) is sorted; [old_size, size()) was just appended
+    void sort_tail_and_merge(size_type old_size) {
+        auto tail = take_pairs(old_size);
+        std::stable_sort(tail.begin(), tail.end(), pair_less());
+
+        key_container_type keys;
+        mapped_container_type values;
+        keys.reserve(old_size + tail.size());
+        values.reserve(old_size + tail.size());
+        size_type i = 0;
+        auto t = tail.begin();
+        while (i != old_size || t != tail.end()) {
+            // Ties go to the existing elements, which keeps a multimap's
+            // equal keys in insertion order
+            const bool take_old = t == tail.end() || (i != old_size && !comp_(t->first, keys_[i]));
+            if (take_old) {
+                keys.push_back(std::move(keys_[i]));
+                values.push_back(std::move(values_[i]));
+                ++i;
+                continue;
+            }
+            if constexpr (!Multi) {
+                if (!keys.empty() && !comp_(keys.back(), t->first)) {
+                    ++t;  // already present
+                    continue;
+                }
+            }
+            keys.push_back(std::move(t->first));
+            values.push_back(std::move(t->second));
+            ++t;
+        }
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+    }
+
+    // Moves [from, size()) out of the arrays as pairs
+    [[nodiscard]] std::vector<value_type> take_pairs(size_type from) {
+        std::vector<value_type> pairs;
+        pairs.reserve(size() - from);
+        for (size_type i = from; i < size(); ++i) {
+            pairs.emplace_back(std::move(keys_[i]), std::move(values_[i]));
+        }
+        keys_.resize(from);
+        values_.resize(from);
+        return pairs;
+    }
+
+    void put_pairs(std::vector<value_type>&& pairs) {
+        for (auto& [key, value] : pairs) {
+            keys_.push_back(std::move(key));
+            values_.push_back(std::move(value));
+        }
+    }
+
+    [[nodiscard]] auto pair_less() const {
+        return [this](const value_type& a, const value_type& b) { return comp_(a.first, b.first); };
+    }
+
+    key_container_type keys_;
+    mapped_container_type values_;
+    [[no_unique_address]] Compare comp_;
+};
+
+/**
+ * A sorted map with unique keys over two contiguous arrays, with the
+ * interface of std::map (and of C++23's std::flat_map).
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+using FlatMap = BasicFlatMap<K, V, Compare, false>;
+
+/**
+ * A sorted map with repeated keys, as std::multimap: find() returns the
+ * first element with a key, and equal_range() all of them in insertion
+ * order.
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+using FlatMultimap = BasicFlatMap<K, V, Compare, true>;
+
+} // namespace flat
+
+#endif // FLAT_MAP_H
@@ -0,0 +1,222 @@
+#include "btree_map.h"
+#include "flat_hash_map.h"
+#include "flat_map.h"
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Demonstrates the flat containers: the open-addressing hash tables, using
+ * the hashers from Chapter 12's unordered_map example, the sorted
+ * FlatMap, for Chapter 12's PhoneBook exercise, and the B+-tree BTreeMap
+ * for ordered data that keeps changing.
+ */
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+
+    bool operator==(const Point& other) const = default;
+};
+
+// Boost-style hash combine, as in Chapter 12's PointHashBetter
+struct PointHash {
+    std::size_t operator()(const Point& p) const {
+        std::size_t seed = 0;
+        seed ^= std::hash<int>{}(p.x) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<int>{}(p.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+};
+
+// Transparent functors: lookups by std::string_view build no std::string
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sv) const {
+        return std::hash<std::string_view>{}(sv);
+    }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+// Counts the bytes a std::map allocates for its nodes
+inline std::size_t allocated_bytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        allocated_bytes += n * sizeof(T);
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        allocated_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+} // namespace
+
+int main() {
+    std::cout << "=== Flat Containers Demo ===\n\n";
+
+    // 1. Drop-in use
+    std::cout << "1. FlatHashMap<std::string, int>:\n";
+    {
+        flat::FlatHashMap<std::string, int> word_count;
+        word_count["hello"] = 1;
+        word_count["world"] = 2;
+        word_count.emplace("foo", 3);
+        word_count.insert({"bar", 4});
+
+        std::cout << "   {";
+        bool first = true;
+        for (const auto& [word, count] : word_count) {
+            std::cout << (first ? "" : ", ") << word << ": " << count;
+            first = false;
+        }
+        std::cout << "} (size=" << word_count.size() << ", capacity=" << word_count.capacity()
+                  << ")\n";
+        std::cout << "   contains(\"foo\"): " << std::boolalpha << word_count.contains("foo")
+                  << "\n\n";
+    }
+
+    // 2. Growth: capacity doubles once 7/8 of the slots are full
+    std::cout << "2. Growth:\n";
+    {
+        flat::FlatHashMap<int, int> m;
+        std::size_t capacity = m.capacity();
+        for (int i = 0; i < 1000; ++i) {
+            m[i] = i;
+            if (m.capacity() != capacity) {
+                capacity = m.capacity();
+                std::cout << "   size " << m.size() << " -> capacity " << capacity << "\n";
+            }
+        }
+        std::cout << "   load factor at 1000 elements: " << m.load_factor() << "\n\n";
+    }
+
+    // 3. A custom hash
+    std::cout << "3. Custom hash (Point):\n";
+    {
+        flat::FlatHashMap<Point, std::string, PointHash> points{
+            {{0, 0}, "origin"}, {{1, 0}, "unit x"}, {{0, 1}, "unit y"}};
+        std::cout << "   (1, 0) -> " << points.at({1, 0}) << "\n\n";
+    }
+
+    // 4. Heterogeneous lookup
+    std::cout << "4. Heterogeneous lookup:\n";
+    {
+        flat::FlatHashMap<std::string, int, StringHash, StringEqual> m{{"hello", 1}, {"world", 2}};
+        const std::string_view key = "world";
+        if (const auto it = m.find(key); it != m.end()) {
+            std::cout << "   found via string_view: " << it->second << "\n\n";
+        }
+    }
+
+    // 5. Erasing: no tombstones are left behind
+    std::cout << "5. erase and erase_if:\n";
+    {
+        flat::FlatHashSet<int> s;
+        for (int i = 0; i < 100; ++i) {
+            s.insert(i);
+        }
+        s.erase(50);
+        const auto removed = erase_if(s, [](int x) { return x % 2 == 0; });
+        std::cout << "   removed " << removed << " even numbers, " << s.size() << " left\n\n";
+    }
+
+    // 6. A phone book: names with several numbers, built in one go
+    std::cout << "6. FlatMultimap as a phone book:\n";
+    {
+        flat::FlatMultimap<std::string, std::string, std::less<>> book{
+            {"Bob", "555-0101"}, {"Alice", "555-0100"}, {"Bob", "555-0199"},
+            {"Carol", "555-0102"}};
+        const std::string_view name = "Bob";
+        std::cout << "   " << name << ":";
+        for (auto [it, end] = book.equal_range(name); it != end; ++it) {
+            std::cout << ' ' << it->second;
+        }
+        std::cout << "\n   all, in order:";
+        for (const auto& [who, number] : book) {
+            std::cout << ' ' << who << '=' << number;
+        }
+        std::cout << "\n\n";
+    }
+
+    // 7. Memory: one node per element vs. two arrays
+    std::cout << "7. Memory for 100000 uint64 -> uint64 elements:\n";
+    {
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> input;
+        for (std::uint64_t i = 0; i < 100'000; ++i) {
+            input.emplace_back(i * 7919 % 100'003, i);
+        }
+        std::size_t map_bytes = 0;
+        {
+            const std::map<std::uint64_t, std::uint64_t, std::less<>,
+                           CountingAllocator<std::pair<const std::uint64_t, std::uint64_t>>>
+                tree(input.begin(), input.end());
+            map_bytes = allocated_bytes;
+        }
+        const flat::FlatMap<std::uint64_t, std::uint64_t> sorted(input.begin(), input.end());
+        const std::size_t flat_bytes = sorted.keys().capacity() * sizeof(std::uint64_t) +
+                                       sorted.values().capacity() * sizeof(std::uint64_t);
+        std::cout << "   std::map: " << std::setw(8) << map_bytes << " bytes ("
+                  << map_bytes / input.size() << " per element, before malloc overhead)\n"
+                  << "   FlatMap:  " << std::setw(8) << flat_bytes << " bytes ("
+                  << flat_bytes / input.size() << " per element)\n";
+    }
+
+    // 8. A B+-tree: std::map's interface, FlatMap's arrays, cheap inserts
+    std::cout << "\n8. BTreeMap of trades by timestamp:\n";
+    {
+        // Bulk loaded from sorted input, then updated one trade at a time
+        std::vector<std::pair<std::uint64_t, double>> history;
+        for (std::uint64_t t = 0; t < 100'000; ++t) {
+            history.emplace_back(t * 10, 100.0 + static_cast<double>(t % 50) / 10);
+        }
+        flat::BTreeMap<std::uint64_t, double> trades(flat::sorted_unique, history.begin(),
+                                                     history.end());
+        trades.insert_or_assign(5'005, 99.5);
+        trades.erase(5'010);
+        std::cout << "   " << trades.size() << " trades in a tree of height " << trades.height()
+                  << " (" << decltype(trades)::leaf_capacity << " per leaf, "
+                  << decltype(trades)::inner_capacity << " keys per inner node)\n";
+
+        // A range query walks the linked leaves
+        double volume = 0;
+        std::size_t n = 0;
+        trades.for_each_in(5'000, 5'050, [&](std::uint64_t, double price) {
+            volume += price;
+            ++n;
+        });
+        std::cout << "   trades in [5000, 5050): " << n << ", sum of prices " << volume << '\n';
+        std::cout << "   first at or after 5007: " << trades.lower_bound(5'007)->first << '\n';
+    }
+
+    std::cout << "\n=== Demo Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,332 @@
+#include <catch2/catch_test_macros.hpp>
+#include "btree_map.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using flat::BTreeMap;
+
+namespace {
+
+// The smallest nodes, so that a few hundred elements already make a tree
+// several levels deep
+template <typename K, typename V>
+using SmallTree = BTreeMap<K, V, std::less<>, 128>;
+
+// Every element as a std::pair, in iteration order
+template <typename Map>
+auto elements(const Map& m) {
+    std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>> out;
+    for (const auto& [k, v] : m) {
+        out.emplace_back(k, v);
+    }
+    return out;
+}
+
+// Same elements in both directions, and no deeper than a tree with
+// half-full nodes can be
+template <typename Tree, typename K, typename V>
+void require_same(const Tree& tree, const std::map<K, V>& expected) {
+    REQUIRE(tree.size() == expected.size());
+    REQUIRE(elements(tree) == std::vector<std::pair<K, V>>(expected.begin(), expected.end()));
+
+    std::vector<K> backwards;
+    for (auto it = tree.rbegin(); it != tree.rend(); ++it) {
+        backwards.push_back(it->first);
+    }
+    REQUIRE(backwards.size() == expected.size());
+    REQUIRE(std::equal(backwards.begin(), backwards.end(), expected.rbegin(), expected.rend(),
+                       [](const K& k, const auto& p) { return k == p.first; }));
+
+    // Each level down needs at least (half of inner_capacity + 1) times
+    // as many elements, starting from two half-full leaves under a root
+    std::size_t bound = 1;
+    for (std::size_t reach = 2 * (Tree::leaf_capacity / 2); reach <= expected.size();
+         reach *= Tree::inner_capacity / 2 + 1) {
+        ++bound;
+    }
+    REQUIRE(tree.height() <= (expected.empty() ? 1 : bound));
+}
+
+} // namespace
+
+TEST_CASE("BTreeMap node sizes follow NodeBytes", "[btree_map]") {
+    using Default = BTreeMap<std::uint64_t, std::uint64_t>;
+    STATIC_REQUIRE(Default::leaf_capacity == (512 - 24) / 16);
+    STATIC_REQUIRE(Default::inner_capacity == (512 - 16) / 16);
+    STATIC_REQUIRE(SmallTree<int, int>::leaf_capacity == 13);
+    STATIC_REQUIRE(BTreeMap<std::string, std::string, std::less<>, 128>::leaf_capacity == 4);
+}
+
+TEST_CASE("BTreeMap basic operations", "[btree_map]") {
+    BTreeMap<std::string, int, std::less<>> m;
+    REQUIRE(m.empty());
+    REQUIRE(m.height() == 0);
+    REQUIRE(m.begin() == m.end());
+    REQUIRE(m.find("missing") == m.end());
+    REQUIRE(m.lower_bound("x") == m.end());
+    REQUIRE(m.erase("missing") == 0);
+    REQUIRE_THROWS_AS(m.at("missing"), std::out_of_range);
+
+    m["hello"] = 1;
+    m["world"] = 2;
+    REQUIRE(m.insert({"foo", 3}).second);
+    REQUIRE_FALSE(m.insert({"foo", 99}).second);
+    REQUIRE(m.emplace("bar", 4).second);
+    REQUIRE(m.try_emplace("baz", 5).second);
+    REQUIRE_FALSE(m.try_emplace("baz", 6).second);
+    REQUIRE_FALSE(m.insert_or_assign("baz", 7).second);
+
+    REQUIRE(m.size() == 5);
+    REQUIRE(m.at("foo") == 3);
+    REQUIRE(m["baz"] == 7);
+    REQUIRE(m.begin()->first == "bar");
+    REQUIRE(std::prev(m.end())->first == "world");
+    REQUIRE_THROWS_AS(m.at("nope"), std::out_of_range);
+
+    // Transparent lookup with a string_view
+    const std::string_view key = "hello";
+    REQUIRE(m.contains(key));
+    REQUIRE(m.count(key) == 1);
+    m.find(key)->second = 10;
+    REQUIRE(m.at(key) == 10);
+
+    REQUIRE(m.erase("foo") == 1);
+    REQUIRE(m.erase("foo") == 0);
+    REQUIRE(elements(m) == std::vector<std::pair<std::string, int>>{
+                               {"bar", 4}, {"baz", 7}, {"hello", 10}, {"world", 2}});
+
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m.begin() == m.end());
+    m["again"] = 1;
+    REQUIRE(m.size() == 1);
+}
+
+TEST_CASE("BTreeMap bounds", "[btree_map]") {
+    SmallTree<int, int> m;
+    for (int i = 0; i < 1000; i += 2) {
+        m.try_emplace(i, i);
+    }
+    for (int key = -1; key <= 1000; ++key) {
+        const auto lower = m.lower_bound(key);
+        const auto upper = m.upper_bound(key);
+        const int even = key < 0 ? 0 : (key + 1) / 2 * 2;
+        if (even >= 1000) {
+            REQUIRE(lower == m.end());
+        } else {
+            REQUIRE(lower->first == even);
+        }
+        if (key % 2 == 0 && key >= 0 && key < 1000) {
+            if (key + 2 < 1000) {
+                REQUIRE(upper->first == key + 2);
+            } else {
+                REQUIRE(upper == m.end());
+            }
+            const auto [first, last] = m.equal_range(key);
+            REQUIRE(std::distance(first, last) == 1);
+            REQUIRE(first->first == key);
+        } else {
+            REQUIRE(upper == lower);
+            const auto [first, last] = m.equal_range(key);
+            REQUIRE(first == last);
+        }
+    }
+}
+
+TEST_CASE("BTreeMap matches std::map under random operations", "[btree_map]") {
+    std::mt19937 gen{12345};
+    std::uniform_int_distribution<int> key_of{0, 3000};
+    std::uniform_int_distribution<int> op_of{0, 9};
+    SmallTree<int, int> tree;
+    std::map<int, int> expected;
+
+    for (int round = 0; round < 20'000; ++round) {
+        const int key = key_of(gen);
+        const int op = op_of(gen);
+        if (op < 5) {
+            const auto [it, inserted] = tree.try_emplace(key, round);
+            REQUIRE(inserted == expected.try_emplace(key, round).second);
+            REQUIRE(it->first == key);
+            REQUIRE(it->second == expected.at(key));
+        } else if (op < 9) {
+            REQUIRE(tree.erase(key) == expected.erase(key));
+        } else {
+            const auto it = tree.find(key);
+            const auto e = expected.find(key);
+            REQUIRE((it == tree.end()) == (e == expected.end()));
+            if (e != expected.end()) {
+                REQUIRE(it->second == e->second);
+            }
+        }
+        if (round % 1000 == 0) {
+            require_same(tree, expected);
+        }
+    }
+    require_same(tree, expected);
+
+    // Empty it completely, the root shrinking level by level
+    while (!expected.empty()) {
+        const auto victim = std::next(expected.begin(),
+                                      static_cast<std::ptrdiff_t>(gen() % expected.size()));
+        REQUIRE(tree.erase(victim->first) == 1);
+        expected.erase(victim);
+    }
+    require_same(tree, expected);
+    REQUIRE(tree.begin() == tree.end());
+}
+
+TEST_CASE("BTreeMap erase by iterator", "[btree_map]") {
+    SmallTree<int, std::string> m;
+    std::map<int, std::string> expected;
+    for (int i = 0; i < 400; ++i) {
+        m.try_emplace(i, std::to_string(i));
+        expected.try_emplace(i, std::to_string(i));
+    }
+
+    // Erase every third element while walking, as with std::map
+    for (auto it = m.begin(); it != m.end();) {
+        if (const int key = it->first; key % 3 == 0) {
+            it = m.erase(it);
+            REQUIRE((key == 399 ? it == m.end() : it->first == key + 1));
+        } else {
+            ++it;
+        }
+    }
+    std::erase_if(expected, [](const auto& p) { return p.first % 3 == 0; });
+    require_same(m, expected);
+
+    // A range in the middle, then a tail
+    auto last = m.erase(m.find(100), m.find(200));
+    expected.erase(expected.find(100), expected.find(200));
+    REQUIRE(last->first == 200);
+    require_same(m, expected);
+
+    last = m.erase(m.lower_bound(350), m.end());
+    REQUIRE(last == m.end());
+    expected.erase(expected.lower_bound(350), expected.end());
+    require_same(m, expected);
+}
+
+TEST_CASE("BTreeMap bulk loading", "[btree_map]") {
+    SECTION("unsorted input with duplicates keeps the first of each key") {
+        std::vector<std::pair<int, int>> input;
+        std::map<int, int> expected;
+        std::mt19937 gen{7};
+        for (int i = 0; i < 5000; ++i) {
+            const int key = static_cast<int>(gen() % 2000);
+            input.emplace_back(key, i);
+            expected.try_emplace(key, i);
+        }
+        const SmallTree<int, int> tree(input.begin(), input.end());
+        require_same(tree, expected);
+    }
+
+    SECTION("every size around node boundaries") {
+        for (int n = 0; n <= 400; ++n) {
+            std::vector<std::pair<int, int>> input;
+            for (int i = 0; i < n; ++i) {
+                input.emplace_back(i, -i);
+            }
+            SmallTree<int, int> tree(flat::sorted_unique, input.begin(), input.end());
+            REQUIRE(tree.size() == static_cast<std::size_t>(n));
+            REQUIRE(elements(tree) == input);
+
+            // A bulk-loaded tree is an ordinary tree afterwards
+            for (int i = 0; i < n; i += 2) {
+                REQUIRE(tree.erase(i) == 1);
+            }
+            tree.try_emplace(n, 0);
+            REQUIRE(tree.size() == static_cast<std::size_t>(n - (n + 1) / 2 + 1));
+        }
+    }
+
+    SECTION("insert into an empty map bulk loads") {
+        BTreeMap<int, int> m;
+        m.insert({{3, 30}, {1, 10}, {2, 20}, {1, 11}});
+        REQUIRE(elements(m) == std::vector<std::pair<int, int>>{{1, 10}, {2, 20}, {3, 30}});
+        m.insert({{0, 0}, {3, 33}});
+        REQUIRE(elements(m) ==
+                std::vector<std::pair<int, int>>{{0, 0}, {1, 10}, {2, 20}, {3, 30}});
+    }
+}
+
+TEST_CASE("BTreeMap range scans", "[btree_map]") {
+    SmallTree<int, int> m;
+    for (int i = 0; i < 2000; i += 3) {
+        m.try_emplace(i, i * 10);
+    }
+
+    for (const auto& [from, to] : {std::pair{0, 2000}, std::pair{1, 2}, std::pair{5, 500},
+                                  std::pair{-10, 10}, std::pair{1990, 5000},
+                                  std::pair{700, 700}, std::pair{800, 100}}) {
+        std::vector<int> by_iterator;
+        for (auto it = m.lower_bound(from); it != m.end() && it->first < to; ++it) {
+            by_iterator.push_back(it->first);
+        }
+        std::vector<int> by_scan;
+        m.for_each_in(from, to, [&](int key, int value) {
+            REQUIRE(value == key * 10);
+            by_scan.push_back(key);
+        });
+        REQUIRE(by_scan == by_iterator);
+    }
+
+    BTreeMap<int, int> empty;
+    int calls = 0;
+    empty.for_each_in(0, 100, [&](int, int) { ++calls; });
+    REQUIRE(calls == 0);
+}
+
+TEST_CASE("BTreeMap copy, move and comparison", "[btree_map]") {
+    SmallTree<int, std::unique_ptr<int>> owning;
+    for (int i = 0; i < 100; ++i) {
+        owning.try_emplace(i, std::make_unique<int>(i));
+    }
+    auto moved = std::move(owning);
+    REQUIRE(moved.size() == 100);
+    REQUIRE(*moved.at(42) == 42);
+    REQUIRE(owning.empty());  // NOLINT(bugprone-use-after-move)
+    owning.try_emplace(1, std::make_unique<int>(1));
+    REQUIRE(owning.size() == 1);
+
+    SmallTree<std::string, int> a;
+    for (int i = 0; i < 300; ++i) {
+        a.try_emplace("k" + std::to_string(i), i);
+    }
+    const auto b = a;
+    REQUIRE(a == b);
+    a["k7"] = -1;
+    REQUIRE_FALSE(a == b);
+    REQUIRE(b.at("k7") == 7);
+
+    SmallTree<std::string, int> c;
+    c = b;
+    REQUIRE(c == b);
+    swap(a, c);
+    REQUIRE(a == b);
+    REQUIRE(c.at("k7") == -1);
+}
+
+TEST_CASE("BTreeMap erase releases what a value owns", "[btree_map]") {
+    const auto shared = std::make_shared<int>(1);
+    {
+        SmallTree<int, std::shared_ptr<int>> m;
+        for (int i = 0; i < 200; ++i) {
+            m.try_emplace(i, shared);
+        }
+        REQUIRE(shared.use_count() == 201);
+        for (int i = 0; i < 150; ++i) {
+            m.erase(i);
+        }
+        REQUIRE(shared.use_count() == 51);
+    }
+    REQUIRE(shared.use_count() == 1);
+}
@@ -0,0 +1,367 @@
+#include <catch2/catch_test_macros.hpp>
+#include "flat_hash_map.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using flat::FlatHashMap;
+using flat::FlatHashSet;
+
+namespace {
+
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+// Every key lands on the same home slot, so every operation walks one run
+struct CollidingHash {
+    std::size_t operator()(int) const { return 42; }
+};
+
+// Counts live instances, to catch leaks and double destruction
+struct Tracked {
+    static inline int live = 0;
+    int value;
+    explicit Tracked(int v) : value{v} { ++live; }
+    Tracked(const Tracked& other) : value{other.value} { ++live; }
+    Tracked(Tracked&& other) noexcept : value{other.value} { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { --live; }
+};
+
+} // namespace
+
+TEST_CASE("FlatHashMap basic operations", "[flat_hash_map]") {
+    FlatHashMap<std::string, int> m;
+    REQUIRE(m.empty());
+    REQUIRE(m.capacity() == 0);
+    REQUIRE(m.find("missing") == m.end());
+    REQUIRE(m.begin() == m.end());
+
+    m["hello"] = 1;
+    m["world"] = 2;
+    REQUIRE(m.insert({"foo", 3}).second);
+    REQUIRE_FALSE(m.insert({"foo", 99}).second);
+    REQUIRE(m.emplace("bar", 4).second);
+    REQUIRE(m.try_emplace("baz", 5).second);
+    REQUIRE_FALSE(m.try_emplace("baz", 6).second);
+
+    REQUIRE(m.size() == 5);
+    REQUIRE(m.at("foo") == 3);
+    REQUIRE(m["baz"] == 5);
+    REQUIRE(m.contains("hello"));
+    REQUIRE(m.count("nope") == 0);
+    REQUIRE_THROWS_AS(m.at("nope"), std::out_of_range);
+
+    m.insert_or_assign("foo", 30);
+    REQUIRE(m.at("foo") == 30);
+
+    REQUIRE(m.erase("hello") == 1);
+    REQUIRE(m.erase("hello") == 0);
+    REQUIRE(m.size() == 4);
+    REQUIRE_FALSE(m.contains("hello"));
+
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m.begin() == m.end());
+    m["again"] = 1;
+    REQUIRE(m.size() == 1);
+}
+
+TEST_CASE("FlatHashMap agrees with std::unordered_map", "[flat_hash_map]") {
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> key{0, 5000};
+    std::uniform_int_distribution<int> op{0, 9};
+
+    FlatHashMap<int, int> m;
+    std::unordered_map<int, int> expected;
+    for (int i = 0; i < 100'000; ++i) {
+        const int k = key(gen);
+        switch (op(gen)) {
+        case 0:
+        case 1:
+        case 2:
+            REQUIRE(m.erase(k) == expected.erase(k));
+            break;
+        case 3: {
+            const auto it = m.find(k);
+            const auto e = expected.find(k);
+            REQUIRE((it == m.end()) == (e == expected.end()));
+            if (e != expected.end()) {
+                REQUIRE(it->second == e->second);
+            }
+            break;
+        }
+        default:
+            m[k] += i;
+            expected[k] += i;
+        }
+    }
+    REQUIRE(m.size() == expected.size());
+    REQUIRE(m.load_factor() <= FlatHashMap<int, int>::max_load_factor());
+
+    // Iteration visits every element exactly once
+    std::size_t visited = 0;
+    for (const auto& [k, v] : m) {
+        REQUIRE(expected.at(k) == v);
+        ++visited;
+    }
+    REQUIRE(visited == expected.size());
+}
+
+TEST_CASE("FlatHashMap erase closes gaps without tombstones", "[flat_hash_map][erase]") {
+    SECTION("every key in one run") {
+        FlatHashMap<int, int, CollidingHash> m;
+        for (int i = 0; i < 40; ++i) {
+            m[i] = i;
+        }
+        // Erase from the front, middle and back of the run
+        for (const int k : {0, 20, 39, 1, 21}) {
+            REQUIRE(m.erase(k) == 1);
+        }
+        for (int i = 0; i < 40; ++i) {
+            const bool erased = i == 0 || i == 1 || i == 20 || i == 21 || i == 39;
+            REQUIRE(m.contains(i) != erased);
+        }
+    }
+
+    SECTION("churn keeps capacity bounded") {
+        // A tombstone table would fill up with deleted markers here
+        FlatHashMap<int, int> m;
+        for (int i = 0; i < 1000; ++i) {
+            m[i] = i;
+        }
+        const auto capacity = m.capacity();
+        for (int round = 0; round < 50; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                m.erase(round * 1000 + i);
+                m[(round + 1) * 1000 + i] = i;
+            }
+        }
+        REQUIRE(m.size() == 1000);
+        REQUIRE(m.capacity() == capacity);
+    }
+
+    SECTION("erase through an iterator") {
+        FlatHashMap<int, int> m{{1, 1}, {2, 2}, {3, 3}};
+        m.erase(m.find(2));
+        REQUIRE(m.size() == 2);
+        REQUIRE_FALSE(m.contains(2));
+    }
+}
+
+TEST_CASE("erase_if removes exactly the matching elements", "[flat_hash_map][erase]") {
+    SECTION("random keys") {
+        FlatHashMap<int, int> m;
+        for (int i = 0; i < 10'000; ++i) {
+            m[i * 7] = i;
+        }
+        REQUIRE(erase_if(m, [](const auto& kv) { return kv.second % 3 == 0; }) == 3334);
+        REQUIRE(m.size() == 6666);
+        for (const auto& [k, v] : m) {
+            REQUIRE(v % 3 != 0);
+        }
+    }
+
+    SECTION("runs that wrap around the end of the table") {
+        FlatHashMap<int, int, CollidingHash> m;
+        for (int i = 0; i < 12; ++i) {
+            m[i] = i;
+        }
+        REQUIRE(erase_if(m, [](const auto& kv) { return kv.first % 2 == 0; }) == 6);
+        for (int i = 0; i < 12; ++i) {
+            REQUIRE(m.contains(i) == (i % 2 == 1));
+        }
+    }
+}
+
+TEST_CASE("FlatHashMap heterogeneous lookup", "[flat_hash_map][transparent]") {
+    FlatHashMap<std::string, int, StringHash, StringEqual> m;
+    m["hello"] = 1;
+    m["world"] = 2;
+
+    const std::string_view sv = "hello";
+    REQUIRE(m.find(sv) != m.end());
+    REQUIRE(m.find(sv)->second == 1);
+    REQUIRE(m.contains(std::string_view{"world"}));
+    REQUIRE(m.count(std::string_view{"nope"}) == 0);
+    REQUIRE(m.at(std::string_view{"world"}) == 2);
+    REQUIRE(m.erase(std::string_view{"world"}) == 1);
+    REQUIRE(m.size() == 1);
+
+    FlatHashSet<std::string, StringHash, StringEqual> names{"alice", "bob"};
+    REQUIRE(names.contains(std::string_view{"bob"}));
+    REQUIRE_FALSE(names.contains(std::string_view{"carol"}));
+}
+
+TEST_CASE("FlatHashMap copy, move and equality", "[flat_hash_map]") {
+    FlatHashMap<std::string, std::vector<int>> a;
+    for (int i = 0; i < 100; ++i) {
+        a[std::to_string(i)] = {i, i * 2};
+    }
+
+    auto b = a;
+    REQUIRE(b == a);
+    b["0"].push_back(1);
+    REQUIRE_FALSE(b == a);
+
+    auto c = std::move(b);
+    REQUIRE(c.size() == 100);
+    REQUIRE(b.empty());  // NOLINT(bugprone-use-after-move)
+    b["x"] = {};
+    REQUIRE(b.size() == 1);
+
+    c = a;
+    REQUIRE(c == a);
+    a.swap(b);
+    REQUIRE(a.size() == 1);
+    REQUIRE(b.size() == 100);
+}
+
+TEST_CASE("FlatHashMap element lifetimes", "[flat_hash_map]") {
+    Tracked::live = 0;
+    {
+        FlatHashMap<int, Tracked> m;
+        for (int i = 0; i < 1000; ++i) {
+            m.try_emplace(i, i);
+        }
+        REQUIRE(Tracked::live == 1000);
+        for (int i = 0; i < 1000; i += 2) {
+            m.erase(i);
+        }
+        REQUIRE(Tracked::live == 500);
+        auto copy = m;
+        REQUIRE(Tracked::live == 1000);
+        copy.clear();
+        REQUIRE(Tracked::live == 500);
+    }
+    REQUIRE(Tracked::live == 0);
+}
+
+TEST_CASE("FlatHashMap with move-only values and reserve", "[flat_hash_map]") {
+    FlatHashMap<int, std::unique_ptr<int>> m;
+    m.reserve(500);
+    const auto capacity = m.capacity();
+    for (int i = 0; i < 500; ++i) {
+        m.try_emplace(i, std::make_unique<int>(i));
+    }
+    REQUIRE(m.capacity() == capacity);
+    for (int i = 0; i < 500; ++i) {
+        REQUIRE(*m.at(i) == i);
+    }
+}
+
+TEST_CASE("FlatHashMap extract hands over keys and values", "[flat_hash_map][extract]") {
+    FlatHashMap<std::string, std::unique_ptr<int>, StringHash, StringEqual> m;
+    for (int i = 0; i < 100; ++i) {
+        m.try_emplace("key" + std::to_string(i), std::make_unique<int>(i));
+    }
+
+    auto node = m.extract(std::string_view{"key7"});
+    REQUIRE(node);
+    REQUIRE(node.key() == "key7");
+    REQUIRE(*node.mapped() == 7);
+    const std::string key = std::move(node.key());  // not const, unlike it->first
+    REQUIRE(key == "key7");
+    REQUIRE(m.size() == 99);
+    REQUIRE_FALSE(m.contains("key7"));
+    REQUIRE(m.extract(std::string_view{"key7"}).empty());
+
+    node = m.extract(m.find("key8"));
+    REQUIRE(*node.mapped() == 8);
+    REQUIRE(m.size() == 98);
+
+    std::vector<int> values;
+    m.extract_all([&values](auto&& taken) { values.push_back(*taken.mapped()); });
+    REQUIRE(m.empty());
+    REQUIRE(values.size() == 98);
+    std::ranges::sort(values);
+    REQUIRE(values.front() == 0);
+    REQUIRE(values.back() == 99);
+
+    // The emptied map is still usable
+    m.try_emplace("again", std::make_unique<int>(1));
+    REQUIRE(*m.at("again") == 1);
+}
+
+TEST_CASE("extract_all destroys what it has not handed over if it throws",
+          "[flat_hash_map][extract]") {
+    Tracked::live = 0;
+    {
+        FlatHashMap<int, Tracked> m;
+        for (int i = 0; i < 100; ++i) {
+            m.try_emplace(i, i);
+        }
+        int taken = 0;
+        const auto take_ten = [&taken](auto&&) {
+            if (++taken == 10) {
+                throw std::runtime_error{"stop"};
+            }
+        };
+        REQUIRE_THROWS_AS(m.extract_all(take_ten), std::runtime_error);
+        REQUIRE(m.empty());
+        REQUIRE(Tracked::live == 0);
+    }
+    REQUIRE(Tracked::live == 0);
+}
+
+TEST_CASE("FlatHashSet", "[flat_hash_set]") {
+    FlatHashSet<int> s{3, 1, 4, 1, 5, 9, 2, 6};
+    REQUIRE(s.size() == 7);
+    REQUIRE(s.contains(9));
+    REQUIRE_FALSE(s.insert(4).second);
+    REQUIRE(s.emplace(7).second);
+    REQUIRE(s.erase(1) == 1);
+
+    std::set<int> sorted(s.begin(), s.end());
+    REQUIRE(sorted == std::set<int>{2, 3, 4, 5, 6, 7, 9});
+
+    REQUIRE(erase_if(s, [](int x) { return x > 4; }) == 4);
+    REQUIRE(s == FlatHashSet<int>{2, 3, 4});
+}
+
+TEST_CASE("control byte groups", "[flat_hash_map][group]") {
+    using flat::detail::ctrl_empty;
+    using flat::detail::ctrl_t;
+
+    // 16 bytes: a pattern of empties and tags, including a byte one
+    // larger than the tag (the portable match's worst case)
+    const ctrl_t bytes[16] = {5, ctrl_empty, 5, 6, ctrl_empty, 0, 127, 5,
+                              4, 5, ctrl_empty, 6, 5, 5, 0, ctrl_empty};
+
+    const auto indices = [](auto mask) {
+        std::vector<std::size_t> out;
+        for (const auto i : mask) {
+            out.push_back(i);
+        }
+        return out;
+    };
+
+    const flat::detail::PortableGroup portable{bytes};
+    REQUIRE(indices(portable.match_empty()) == std::vector<std::size_t>{1, 4});
+    REQUIRE(indices(portable.match_full()) == std::vector<std::size_t>{0, 2, 3, 5, 6, 7});
+    // May over-report, never under-report
+    const auto matches = indices(portable.match(5));
+    for (const std::size_t i : {0UL, 2UL, 7UL}) {
+        REQUIRE(std::find(matches.begin(), matches.end(), i) != matches.end());
+    }
+
+#if FLAT_HASH_SSE2
+    const flat::detail::Sse2Group sse{bytes};
+    REQUIRE(indices(sse.match(5)) == std::vector<std::size_t>{0, 2, 7, 9, 12, 13});
+    REQUIRE(indices(sse.match_empty()) == std::vector<std::size_t>{1, 4, 10, 15});
+    REQUIRE(sse.match_full().lowest() == 0);
+#endif
+}
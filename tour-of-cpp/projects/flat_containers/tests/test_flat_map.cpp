@@ -0,0 +1,277 @@
+#include <catch2/catch_test_macros.hpp>
+#include "flat_map.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using flat::FlatMap;
+using flat::FlatMultimap;
+
+namespace {
+
+// Every element as a std::pair, in iteration order
+template <typename Map>
+auto elements(const Map& m) {
+    std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>> out;
+    for (const auto& [k, v] : m) {
+        out.emplace_back(k, v);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("branchless partition point", "[flat_map][search]") {
+    for (std::size_t n = 0; n <= 40; ++n) {
+        std::vector<int> v(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            v[i] = static_cast<int>(2 * i);
+        }
+        for (int key = -1; key <= static_cast<int>(2 * n); ++key) {
+            const auto expected =
+                static_cast<std::size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin());
+            REQUIRE(flat::detail::branchless_partition_point(
+                        v.data(), n, [key](int x) { return x < key; }) == expected);
+        }
+    }
+}
+
+TEST_CASE("FlatMap basic operations", "[flat_map]") {
+    FlatMap<std::string, int> m;
+    REQUIRE(m.empty());
+    REQUIRE(m.find("missing") == m.end());
+    REQUIRE(m.begin() == m.end());
+
+    m["hello"] = 1;
+    m["world"] = 2;
+    REQUIRE(m.insert({"foo", 3}).second);
+    REQUIRE_FALSE(m.insert({"foo", 99}).second);
+    REQUIRE(m.emplace("bar", 4).second);
+    REQUIRE(m.try_emplace("baz", 5).second);
+    REQUIRE_FALSE(m.try_emplace("baz", 6).second);
+
+    REQUIRE(m.size() == 5);
+    REQUIRE(m.at("foo") == 3);
+    REQUIRE(m["baz"] == 5);
+    REQUIRE(m.contains("hello"));
+    REQUIRE(m.count("nope") == 0);
+    REQUIRE_THROWS_AS(m.at("nope"), std::out_of_range);
+
+    m.insert_or_assign("foo", 30);
+    REQUIRE(m.at("foo") == 30);
+
+    // Sorted by key, and the arrays line up
+    REQUIRE(m.keys() == std::vector<std::string>{"bar", "baz", "foo", "hello", "world"});
+    REQUIRE(m.values() == std::vector<int>{4, 5, 30, 1, 2});
+    REQUIRE(m.begin()->first == "bar");
+    REQUIRE((m.end() - 1)->second == 2);
+    REQUIRE(m.rbegin()->first == "world");
+
+    REQUIRE(m.erase("hello") == 1);
+    REQUIRE(m.erase("hello") == 0);
+    REQUIRE(m.size() == 4);
+
+    const auto next = m.erase(m.find("baz"));
+    REQUIRE(next->first == "foo");
+
+    m.clear();
+    REQUIRE(m.empty());
+}
+
+TEST_CASE("FlatMap bulk construction sorts and removes duplicates once", "[flat_map][bulk]") {
+    SECTION("from pairs, keeping the first of equal keys") {
+        const FlatMap<int, std::string> m{{3, "c"}, {1, "a"}, {2, "b"}, {1, "again"}, {3, "x"}};
+        REQUIRE(elements(m) == std::vector<std::pair<int, std::string>>{
+                                   {1, "a"}, {2, "b"}, {3, "c"}});
+    }
+
+    SECTION("from two containers") {
+        const FlatMap<int, char> m{std::vector<int>{5, 4, 5, 1},
+                                   std::vector<char>{'e', 'd', 'x', 'a'}};
+        REQUIRE(m.keys() == std::vector<int>{1, 4, 5});
+        REQUIRE(m.values() == std::vector<char>{'a', 'd', 'e'});
+        REQUIRE_THROWS_AS((FlatMap<int, char>{std::vector<int>{1, 2}, std::vector<char>{'a'}}),
+                          std::invalid_argument);
+    }
+
+    SECTION("already sorted input is taken as it is") {
+        std::vector<int> keys{1, 2, 3};
+        const int* data = keys.data();
+        const FlatMap<int, int> m{flat::sorted_unique, std::move(keys), std::vector<int>{7, 8, 9}};
+        REQUIRE(m.keys().data() == data);
+        REQUIRE(m.at(2) == 8);
+    }
+
+    SECTION("extract and replace hand over the arrays") {
+        FlatMap<int, int> m{{2, 20}, {1, 10}};
+        auto [keys, values] = std::move(m).extract();
+        REQUIRE(m.empty());
+        REQUIRE(keys == std::vector<int>{1, 2});
+        keys.push_back(3);
+        values.push_back(30);
+        m.replace(std::move(keys), std::move(values));
+        REQUIRE(m.at(3) == 30);
+    }
+}
+
+TEST_CASE("FlatMap bulk insert merges into the existing elements", "[flat_map][bulk]") {
+    FlatMap<int, int> m{{10, 0}, {30, 0}, {50, 0}};
+    const std::vector<std::pair<int, int>> batch{{40, 1}, {10, 1}, {20, 1}, {40, 2}, {60, 1}};
+    m.insert(batch.begin(), batch.end());
+    // Existing keys keep their value; the first of a repeated new key wins
+    REQUIRE(elements(m) == std::vector<std::pair<int, int>>{
+                               {10, 0}, {20, 1}, {30, 0}, {40, 1}, {50, 0}, {60, 1}});
+
+    m.insert({{0, 5}});
+    REQUIRE(m.begin()->first == 0);
+}
+
+TEST_CASE("FlatMap agrees with std::map", "[flat_map]") {
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<int> key{0, 300};
+    FlatMap<int, int> flat;
+    std::map<int, int> ref;
+
+    for (int step = 0; step < 5000; ++step) {
+        const int k = key(gen);
+        switch (step % 5) {
+        case 0:
+            REQUIRE(flat.erase(k) == ref.erase(k));
+            break;
+        case 1: {
+            std::vector<std::pair<int, int>> batch;
+            for (int i = 0; i < 8; ++i) {
+                batch.emplace_back(key(gen), step);
+            }
+            flat.insert(batch.begin(), batch.end());
+            ref.insert(batch.begin(), batch.end());
+            break;
+        }
+        default:
+            flat[k] += step;
+            ref[k] += step;
+        }
+        REQUIRE(flat.size() == ref.size());
+        REQUIRE((flat.lower_bound(k) == flat.end()) == (ref.lower_bound(k) == ref.end()));
+        REQUIRE((flat.upper_bound(k) == flat.end()) == (ref.upper_bound(k) == ref.end()));
+        if (flat.lower_bound(k) != flat.end()) {
+            REQUIRE(flat.lower_bound(k)->first == ref.lower_bound(k)->first);
+        }
+    }
+    REQUIRE(elements(flat) == std::vector<std::pair<int, int>>(ref.begin(), ref.end()));
+
+    const auto removed = erase_if(flat, [](const auto& kv) { return kv.first % 3 == 0; });
+    const auto ref_removed = std::erase_if(ref, [](const auto& kv) { return kv.first % 3 == 0; });
+    REQUIRE(removed == ref_removed);
+    REQUIRE(elements(flat) == std::vector<std::pair<int, int>>(ref.begin(), ref.end()));
+}
+
+TEST_CASE("FlatMap heterogeneous lookup", "[flat_map][transparent]") {
+    FlatMap<std::string, int, std::less<>> m{{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    const std::string_view key = "banana";
+    REQUIRE(m.find(key)->second == 2);
+    REQUIRE(m.contains(std::string_view{"cherry"}));
+    REQUIRE(m.at(std::string_view{"apple"}) == 1);
+    REQUIRE(m.lower_bound(std::string_view{"b"})->first == "banana");
+    REQUIRE(m.count(std::string_view{"durian"}) == 0);
+    REQUIRE(m.erase(std::string_view{"apple"}) == 1);
+    REQUIRE(m.size() == 2);
+}
+
+TEST_CASE("FlatMap iterators", "[flat_map][iterator]") {
+    FlatMap<int, int> m{{1, 10}, {2, 20}, {3, 30}};
+
+    for (auto [k, v] : m) {
+        v += k;  // v is a reference into the value array
+    }
+    REQUIRE(m.values() == std::vector<int>{11, 22, 33});
+
+    auto it = m.begin();
+    it->second = 0;
+    REQUIRE(m.at(1) == 0);
+    REQUIRE(it[2].first == 3);
+    REQUIRE(m.end() - m.begin() == 3);
+    REQUIRE(m.begin() < m.end());
+
+    const auto& cm = m;
+    FlatMap<int, int>::const_iterator cit = m.begin();
+    REQUIRE(cit == cm.begin());
+    REQUIRE(std::distance(cm.begin(), cm.end()) == 3);
+    REQUIRE(std::find_if(cm.begin(), cm.end(), [](const auto& kv) { return kv.second == 33; })
+                ->first == 3);
+}
+
+TEST_CASE("FlatMap with move-only values", "[flat_map]") {
+    FlatMap<int, std::unique_ptr<int>> m;
+    m.try_emplace(2, std::make_unique<int>(2));
+    m.try_emplace(1, std::make_unique<int>(1));
+    REQUIRE(*m.at(1) == 1);
+    auto moved = std::move(m);
+    REQUIRE(*moved.at(2) == 2);
+    REQUIRE(moved.erase(1) == 1);
+
+    SECTION("bulk insert from move iterators moves the elements") {
+        std::vector<std::pair<int, std::unique_ptr<int>>> batch;
+        batch.emplace_back(3, std::make_unique<int>(3));
+        batch.emplace_back(0, std::make_unique<int>(0));
+        moved.insert(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        REQUIRE(moved.size() == 3);
+        REQUIRE(*moved.at(0) == 0);
+        REQUIRE(*moved.at(3) == 3);
+        REQUIRE(batch[0].second == nullptr);
+    }
+}
+
+TEST_CASE("FlatMultimap keeps equal keys in insertion order", "[flat_multimap]") {
+    FlatMultimap<std::string, std::string> book{
+        {"bob", "555-1"}, {"alice", "555-2"}, {"bob", "555-3"}, {"carol", "555-4"}};
+    book.insert({"bob", "555-5"});
+
+    REQUIRE(book.size() == 5);
+    REQUIRE(book.count("bob") == 3);
+    REQUIRE(book.find("bob")->second == "555-1");
+
+    std::vector<std::string> numbers;
+    for (auto [it, end] = book.equal_range("bob"); it != end; ++it) {
+        numbers.push_back(it->second);
+    }
+    REQUIRE(numbers == std::vector<std::string>{"555-1", "555-3", "555-5"});
+
+    SECTION("bulk insert appends after the existing equal keys") {
+        const std::vector<std::pair<std::string, std::string>> more{{"bob", "555-6"},
+                                                                    {"alice", "555-7"}};
+        book.insert(more.begin(), more.end());
+        REQUIRE(book.count("bob") == 4);
+        REQUIRE(std::prev(book.upper_bound("bob"))->second == "555-6");
+        REQUIRE(std::prev(book.upper_bound("alice"))->second == "555-7");
+    }
+
+    SECTION("erase by key removes every equal key") {
+        REQUIRE(book.erase("bob") == 3);
+        REQUIRE(book.size() == 2);
+        REQUIRE_FALSE(book.contains("bob"));
+    }
+}
+
+TEST_CASE("FlatMultimap agrees with std::multimap", "[flat_multimap]") {
+    std::mt19937 gen{9};
+    std::uniform_int_distribution<int> key{0, 50};
+    FlatMultimap<int, int> flat;
+    std::multimap<int, int> ref;
+    for (int step = 0; step < 2000; ++step) {
+        const int k = key(gen);
+        if (step % 7 == 0) {
+            REQUIRE(flat.erase(k) == ref.erase(k));
+        } else {
+            flat.insert({k, step});
+            ref.insert({k, step});
+        }
+        REQUIRE(flat.count(k) == ref.count(k));
+    }
+    REQUIRE(elements(flat) == std::vector<std::pair<int, int>>(ref.begin(), ref.end()));
+}
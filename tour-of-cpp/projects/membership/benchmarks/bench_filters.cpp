@@ -0,0 +1,149 @@
+// Benchmark: BloomFilter and CuckooFilter vs. an exact hash set
+//
+// Operations on 64-bit ids, the usual key of a large remote set:
+//   insert      - n keys into a filter built for n
+//   query_miss  - n lookups of absent keys, one at a time; what a filter
+//                 in front of a slow lookup mostly sees
+//   query_hit   - n lookups of present keys
+//   query_bulk  - the misses again, through contains_all(), which hashes
+//                 a batch of keys and prefetches their memory first
+//
+//   bloom       - BloomFilter at 1% false positives (about 10.5 bits per key)
+//   cuckoo8     - CuckooFilter<std::uint8_t>, at most 3.1%
+//   cuckoo16    - CuckooFilter<std::uint16_t>, at most 0.012%
+//   exact       - flat::FlatHashSet<std::uint64_t> (projects/flat_containers)
+//
+// Sizes stop at 1M keys to keep the smoke test short; the filters that the
+// queries read are built once per size.
+
+#include "bench.h"
+#include "bloom_filter.h"
+#include "cuckoo_filter.h"
+#include "flat_hash_map.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Distinct ids: the first n are members, the next n are not
+std::uint64_t id(std::uint64_t i) { return membership::detail::mix(i + 1); }
+
+const std::vector<std::uint64_t>& queries(std::int64_t n, bool hit) {
+    static std::map<std::pair<std::int64_t, bool>, std::vector<std::uint64_t>> cache;
+    auto& out = cache[{n, hit}];
+    if (out.empty()) {
+        const auto first = hit ? 0 : static_cast<std::uint64_t>(n);
+        for (std::uint64_t i = 0; i < static_cast<std::uint64_t>(n); ++i) {
+            out.push_back(id(first + i));
+        }
+        std::shuffle(out.begin(), out.end(), std::mt19937{7});
+    }
+    return out;
+}
+
+struct Bloom {
+    explicit Bloom(std::size_t n) : filter(n, 0.01) {}
+    void insert(std::uint64_t key) { filter.insert(key); }
+    bool contains(std::uint64_t key) const { return filter.contains(key); }
+    membership::BloomFilter filter;
+};
+
+template <typename Fingerprint>
+struct Cuckoo {
+    explicit Cuckoo(std::size_t n) : filter(n) {}
+    void insert(std::uint64_t key) { filter.insert(key); }
+    bool contains(std::uint64_t key) const { return filter.contains(key); }
+    membership::CuckooFilter<Fingerprint> filter;
+};
+
+struct Exact {
+    explicit Exact(std::size_t n) { set.reserve(n); }
+    void insert(std::uint64_t key) { set.insert(key); }
+    bool contains(std::uint64_t key) const { return set.contains(key); }
+    flat::FlatHashSet<std::uint64_t> set;
+};
+
+template <typename Set>
+const Set& built(std::int64_t n) {
+    static std::map<std::int64_t, std::unique_ptr<Set>> cache;
+    auto& set = cache[n];
+    if (!set) {
+        set = std::make_unique<Set>(static_cast<std::size_t>(n));
+        for (const auto key : queries(n, true)) {
+            set->insert(key);
+        }
+    }
+    return *set;
+}
+
+template <typename Set>
+void insert(bench::State& state) {
+    const auto& keys = queries(state.arg(), true);
+    while (state.keep_running()) {
+        Set set{keys.size()};
+        for (const auto key : keys) {
+            set.insert(key);
+        }
+        bench::do_not_optimize(&set);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Set>
+void query(bench::State& state, bool hit) {
+    const auto& keys = queries(state.arg(), hit);
+    const Set& set = built<Set>(state.arg());
+    while (state.keep_running()) {
+        std::uint64_t found = 0;
+        for (const auto key : keys) {
+            found += set.contains(key) ? 1u : 0u;
+        }
+        bench::do_not_optimize(found);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Set>
+void query_bulk(bench::State& state) {
+    const auto& keys = queries(state.arg(), false);
+    const Set& set = built<Set>(state.arg());
+    const auto results = std::make_unique<bool[]>(keys.size());
+    while (state.keep_running()) {
+        bench::do_not_optimize(set.filter.contains_all(keys, {results.get(), keys.size()}));
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Set>
+void register_set(const std::string& name) {
+    constexpr std::int64_t small = 1 << 12;
+    constexpr std::int64_t large = 1 << 20;
+
+    bench::register_benchmark("insert/" + name, insert<Set>)->range(small, large, 16);
+    bench::register_benchmark("query_miss/" + name,
+                              [](bench::State& s) { query<Set>(s, false); })
+        ->range(small, large, 16);
+    bench::register_benchmark("query_hit/" + name, [](bench::State& s) { query<Set>(s, true); })
+        ->range(small, large, 16);
+    if constexpr (requires(const Set& set) { set.filter; }) {
+        bench::register_benchmark("query_bulk/" + name, query_bulk<Set>)->range(small, large, 16);
+    }
+}
+
+[[maybe_unused]] const bool registered = [] {
+    register_set<Bloom>("bloom");
+    register_set<Cuckoo<std::uint8_t>>("cuckoo8");
+    register_set<Cuckoo<std::uint16_t>>("cuckoo16");
+    register_set<Exact>("exact");
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,147 @@
+// Benchmark: PerfectHashSet vs. general hash sets, for a fixed set of names
+//
+// Operations on user-name-like strings of 4 to 20 characters:
+//   build       - building the set from n names
+//   lookup_hit  - n lookups of names in the set, in random order
+//   lookup_miss - n lookups of names that are not
+//
+//   std         - std::unordered_set<std::string>
+//   flat        - flat::FlatHashSet<std::string> (projects/flat_containers)
+//   perfect     - PerfectHashSet: one pilot, one slot, one record
+//
+// Lookups take a std::string_view, as a validator reading names out of a
+// request would; the standard set needs a std::string built for each.
+//
+// Sizes stop at 64K names to keep the smoke test short; the sets that the
+// lookups read are built once per size.
+
+#include "bench.h"
+#include "flat_hash_map.h"
+#include "perfect_hash_set.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// 2n distinct names; the first n go into the set, the rest are misses
+const std::vector<std::string>& names(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::string>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937_64 gen{42};
+        std::uniform_int_distribution<std::size_t> length{4, 20};
+        std::uniform_int_distribution<int> letter{'a', 'z'};
+        std::set<std::string> seen;
+        while (out.size() < static_cast<std::size_t>(2 * n)) {
+            std::string name(length(gen), ' ');
+            for (auto& c : name) {
+                c = static_cast<char>(letter(gen));
+            }
+            if (seen.insert(name).second) {
+                out.push_back(std::move(name));
+            }
+        }
+    }
+    return out;
+}
+
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+struct StdSet {
+    explicit StdSet(const std::vector<std::string>& keys) : set(keys.begin(), keys.end()) {}
+    bool contains(std::string_view key) const { return set.count(std::string{key}) != 0; }
+    std::unordered_set<std::string> set;
+};
+
+struct FlatSet {
+    explicit FlatSet(const std::vector<std::string>& keys) : set(keys.begin(), keys.end()) {}
+    bool contains(std::string_view key) const { return set.contains(key); }
+    flat::FlatHashSet<std::string, StringHash, StringEqual> set;
+};
+
+struct PerfectSet {
+    explicit PerfectSet(const std::vector<std::string>& keys) : set(keys) {}
+    bool contains(std::string_view key) const { return set.contains(key); }
+    membership::PerfectHashSet set;
+};
+
+std::vector<std::string> members(std::int64_t n) {
+    const auto& all = names(n);
+    return {all.begin(), all.begin() + n};
+}
+
+// The set under test for n names, built once and shared by both lookups
+template <typename Set>
+const Set& built(std::int64_t n) {
+    static std::map<std::int64_t, Set> cache;
+    auto it = cache.find(n);
+    if (it == cache.end()) {
+        it = cache.emplace(n, Set{members(n)}).first;
+    }
+    return it->second;
+}
+
+template <typename Set>
+void build(bench::State& state) {
+    const auto keys = members(state.arg());
+    while (state.keep_running()) {
+        const Set set{keys};
+        bench::do_not_optimize(&set);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Set>
+void lookup(bench::State& state, bool hit) {
+    const auto& all = names(state.arg());
+    const Set& set = built<Set>(state.arg());
+    std::vector<std::string_view> queries(all.begin() + (hit ? 0 : state.arg()),
+                                          all.begin() + (hit ? state.arg() : 2 * state.arg()));
+    std::shuffle(queries.begin(), queries.end(), std::mt19937{7});
+    while (state.keep_running()) {
+        std::uint64_t found = 0;
+        for (const auto q : queries) {
+            found += set.contains(q) ? 1u : 0u;
+        }
+        bench::do_not_optimize(found);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Set>
+void register_set(const std::string& name, std::int64_t lo, std::int64_t hi) {
+    bench::register_benchmark("build/" + name, build<Set>)->range(lo, hi, 16);
+    bench::register_benchmark("lookup_hit/" + name, [](bench::State& s) { lookup<Set>(s, true); })
+        ->range(lo, hi, 16);
+    bench::register_benchmark("lookup_miss/" + name,
+                              [](bench::State& s) { lookup<Set>(s, false); })
+        ->range(lo, hi, 16);
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 16;
+
+    register_set<StdSet>("std", small, large);
+    register_set<FlatSet>("flat", small, large);
+    register_set<PerfectSet>("perfect", small, large);
+    return true;
+}();
+
+} // namespace
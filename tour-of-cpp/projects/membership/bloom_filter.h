@@ -0,0 +1,342 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include "filter_common.h"
+#include "serialization.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// AVX2 computes and tests a whole block in one register; SSE2, which every
+// x86-64 has, works on it in two halves. Define MEMBERSHIP_NO_SIMD to compare
+// against the portable loop.
+#if !defined(MEMBERSHIP_NO_SIMD) && defined(__AVX2__)
+#define MEMBERSHIP_AVX2 1
+#include <immintrin.h>
+#else
+#define MEMBERSHIP_AVX2 0
+#endif
+
+#if !defined(MEMBERSHIP_NO_SIMD) && !MEMBERSHIP_AVX2 && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MEMBERSHIP_SSE2 1
+#include <emmintrin.h>
+#else
+#define MEMBERSHIP_SSE2 0
+#endif
+
+namespace membership {
+
+namespace detail {
+
+// =============================================================================
+// Split blocks
+// =============================================================================
+//
+// A key touches one 256-bit block - one cache line or less - and sets one
+// bit in each of its eight 32-bit words. The word's bit comes from
+// multiplying the low 32 bits of the key's hash by a per-word odd constant
+// and keeping the top five bits (the "split block" filter of Apache
+// Parquet). The high 32 bits of the hash pick the block.
+
+struct alignas(32) BloomBlock {
+    std::array<std::uint32_t, 8> words{};
+};
+
+inline constexpr std::array<std::uint32_t, 8> bloom_salts{
+    0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+    0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u};
+
+[[nodiscard]] constexpr std::array<std::uint32_t, 8> bloom_masks(std::uint32_t key) noexcept {
+    std::array<std::uint32_t, 8> masks{};
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        masks[i] = 1u << ((key * bloom_salts[i]) >> 27);
+    }
+    return masks;
+}
+
+#if MEMBERSHIP_SSE2
+// Four of the masks in a register. SSE2 has neither a 32-bit multiply nor
+// per-lane shifts: the products come from two 32x32->64 multiplies, and
+// 1 << b from building the float 2^b and converting it back to an integer
+// (2^31 is out of range and converts to 0x80000000, which is 1 << 31).
+[[nodiscard]] inline __m128i bloom_masks_sse2(std::uint32_t key, std::size_t first) noexcept {
+    const auto salts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&bloom_salts[first]));
+    const auto k = _mm_set1_epi32(static_cast<int>(key));
+    const auto even = _mm_mul_epu32(k, salts);
+    const auto odd = _mm_mul_epu32(k, _mm_srli_epi64(salts, 32));
+    const auto products = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    const auto exponents = _mm_slli_epi32(_mm_add_epi32(_mm_srli_epi32(products, 27),
+                                                        _mm_set1_epi32(127)), 23);
+    return _mm_cvttps_epi32(_mm_castsi128_ps(exponents));
+}
+#endif
+
+inline void bloom_set(BloomBlock& block, std::uint32_t key) noexcept {
+#if MEMBERSHIP_AVX2
+    const auto salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloom_salts.data()));
+    const auto bits = _mm256_srli_epi32(
+        _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27);
+    const auto masks = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    auto* p = reinterpret_cast<__m256i*>(block.words.data());
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), masks));
+#elif MEMBERSHIP_SSE2
+    auto* p = reinterpret_cast<__m128i*>(block.words.data());
+    _mm_store_si128(p, _mm_or_si128(_mm_load_si128(p), bloom_masks_sse2(key, 0)));
+    _mm_store_si128(p + 1, _mm_or_si128(_mm_load_si128(p + 1), bloom_masks_sse2(key, 4)));
+#else
+    const auto masks = bloom_masks(key);
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        block.words[i] |= masks[i];
+    }
+#endif
+}
+
+[[nodiscard]] inline bool bloom_test(const BloomBlock& block, std::uint32_t key) noexcept {
+#if MEMBERSHIP_AVX2
+    const auto salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloom_salts.data()));
+    const auto bits = _mm256_srli_epi32(
+        _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27);
+    const auto masks = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    // testc: are all bits of masks set in the block?
+    return _mm256_testc_si256(
+               _mm256_load_si256(reinterpret_cast<const __m256i*>(block.words.data())), masks) != 0;
+#elif MEMBERSHIP_SSE2
+    const auto* w = reinterpret_cast<const __m128i*>(block.words.data());
+    const auto m0 = bloom_masks_sse2(key, 0);
+    const auto m1 = bloom_masks_sse2(key, 4);
+    const auto hit0 = _mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(w), m0), m0);
+    const auto hit1 = _mm_cmpeq_epi32(_mm_and_si128(_mm_load_si128(w + 1), m1), m1);
+    return _mm_movemask_epi8(_mm_and_si128(hit0, hit1)) == 0xFFFF;
+#else
+    const auto masks = bloom_masks(key);
+    std::uint32_t missing = 0;  // no early exit: misses would mispredict
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        missing |= masks[i] & ~block.words[i];
+    }
+    return missing == 0;
+#endif
+}
+
+// The false-positive rate at a given number of bits per key: the number of
+// keys in a block is Poisson distributed, and a block holding i keys
+// answers yes to a stranger if all eight of its bits are already set.
+[[nodiscard]] inline double bloom_false_positive_rate(double bits_per_key) {
+    const double keys_per_block = 256.0 / bits_per_key;
+    const auto last = static_cast<int>(keys_per_block + 12 * std::sqrt(keys_per_block) + 20);
+    double poisson = std::exp(-keys_per_block);  // P(i = 0)
+    double rate = 0;
+    for (int i = 1; i <= last; ++i) {
+        poisson *= keys_per_block / i;
+        rate += poisson * std::pow(1 - std::pow(31.0 / 32.0, i), 8);
+    }
+    return rate;
+}
+
+inline constexpr double bloom_max_bits_per_key = 64;
+
+// The fewest bits per key that reach a rate, to within 1%
+[[nodiscard]] inline double bloom_bits_per_key(double false_positive_rate) {
+    double lo = 1;
+    double hi = bloom_max_bits_per_key;
+    while (hi - lo > 0.01 * lo) {
+        const double mid = (lo + hi) / 2;
+        (bloom_false_positive_rate(mid) > false_positive_rate ? lo : hi) = mid;
+    }
+    return hi;
+}
+
+// =============================================================================
+// The serialized form
+// =============================================================================
+//
+//   offset 0   u64 magic
+//          8   u64 block count
+//         16   u64 insertions
+//         24   u64 reserved (0)
+//         32   the blocks, 32 bytes each
+
+inline constexpr std::uint64_t bloom_magic = 0x31'46'4D'4F'4F'4C'42'00ULL;  // "\0BLOOMF1"
+inline constexpr std::size_t bloom_header_size = 32;
+
+} // namespace detail
+
+/**
+ * A blocked Bloom filter: a compact set that can answer "definitely not
+ * present" or "probably present", and never misses a key it was given.
+ *
+ *     membership::BloomFilter seen{1'000'000, 0.01};  // 1M keys, 1% false positives
+ *     seen.insert("alice");
+ *     if (seen.contains(name)) {
+ *         // maybe: ask the real, slow set
+ *     }
+ *
+ * Each key sets eight bits in a single 32-byte block, so both insert and
+ * contains touch one cache line, and a query tests the block with one or
+ * two SIMD instructions. That costs some accuracy against a classic Bloom
+ * filter, which the constructor allows for: 1% takes about 10.5 bits per
+ * key instead of 9.6. Rates below about 10^-6 would need more than the
+ * 64 bits per key it allows. Keys cannot be removed; see CuckooFilter.
+ */
+class BloomFilter {
+public:
+    BloomFilter(std::size_t expected_keys, double false_positive_rate) {
+        if (!(false_positive_rate > 0 && false_positive_rate < 1)) {
+            throw std::invalid_argument{"BloomFilter: rate must be between 0 and 1"};
+        }
+        const double bits = static_cast<double>(std::max<std::size_t>(expected_keys, 1)) *
+                            detail::bloom_bits_per_key(false_positive_rate);
+        const auto blocks = static_cast<std::uint64_t>(std::ceil(bits / 256));
+        if (blocks >= std::uint64_t{1} << 32) {
+            throw std::length_error{"BloomFilter: too many keys"};
+        }
+        blocks_.resize(static_cast<std::size_t>(blocks));
+    }
+
+    explicit BloomFilter(std::size_t expected_keys) : BloomFilter(expected_keys, 0.01) {}
+
+    template <FilterKey K>
+    void insert(const K& key) noexcept {
+        const auto h = detail::hash_key(key);
+        detail::bloom_set(blocks_[block_index(h)], static_cast<std::uint32_t>(h));
+        ++insertions_;
+    }
+
+    // False: certainly never inserted. True: inserted, or a false positive.
+    template <FilterKey K>
+    [[nodiscard]] bool contains(const K& key) const noexcept {
+        const auto h = detail::hash_key(key);
+        return detail::bloom_test(blocks_[block_index(h)], static_cast<std::uint32_t>(h));
+    }
+
+    template <std::ranges::input_range R>
+        requires FilterKey<std::ranges::range_value_t<R>>
+    void insert_all(const R& keys) {
+        for (const auto& key : keys) {
+            insert(key);
+        }
+    }
+
+    /**
+     * contains() for every key, written to results in order; returns how
+     * many were found. Keys are hashed a batch at a time and their blocks
+     * prefetched before any is tested, which hides most of the memory
+     * latency once the filter outgrows the cache.
+     */
+    template <std::ranges::input_range R>
+        requires FilterKey<std::ranges::range_value_t<R>> && std::ranges::sized_range<R>
+    std::size_t contains_all(const R& keys, std::span<bool> results) const {
+        if (results.size() < std::ranges::size(keys)) {
+            throw std::invalid_argument{"BloomFilter::contains_all: results too small"};
+        }
+        std::array<std::uint64_t, detail::batch_size> hashes{};
+        std::size_t found = 0;
+        std::size_t done = 0;
+        std::size_t pending = 0;
+        const auto flush = [&] {
+            for (std::size_t i = 0; i < pending; ++i) {
+                const bool hit = detail::bloom_test(blocks_[block_index(hashes[i])],
+                                                    static_cast<std::uint32_t>(hashes[i]));
+                results[done++] = hit;
+                found += hit ? 1 : 0;
+            }
+            pending = 0;
+        };
+        for (const auto& key : keys) {
+            hashes[pending] = detail::hash_key(key);
+            detail::prefetch(&blocks_[block_index(hashes[pending])]);
+            if (++pending == hashes.size()) {
+                flush();
+            }
+        }
+        flush();
+        return found;
+    }
+
+    // Adds every key of `other`, which must have the same size
+    void merge(const BloomFilter& other) {
+        if (other.blocks_.size() != blocks_.size()) {
+            throw std::invalid_argument{"BloomFilter::merge: filters differ in size"};
+        }
+        for (std::size_t b = 0; b < blocks_.size(); ++b) {
+            for (std::size_t w = 0; w < 8; ++w) {
+                blocks_[b].words[w] |= other.blocks_[b].words[w];
+            }
+        }
+        insertions_ += other.insertions_;
+    }
+
+    void clear() noexcept {
+        std::fill(blocks_.begin(), blocks_.end(), detail::BloomBlock{});
+        insertions_ = 0;
+    }
+
+    // Calls to insert(), counting repeated keys each time
+    [[nodiscard]] std::size_t insertions() const noexcept { return insertions_; }
+    [[nodiscard]] std::size_t size_bytes() const noexcept { return 32 * blocks_.size(); }
+
+    // The expected rate for the keys inserted so far
+    [[nodiscard]] double false_positive_rate() const {
+        if (insertions_ == 0) {
+            return 0;
+        }
+        return detail::bloom_false_positive_rate(static_cast<double>(8 * size_bytes()) /
+                                                 static_cast<double>(insertions_));
+    }
+
+    [[nodiscard]] std::vector<std::byte> to_bytes() const {
+        std::vector<std::byte> out;
+        out.reserve(detail::bloom_header_size + size_bytes());
+        detail::write(out, detail::bloom_magic);
+        detail::write(out, std::uint64_t{blocks_.size()});
+        detail::write(out, std::uint64_t{insertions_});
+        detail::write(out, std::uint64_t{0});
+        detail::write_bytes(out, blocks_.data(), size_bytes());
+        return out;
+    }
+
+    // Throws std::invalid_argument if the bytes are not a filter's to_bytes()
+    [[nodiscard]] static BloomFilter from_bytes(std::span<const std::byte> bytes) {
+        const auto fail = [] {
+            throw std::invalid_argument{"BloomFilter: malformed bytes"};
+        };
+        if (bytes.size() < detail::bloom_header_size ||
+            detail::read_u64(bytes.data()) != detail::bloom_magic) {
+            fail();
+        }
+        const auto blocks = detail::read_u64(bytes.data() + 8);
+        if (blocks == 0 || blocks >= std::uint64_t{1} << 32 ||
+            bytes.size() != detail::bloom_header_size + 32 * blocks) {
+            fail();
+        }
+        BloomFilter filter;
+        filter.blocks_.resize(static_cast<std::size_t>(blocks));
+        std::memcpy(filter.blocks_.data(), bytes.data() + detail::bloom_header_size,
+                    filter.size_bytes());
+        filter.insertions_ = detail::read_u64(bytes.data() + 16);
+        return filter;
+    }
+
+private:
+    BloomFilter() = default;
+
+    [[nodiscard]] std::size_t block_index(std::uint64_t hash) const noexcept {
+        return detail::fast_range(static_cast<std::uint32_t>(hash >> 32),
+                                  static_cast<std::uint32_t>(blocks_.size()));
+    }
+
+    std::vector<detail::BloomBlock> blocks_;
+    std::size_t insertions_ = 0;
+};
+
+} // namespace membership
+
+#endif // BLOOM_FILTER_H
@@ -0,0 +1,393 @@
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include "filter_common.h"
+#include "serialization.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace membership {
+
+namespace detail {
+
+// =============================================================================
+// Buckets
+// =============================================================================
+//
+// The table is an array of buckets of four fingerprints; 0 marks an empty
+// slot. A key's fingerprint may sit in either of two buckets, i1 from its
+// hash and i2 = i1 ^ hash(fingerprint). Since i1 = i2 ^ hash(fingerprint)
+// as well, a fingerprint can be moved to its other bucket without knowing
+// the key ("partial-key cuckoo hashing"). The bucket count is a power of
+// two so the XOR stays in range.
+
+inline constexpr std::size_t cuckoo_slots = 4;
+inline constexpr int cuckoo_max_kicks = 500;
+inline constexpr double cuckoo_max_load = 0.95;
+
+/**
+ * Whether any of a bucket's four fingerprints equals fp, with no loop or
+ * branch per slot: XOR fp into every lane, then look for a lane that is
+ * now zero. (x - 0x01..01) & ~x & 0x80..80 is non-zero exactly when some
+ * lane of x is zero. One 32-bit word holds a bucket of 8-bit
+ * fingerprints, one 64-bit word a bucket of 16-bit ones.
+ */
+template <std::unsigned_integral F>
+[[nodiscard]] bool bucket_contains(const F* bucket, F fp) noexcept {
+    using Word = std::conditional_t<sizeof(F) == 1, std::uint32_t, std::uint64_t>;
+    constexpr Word ones = ~Word{0} / std::numeric_limits<F>::max();
+    constexpr Word highs = ones << (8 * sizeof(F) - 1);
+    constexpr std::size_t words = cuckoo_slots * sizeof(F) / sizeof(Word);
+    Word zero_lanes = 0;
+    for (std::size_t w = 0; w < words; ++w) {
+        Word x;
+        std::memcpy(&x, reinterpret_cast<const char*>(bucket) + w * sizeof(Word), sizeof x);
+        x ^= ones * fp;
+        zero_lanes |= (x - ones) & ~x & highs;
+    }
+    return zero_lanes != 0;
+}
+
+// =============================================================================
+// The serialized form
+// =============================================================================
+//
+//   offset 0   u64 magic
+//          8   u32 fingerprint bits
+//         12   u32 1 if the victim below holds a fingerprint
+//         16   u64 bucket count
+//         24   u64 fingerprints stored
+//         32   u64 victim bucket
+//         40   u64 victim fingerprint
+//         48   the buckets, 4 fingerprints each
+
+inline constexpr std::uint64_t cuckoo_magic = 0x31'46'4F'4B'43'55'43'00ULL;  // "\0CUCKOF1"
+inline constexpr std::size_t cuckoo_header_size = 48;
+
+} // namespace detail
+
+/**
+ * A cuckoo filter: like a Bloom filter it answers "definitely not present"
+ * or "probably present", but it stores a small fingerprint per key, so
+ * keys can also be erased.
+ *
+ *     membership::CuckooFilter<> sessions{100'000};
+ *     sessions.insert(session_id);
+ *     sessions.erase(session_id);        // on logout
+ *
+ * The fingerprint type sets the false-positive rate, at most 8 / 2^bits:
+ *
+ *     std::uint8_t    3.1%        1 byte per slot
+ *     std::uint16_t   0.012%      2 bytes per slot (the default)
+ *     std::uint32_t   2 * 10^-9   4 bytes per slot
+ *
+ * A query reads two buckets and compares all four fingerprints of each at
+ * once (see bucket_contains). The filter holds the capacity it was built
+ * for, rounded up so the bucket count is a power of two; near full,
+ * insert() moves fingerprints between buckets, and it returns false once
+ * no room can be made.
+ *
+ * Only erase keys that were inserted: erasing a stranger whose fingerprint
+ * happens to match removes another key's. Inserting a key twice stores it
+ * twice, and it then takes two erases.
+ */
+template <std::unsigned_integral Fingerprint = std::uint16_t>
+    requires(sizeof(Fingerprint) <= 4)
+class CuckooFilter {
+public:
+    explicit CuckooFilter(std::size_t capacity) {
+        const auto wanted = static_cast<double>(std::max<std::size_t>(capacity, 1)) /
+                            (detail::cuckoo_slots * detail::cuckoo_max_load);
+        if (wanted > static_cast<double>(std::uint64_t{1} << 32)) {
+            throw std::length_error{"CuckooFilter: capacity too large"};
+        }
+        const auto buckets = std::bit_ceil(static_cast<std::size_t>(wanted) + 1);
+        slots_.assign(buckets * detail::cuckoo_slots, 0);
+        mask_ = buckets - 1;
+    }
+
+    // The rate at full capacity, an upper bound
+    [[nodiscard]] static constexpr double false_positive_rate() noexcept {
+        return 2.0 * detail::cuckoo_slots / std::numeric_limits<Fingerprint>::max();
+    }
+
+    // False if the filter is full; the key was not added
+    template <FilterKey K>
+    bool insert(const K& key) {
+        if (victim_.used) {
+            return false;
+        }
+        const auto h = detail::hash_key(key);
+        return add(first_bucket(h), fingerprint(h));
+    }
+
+    // False: certainly never inserted. True: inserted, or a false positive.
+    template <FilterKey K>
+    [[nodiscard]] bool contains(const K& key) const noexcept {
+        const auto h = detail::hash_key(key);
+        return contains_hash(h);
+    }
+
+    // Removes one copy of the key's fingerprint; false if there was none
+    template <FilterKey K>
+    bool erase(const K& key) {
+        const auto h = detail::hash_key(key);
+        const auto fp = fingerprint(h);
+        const auto i1 = first_bucket(h);
+        const auto i2 = other_bucket(i1, fp);
+        if (victim_.used && victim_.fingerprint == fp &&
+            (victim_.bucket == i1 || victim_.bucket == i2)) {
+            victim_.used = false;
+            --size_;
+            return true;
+        }
+        if (!remove(i1, fp) && !remove(i2, fp)) {
+            return false;
+        }
+        --size_;
+        // The victim waited for a free slot; there is one now
+        if (victim_.used) {
+            victim_.used = false;
+            --size_;
+            add(victim_.bucket, victim_.fingerprint);
+        }
+        return true;
+    }
+
+    // insert() for each key in turn; returns how many fit
+    template <std::ranges::input_range R>
+        requires FilterKey<std::ranges::range_value_t<R>>
+    std::size_t insert_all(const R& keys) {
+        std::size_t inserted = 0;
+        for (const auto& key : keys) {
+            if (!insert(key)) {
+                break;
+            }
+            ++inserted;
+        }
+        return inserted;
+    }
+
+    /**
+     * contains() for every key, written to results in order; returns how
+     * many were found. Both buckets of a batch of keys are prefetched
+     * before any is read.
+     */
+    template <std::ranges::input_range R>
+        requires FilterKey<std::ranges::range_value_t<R>> && std::ranges::sized_range<R>
+    std::size_t contains_all(const R& keys, std::span<bool> results) const {
+        if (results.size() < std::ranges::size(keys)) {
+            throw std::invalid_argument{"CuckooFilter::contains_all: results too small"};
+        }
+        std::array<std::uint64_t, detail::batch_size> hashes{};
+        std::size_t found = 0;
+        std::size_t done = 0;
+        std::size_t pending = 0;
+        const auto flush = [&] {
+            for (std::size_t i = 0; i < pending; ++i) {
+                const bool hit = contains_hash(hashes[i]);
+                results[done++] = hit;
+                found += hit ? 1 : 0;
+            }
+            pending = 0;
+        };
+        for (const auto& key : keys) {
+            const auto h = detail::hash_key(key);
+            const auto i1 = first_bucket(h);
+            detail::prefetch(bucket(i1));
+            detail::prefetch(bucket(other_bucket(i1, fingerprint(h))));
+            hashes[pending] = h;
+            if (++pending == hashes.size()) {
+                flush();
+            }
+        }
+        flush();
+        return found;
+    }
+
+    void clear() noexcept {
+        std::fill(slots_.begin(), slots_.end(), Fingerprint{0});
+        size_ = 0;
+        victim_ = {};
+    }
+
+    // Fingerprints stored: insertions minus erasures
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::size_t slot_count() const noexcept { return slots_.size(); }
+    [[nodiscard]] double load_factor() const noexcept {
+        return static_cast<double>(size_) / static_cast<double>(slots_.size());
+    }
+    [[nodiscard]] std::size_t size_bytes() const noexcept {
+        return slots_.size() * sizeof(Fingerprint);
+    }
+
+    [[nodiscard]] std::vector<std::byte> to_bytes() const {
+        std::vector<std::byte> out;
+        out.reserve(detail::cuckoo_header_size + size_bytes());
+        detail::write(out, detail::cuckoo_magic);
+        detail::write(out, std::uint32_t{8 * sizeof(Fingerprint)});
+        detail::write(out, std::uint32_t{victim_.used ? 1u : 0u});
+        detail::write(out, std::uint64_t{mask_ + 1});
+        detail::write(out, std::uint64_t{size_});
+        detail::write(out, std::uint64_t{victim_.bucket});
+        detail::write(out, std::uint64_t{victim_.fingerprint});
+        detail::write_bytes(out, slots_.data(), size_bytes());
+        return out;
+    }
+
+    // Throws std::invalid_argument if the bytes are not the to_bytes() of
+    // a filter with the same fingerprint type
+    [[nodiscard]] static CuckooFilter from_bytes(std::span<const std::byte> bytes) {
+        const auto fail = [] {
+            throw std::invalid_argument{"CuckooFilter: malformed bytes"};
+        };
+        if (bytes.size() < detail::cuckoo_header_size ||
+            detail::read_u64(bytes.data()) != detail::cuckoo_magic ||
+            detail::read_u32(bytes.data() + 8) != 8 * sizeof(Fingerprint)) {
+            fail();
+        }
+        const auto buckets = detail::read_u64(bytes.data() + 16);
+        if (!std::has_single_bit(buckets) || buckets > std::uint64_t{1} << 32 ||
+            bytes.size() != detail::cuckoo_header_size +
+                                buckets * detail::cuckoo_slots * sizeof(Fingerprint)) {
+            fail();
+        }
+        CuckooFilter filter{1};
+        filter.slots_.resize(static_cast<std::size_t>(buckets) * detail::cuckoo_slots);
+        filter.mask_ = static_cast<std::size_t>(buckets) - 1;
+        std::memcpy(filter.slots_.data(), bytes.data() + detail::cuckoo_header_size,
+                    filter.size_bytes());
+
+        auto& victim = filter.victim_;
+        victim.used = detail::read_u32(bytes.data() + 12) != 0;
+        const auto victim_bucket = detail::read_u64(bytes.data() + 32);
+        const auto victim_fingerprint = detail::read_u64(bytes.data() + 40);
+        if (victim.used && (victim_bucket >= buckets || victim_fingerprint == 0 ||
+                            victim_fingerprint > std::numeric_limits<Fingerprint>::max())) {
+            fail();
+        }
+        victim.bucket = static_cast<std::size_t>(victim_bucket);
+        victim.fingerprint = static_cast<Fingerprint>(victim_fingerprint);
+
+        // The count must match the table, or erase() could underflow it
+        filter.size_ = static_cast<std::size_t>(
+            std::count_if(filter.slots_.begin(), filter.slots_.end(),
+                          [](Fingerprint fp) { return fp != 0; }) +
+            (victim.used ? 1 : 0));
+        if (filter.size_ != detail::read_u64(bytes.data() + 24)) {
+            fail();
+        }
+        return filter;
+    }
+
+private:
+    struct Victim {
+        std::size_t bucket = 0;
+        Fingerprint fingerprint = 0;
+        bool used = false;
+    };
+
+    // The low bits of the hash, never 0; the bucket uses the high bits
+    [[nodiscard]] static Fingerprint fingerprint(std::uint64_t hash) noexcept {
+        const auto fp = static_cast<Fingerprint>(hash);
+        return fp == 0 ? Fingerprint{1} : fp;
+    }
+
+    [[nodiscard]] std::size_t first_bucket(std::uint64_t hash) const noexcept {
+        return (hash >> 32) & mask_;
+    }
+
+    [[nodiscard]] std::size_t other_bucket(std::size_t bucket, Fingerprint fp) const noexcept {
+        return (bucket ^ static_cast<std::size_t>(detail::mix(fp))) & mask_;
+    }
+
+    [[nodiscard]] Fingerprint* bucket(std::size_t i) noexcept {
+        return slots_.data() + i * detail::cuckoo_slots;
+    }
+    [[nodiscard]] const Fingerprint* bucket(std::size_t i) const noexcept {
+        return slots_.data() + i * detail::cuckoo_slots;
+    }
+
+    [[nodiscard]] bool contains_hash(std::uint64_t h) const noexcept {
+        const auto fp = fingerprint(h);
+        const auto i1 = first_bucket(h);
+        const auto i2 = other_bucket(i1, fp);
+        const bool in_victim = victim_.used && victim_.fingerprint == fp &&
+                               (victim_.bucket == i1 || victim_.bucket == i2);
+        return detail::bucket_contains(bucket(i1), fp) ||
+               detail::bucket_contains(bucket(i2), fp) || in_victim;
+    }
+
+    bool try_put(std::size_t i, Fingerprint fp) noexcept {
+        for (auto* slot = bucket(i); slot != bucket(i) + detail::cuckoo_slots; ++slot) {
+            if (*slot == 0) {
+                *slot = fp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool remove(std::size_t i, Fingerprint fp) noexcept {
+        for (auto* slot = bucket(i); slot != bucket(i) + detail::cuckoo_slots; ++slot) {
+            if (*slot == fp) {
+                *slot = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Puts fp in bucket i or its other bucket, evicting fingerprints to
+    // their other buckets if both are full. The last one evicted waits in
+    // victim_ if no room turns up, so nothing inserted is ever lost.
+    bool add(std::size_t i, Fingerprint fp) noexcept {
+        ++size_;
+        if (try_put(i, fp) || try_put(other_bucket(i, fp), fp)) {
+            return true;
+        }
+        if (next_random() & 1) {
+            i = other_bucket(i, fp);
+        }
+        for (int kick = 0; kick < detail::cuckoo_max_kicks; ++kick) {
+            std::swap(fp, bucket(i)[next_random() % detail::cuckoo_slots]);
+            i = other_bucket(i, fp);
+            if (try_put(i, fp)) {
+                return true;
+            }
+        }
+        victim_ = {i, fp, true};
+        return true;
+    }
+
+    // xorshift64: which slot to evict needs to vary, not to be good random
+    std::uint64_t next_random() noexcept {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        return random_;
+    }
+
+    std::vector<Fingerprint> slots_;
+    std::size_t mask_ = 0;  // bucket count - 1
+    std::size_t size_ = 0;
+    Victim victim_;
+    std::uint64_t random_ = 0x9E3779B97F4A7C15ULL;
+};
+
+} // namespace membership
+
+#endif // CUCKOO_FILTER_H
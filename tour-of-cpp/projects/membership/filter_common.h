@@ -0,0 +1,44 @@
+#ifndef MEMBERSHIP_FILTER_COMMON_H
+#define MEMBERSHIP_FILTER_COMMON_H
+
+#include "hashing.h"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace membership {
+
+// What the filters accept as keys: strings, and integers such as ids
+template <typename K>
+concept FilterKey = std::convertible_to<const K&, std::string_view> || std::integral<K>;
+
+namespace detail {
+
+inline constexpr std::uint64_t filter_seed = 0x5851F42D4C957F2DULL;
+
+// The one hash a filter computes per key; each filter splits its 64 bits
+// into the parts it needs
+template <FilterKey K>
+[[nodiscard]] constexpr std::uint64_t hash_key(const K& key) noexcept {
+    if constexpr (std::convertible_to<const K&, std::string_view>) {
+        return hash_string(std::string_view{key}, filter_seed);
+    } else {
+        return mix(static_cast<std::uint64_t>(key) ^ filter_seed);
+    }
+}
+
+// Bulk queries hash this many keys and prefetch their memory before
+// probing any of them, so the cache misses overlap
+inline constexpr std::size_t batch_size = 16;
+
+inline void prefetch([[maybe_unused]] const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#endif
+}
+
+} // namespace detail
+} // namespace membership
+
+#endif // MEMBERSHIP_FILTER_COMMON_H
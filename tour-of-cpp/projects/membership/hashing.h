@@ -0,0 +1,56 @@
+#ifndef MEMBERSHIP_HASHING_H
+#define MEMBERSHIP_HASHING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace membership::detail {
+
+// The splitmix64 finalizer: every input bit affects every output bit
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Up to 8 bytes as a little-endian integer. Written with shifts so it also
+// runs in constant expressions; compilers turn it into a single load.
+[[nodiscard]] constexpr std::uint64_t load_bytes(const char* p, std::size_t n) noexcept {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+/**
+ * A seeded 64-bit string hash that gives the same result at compile time,
+ * at run time and on any platform, so tables built by one can be read by
+ * the others. Eight bytes per step; fast enough for short keys such as
+ * user names, not meant for long documents.
+ */
+[[nodiscard]] constexpr std::uint64_t hash_string(std::string_view s,
+                                                  std::uint64_t seed) noexcept {
+    std::uint64_t h = seed ^ (s.size() * 0x9E3779B97F4A7C15ULL);
+    std::size_t i = 0;
+    for (; i + 8 <= s.size(); i += 8) {
+        h = mix(h ^ load_bytes(s.data() + i, 8));
+    }
+    if (i < s.size()) {
+        h = mix(h ^ load_bytes(s.data() + i, s.size() - i));
+    }
+    return mix(h);
+}
+
+// Maps a 32-bit value uniformly onto [0, n) with a multiply instead of a
+// division (Lemire's "fast range")
+[[nodiscard]] constexpr std::uint32_t fast_range(std::uint32_t x, std::uint32_t n) noexcept {
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(x) * n) >> 32);
+}
+
+} // namespace membership::detail
+
+#endif // MEMBERSHIP_HASHING_H
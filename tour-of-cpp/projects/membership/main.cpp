@@ -0,0 +1,176 @@
+#include "bloom_filter.h"
+#include "cuckoo_filter.h"
+#include "perfect_hash_set.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MEMBERSHIP_HAVE_MMAP 1
+#else
+#define MEMBERSHIP_HAVE_MMAP 0
+#endif
+
+/**
+ * Demonstrates the membership structures, starting from Chapter 12's
+ * UsernameValidator exercise: is this name one of a fixed list?
+ */
+
+namespace {
+
+std::vector<std::string> registered_users() {
+    std::vector<std::string> users;
+    for (int i = 0; i < 10'000; ++i) {
+        users.push_back("user" + std::to_string(i));
+    }
+    users.insert(users.end(), {"alice", "bob", "carol", "dave"});
+    return users;
+}
+
+// Maps a file read-only and calls fn(bytes), or reads it into memory
+// where mmap is not available
+template <typename F>
+void with_file_bytes(const std::filesystem::path& path, F fn) {
+#if MEMBERSHIP_HAVE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info {};
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        throw std::runtime_error{"cannot open " + path.string()};
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error{"cannot map " + path.string()};
+    }
+    fn(std::span<const std::byte>{static_cast<const std::byte*>(mapped), size});
+    ::munmap(mapped, size);
+#else
+    std::ifstream in{path, std::ios::binary};
+    std::vector<std::byte> bytes(std::filesystem::file_size(path));
+    in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    fn(std::span<const std::byte>{bytes});
+#endif
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Membership Demo ===\n\n";
+
+    const auto users = registered_users();
+
+    // 1. UsernameValidator, with one probe per check
+    std::cout << "1. PerfectHashSet of " << users.size() << " user names:\n";
+    const membership::PerfectHashSet valid{users};
+    for (const std::string_view name : {"alice", "eve", "user42", "user10000"}) {
+        std::cout << "   " << name << ": " << (valid.contains(name) ? "valid" : "unknown")
+                  << "\n";
+    }
+    std::cout << "   " << valid.bytes().size() << " bytes, "
+              << static_cast<double>(valid.bytes().size()) / static_cast<double>(valid.size())
+              << " per name\n\n";
+
+    // 2. Slots are a dense index, so values can live in a plain array
+    std::cout << "2. Slots index a parallel array:\n";
+    {
+        std::vector<int> login_count(valid.size(), 0);
+        for (const std::string_view name : {"alice", "bob", "alice", "alice"}) {
+            ++login_count[valid.find(name)];
+        }
+        std::cout << "   alice logged in " << login_count[valid.find("alice")] << " times, bob "
+                  << login_count[valid.find("bob")] << " time\n\n";
+    }
+
+    // 3. Save the table once, map it at startup
+    std::cout << "3. Saved and mapped back:\n";
+    {
+        const auto path = std::filesystem::temp_directory_path() / "membership_demo.mph";
+        {
+            std::ofstream out{path, std::ios::binary};
+            out.write(reinterpret_cast<const char*>(valid.bytes().data()),
+                      static_cast<std::streamsize>(valid.bytes().size()));
+        }
+        with_file_bytes(path, [](std::span<const std::byte> bytes) {
+            const auto mapped = membership::PerfectHashSet::view(bytes);
+            std::cout << "   " << (MEMBERSHIP_HAVE_MMAP ? "mmapped " : "read ") << mapped.size()
+                      << " names without rebuilding; carol: "
+                      << (mapped.contains("carol") ? "valid" : "unknown") << "\n\n";
+        });
+        std::filesystem::remove(path);
+    }
+
+    // 4. Built by the compiler
+    std::cout << "4. StaticPerfectHashSet, built at compile time:\n";
+    {
+        static constexpr membership::StaticPerfectHashSet reserved{"admin", "root", "system",
+                                                                   "nobody"};
+        static_assert(reserved.contains("root"));
+        static_assert(!reserved.contains("alice"));
+        for (const std::string_view name : {"root", "alice"}) {
+            std::cout << "   " << name << (reserved.contains(name) ? " is" : " is not")
+                      << " reserved\n";
+        }
+    }
+
+    // 5. A Bloom filter in front of an expensive lookup
+    std::cout << "\n5. BloomFilter rejecting unknown names before the lookup:\n";
+    {
+        membership::BloomFilter known{users.size(), 0.01};
+        known.insert_all(users);
+
+        // Mostly names nobody registered, as a login endpoint under attack sees
+        int lookups = 0;
+        int valid_names = 0;
+        for (int i = 0; i < 100'000; ++i) {
+            const auto name = (i % 100 == 0 ? "user" : "guest") + std::to_string(i % 10'000);
+            if (known.contains(name)) {
+                ++lookups;  // only now ask the real set
+                valid_names += valid.contains(name) ? 1 : 0;
+            }
+        }
+        std::cout << "   100000 attempts, " << lookups << " reached the lookup, " << valid_names
+                  << " valid\n";
+        std::cout << "   " << static_cast<double>(8 * known.size_bytes()) /
+                                  static_cast<double>(users.size())
+                  << " bits per name, expected false-positive rate "
+                  << known.false_positive_rate() << "\n";
+    }
+
+    // 6. A cuckoo filter can forget
+    std::cout << "\n6. CuckooFilter of active sessions:\n";
+    {
+        membership::CuckooFilter<> sessions{10'000};
+        for (std::uint64_t session = 1; session <= 5'000; ++session) {
+            sessions.insert(session);
+        }
+        for (std::uint64_t session = 1; session <= 5'000; session += 2) {
+            sessions.erase(session);  // logged out
+        }
+        std::cout << "   " << sessions.size() << " sessions; 41 active: " << std::boolalpha
+                  << sessions.contains(std::uint64_t{41}) << ", 42 active: "
+                  << sessions.contains(std::uint64_t{42}) << "\n";
+        std::cout << "   load " << sessions.load_factor() << ", at most "
+                  << membership::CuckooFilter<>::false_positive_rate() << " false positives\n";
+
+        // 7. Filters travel as bytes too
+        const auto bytes = sessions.to_bytes();
+        const auto restored = membership::CuckooFilter<>::from_bytes(bytes);
+        std::cout << "\n7. Serialized to " << bytes.size() << " bytes and restored: "
+                  << restored.size() << " sessions\n";
+    }
+
+    std::cout << "\n=== Demo Complete ===\n";
+    return 0;
+}
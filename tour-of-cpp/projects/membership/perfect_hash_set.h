@@ -0,0 +1,477 @@
+#ifndef PERFECT_HASH_SET_H
+#define PERFECT_HASH_SET_H
+
+#include "hashing.h"
+#include "serialization.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace membership {
+
+namespace detail {
+
+// =============================================================================
+// Building: hash and displace
+// =============================================================================
+//
+// Keys are hashed once and split into buckets of about four. Each bucket
+// then gets a "pilot": a small number that, mixed into the hash of each of
+// its keys, sends them all to slots nobody else has taken. Buckets are
+// placed largest first, while the table is still empty; the single-key
+// buckets at the end need many tries each, but a try is one multiply and
+// one mix. A lookup repeats the same steps for one key.
+
+inline constexpr std::uint32_t keys_per_bucket = 4;
+inline constexpr std::uint32_t max_pilot = 1u << 22;
+inline constexpr int max_seeds = 16;
+
+[[nodiscard]] constexpr std::uint32_t bucket_count(std::size_t keys) noexcept {
+    return keys == 0 ? 1
+                     : static_cast<std::uint32_t>((keys + keys_per_bucket - 1) / keys_per_bucket);
+}
+
+[[nodiscard]] constexpr std::uint32_t bucket_of(std::uint64_t hash,
+                                                std::uint32_t buckets) noexcept {
+    return fast_range(static_cast<std::uint32_t>(hash >> 32), buckets);
+}
+
+[[nodiscard]] constexpr std::uint32_t slot_of(std::uint64_t hash, std::uint32_t pilot,
+                                              std::uint32_t slots) noexcept {
+    return fast_range(static_cast<std::uint32_t>(mix(hash ^ (pilot * 0x9E3779B97F4A7C15ULL))),
+                      slots);
+}
+
+[[nodiscard]] constexpr std::uint64_t seed_for(int attempt) noexcept {
+    return mix(static_cast<std::uint64_t>(attempt) + 1);
+}
+
+struct Placement {
+    std::uint64_t seed = 0;
+    std::vector<std::uint32_t> pilots;       // per bucket
+    std::vector<std::uint32_t> key_at_slot;  // index into the input keys
+};
+
+/**
+ * Finds a pilot for every bucket so that the keys fill the slots
+ * [0, hashes.size()) exactly once. False if some bucket runs out of
+ * pilots - two keys with the same 64-bit hash, or very bad luck - and the
+ * caller should try another seed.
+ */
+constexpr bool place(const std::vector<std::uint64_t>& hashes, Placement& out) {
+    const auto n = static_cast<std::uint32_t>(hashes.size());
+    const std::uint32_t buckets = bucket_count(n);
+
+    // Group the keys by bucket (a counting sort)
+    std::vector<std::uint32_t> start(buckets + 1, 0);
+    for (const auto h : hashes) {
+        ++start[bucket_of(h, buckets) + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<std::uint32_t> members(n);
+    std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        members[fill[bucket_of(hashes[i], buckets)]++] = i;
+    }
+
+    std::vector<std::uint32_t> order(buckets);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        const auto size_a = start[a + 1] - start[a];
+        const auto size_b = start[b + 1] - start[b];
+        return size_a != size_b ? size_a > size_b : a < b;
+    });
+
+    std::vector<bool> taken(n, false);
+    out.pilots.assign(buckets, 0);
+    out.key_at_slot.assign(n, 0);
+    std::vector<std::uint32_t> slots;
+    for (const auto b : order) {
+        if (start[b] == start[b + 1]) {
+            break;  // only empty buckets are left
+        }
+        bool placed = false;
+        for (std::uint32_t pilot = 0; pilot < max_pilot && !placed; ++pilot) {
+            slots.clear();
+            placed = true;
+            for (auto m = start[b]; m < start[b + 1]; ++m) {
+                const auto s = slot_of(hashes[members[m]], pilot, n);
+                if (taken[s] || std::find(slots.begin(), slots.end(), s) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(s);
+            }
+            if (placed) {
+                out.pilots[b] = pilot;
+                for (std::size_t k = 0; k < slots.size(); ++k) {
+                    taken[slots[k]] = true;
+                    out.key_at_slot[slots[k]] = members[start[b] + k];
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Keys must be unique; a placement exists for all but astronomically
+// unlucky inputs, so running out of seeds is reported as an error
+constexpr Placement build(const std::vector<std::string_view>& keys) {
+    if (keys.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error{"PerfectHashSet: too many keys"};
+    }
+    Placement out;
+    std::vector<std::uint64_t> hashes(keys.size());
+    for (int attempt = 0; attempt < max_seeds; ++attempt) {
+        out.seed = seed_for(attempt);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            hashes[i] = hash_string(keys[i], out.seed);
+        }
+        if (place(hashes, out)) {
+            return out;
+        }
+    }
+    throw std::runtime_error{"PerfectHashSet: no placement found"};
+}
+
+// =============================================================================
+// The serialized form
+// =============================================================================
+//
+//   offset 0   u64 magic
+//          8   u64 seed
+//         16   u32 key count n
+//         20   u32 bucket count
+//         24   u32 bytes of key text
+//         28   u32 reserved (0)
+//         32   u32 pilots[buckets]
+//              u64 records[n]        per slot: text offset (32 bits), key
+//                                    length (16), hash fingerprint (16)
+//              char text[...]        the keys in slot order, back to back
+//
+// A lookup reads one pilot and one record. The fingerprint turns away all
+// but 1 in 65536 absent keys there, so only hits read the key text.
+// Integers are in the byte order of the machine that built the table; the
+// magic number reads differently on the other byte order and is rejected.
+
+inline constexpr std::uint64_t table_magic = 0x31'54'45'53'48'50'4D'00ULL;  // "\0MPHSET1"
+inline constexpr std::size_t header_size = 32;
+inline constexpr std::size_t max_key_length = 0xFFFF;
+
+[[nodiscard]] constexpr std::uint16_t fingerprint(std::uint64_t hash) noexcept {
+    return static_cast<std::uint16_t>(hash);  // the bucket uses the high bits
+}
+
+[[nodiscard]] constexpr std::uint64_t make_record(std::uint32_t offset, std::size_t length,
+                                                  std::uint16_t fingerprint) noexcept {
+    return offset | (std::uint64_t{length} << 32) | (std::uint64_t{fingerprint} << 48);
+}
+
+[[nodiscard]] constexpr std::uint32_t record_offset(std::uint64_t r) noexcept {
+    return static_cast<std::uint32_t>(r);
+}
+[[nodiscard]] constexpr std::size_t record_length(std::uint64_t r) noexcept {
+    return (r >> 32) & 0xFFFF;
+}
+[[nodiscard]] constexpr std::uint16_t record_fingerprint(std::uint64_t r) noexcept {
+    return static_cast<std::uint16_t>(r >> 48);
+}
+
+} // namespace detail
+
+/**
+ * An immutable set of strings with a minimal perfect hash: n keys in
+ * exactly n slots, each key in a slot of its own. A lookup hashes the
+ * query, reads one pilot, computes the one slot the key could be in and
+ * checks the key stored there - no probing, no chains. A 16-bit
+ * fingerprint of the hash turns most absent keys away before the string
+ * comparison.
+ *
+ *     membership::PerfectHashSet users{names};          // built once
+ *     users.contains("alice");
+ *
+ *     std::span<const std::byte> bytes = users.bytes(); // write to a file...
+ *     auto mapped = membership::PerfectHashSet::view(file_bytes);  // ...and mmap it
+ *
+ * The whole table is one contiguous buffer in its serialized form, so a
+ * table written to disk is used straight from an mmapped file without
+ * parsing or copying. About 1 byte of pilots and an 8-byte record per
+ * key, plus the key text. Keys may be up to 65535 bytes long.
+ *
+ * find() returns the key's slot, a dense index in [0, size()) that can
+ * address a parallel array of values.
+ */
+class PerfectHashSet {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    PerfectHashSet() : PerfectHashSet(std::vector<std::string_view>{}) {}
+
+    // Any range of strings; duplicates are dropped
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+    explicit PerfectHashSet(const R& keys) {
+        std::vector<std::string_view> unique;
+        for (const auto& key : keys) {
+            unique.emplace_back(key);
+        }
+        std::sort(unique.begin(), unique.end());
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+        serialize(unique, detail::build(unique));
+    }
+
+    PerfectHashSet(std::initializer_list<std::string_view> keys)
+        : PerfectHashSet(std::span<const std::string_view>{keys.begin(), keys.size()}) {}
+
+    /**
+     * A set over bytes produced by bytes(), for example an mmapped file.
+     * Nothing is copied: the bytes must outlive the set. Throws
+     * std::invalid_argument if they are not a well-formed table.
+     */
+    [[nodiscard]] static PerfectHashSet view(std::span<const std::byte> bytes) {
+        return PerfectHashSet(bytes);
+    }
+
+    // As view(), but the set owns its copy of the bytes
+    [[nodiscard]] static PerfectHashSet from_bytes(std::vector<std::byte> bytes) {
+        PerfectHashSet set(std::span<const std::byte>{bytes});
+        set.owned_ = std::move(bytes);  // moving keeps the buffer, so bytes_ stays valid
+        return set;
+    }
+
+    PerfectHashSet(const PerfectHashSet& other)
+        : owned_{other.owned_},
+          bytes_{owned_.empty() ? other.bytes_ : std::span<const std::byte>{owned_}},
+          seed_{other.seed_},
+          size_{other.size_},
+          buckets_{other.buckets_} {}
+
+    // Leaves `other` empty
+    PerfectHashSet(PerfectHashSet&& other) noexcept
+        : owned_{std::move(other.owned_)},
+          bytes_{std::exchange(other.bytes_, {})},
+          seed_{other.seed_},
+          size_{std::exchange(other.size_, 0)},
+          buckets_{other.buckets_} {}
+
+    PerfectHashSet& operator=(const PerfectHashSet& other) {
+        PerfectHashSet copy{other};
+        *this = std::move(copy);
+        return *this;
+    }
+
+    PerfectHashSet& operator=(PerfectHashSet&& other) noexcept {
+        owned_ = std::move(other.owned_);
+        bytes_ = std::exchange(other.bytes_, {});
+        seed_ = other.seed_;
+        size_ = std::exchange(other.size_, 0);
+        buckets_ = other.buckets_;
+        return *this;
+    }
+
+    // The key's slot in [0, size()), or npos
+    [[nodiscard]] std::size_t find(std::string_view key) const noexcept {
+        if (size_ == 0) {
+            return npos;
+        }
+        const auto h = detail::hash_string(key, seed_);
+        const auto pilot = detail::read_u32(pilots() + 4 * detail::bucket_of(h, buckets_));
+        const auto slot = detail::slot_of(h, pilot, size_);
+        const auto r = record(slot);
+        if (detail::record_fingerprint(r) != detail::fingerprint(h)) {
+            return npos;
+        }
+        return text_of(r) == key ? slot : npos;
+    }
+
+    [[nodiscard]] bool contains(std::string_view key) const noexcept { return find(key) != npos; }
+
+    // The key in a slot; slots are in no particular order
+    [[nodiscard]] std::string_view key(std::size_t slot) const noexcept {
+        return text_of(record(slot));
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    // The serialized table, ready to write to a file
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return bytes_; }
+
+private:
+    // Parses and validates a serialized table
+    explicit PerfectHashSet(std::span<const std::byte> bytes) : bytes_{bytes} {
+        const auto fail = [] { throw std::invalid_argument{"PerfectHashSet: malformed table"}; };
+        if (bytes.size() < detail::header_size ||
+            detail::read_u64(bytes.data()) != detail::table_magic) {
+            fail();
+        }
+        seed_ = detail::read_u64(bytes.data() + 8);
+        size_ = detail::read_u32(bytes.data() + 16);
+        buckets_ = detail::read_u32(bytes.data() + 20);
+        const std::uint64_t text_size = detail::read_u32(bytes.data() + 24);
+        if (buckets_ != detail::bucket_count(size_) ||
+            bytes.size() != detail::header_size + 4 * std::uint64_t{buckets_} +
+                                8 * std::uint64_t{size_} + text_size) {
+            fail();
+        }
+        // Every key must lie within the text, so key() stays in bounds
+        for (std::uint32_t slot = 0; slot < size_; ++slot) {
+            const auto r = record(slot);
+            if (detail::record_offset(r) + std::uint64_t{detail::record_length(r)} > text_size) {
+                fail();
+            }
+        }
+    }
+
+    void serialize(const std::vector<std::string_view>& keys, const detail::Placement& placement) {
+        std::size_t text_size = 0;
+        for (const auto key : keys) {
+            if (key.size() > detail::max_key_length) {
+                throw std::length_error{"PerfectHashSet: key too long"};
+            }
+            text_size += key.size();
+        }
+        if (text_size > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error{"PerfectHashSet: keys too long"};
+        }
+        seed_ = placement.seed;
+        size_ = static_cast<std::uint32_t>(keys.size());
+        buckets_ = static_cast<std::uint32_t>(placement.pilots.size());
+
+        auto& out = owned_;
+        out.reserve(detail::header_size + 4 * buckets_ + 8 * size_ + text_size);
+        detail::write(out, detail::table_magic);
+        detail::write(out, seed_);
+        detail::write(out, size_);
+        detail::write(out, buckets_);
+        detail::write(out, static_cast<std::uint32_t>(text_size));
+        detail::write(out, std::uint32_t{0});
+        for (const auto pilot : placement.pilots) {
+            detail::write(out, pilot);
+        }
+        std::uint32_t offset = 0;
+        for (const auto k : placement.key_at_slot) {
+            const auto h = detail::hash_string(keys[k], seed_);
+            detail::write(out, detail::make_record(offset, keys[k].size(), detail::fingerprint(h)));
+            offset += static_cast<std::uint32_t>(keys[k].size());
+        }
+        for (const auto k : placement.key_at_slot) {
+            const auto at = out.size();
+            out.resize(at + keys[k].size());
+            std::memcpy(out.data() + at, keys[k].data(), keys[k].size());
+        }
+        bytes_ = owned_;
+    }
+
+    [[nodiscard]] const std::byte* pilots() const noexcept {
+        return bytes_.data() + detail::header_size;
+    }
+    [[nodiscard]] const std::byte* records() const noexcept { return pilots() + 4 * buckets_; }
+    [[nodiscard]] const std::byte* text() const noexcept { return records() + 8 * size_; }
+
+    [[nodiscard]] std::uint64_t record(std::size_t slot) const noexcept {
+        return detail::read_u64(records() + 8 * slot);
+    }
+
+    [[nodiscard]] std::string_view text_of(std::uint64_t record) const noexcept {
+        return {reinterpret_cast<const char*>(text()) + detail::record_offset(record),
+                detail::record_length(record)};
+    }
+
+    std::vector<std::byte> owned_;     // empty for a view
+    std::span<const std::byte> bytes_; // owned_, or memory the caller keeps alive
+    std::uint64_t seed_ = 0;
+    std::uint32_t size_ = 0;
+    std::uint32_t buckets_ = 0;
+};
+
+/**
+ * The same table built at compile time from N string literals:
+ *
+ *     constexpr membership::StaticPerfectHashSet reserved{"admin", "root", "system"};
+ *     static_assert(reserved.contains("root"));
+ *
+ * The slots hold string_views of the literals, so the set lives in
+ * read-only data and costs nothing at startup. Duplicate keys are a
+ * compile error. Building is an ordinary constexpr loop, so it suits
+ * lists of up to a few hundred keys before the compiler's constexpr
+ * limits are reached; use PerfectHashSet for more.
+ */
+template <std::size_t N>
+class StaticPerfectHashSet {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    constexpr explicit StaticPerfectHashSet(const std::array<std::string_view, N>& keys) {
+        std::vector<std::string_view> sorted(keys.begin(), keys.end());
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+            throw std::invalid_argument{"StaticPerfectHashSet: duplicate key"};
+        }
+        const std::vector<std::string_view> input(keys.begin(), keys.end());
+        const auto placement = detail::build(input);
+        seed_ = placement.seed;
+        std::copy(placement.pilots.begin(), placement.pilots.end(), pilots_.begin());
+        for (std::size_t slot = 0; slot < N; ++slot) {
+            slots_[slot] = keys[placement.key_at_slot[slot]];
+        }
+    }
+
+    template <std::convertible_to<std::string_view>... Keys>
+        requires(sizeof...(Keys) == N && N > 0)
+    constexpr StaticPerfectHashSet(const Keys&... keys)
+        : StaticPerfectHashSet(std::array<std::string_view, N>{std::string_view{keys}...}) {}
+
+    [[nodiscard]] constexpr std::size_t find(std::string_view key) const noexcept {
+        if constexpr (N == 0) {
+            return npos;
+        } else {
+            const auto h = detail::hash_string(key, seed_);
+            const auto slot = detail::slot_of(h, pilots_[detail::bucket_of(h, buckets)],
+                                              static_cast<std::uint32_t>(N));
+            return slots_[slot] == key ? slot : npos;
+        }
+    }
+
+    [[nodiscard]] constexpr bool contains(std::string_view key) const noexcept {
+        return find(key) != npos;
+    }
+
+    [[nodiscard]] constexpr std::string_view key(std::size_t slot) const noexcept {
+        return slots_[slot];
+    }
+
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return N; }
+
+private:
+    static constexpr std::uint32_t buckets = detail::bucket_count(N);
+
+    std::uint64_t seed_ = 0;
+    std::array<std::uint32_t, buckets> pilots_{};
+    std::array<std::string_view, N> slots_{};
+};
+
+template <typename... Keys>
+StaticPerfectHashSet(const Keys&...) -> StaticPerfectHashSet<sizeof...(Keys)>;
+
+template <std::size_t N>
+StaticPerfectHashSet(const std::array<std::string_view, N>&) -> StaticPerfectHashSet<N>;
+
+} // namespace membership
+
+#endif // PERFECT_HASH_SET_H
@@ -0,0 +1,44 @@
+#ifndef MEMBERSHIP_SERIALIZATION_H
+#define MEMBERSHIP_SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace membership::detail {
+
+// Reading and writing the structures' serialized forms. Integers are
+// stored in the byte order of the machine; each format starts with a magic
+// number that reads differently on the other byte order.
+
+inline std::uint32_t read_u32(const std::byte* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+inline std::uint64_t read_u64(const std::byte* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+template <typename T>
+void write(std::vector<std::byte>& out, T value) {
+    const auto at = out.size();
+    out.resize(at + sizeof value);
+    std::memcpy(out.data() + at, &value, sizeof value);
+}
+
+inline void write_bytes(std::vector<std::byte>& out, const void* data, std::size_t size) {
+    const auto at = out.size();
+    out.resize(at + size);
+    if (size != 0) {
+        std::memcpy(out.data() + at, data, size);
+    }
+}
+
+} // namespace membership::detail
+
+#endif // MEMBERSHIP_SERIALIZATION_H
@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include "bloom_filter.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using membership::BloomFilter;
+
+namespace {
+
+std::vector<std::string> user_names(std::size_t first, std::size_t n) {
+    std::vector<std::string> names;
+    for (std::size_t i = first; i < first + n; ++i) {
+        names.push_back("user" + std::to_string(i));
+    }
+    return names;
+}
+
+// The share of strangers the filter lets through
+double measured_rate(const BloomFilter& filter, std::uint64_t first, std::uint64_t n) {
+    std::size_t positives = 0;
+    for (auto id = first; id < first + n; ++id) {
+        positives += filter.contains(id) ? 1u : 0u;
+    }
+    return static_cast<double>(positives) / static_cast<double>(n);
+}
+
+} // namespace
+
+TEST_CASE("BloomFilter never forgets a key", "[bloom_filter]") {
+    BloomFilter filter{10'000};
+    const auto names = user_names(0, 10'000);
+    filter.insert_all(names);
+    for (std::uint64_t id = 0; id < 10'000; ++id) {
+        filter.insert(id * 7919);
+    }
+
+    for (const auto& name : names) {
+        REQUIRE(filter.contains(name));
+    }
+    for (std::uint64_t id = 0; id < 10'000; ++id) {
+        REQUIRE(filter.contains(id * 7919));
+    }
+    REQUIRE(filter.insertions() == 20'000);
+
+    // String and integer keys are hashed differently
+    BloomFilter strings{100};
+    strings.insert("42");
+    REQUIRE(strings.contains(std::string{"42"}));
+    REQUIRE_FALSE(strings.contains(42));
+}
+
+TEST_CASE("BloomFilter meets its false-positive rate", "[bloom_filter]") {
+    for (const double rate : {0.05, 0.01, 0.001}) {
+        BloomFilter filter{20'000, rate};
+        for (std::uint64_t id = 0; id < 20'000; ++id) {
+            filter.insert(id);
+        }
+        const double measured = measured_rate(filter, 1'000'000, 200'000);
+        REQUIRE(measured < rate * 1.25);
+        REQUIRE(measured > rate * 0.5);  // and is not oversized
+
+        // The estimate agrees with what was measured
+        REQUIRE(filter.false_positive_rate() < rate * 1.1);
+        REQUIRE(filter.false_positive_rate() > measured * 0.75);
+    }
+
+    REQUIRE_THROWS_AS((BloomFilter{100, 0.0}), std::invalid_argument);
+    REQUIRE_THROWS_AS((BloomFilter{100, 1.0}), std::invalid_argument);
+}
+
+TEST_CASE("BloomFilter bulk operations", "[bloom_filter][bulk]") {
+    BloomFilter filter{1000, 0.001};
+    const auto members = user_names(0, 1000);
+    filter.insert_all(members);
+
+    // Members and strangers, more than one batch of each
+    auto queries = user_names(500, 1000);
+    const auto results = std::make_unique<bool[]>(queries.size());
+    const auto found = filter.contains_all(queries, {results.get(), queries.size()});
+
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        REQUIRE(results[i] == filter.contains(queries[i]));
+        expected += results[i] ? 1u : 0u;
+    }
+    REQUIRE(found == expected);
+    REQUIRE(found >= 500);
+
+    REQUIRE_THROWS_AS(filter.contains_all(queries, {results.get(), 10}), std::invalid_argument);
+}
+
+TEST_CASE("BloomFilter merge and clear", "[bloom_filter]") {
+    BloomFilter a{1000};
+    BloomFilter b{1000};
+    a.insert("alice");
+    b.insert("bob");
+    a.merge(b);
+    REQUIRE(a.contains("alice"));
+    REQUIRE(a.contains("bob"));
+    REQUIRE(a.insertions() == 2);
+
+    BloomFilter other_size{100'000};
+    REQUIRE_THROWS_AS(a.merge(other_size), std::invalid_argument);
+
+    a.clear();
+    REQUIRE_FALSE(a.contains("alice"));
+    REQUIRE(a.insertions() == 0);
+    REQUIRE(a.false_positive_rate() == 0);
+}
+
+TEST_CASE("BloomFilter serialization", "[bloom_filter][serialize]") {
+    BloomFilter filter{5000, 0.01};
+    const auto names = user_names(0, 5000);
+    filter.insert_all(names);
+
+    const auto bytes = filter.to_bytes();
+    REQUIRE(bytes.size() == 32 + filter.size_bytes());
+
+    const auto copy = BloomFilter::from_bytes(bytes);
+    REQUIRE(copy.size_bytes() == filter.size_bytes());
+    REQUIRE(copy.insertions() == filter.insertions());
+    for (const auto& name : names) {
+        REQUIRE(copy.contains(name));
+    }
+    REQUIRE(measured_rate(copy, 0, 10'000) == measured_rate(filter, 0, 10'000));
+
+    REQUIRE_THROWS_AS(BloomFilter::from_bytes({bytes.data(), bytes.size() - 1}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(BloomFilter::from_bytes({bytes.data(), 8}), std::invalid_argument);
+    auto bad_magic = bytes;
+    bad_magic[0] = std::byte{0xFF};
+    REQUIRE_THROWS_AS(BloomFilter::from_bytes(bad_magic), std::invalid_argument);
+}
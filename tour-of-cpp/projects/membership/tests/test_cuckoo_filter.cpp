@@ -0,0 +1,210 @@
+#include <catch2/catch_test_macros.hpp>
+#include "cuckoo_filter.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using membership::CuckooFilter;
+
+namespace {
+
+template <typename Filter>
+double measured_rate(const Filter& filter, std::uint64_t first, std::uint64_t n) {
+    std::size_t positives = 0;
+    for (auto id = first; id < first + n; ++id) {
+        positives += filter.contains(id) ? 1u : 0u;
+    }
+    return static_cast<double>(positives) / static_cast<double>(n);
+}
+
+// Inserts ids from 0 until the filter is full; returns how many fit
+template <typename Filter>
+std::uint64_t fill(Filter& filter) {
+    std::uint64_t id = 0;
+    while (filter.insert(id)) {
+        ++id;
+    }
+    return id;
+}
+
+template <typename F>
+void require_bucket_contains_matches_loop() {
+    std::mt19937_64 gen{3};
+    for (int round = 0; round < 10'000; ++round) {
+        std::array<F, 4> bucket{};
+        for (auto& fp : bucket) {
+            // Small values, so neighbouring lanes often differ by one bit
+            fp = static_cast<F>(gen() % 4);
+        }
+        for (F fp = 1; fp < 5; ++fp) {
+            const bool expected = std::find(bucket.begin(), bucket.end(), fp) != bucket.end();
+            REQUIRE(membership::detail::bucket_contains(bucket.data(), fp) == expected);
+        }
+    }
+    const std::array<F, 4> full{1, 2, std::numeric_limits<F>::max(), 3};
+    REQUIRE(membership::detail::bucket_contains(full.data(), full[2]));
+}
+
+template <typename F>
+void require_fills_and_meets_rate() {
+    CuckooFilter<F> filter{50'000};
+    const auto inserted = fill(filter);
+    REQUIRE(filter.load_factor() > 0.9);
+    REQUIRE(filter.size() == inserted);
+    // Once full, the filter stays full
+    REQUIRE_FALSE(filter.insert(std::uint64_t{1} << 40));
+    REQUIRE(filter.size() == inserted);
+
+    // Nothing that fit was lost, the last one included
+    for (std::uint64_t id = 0; id < inserted; ++id) {
+        REQUIRE(filter.contains(id));
+    }
+    const double measured = measured_rate(filter, 1ULL << 32, 200'000);
+    REQUIRE(measured < CuckooFilter<F>::false_positive_rate());
+
+    // Erasing makes room again
+    for (std::uint64_t id = 0; id < 100; ++id) {
+        REQUIRE(filter.erase(id));
+    }
+    for (std::uint64_t id = 0; id < 50; ++id) {
+        REQUIRE(filter.insert((std::uint64_t{1} << 41) + id));
+    }
+    for (std::uint64_t id = 100; id < inserted; ++id) {
+        REQUIRE(filter.contains(id));
+    }
+}
+
+} // namespace
+
+TEST_CASE("bucket_contains finds a fingerprint in any slot", "[cuckoo_filter][swar]") {
+    require_bucket_contains_matches_loop<std::uint8_t>();
+    require_bucket_contains_matches_loop<std::uint16_t>();
+    require_bucket_contains_matches_loop<std::uint32_t>();
+}
+
+TEST_CASE("CuckooFilter insert and contains", "[cuckoo_filter]") {
+    CuckooFilter<> filter{10'000};
+    REQUIRE(filter.empty());
+    for (std::uint64_t id = 0; id < 10'000; ++id) {
+        REQUIRE(filter.insert(id));
+    }
+    REQUIRE(filter.size() == 10'000);
+    for (std::uint64_t id = 0; id < 10'000; ++id) {
+        REQUIRE(filter.contains(id));
+    }
+    REQUIRE(measured_rate(filter, 1'000'000, 100'000) < CuckooFilter<>::false_positive_rate());
+
+    CuckooFilter<> names{100};
+    names.insert("alice");
+    REQUIRE(names.contains(std::string{"alice"}));
+    REQUIRE_FALSE(names.contains("bob"));
+}
+
+TEST_CASE("CuckooFilter fills up and meets its rate", "[cuckoo_filter]") {
+    require_fills_and_meets_rate<std::uint8_t>();
+    require_fills_and_meets_rate<std::uint16_t>();
+}
+
+TEST_CASE("CuckooFilter erase", "[cuckoo_filter]") {
+    CuckooFilter<std::uint32_t> filter{20'000};
+    for (std::uint64_t id = 0; id < 20'000; ++id) {
+        filter.insert(id);
+    }
+
+    for (std::uint64_t id = 0; id < 20'000; id += 2) {
+        REQUIRE(filter.erase(id));
+    }
+    REQUIRE(filter.size() == 10'000);
+    for (std::uint64_t id = 0; id < 20'000; ++id) {
+        // 32-bit fingerprints make a false positive all but impossible
+        REQUIRE(filter.contains(id) == (id % 2 == 1));
+    }
+    REQUIRE_FALSE(filter.erase(std::uint64_t{0}));
+
+    SECTION("a key inserted twice takes two erases") {
+        filter.insert("alice");
+        filter.insert("alice");
+        REQUIRE(filter.erase("alice"));
+        REQUIRE(filter.contains("alice"));
+        REQUIRE(filter.erase("alice"));
+        REQUIRE_FALSE(filter.contains("alice"));
+    }
+
+    SECTION("clear") {
+        filter.clear();
+        REQUIRE(filter.empty());
+        REQUIRE_FALSE(filter.contains(std::uint64_t{1}));
+    }
+}
+
+TEST_CASE("CuckooFilter bulk operations", "[cuckoo_filter][bulk]") {
+    CuckooFilter<> filter{1000};
+    std::vector<std::uint64_t> members(1000);
+    for (std::uint64_t i = 0; i < members.size(); ++i) {
+        members[i] = i * 3;
+    }
+    REQUIRE(filter.insert_all(members) == members.size());
+
+    std::vector<std::uint64_t> queries(1000);
+    for (std::uint64_t i = 0; i < queries.size(); ++i) {
+        queries[i] = i;
+    }
+    const auto results = std::make_unique<bool[]>(queries.size());
+    const auto found = filter.contains_all(queries, {results.get(), queries.size()});
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        REQUIRE(results[i] == filter.contains(queries[i]));
+        expected += results[i] ? 1u : 0u;
+    }
+    REQUIRE(found == expected);
+    REQUIRE(found >= 334);
+
+    // insert_all stops when the filter is full
+    CuckooFilter<> small{10};
+    std::vector<std::uint64_t> many(1000);
+    for (std::uint64_t i = 0; i < many.size(); ++i) {
+        many[i] = i;
+    }
+    const auto fitted = small.insert_all(many);
+    REQUIRE(fitted < many.size());
+    REQUIRE(small.size() == fitted);
+}
+
+TEST_CASE("CuckooFilter serialization", "[cuckoo_filter][serialize]") {
+    CuckooFilter<> filter{2000};
+    const auto inserted = fill(filter);  // so the victim is in use too
+
+    const auto bytes = filter.to_bytes();
+    REQUIRE(bytes.size() == 48 + filter.size_bytes());
+
+    auto copy = CuckooFilter<>::from_bytes(bytes);
+    REQUIRE(copy.size() == filter.size());
+    for (std::uint64_t id = 0; id < inserted; ++id) {
+        REQUIRE(copy.contains(id));
+    }
+    REQUIRE(measured_rate(copy, 1ULL << 32, 10'000) ==
+            measured_rate(filter, 1ULL << 32, 10'000));
+    REQUIRE_FALSE(copy.insert(std::uint64_t{1} << 40));  // still full
+    REQUIRE(copy.erase(std::uint64_t{0}));
+    REQUIRE(copy.insert(std::uint64_t{1} << 40));
+
+    SECTION("malformed bytes are rejected") {
+        REQUIRE_THROWS_AS(CuckooFilter<>::from_bytes({bytes.data(), bytes.size() - 1}),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(CuckooFilter<>::from_bytes({bytes.data(), 8}), std::invalid_argument);
+        // Another fingerprint width
+        REQUIRE_THROWS_AS(CuckooFilter<std::uint8_t>::from_bytes(bytes), std::invalid_argument);
+        // A count that does not match the table
+        auto bad_count = bytes;
+        bad_count[24] = std::byte{0};
+        bad_count[25] = std::byte{0};
+        REQUIRE_THROWS_AS(CuckooFilter<>::from_bytes(bad_count), std::invalid_argument);
+    }
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include "perfect_hash_set.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using membership::PerfectHashSet;
+using membership::StaticPerfectHashSet;
+
+namespace {
+
+std::vector<std::string> user_names(std::size_t n, unsigned seed = 1) {
+    std::mt19937_64 gen{seed};
+    std::uniform_int_distribution<std::size_t> length{1, 24};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::set<std::string> names;
+    while (names.size() < n) {
+        std::string name(length(gen), ' ');
+        for (auto& c : name) {
+            c = static_cast<char>(letter(gen));
+        }
+        names.insert(std::move(name));
+    }
+    return {names.begin(), names.end()};
+}
+
+// Every key has its own slot in [0, size())
+void require_minimal_perfect(const PerfectHashSet& set, const std::vector<std::string>& keys) {
+    REQUIRE(set.size() == keys.size());
+    std::vector<bool> used(keys.size(), false);
+    for (const auto& key : keys) {
+        const auto slot = set.find(key);
+        REQUIRE(slot < keys.size());
+        REQUIRE_FALSE(used[slot]);
+        used[slot] = true;
+        REQUIRE(set.key(slot) == key);
+    }
+}
+
+} // namespace
+
+TEST_CASE("PerfectHashSet is a minimal perfect hash", "[perfect_hash_set]") {
+    for (const std::size_t n : {0, 1, 2, 3, 5, 17, 100, 1000, 20'000}) {
+        const auto keys = user_names(n);
+        const PerfectHashSet set{keys};
+        require_minimal_perfect(set, keys);
+
+        // Keys that are not in the set land in some slot too; the fingerprint
+        // or the string comparison rejects them
+        for (const auto& other : user_names(200, 99)) {
+            const bool member = std::binary_search(keys.begin(), keys.end(), other);
+            REQUIRE(set.contains(other) == member);
+        }
+    }
+}
+
+TEST_CASE("PerfectHashSet construction", "[perfect_hash_set]") {
+    SECTION("duplicates are dropped") {
+        const PerfectHashSet set{"alice", "bob", "alice", "carol", "bob"};
+        REQUIRE(set.size() == 3);
+        REQUIRE(set.contains("alice"));
+        REQUIRE_FALSE(set.contains("dave"));
+    }
+
+    SECTION("empty set and empty key") {
+        const PerfectHashSet none;
+        REQUIRE(none.empty());
+        REQUIRE_FALSE(none.contains(""));
+        REQUIRE(none.find("x") == PerfectHashSet::npos);
+
+        const PerfectHashSet blank{""};
+        REQUIRE(blank.contains(""));
+        REQUIRE_FALSE(blank.contains("a"));
+    }
+
+    SECTION("keys longer than a record can describe") {
+        REQUIRE_THROWS_AS(PerfectHashSet{std::string(70'000, 'x')}, std::length_error);
+    }
+
+    SECTION("keys that differ only past eight bytes") {
+        const PerfectHashSet set{"prefix__a", "prefix__b", "prefix__"};
+        REQUIRE(set.contains("prefix__b"));
+        REQUIRE_FALSE(set.contains("prefix__c"));
+    }
+}
+
+TEST_CASE("PerfectHashSet serialization", "[perfect_hash_set][serialize]") {
+    const auto keys = user_names(500);
+    const PerfectHashSet original{keys};
+    const auto bytes = original.bytes();
+
+    SECTION("a view reads the bytes in place") {
+        const auto view = PerfectHashSet::view(bytes);
+        REQUIRE(view.bytes().data() == bytes.data());
+        require_minimal_perfect(view, keys);
+        for (const auto& key : keys) {
+            REQUIRE(view.find(key) == original.find(key));
+        }
+    }
+
+    SECTION("from_bytes owns a copy") {
+        auto set = PerfectHashSet::from_bytes({bytes.begin(), bytes.end()});
+        require_minimal_perfect(set, keys);
+        const PerfectHashSet copy = set;
+        REQUIRE(copy.bytes().data() != set.bytes().data());
+        const PerfectHashSet moved = std::move(set);
+        require_minimal_perfect(moved, keys);
+        REQUIRE(set.empty());
+        require_minimal_perfect(copy, keys);
+    }
+
+    SECTION("malformed bytes are rejected") {
+        std::vector<std::byte> copy(bytes.begin(), bytes.end());
+        REQUIRE_THROWS_AS(PerfectHashSet::view({copy.data(), copy.size() - 1}),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(PerfectHashSet::view({copy.data(), 16}), std::invalid_argument);
+
+        auto bad_magic = copy;
+        bad_magic[0] = std::byte{0xFF};
+        REQUIRE_THROWS_AS(PerfectHashSet::view(bad_magic), std::invalid_argument);
+
+        // A key past the end of the text
+        auto bad_offset = copy;
+        const std::size_t first_record = 32 + 4 * ((keys.size() + 3) / 4);
+        bad_offset[first_record + 3] = std::byte{0x7F};
+        REQUIRE_THROWS_AS(PerfectHashSet::view(bad_offset), std::invalid_argument);
+    }
+}
+
+TEST_CASE("StaticPerfectHashSet is built at compile time", "[perfect_hash_set][constexpr]") {
+    static constexpr StaticPerfectHashSet reserved{"admin", "root", "system", "daemon", "nobody",
+                                                   "operator", "guest"};
+    static_assert(reserved.size() == 7);
+    static_assert(reserved.contains("root"));
+    static_assert(reserved.contains("guest"));
+    static_assert(!reserved.contains("alice"));
+    static_assert(!reserved.contains(""));
+
+    // The same hashing at run time, and a slot per key
+    std::set<std::size_t> slots;
+    for (const auto* name : {"admin", "root", "system", "daemon", "nobody", "operator", "guest"}) {
+        const std::string key = name;
+        REQUIRE(reserved.contains(key));
+        slots.insert(reserved.find(key));
+    }
+    REQUIRE(slots.size() == 7);
+    REQUIRE(*slots.rbegin() == 6);
+
+    constexpr StaticPerfectHashSet from_array{std::to_array<std::string_view>({"x", "y"})};
+    static_assert(from_array.contains("y"));
+    REQUIRE_THROWS_AS((StaticPerfectHashSet{"x", "y", "x"}), std::invalid_argument);
+}
@@ -0,0 +1,190 @@
+// Benchmark: parallel:: algorithms vs. std::execution
+//
+// Each algorithm runs three ways on the same input:
+//   std_seq  - std::execution::seq, the sequential baseline
+//   std_par  - std::execution::par; on libstdc++ this is TBB when its
+//              headers were found at build time, and sequential otherwise
+//   pool     - parallel:: on the default ThreadPool
+//
+// The speed-up of `pool` over `std_seq` should approach the core count for
+// compute-bound work (transform_reduce, sort) and the memory bandwidth
+// limit for the rest, whatever the standard library does.
+
+#include "bench.h"
+#include "parallel_algorithms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<execution>)
+    #include <execution>
+#endif
+#if defined(__cpp_lib_execution)
+    #define BENCH_HAS_STD_EXECUTION 1
+#else
+    #define BENCH_HAS_STD_EXECUTION 0
+#endif
+
+namespace {
+
+const std::vector<double>& random_doubles(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<double>> inputs;
+    auto& data = inputs[n];
+    if (data.empty()) {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<> dist{0.0, 100.0};
+        data.resize(static_cast<std::size_t>(n));
+        std::generate(data.begin(), data.end(), [&] { return dist(gen); });
+    }
+    return data;
+}
+
+double expensive(double x) {
+    for (int i = 0; i < 20; ++i) {
+        x = std::sin(x) * std::cos(x) + std::sqrt(std::abs(x) + 1.0);
+    }
+    return x;
+}
+
+// Runs `op(policy)` for each of the three variants
+template <typename Op>
+void register_variants(const std::string& name, Op op, std::int64_t lo, std::int64_t hi) {
+#if BENCH_HAS_STD_EXECUTION
+    bench::register_benchmark(name + "/std_seq", [op](bench::State& s) {
+        op(s, std::execution::seq);
+    })->range(lo, hi, 16);
+    bench::register_benchmark(name + "/std_par", [op](bench::State& s) {
+        op(s, std::execution::par);
+    })->range(lo, hi, 16);
+#endif
+    bench::register_benchmark(name + "/pool", [op](bench::State& s) {
+        op(s, parallel::par);
+    })->range(lo, hi, 16);
+}
+
+// True for parallel::Policy, false for the std::execution policies
+template <typename P>
+constexpr bool on_pool = std::is_same_v<std::decay_t<P>, parallel::Policy>;
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 12;
+    constexpr std::int64_t large = 1 << 20;
+
+    register_variants(
+        "sort",
+        [](bench::State& state, const auto& policy) {
+            const auto& input = random_doubles(state.arg());
+            std::vector<double> v;
+            while (state.keep_running()) {
+                state.pause_timing();
+                v = input;
+                state.resume_timing();
+                if constexpr (on_pool<decltype(policy)>) {
+                    parallel::sort(policy, v.begin(), v.end());
+                } else {
+                    std::sort(policy, v.begin(), v.end());
+                }
+                bench::do_not_optimize(v.data());
+            }
+            state.set_items_per_iteration(state.arg());
+        },
+        small, large);
+
+    register_variants(
+        "for_each",
+        [](bench::State& state, const auto& policy) {
+            auto v = random_doubles(state.arg());
+            const auto f = [](double& x) { x = expensive(x); };
+            while (state.keep_running()) {
+                if constexpr (on_pool<decltype(policy)>) {
+                    parallel::for_each(policy, v.begin(), v.end(), f);
+                } else {
+                    std::for_each(policy, v.begin(), v.end(), f);
+                }
+                bench::clobber_memory();
+            }
+            state.set_items_per_iteration(state.arg());
+        },
+        small, 1 << 16);
+
+    register_variants(
+        "transform_reduce",
+        [](bench::State& state, const auto& policy) {
+            const auto& v = random_doubles(state.arg());
+            while (state.keep_running()) {
+                double r = 0.0;
+                if constexpr (on_pool<decltype(policy)>) {
+                    r = parallel::transform_reduce(policy, v.begin(), v.end(), 0.0, std::plus<>{},
+                                                   [](double x) { return x * x; });
+                } else {
+                    r = std::transform_reduce(policy, v.begin(), v.end(), 0.0, std::plus<>{},
+                                              [](double x) { return x * x; });
+                }
+                bench::do_not_optimize(r);
+            }
+            state.set_bytes_per_iteration(state.arg() * static_cast<std::int64_t>(sizeof(double)));
+        },
+        small, large);
+
+    register_variants(
+        "find",
+        [](bench::State& state, const auto& policy) {
+            // At least one element, for the -1.0 to find
+            std::vector<double> v(static_cast<std::size_t>(std::max<std::int64_t>(state.arg(), 1)),
+                                  1.0);
+            v.back() = -1.0;
+            while (state.keep_running()) {
+                if constexpr (on_pool<decltype(policy)>) {
+                    bench::do_not_optimize(parallel::find(policy, v.begin(), v.end(), -1.0));
+                } else {
+                    bench::do_not_optimize(std::find(policy, v.begin(), v.end(), -1.0));
+                }
+            }
+            state.set_bytes_per_iteration(state.arg() * static_cast<std::int64_t>(sizeof(double)));
+        },
+        small, large);
+
+    register_variants(
+        "count_if",
+        [](bench::State& state, const auto& policy) {
+            const auto& v = random_doubles(state.arg());
+            const auto pred = [](double x) { return x > 50.0; };
+            while (state.keep_running()) {
+                if constexpr (on_pool<decltype(policy)>) {
+                    bench::do_not_optimize(parallel::count_if(policy, v.begin(), v.end(), pred));
+                } else {
+                    bench::do_not_optimize(std::count_if(policy, v.begin(), v.end(), pred));
+                }
+            }
+            state.set_items_per_iteration(state.arg());
+        },
+        small, large);
+
+    register_variants(
+        "inclusive_scan",
+        [](bench::State& state, const auto& policy) {
+            const auto& v = random_doubles(state.arg());
+            std::vector<double> out(v.size());
+            while (state.keep_running()) {
+                if constexpr (on_pool<decltype(policy)>) {
+                    parallel::inclusive_scan(policy, v.begin(), v.end(), out.begin());
+                } else {
+                    std::inclusive_scan(policy, v.begin(), v.end(), out.begin());
+                }
+                bench::clobber_memory();
+            }
+            state.set_items_per_iteration(state.arg());
+        },
+        small, large);
+
+    return true;
+}();
+
+} // namespace
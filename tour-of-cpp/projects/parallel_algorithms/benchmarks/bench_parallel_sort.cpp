@@ -0,0 +1,102 @@
+// Benchmark: radix_sort and sample_sort vs. std::sort
+//
+// Every key type is sorted five ways on the same random input:
+//   std_seq      - std::sort
+//   std_par      - std::sort(std::execution::par), where <execution> exists
+//   merge_sort   - parallel::sort, per-thread std::sort plus merge rounds
+//   sample_sort  - parallel::sample_sort
+//   radix_sort   - parallel::radix_sort
+//
+// radix_sort does O(n) work per key byte, so it should beat every
+// comparison sort on a single thread already, by more for narrow keys;
+// the parallel variants add a factor of up to the core count on top.
+// Sizes stop at 256K elements to keep the smoke test short; raise `large`
+// to measure the 100M-element sorts the algorithms are meant for.
+
+#include "bench.h"
+#include "parallel_sort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<execution>)
+    #include <execution>
+#endif
+#if defined(__cpp_lib_execution)
+    #define BENCH_HAS_STD_EXECUTION 1
+#else
+    #define BENCH_HAS_STD_EXECUTION 0
+#endif
+
+namespace {
+
+template <typename T>
+const std::vector<T>& random_keys(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<T>> inputs;
+    auto& data = inputs[n];
+    if (data.empty()) {
+        std::mt19937_64 gen{42};
+        data.resize(static_cast<std::size_t>(n));
+        if constexpr (std::is_floating_point_v<T>) {
+            std::uniform_real_distribution<T> dist{-1e6, 1e6};
+            std::generate(data.begin(), data.end(), [&] { return dist(gen); });
+        } else {
+            std::uniform_int_distribution<T> dist{std::numeric_limits<T>::min(),
+                                                  std::numeric_limits<T>::max()};
+            std::generate(data.begin(), data.end(), [&] { return dist(gen); });
+        }
+    }
+    return data;
+}
+
+// Copies the input outside the timed region, then times `sort(v)`
+template <typename T, typename Sort>
+void register_sort(const std::string& name, Sort sort, std::int64_t lo, std::int64_t hi) {
+    bench::register_benchmark(name, [sort](bench::State& state) {
+        const auto& input = random_keys<T>(state.arg());
+        std::vector<T> v;
+        while (state.keep_running()) {
+            state.pause_timing();
+            v = input;
+            state.resume_timing();
+            sort(v);
+            bench::do_not_optimize(v.data());
+        }
+        state.set_items_per_iteration(state.arg());
+        state.set_bytes_per_iteration(state.arg() * static_cast<std::int64_t>(sizeof(T)));
+    })->range(lo, hi, 16);
+}
+
+template <typename T>
+void register_key_type(const std::string& type, std::int64_t lo, std::int64_t hi) {
+    register_sort<T>(type + "/std_seq", [](auto& v) { std::sort(v.begin(), v.end()); }, lo, hi);
+#if BENCH_HAS_STD_EXECUTION
+    register_sort<T>(type + "/std_par",
+                     [](auto& v) { std::sort(std::execution::par, v.begin(), v.end()); }, lo, hi);
+#endif
+    register_sort<T>(type + "/merge_sort",
+                     [](auto& v) { parallel::sort(parallel::par, v.begin(), v.end()); }, lo, hi);
+    register_sort<T>(type + "/sample_sort",
+                     [](auto& v) { parallel::sample_sort(parallel::par, v); }, lo, hi);
+    register_sort<T>(type + "/radix_sort",
+                     [](auto& v) { parallel::radix_sort(parallel::par, v); }, lo, hi);
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 18;
+
+    register_key_type<std::uint32_t>("uint32", small, large);
+    register_key_type<std::int64_t>("int64", small, large);
+    register_key_type<float>("float", small, large);
+    register_key_type<double>("double", small, large);
+    return true;
+}();
+
+} // namespace
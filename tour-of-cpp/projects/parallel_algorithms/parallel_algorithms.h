@@ -0,0 +1,558 @@
+#ifndef PARALLEL_ALGORITHMS_H
+#define PARALLEL_ALGORITHMS_H
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace parallel {
+
+// =============================================================================
+// Policies
+// =============================================================================
+
+/**
+ * Where and how finely to split the work.
+ *
+ * `pool == nullptr` means the shared default_pool(). `grain` is the
+ * smallest number of elements worth handing to another thread; 0 lets each
+ * algorithm pick its own. Inputs shorter than two grains run sequentially
+ * on the calling thread: waking a worker costs a few microseconds, which
+ * is more than sorting or scanning a few thousand elements.
+ */
+struct Policy {
+    concurrent::ThreadPool* pool = nullptr;
+    std::size_t grain = 0;
+};
+
+// The default pool, with one worker per hardware thread
+inline constexpr Policy par{};
+
+// A specific pool, and optionally a grain size
+[[nodiscard]] inline Policy on(concurrent::ThreadPool& pool, std::size_t grain = 0) noexcept {
+    return Policy{&pool, grain};
+}
+
+// Shared by every algorithm called with `par`; created on first use. The
+// calling thread works too, so one worker fewer than hardware threads.
+[[nodiscard]] inline concurrent::ThreadPool& default_pool() {
+    static concurrent::ThreadPool pool{std::max(2u, std::thread::hardware_concurrency()) - 1};
+    return pool;
+}
+
+namespace detail {
+
+// Default grains, in elements. Cheap per-element work (compare, add) needs
+// larger chunks to outweigh the cost of scheduling them.
+inline constexpr std::size_t grain_for_each = 4096;
+inline constexpr std::size_t grain_reduce = 16384;
+inline constexpr std::size_t grain_find = 16384;
+inline constexpr std::size_t grain_scan = 16384;
+inline constexpr std::size_t grain_sort = 8192;
+
+// Chunks per participating thread: more than one, so a thread that finishes
+// early (or starts late) can take over work from a slow one
+inline constexpr std::size_t chunks_per_thread = 4;
+
+inline concurrent::ThreadPool& resolve(const Policy& policy) {
+    return policy.pool != nullptr ? *policy.pool : default_pool();
+}
+
+// Threads that will work on a call: the pool's workers plus the caller. A
+// pool passed explicitly is taken at its word; the default pool is never
+// asked for more threads than the hardware has, so on a single core `par`
+// runs sequentially instead of time-slicing.
+inline std::size_t thread_count(const Policy& policy, const concurrent::ThreadPool& pool) {
+    const std::size_t threads = pool.size() + 1;
+    if (policy.pool != nullptr) {
+        return threads;
+    }
+    return std::min<std::size_t>(threads, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// How many chunks to split `n` elements into; 1 means "run sequentially"
+inline std::size_t chunk_count(std::size_t n, std::size_t grain, std::size_t threads) {
+    if (threads <= 1 || n < 2 * grain) {
+        return 1;
+    }
+    return std::max<std::size_t>(1, std::min(n / grain, threads * chunks_per_thread));
+}
+
+// Half-open element range of chunk `i` when `n` elements are split `chunks` ways
+inline std::pair<std::size_t, std::size_t> chunk_bounds(std::size_t i, std::size_t n,
+                                                        std::size_t chunks) {
+    return {i * n / chunks, (i + 1) * n / chunks};
+}
+
+struct ChunkState {
+    explicit ChunkState(std::size_t count) : chunks{count} {}
+
+    const std::size_t chunks;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+/**
+ * Calls body(i) for every i in [0, chunks), spread over the pool.
+ *
+ * The calling thread claims chunks too, and waits only for the chunks to
+ * be finished - not for the helper tasks to run. So a call made from
+ * inside a pool task cannot deadlock even when every worker is busy: the
+ * caller then simply does all the work itself. Helpers that start after
+ * the last chunk was claimed find nothing to do and return.
+ *
+ * The first exception thrown by `body` is rethrown here once every
+ * claimed chunk has finished; chunks not yet started are skipped.
+ */
+template <typename Body>
+void run_chunks(concurrent::ThreadPool& pool, std::size_t chunks, Body& body) {
+    if (chunks <= 1) {
+        if (chunks == 1) {
+            body(std::size_t{0});
+        }
+        return;
+    }
+
+    auto state = std::make_shared<ChunkState>(chunks);
+    // Helpers that run late hold `state` alive but never touch `body`
+    auto work = [state, body_ptr = &body] {
+        while (true) {
+            const std::size_t i = state->next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= state->chunks) {
+                return;
+            }
+            if (!state->failed.load(std::memory_order_relaxed)) {
+                try {
+                    (*body_ptr)(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock{state->error_mutex};
+                    if (!state->error) {
+                        state->error = std::current_exception();
+                    }
+                    state->failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == state->chunks) {
+                state->done.notify_all();
+            }
+        }
+    };
+
+    const std::size_t helpers = std::min(pool.size(), chunks - 1);
+    for (std::size_t h = 0; h < helpers; ++h) {
+        try {
+            static_cast<void>(pool.submit(work));
+        } catch (const std::runtime_error&) {
+            break;  // stopped pool: the caller does the remaining chunks
+        }
+    }
+    work();
+
+    std::size_t done = state->done.load(std::memory_order_acquire);
+    while (done != chunks) {
+        state->done.wait(done, std::memory_order_acquire);
+        done = state->done.load(std::memory_order_acquire);
+    }
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+// Splits [0, n) into chunks and calls body(begin, end) for each
+template <typename Body>
+void run_ranges(const Policy& policy, std::size_t n, std::size_t default_grain, Body&& body) {
+    auto& pool = resolve(policy);
+    const std::size_t grain = policy.grain != 0 ? policy.grain : default_grain;
+    const std::size_t chunks = chunk_count(n, grain, thread_count(policy, pool));
+    auto per_chunk = [&](std::size_t i) {
+        const auto [begin, end] = chunk_bounds(i, n, chunks);
+        body(begin, end);
+    };
+    run_chunks(pool, chunks, per_chunk);
+}
+
+/**
+ * acc op f(x0) op f(x1) ... for one chunk, grouped in fours:
+ * acc op ((f0 op f1) op (f2 op f3)). The four transforms and the inner
+ * combinations are independent, so the CPU overlaps them instead of
+ * waiting on one long dependency chain through `acc`. The order of the
+ * operands is unchanged, so `op` only needs to be associative.
+ */
+template <typename It, typename T, typename Reduce, typename Transform>
+T reduce_chunk(It it, It end, T acc, Reduce& reduce, Transform& transform) {
+    for (; end - it >= 4; it += 4) {
+        acc = reduce(std::move(acc), reduce(reduce(transform(it[0]), transform(it[1])),
+                                            reduce(transform(it[2]), transform(it[3]))));
+    }
+    for (; it != end; ++it) {
+        acc = reduce(std::move(acc), transform(*it));
+    }
+    return acc;
+}
+
+} // namespace detail
+
+// =============================================================================
+// for_each
+// =============================================================================
+
+// Applies f to every element, in no particular order
+template <std::random_access_iterator It, typename F>
+    requires std::invocable<F&, std::iter_reference_t<It>>
+void for_each(const Policy& policy, It first, It last, F f) {
+    const auto n = static_cast<std::size_t>(last - first);
+    detail::run_ranges(policy, n, detail::grain_for_each, [&](std::size_t b, std::size_t e) {
+        using diff = std::iter_difference_t<It>;
+        std::for_each(first + static_cast<diff>(b), first + static_cast<diff>(e), f);
+    });
+}
+
+// =============================================================================
+// transform_reduce
+// =============================================================================
+
+/**
+ * reduce(init, transform(x0), transform(x1), ...) with the elements grouped
+ * into chunks. `reduce` must be associative; it need not be commutative,
+ * because partial results are combined in element order. The grouping is
+ * fixed for a given pool and grain, so floating-point sums are repeatable
+ * from run to run (though not identical to a sequential sum).
+ */
+template <std::random_access_iterator It, typename T, typename Reduce, typename Transform>
+    requires std::invocable<Transform&, std::iter_reference_t<It>>
+T transform_reduce(const Policy& policy, It first, It last, T init, Reduce reduce,
+                   Transform transform) {
+    using diff = std::iter_difference_t<It>;
+    const auto n = static_cast<std::size_t>(last - first);
+    auto& pool = detail::resolve(policy);
+    const std::size_t grain = policy.grain != 0 ? policy.grain : detail::grain_reduce;
+    const std::size_t chunks = detail::chunk_count(n, grain, detail::thread_count(policy, pool));
+
+    if (chunks == 1) {
+        return detail::reduce_chunk(first, last, std::move(init), reduce, transform);
+    }
+
+    // Each chunk starts from its first element, so no identity value is needed
+    std::vector<std::optional<T>> partial(chunks);
+    auto per_chunk = [&](std::size_t i) {
+        const auto [b, e] = detail::chunk_bounds(i, n, chunks);
+        const auto begin = first + static_cast<diff>(b);
+        partial[i].emplace(detail::reduce_chunk(begin + 1, first + static_cast<diff>(e),
+                                                T(transform(*begin)), reduce, transform));
+    };
+    detail::run_chunks(pool, chunks, per_chunk);
+
+    for (auto& p : partial) {
+        init = reduce(std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+// Inner product: init + a0*b0 + a1*b1 + ...
+template <std::random_access_iterator It1, std::random_access_iterator It2, typename T>
+T transform_reduce(const Policy& policy, It1 first1, It1 last1, It2 first2, T init) {
+    using diff = std::iter_difference_t<It1>;
+    const auto n = static_cast<std::size_t>(last1 - first1);
+    // Reduce over indices so a single range drives both inputs
+    auto indices = std::views::iota(std::size_t{0}, n);
+    return parallel::transform_reduce(
+        policy, indices.begin(), indices.end(), std::move(init), std::plus<>{},
+        [&](std::size_t i) {
+            const auto d = static_cast<diff>(i);
+            return first1[d] * first2[static_cast<std::iter_difference_t<It2>>(d)];
+        });
+}
+
+// =============================================================================
+// count_if
+// =============================================================================
+
+template <std::random_access_iterator It, std::indirect_unary_predicate<It> Pred>
+std::iter_difference_t<It> count_if(const Policy& policy, It first, It last, Pred pred) {
+    using diff = std::iter_difference_t<It>;
+    return parallel::transform_reduce(policy, first, last, diff{0}, std::plus<>{},
+                                      [&](auto&& x) { return pred(x) ? diff{1} : diff{0}; });
+}
+
+// =============================================================================
+// find
+// =============================================================================
+
+/**
+ * The first element satisfying pred, or last.
+ *
+ * Chunks are claimed in order and every chunk starts by checking whether
+ * an earlier one already found a match; once one has, all later chunks
+ * are skipped, so a match near the front costs little more than a
+ * sequential search.
+ */
+template <std::random_access_iterator It, std::indirect_unary_predicate<It> Pred>
+It find_if(const Policy& policy, It first, It last, Pred pred) {
+    using diff = std::iter_difference_t<It>;
+    const auto n = static_cast<std::size_t>(last - first);
+    std::atomic<std::size_t> found{n};
+
+    detail::run_ranges(policy, n, detail::grain_find, [&](std::size_t b, std::size_t e) {
+        // Check in blocks so a match found elsewhere stops this chunk early
+        constexpr std::size_t block = 1024;
+        for (std::size_t i = b; i < e; i += block) {
+            if (found.load(std::memory_order_relaxed) < i) {
+                return;
+            }
+            const auto block_begin = first + static_cast<diff>(i);
+            const auto block_end = first + static_cast<diff>(std::min(e, i + block));
+            const auto it = std::find_if(block_begin, block_end, pred);
+            if (it != block_end) {
+                const auto index = static_cast<std::size_t>(it - first);
+                std::size_t current = found.load(std::memory_order_relaxed);
+                while (index < current &&
+                       !found.compare_exchange_weak(current, index, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    });
+    return first + static_cast<diff>(found.load(std::memory_order_relaxed));
+}
+
+template <std::random_access_iterator It, typename T>
+    requires std::indirect_binary_predicate<std::ranges::equal_to, It, const T*>
+It find(const Policy& policy, It first, It last, const T& value) {
+    return parallel::find_if(policy, first, last, [&](const auto& x) { return x == value; });
+}
+
+// =============================================================================
+// inclusive_scan
+// =============================================================================
+
+/**
+ * out[i] = x0 op x1 op ... op xi, for an associative `op`.
+ *
+ * Two passes over the chunks: first each chunk is reduced to its total,
+ * then - after a short sequential scan of the totals - each chunk is
+ * scanned again starting from the total of everything before it. The
+ * input is read twice, the output written once.
+ */
+template <std::random_access_iterator It, std::random_access_iterator Out,
+          typename Op = std::plus<>>
+Out inclusive_scan(const Policy& policy, It first, It last, Out d_first, Op op = {}) {
+    using T = std::iter_value_t<It>;
+    using diff = std::iter_difference_t<It>;
+    using out_diff = std::iter_difference_t<Out>;
+    const auto n = static_cast<std::size_t>(last - first);
+    auto& pool = detail::resolve(policy);
+    const std::size_t grain = policy.grain != 0 ? policy.grain : detail::grain_scan;
+    const std::size_t chunks = detail::chunk_count(n, grain, detail::thread_count(policy, pool));
+
+    if (chunks == 1) {
+        return std::inclusive_scan(first, last, d_first, op);
+    }
+
+    // Pass 1: the total of every chunk but the last
+    std::vector<std::optional<T>> carry(chunks);
+    auto reduce_chunk = [&](std::size_t i) {
+        if (i + 1 == chunks) {
+            return;
+        }
+        const auto [b, e] = detail::chunk_bounds(i, n, chunks);
+        auto it = first + static_cast<diff>(b);
+        const auto end = first + static_cast<diff>(e);
+        T acc = *it;
+        for (++it; it != end; ++it) {
+            acc = op(std::move(acc), *it);
+        }
+        carry[i].emplace(std::move(acc));
+    };
+    detail::run_chunks(pool, chunks, reduce_chunk);
+
+    // Turn totals into the running total of everything before chunk i + 1
+    for (std::size_t i = 1; i + 1 < chunks; ++i) {
+        carry[i] = op(*carry[i - 1], std::move(*carry[i]));
+    }
+
+    // Pass 2: scan each chunk, seeded with the carry from the previous ones
+    auto scan_chunk = [&](std::size_t i) {
+        const auto [b, e] = detail::chunk_bounds(i, n, chunks);
+        auto it = first + static_cast<diff>(b);
+        const auto end = first + static_cast<diff>(e);
+        auto out = d_first + static_cast<out_diff>(b);
+        T acc = i == 0 ? T(*it) : op(*carry[i - 1], *it);
+        *out = acc;
+        for (++it, ++out; it != end; ++it, ++out) {
+            acc = op(std::move(acc), *it);
+            *out = acc;
+        }
+    };
+    detail::run_chunks(pool, chunks, scan_chunk);
+
+    return d_first + static_cast<out_diff>(n);
+}
+
+// =============================================================================
+// sort
+// =============================================================================
+
+namespace detail {
+
+/**
+ * Merge path: how many of the first `d` merged elements come from `a`.
+ * Splitting a merge at several such diagonals gives independent pieces
+ * that together produce exactly std::merge's (stable) output.
+ */
+template <typename ItA, typename ItB, typename Compare>
+std::size_t merge_split(std::size_t d, ItA a, std::size_t m, ItB b, std::size_t n,
+                        Compare& comp) {
+    std::size_t lo = d > n ? d - n : 0;
+    std::size_t hi = std::min(d, m);
+    while (lo < hi) {
+        const std::size_t i = lo + (hi - lo) / 2;
+        const std::size_t j = d - i;
+        // Ties go to `a`, as in std::merge: take a[i] while b[j - 1] is not less
+        if (!comp(b[static_cast<std::ptrdiff_t>(j - 1)], a[static_cast<std::ptrdiff_t>(i)])) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+template <std::random_access_iterator It, typename Compare, typename ChunkSort>
+void merge_sort(const Policy& policy, It first, It last, Compare& comp, ChunkSort chunk_sort) {
+    using T = std::iter_value_t<It>;
+    using diff = std::iter_difference_t<It>;
+    const auto n = static_cast<std::size_t>(last - first);
+    auto& pool = resolve(policy);
+    const std::size_t threads = thread_count(policy, pool);
+    const std::size_t grain = policy.grain != 0 ? policy.grain : grain_sort;
+    // One run per thread: more runs only add merge rounds
+    const std::size_t runs = std::min(chunk_count(n, grain, threads), threads);
+
+    if (runs == 1) {
+        chunk_sort(first, last);
+        return;
+    }
+
+    // Sort the runs independently
+    std::vector<std::size_t> bounds(runs + 1);
+    for (std::size_t i = 0; i <= runs; ++i) {
+        bounds[i] = i * n / runs;
+    }
+    auto sort_run = [&](std::size_t i) {
+        chunk_sort(first + static_cast<diff>(bounds[i]), first + static_cast<diff>(bounds[i + 1]));
+    };
+    run_chunks(pool, runs, sort_run);
+
+    // Merge pairs of runs, alternating between the input and a buffer. Each
+    // merge is cut into pieces so every round keeps all threads busy, even
+    // the last one, which merges just two runs.
+    std::vector<T> buffer(n);
+    bool in_buffer = false;
+
+    auto merge_round = [&](auto src, auto dst) {
+        struct Piece {
+            std::size_t a_begin, a_end, b_begin, b_end, out;
+        };
+        std::vector<Piece> pieces;
+        std::vector<std::size_t> next_bounds{0};
+        const std::size_t pairs = std::max<std::size_t>(1, (bounds.size() - 1) / 2);
+        const std::size_t per_pair = std::max<std::size_t>(1, threads * 2 / pairs);
+
+        for (std::size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            const std::size_t a0 = bounds[r];
+            const std::size_t a1 = bounds[r + 1];
+            const std::size_t b1 = r + 2 < bounds.size() ? bounds[r + 2] : a1;  // odd run out
+            const std::size_t m = a1 - a0;
+            const std::size_t k = b1 - a1;
+            const std::size_t split =
+                k == 0 ? 1 : std::min(per_pair, std::max<std::size_t>(1, (m + k) / grain));
+
+            std::size_t prev_i = 0;
+            std::size_t prev_d = 0;
+            for (std::size_t p = 1; p <= split; ++p) {
+                const std::size_t d = p * (m + k) / split;
+                const std::size_t i =
+                    p == split ? m
+                               : merge_split(d, src + static_cast<diff>(a0), m,
+                                             src + static_cast<diff>(a1), k, comp);
+                pieces.push_back(Piece{a0 + prev_i, a0 + i, a1 + (prev_d - prev_i),
+                                       a1 + (d - i), a0 + prev_d});
+                prev_i = i;
+                prev_d = d;
+            }
+            next_bounds.push_back(b1);
+        }
+
+        auto merge_piece = [&](std::size_t p) {
+            const Piece& piece = pieces[p];
+            std::merge(std::make_move_iterator(src + static_cast<diff>(piece.a_begin)),
+                       std::make_move_iterator(src + static_cast<diff>(piece.a_end)),
+                       std::make_move_iterator(src + static_cast<diff>(piece.b_begin)),
+                       std::make_move_iterator(src + static_cast<diff>(piece.b_end)),
+                       dst + static_cast<diff>(piece.out), comp);
+        };
+        run_chunks(pool, pieces.size(), merge_piece);
+        bounds = std::move(next_bounds);
+    };
+
+    while (bounds.size() > 2) {
+        if (in_buffer) {
+            merge_round(buffer.begin(), first);
+        } else {
+            merge_round(first, buffer.begin());
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        run_ranges(policy, n, grain_for_each, [&](std::size_t b, std::size_t e) {
+            std::move(buffer.begin() + static_cast<diff>(b), buffer.begin() + static_cast<diff>(e),
+                      first + static_cast<diff>(b));
+        });
+    }
+}
+
+} // namespace detail
+
+/**
+ * Parallel merge sort: one run per thread sorted with std::sort, then
+ * rounds of pairwise merges, each merge split into independent pieces
+ * along its merge path. Needs n extra elements of buffer, so the value
+ * type must be default constructible.
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less>
+    requires std::sortable<It, Compare> && std::default_initializable<std::iter_value_t<It>>
+void sort(const Policy& policy, It first, It last, Compare comp = {}) {
+    detail::merge_sort(policy, first, last, comp,
+                       [&](It b, It e) { std::sort(b, e, std::ref(comp)); });
+}
+
+// As sort(), but equal elements keep their relative order
+template <std::random_access_iterator It, typename Compare = std::ranges::less>
+    requires std::sortable<It, Compare> && std::default_initializable<std::iter_value_t<It>>
+void stable_sort(const Policy& policy, It first, It last, Compare comp = {}) {
+    detail::merge_sort(policy, first, last, comp,
+                       [&](It b, It e) { std::stable_sort(b, e, std::ref(comp)); });
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_ALGORITHMS_H
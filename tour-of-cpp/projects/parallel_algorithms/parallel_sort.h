@@ -0,0 +1,363 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include "parallel_algorithms.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+namespace parallel {
+
+// =============================================================================
+// Concepts
+// =============================================================================
+
+/**
+ * A key radix_sort can order by its bit pattern: any integer type except
+ * bool, or an IEEE float or double.
+ */
+template <typename T>
+concept RadixKey = (std::integral<T> && !std::same_as<T, bool>) ||
+                   (std::floating_point<T> && std::numeric_limits<T>::is_iec559 &&
+                    (sizeof(T) == 4 || sizeof(T) == 8));
+
+// The key a projection extracts from an element
+template <typename It, typename Proj>
+using projected_key_t = std::remove_cvref_t<std::invoke_result_t<Proj&, std::iter_reference_t<It>>>;
+
+template <typename It, typename Proj>
+concept RadixSortable = std::random_access_iterator<It> &&
+                        std::invocable<Proj&, std::iter_reference_t<It>> &&
+                        RadixKey<projected_key_t<It, Proj>> &&
+                        std::permutable<It> &&
+                        std::default_initializable<std::iter_value_t<It>>;
+
+// =============================================================================
+// Radix sort
+// =============================================================================
+
+namespace detail {
+
+inline constexpr std::size_t radix_bits_per_digit = 8;
+inline constexpr std::size_t radix_buckets = std::size_t{1} << radix_bits_per_digit;
+inline constexpr std::size_t grain_radix = 65536;
+// Below this, a comparison sort wins: radix_sort's passes have fixed costs
+inline constexpr std::size_t radix_min_size = 256;
+
+/**
+ * Maps a key to an unsigned integer with the same ordering, so that
+ * sorting the integers byte by byte sorts the keys:
+ * - signed integers: flip the sign bit, moving negatives below positives
+ * - floats: flip the sign bit of positives, and every bit of negatives
+ *   (whose magnitude grows as the bit pattern grows)
+ * Floats end up in IEEE totalOrder: -NaN < -inf < ... < -0.0 < +0.0 < ...
+ * < +inf < +NaN.
+ */
+template <RadixKey K>
+[[nodiscard]] constexpr auto radix_bits(K key) noexcept {
+    if constexpr (std::floating_point<K>) {
+        using U = std::conditional_t<sizeof(K) == 4, std::uint32_t, std::uint64_t>;
+        const auto bits = std::bit_cast<U>(key);
+        constexpr U sign = U{1} << (std::numeric_limits<U>::digits - 1);
+        return (bits & sign) != 0 ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+    } else if constexpr (std::signed_integral<K>) {
+        using U = std::make_unsigned_t<K>;
+        constexpr U sign = U{1} << (std::numeric_limits<U>::digits - 1);
+        return static_cast<U>(static_cast<U>(key) ^ sign);
+    } else {
+        return key;
+    }
+}
+
+template <RadixKey K>
+using radix_bits_t = decltype(radix_bits(K{}));
+
+template <typename U>
+[[nodiscard]] constexpr std::size_t digit_of(U bits, std::size_t pass) noexcept {
+    return static_cast<std::size_t>(bits >> (pass * radix_bits_per_digit)) & (radix_buckets - 1);
+}
+
+} // namespace detail
+
+/**
+ * Stable least-significant-digit radix sort by an integer or floating-point
+ * key, in ascending order.
+ *
+ * One pass per byte of the key, over the input split into one part per
+ * thread:
+ * 1. Each part counts how often every digit occurs in it.
+ * 2. A prefix sum over all parts' counts, digit by digit, gives every part
+ *    its own output positions for each digit.
+ * 3. The parts scatter their elements to those positions in parallel,
+ *    without locking.
+ * A single sweep up front counts the digits of every pass at once. Those
+ * counts serve the first pass directly, and every pass when there is only
+ * one part; they also reveal passes in which all keys share a digit - the
+ * high bytes of small numbers, say - which are skipped.
+ *
+ * O(n * sizeof(key)) work regardless of the input order, plus an n-element
+ * buffer. `proj` extracts the key from an element, so records can be
+ * sorted by a field:
+ *
+ *     parallel::radix_sort(parallel::par, orders, &Order::timestamp);
+ */
+template <std::random_access_iterator It, typename Proj = std::identity>
+    requires RadixSortable<It, Proj>
+void radix_sort(const Policy& policy, It first, It last, Proj proj = {}) {
+    using T = std::iter_value_t<It>;
+    using K = projected_key_t<It, Proj>;
+    using diff = std::iter_difference_t<It>;
+    using Counts = std::array<std::size_t, detail::radix_buckets>;
+    constexpr std::size_t passes = sizeof(detail::radix_bits_t<K>);
+
+    const auto n = static_cast<std::size_t>(last - first);
+    const auto bits_of = [&proj](const auto& x) {
+        return detail::radix_bits(static_cast<K>(std::invoke(proj, x)));
+    };
+
+    if (n < detail::radix_min_size) {
+        std::stable_sort(first, last,
+                         [&](const auto& a, const auto& b) { return bits_of(a) < bits_of(b); });
+        return;
+    }
+
+    auto& pool = detail::resolve(policy);
+    const std::size_t grain = policy.grain != 0 ? policy.grain : detail::grain_radix;
+    const std::size_t threads = detail::thread_count(policy, pool);
+    // One contiguous part per thread keeps each part's 256 output streams long
+    const std::size_t parts = std::min(detail::chunk_count(n, grain, threads), threads);
+
+    // counts[p][pass]: digit counts of part p
+    std::vector<std::array<Counts, passes>> counts(parts);
+    auto count_all = [&](std::size_t p) {
+        auto& c = counts[p];
+        for (auto& pass_counts : c) {
+            pass_counts.fill(0);
+        }
+        const auto [b, e] = detail::chunk_bounds(p, n, parts);
+        for (std::size_t i = b; i < e; ++i) {
+            const auto bits = bits_of(first[static_cast<diff>(i)]);
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                ++c[pass][detail::digit_of(bits, pass)];
+            }
+        }
+    };
+    detail::run_chunks(pool, parts, count_all);
+
+    // A pass is trivial if every key has the same digit in it
+    std::array<bool, passes> trivial{};
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        for (std::size_t d = 0; d < detail::radix_buckets && !trivial[pass]; ++d) {
+            std::size_t total = 0;
+            for (std::size_t p = 0; p < parts; ++p) {
+                total += counts[p][pass][d];
+            }
+            trivial[pass] = total == n;
+        }
+    }
+
+    std::vector<T> buffer(n);
+    bool in_buffer = false;
+    bool counts_current = true;  // counts describe the parts' current contents
+
+    auto run_pass = [&](auto src, auto dst, std::size_t pass) {
+        // 1. Recount, once elements have moved between parts
+        if (!counts_current) {
+            auto count_part = [&](std::size_t p) {
+                Counts& c = counts[p][pass];
+                c.fill(0);
+                const auto [b, e] = detail::chunk_bounds(p, n, parts);
+                for (std::size_t i = b; i < e; ++i) {
+                    ++c[detail::digit_of(bits_of(src[static_cast<diff>(i)]), pass)];
+                }
+            };
+            detail::run_chunks(pool, parts, count_part);
+        }
+
+        // 2. Exclusive prefix sum, digit-major: all of digit 0 (part 0,
+        //    then part 1, ...), then all of digit 1, and so on
+        std::size_t offset = 0;
+        for (std::size_t d = 0; d < detail::radix_buckets; ++d) {
+            for (std::size_t p = 0; p < parts; ++p) {
+                const std::size_t c = counts[p][pass][d];
+                counts[p][pass][d] = offset;
+                offset += c;
+            }
+        }
+
+        // 3. Scatter; each part writes only to its own slots
+        auto scatter_part = [&](std::size_t p) {
+            Counts& next = counts[p][pass];
+            const auto [b, e] = detail::chunk_bounds(p, n, parts);
+            for (std::size_t i = b; i < e; ++i) {
+                auto& x = src[static_cast<diff>(i)];
+                const std::size_t d = detail::digit_of(bits_of(x), pass);
+                dst[static_cast<diff>(next[d]++)] = std::move(x);
+            }
+        };
+        detail::run_chunks(pool, parts, scatter_part);
+        counts_current = parts == 1;
+    };
+
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        if (trivial[pass]) {
+            continue;
+        }
+        if (in_buffer) {
+            run_pass(buffer.begin(), first, pass);
+        } else {
+            run_pass(first, buffer.begin(), pass);
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        detail::run_ranges(policy, n, detail::grain_for_each, [&](std::size_t b, std::size_t e) {
+            std::move(buffer.begin() + static_cast<diff>(b), buffer.begin() + static_cast<diff>(e),
+                      first + static_cast<diff>(b));
+        });
+    }
+}
+
+template <std::ranges::random_access_range R, typename Proj = std::identity>
+    requires RadixSortable<std::ranges::iterator_t<R>, Proj>
+void radix_sort(const Policy& policy, R&& range, Proj proj = {}) {
+    parallel::radix_sort(policy, std::ranges::begin(range), std::ranges::end(range),
+                         std::move(proj));
+}
+
+// =============================================================================
+// Sample sort
+// =============================================================================
+
+namespace detail {
+
+inline constexpr std::size_t grain_sample_sort = 16384;
+inline constexpr std::size_t buckets_per_thread = 8;
+inline constexpr std::size_t sample_oversampling = 32;
+inline constexpr std::size_t max_buckets = std::numeric_limits<std::uint16_t>::max();
+
+} // namespace detail
+
+/**
+ * Parallel sample sort for any strict weak ordering. Not stable.
+ *
+ * 1. Sort a random sample of the input and pick evenly spaced splitters
+ *    from it, dividing the key space into buckets of about equal size.
+ * 2. In parallel, each part of the input finds every element's bucket by
+ *    binary search over the splitters, and counts them.
+ * 3. A prefix sum over the counts gives each part its own output slots;
+ *    the parts scatter into a buffer in parallel.
+ * 4. Each bucket is moved back into place and sorted with std::sort, in
+ *    parallel - buckets already hold the right elements in the right
+ *    order relative to each other.
+ *
+ * Each element is moved twice, against log2(threads) times for a merge
+ * sort. Inputs with very many copies of one key can make one bucket much
+ * larger than the rest, which limits the speed-up.
+ */
+template <std::random_access_iterator It, typename Compare = std::ranges::less>
+    requires std::sortable<It, Compare> && std::default_initializable<std::iter_value_t<It>>
+void sample_sort(const Policy& policy, It first, It last, Compare comp = {}) {
+    using T = std::iter_value_t<It>;
+    using diff = std::iter_difference_t<It>;
+    const auto n = static_cast<std::size_t>(last - first);
+    auto& pool = detail::resolve(policy);
+    const std::size_t threads = detail::thread_count(policy, pool);
+    const std::size_t grain = policy.grain != 0 ? policy.grain : detail::grain_sample_sort;
+    const std::size_t parts = std::min(detail::chunk_count(n, grain, threads), threads);
+
+    if (parts <= 1) {
+        std::sort(first, last, std::ref(comp));
+        return;
+    }
+    const std::size_t buckets = std::min({threads * detail::buckets_per_thread, n / grain + 1,
+                                          detail::max_buckets});
+
+    // 1. Splitters from a sorted, seeded (so repeatable) random sample. The
+    //    sample holds positions rather than copies, so T need not be copyable;
+    //    the splitters are only read before the input is moved from.
+    std::vector<std::size_t> sample(buckets * detail::sample_oversampling);
+    std::minstd_rand gen{static_cast<std::minstd_rand::result_type>(n)};
+    std::uniform_int_distribution<std::size_t> pick{0, n - 1};
+    std::generate(sample.begin(), sample.end(), [&] { return pick(gen); });
+    const auto at = [&](std::size_t i) -> decltype(auto) { return first[static_cast<diff>(i)]; };
+    std::sort(sample.begin(), sample.end(),
+              [&](std::size_t a, std::size_t b) { return std::invoke(comp, at(a), at(b)); });
+    std::vector<std::size_t> splitters;
+    for (std::size_t b = 1; b < buckets; ++b) {
+        splitters.push_back(sample[b * sample.size() / buckets]);
+    }
+
+    // 2. Classify and count
+    std::vector<std::uint16_t> bucket_of(n);
+    std::vector<std::vector<std::size_t>> counts(parts, std::vector<std::size_t>(buckets));
+    auto classify = [&](std::size_t p) {
+        const auto [b, e] = detail::chunk_bounds(p, n, parts);
+        auto& c = counts[p];
+        for (std::size_t i = b; i < e; ++i) {
+            const auto it = std::upper_bound(
+                splitters.begin(), splitters.end(), i,
+                [&](std::size_t x, std::size_t s) { return std::invoke(comp, at(x), at(s)); });
+            const auto bucket = static_cast<std::uint16_t>(it - splitters.begin());
+            bucket_of[i] = bucket;
+            ++c[bucket];
+        }
+    };
+    detail::run_chunks(pool, parts, classify);
+
+    // 3. Offsets, bucket-major, then scatter
+    std::vector<std::size_t> bucket_begin(buckets + 1);
+    std::size_t offset = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+        bucket_begin[b] = offset;
+        for (std::size_t p = 0; p < parts; ++p) {
+            const std::size_t c = counts[p][b];
+            counts[p][b] = offset;
+            offset += c;
+        }
+    }
+    bucket_begin[buckets] = n;
+
+    std::vector<T> buffer(n);
+    auto scatter = [&](std::size_t p) {
+        const auto [b, e] = detail::chunk_bounds(p, n, parts);
+        auto& next = counts[p];
+        for (std::size_t i = b; i < e; ++i) {
+            buffer[next[bucket_of[i]]++] = std::move(first[static_cast<diff>(i)]);
+        }
+    };
+    detail::run_chunks(pool, parts, scatter);
+
+    // 4. Move each bucket home and sort it
+    auto sort_bucket = [&](std::size_t b) {
+        const auto src = buffer.begin() + static_cast<diff>(bucket_begin[b]);
+        const auto src_end = buffer.begin() + static_cast<diff>(bucket_begin[b + 1]);
+        const auto dst = first + static_cast<diff>(bucket_begin[b]);
+        std::move(src, src_end, dst);
+        std::sort(dst, dst + (src_end - src), std::ref(comp));
+    };
+    detail::run_chunks(pool, buckets, sort_bucket);
+}
+
+template <std::ranges::random_access_range R, typename Compare = std::ranges::less>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare> &&
+             std::default_initializable<std::ranges::range_value_t<R>>
+void sample_sort(const Policy& policy, R&& range, Compare comp = {}) {
+    parallel::sample_sort(policy, std::ranges::begin(range), std::ranges::end(range),
+                          std::move(comp));
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_SORT_H
@@ -0,0 +1,235 @@
+#include <catch2/catch_test_macros.hpp>
+#include "parallel_algorithms.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using concurrent::ThreadPool;
+
+namespace {
+
+std::vector<int> random_ints(std::size_t n, int max = 1'000'000) {
+    std::mt19937 gen{static_cast<unsigned>(n)};
+    std::uniform_int_distribution<int> dist{0, max};
+    std::vector<int> v(n);
+    std::generate(v.begin(), v.end(), [&] { return dist(gen); });
+    return v;
+}
+
+// Sizes around the chunking thresholds, with a small grain so that even
+// modest inputs are split many ways
+const std::vector<std::size_t> sizes{0, 1, 2, 15, 16, 17, 31, 100, 1000, 4099, 50'000};
+
+} // namespace
+
+TEST_CASE("parallel::for_each visits every element once", "[parallel][for_each]") {
+    ThreadPool pool{4};
+    for (const auto n : sizes) {
+        std::vector<int> v(n, 1);
+        parallel::for_each(parallel::on(pool, 16), v.begin(), v.end(), [](int& x) { x *= 3; });
+        REQUIRE(std::all_of(v.begin(), v.end(), [](int x) { return x == 3; }));
+    }
+}
+
+TEST_CASE("parallel::transform_reduce", "[parallel][transform_reduce]") {
+    ThreadPool pool{4};
+
+    SECTION("sum of squares matches std") {
+        for (const auto n : sizes) {
+            const auto v = random_ints(n, 1000);
+            const long long expected = std::transform_reduce(
+                v.begin(), v.end(), 0LL, std::plus<>{}, [](int x) { return 1LL * x * x; });
+            const long long actual =
+                parallel::transform_reduce(parallel::on(pool, 16), v.begin(), v.end(), 0LL,
+                                           std::plus<>{}, [](int x) { return 1LL * x * x; });
+            REQUIRE(actual == expected);
+        }
+    }
+
+    SECTION("partial results are combined in order") {
+        // Concatenation is associative but not commutative
+        std::vector<char> letters(500);
+        std::iota(letters.begin(), letters.end(), 0);
+        std::string expected;
+        for (const char c : letters) {
+            expected += static_cast<char>('a' + c % 26);
+        }
+        const auto actual = parallel::transform_reduce(
+            parallel::on(pool, 16), letters.begin(), letters.end(), std::string{}, std::plus<>{},
+            [](char c) { return std::string(1, static_cast<char>('a' + c % 26)); });
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("inner product") {
+        const std::vector<double> a(10'000, 1.5);
+        const std::vector<double> b(10'000, 2.0);
+        REQUIRE(parallel::transform_reduce(parallel::on(pool, 64), a.begin(), a.end(), b.begin(),
+                                           0.0) == 30'000.0);
+    }
+}
+
+TEST_CASE("parallel::count_if matches std::count_if", "[parallel][count_if]") {
+    ThreadPool pool{3};
+    for (const auto n : sizes) {
+        const auto v = random_ints(n);
+        const auto even = [](int x) { return x % 2 == 0; };
+        REQUIRE(parallel::count_if(parallel::on(pool, 16), v.begin(), v.end(), even) ==
+                std::count_if(v.begin(), v.end(), even));
+    }
+}
+
+TEST_CASE("parallel::find returns the first match", "[parallel][find]") {
+    ThreadPool pool{4};
+    std::vector<int> v(100'000, 0);
+
+    SECTION("no match") {
+        REQUIRE(parallel::find(parallel::on(pool, 16), v.begin(), v.end(), 1) == v.end());
+    }
+
+    SECTION("several matches in different chunks") {
+        for (const std::size_t first : {0UL, 1UL, 777UL, 50'000UL, 99'999UL}) {
+            std::fill(v.begin(), v.end(), 0);
+            v[first] = 1;
+            if (first + 3 < v.size()) {
+                v[first + 3] = 1;
+            }
+            v.back() = 1;
+            const auto it = parallel::find(parallel::on(pool, 16), v.begin(), v.end(), 1);
+            REQUIRE(static_cast<std::size_t>(it - v.begin()) == first);
+        }
+    }
+
+    SECTION("find_if on an empty range") {
+        std::vector<int> empty;
+        REQUIRE(parallel::find_if(parallel::on(pool), empty.begin(), empty.end(),
+                                  [](int) { return true; }) == empty.end());
+    }
+}
+
+TEST_CASE("parallel::inclusive_scan matches std::inclusive_scan", "[parallel][scan]") {
+    ThreadPool pool{4};
+
+    SECTION("sums") {
+        for (const auto n : sizes) {
+            const auto v = random_ints(n, 100);
+            std::vector<long long> expected(n);
+            std::vector<long long> actual(n);
+            std::inclusive_scan(v.begin(), v.end(), expected.begin(), std::plus<long long>{});
+            const auto end = parallel::inclusive_scan(parallel::on(pool, 16), v.begin(), v.end(),
+                                                      actual.begin(), std::plus<long long>{});
+            REQUIRE(end == actual.end());
+            REQUIRE(actual == expected);
+        }
+    }
+
+    SECTION("non-commutative operation") {
+        std::vector<std::string> words(200);
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            words[i] = std::string(1, static_cast<char>('a' + i % 26));
+        }
+        std::vector<std::string> expected(words.size());
+        std::vector<std::string> actual(words.size());
+        std::inclusive_scan(words.begin(), words.end(), expected.begin());
+        parallel::inclusive_scan(parallel::on(pool, 8), words.begin(), words.end(),
+                                 actual.begin());
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("parallel::sort", "[parallel][sort]") {
+    SECTION("matches std::sort for every size and pool") {
+        for (const std::size_t threads : {1UL, 2UL, 3UL, 8UL}) {
+            ThreadPool pool{threads};
+            for (const auto n : sizes) {
+                auto v = random_ints(n);
+                auto expected = v;
+                std::sort(expected.begin(), expected.end());
+                parallel::sort(parallel::on(pool, 16), v.begin(), v.end());
+                REQUIRE(v == expected);
+            }
+        }
+    }
+
+    SECTION("custom comparator and many duplicates") {
+        ThreadPool pool{4};
+        auto v = random_ints(20'000, 10);
+        parallel::sort(parallel::on(pool, 64), v.begin(), v.end(), std::greater<>{});
+        REQUIRE(std::is_sorted(v.begin(), v.end(), std::greater<>{}));
+    }
+
+    SECTION("stable_sort keeps equal elements in order") {
+        ThreadPool pool{4};
+        std::vector<std::pair<int, int>> v;
+        const auto keys = random_ints(20'000, 50);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            v.emplace_back(keys[i], static_cast<int>(i));
+        }
+        auto expected = v;
+        const auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+        std::stable_sort(expected.begin(), expected.end(), by_key);
+        parallel::stable_sort(parallel::on(pool, 64), v.begin(), v.end(), by_key);
+        REQUIRE(v == expected);
+    }
+
+    SECTION("move-only-friendly element type") {
+        ThreadPool pool{4};
+        std::vector<std::string> v(5000);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            v[i] = std::to_string((i * 7919) % 5000);
+        }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+        parallel::sort(parallel::on(pool, 64), v.begin(), v.end());
+        REQUIRE(v == expected);
+    }
+}
+
+TEST_CASE("parallel algorithms propagate exceptions", "[parallel][exceptions]") {
+    ThreadPool pool{4};
+    std::vector<int> v(10'000);
+    std::iota(v.begin(), v.end(), 0);
+    std::atomic<int> calls{0};
+
+    REQUIRE_THROWS_AS(parallel::for_each(parallel::on(pool, 16), v.begin(), v.end(),
+                                         [&](int x) {
+                                             calls.fetch_add(1);
+                                             if (x == 5000) {
+                                                 throw std::runtime_error{"bad element"};
+                                             }
+                                         }),
+                      std::runtime_error);
+
+    // The pool is still usable afterwards
+    REQUIRE(parallel::count_if(parallel::on(pool, 16), v.begin(), v.end(),
+                               [](int x) { return x < 100; }) == 100);
+}
+
+TEST_CASE("parallel algorithms can be called from pool tasks", "[parallel][nested]") {
+    // Every worker blocks in a nested call; the callers must finish the
+    // chunks themselves rather than wait for a free worker
+    ThreadPool pool{2};
+    std::vector<std::future<long long>> results;
+    for (int t = 0; t < 4; ++t) {
+        results.push_back(pool.submit([&pool] {
+            std::vector<int> v(50'000, 1);
+            return parallel::transform_reduce(parallel::on(pool, 16), v.begin(), v.end(), 0LL,
+                                              std::plus<>{}, [](int x) { return 1LL * x; });
+        }));
+    }
+    for (auto& r : results) {
+        REQUIRE(r.get() == 50'000);
+    }
+}
+
+TEST_CASE("default pool", "[parallel][default]") {
+    auto v = random_ints(100'000);
+    auto expected = v;
+    std::sort(expected.begin(), expected.end());
+    parallel::sort(parallel::par, v.begin(), v.end());
+    REQUIRE(v == expected);
+    REQUIRE(parallel::default_pool().size() >= 1);
+}
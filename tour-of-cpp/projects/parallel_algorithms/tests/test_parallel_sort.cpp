@@ -0,0 +1,195 @@
+#include <catch2/catch_test_macros.hpp>
+#include "parallel_sort.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using concurrent::ThreadPool;
+
+namespace {
+
+template <typename T>
+std::vector<T> random_values(std::size_t n, T lo, T hi) {
+    std::mt19937_64 gen{n};
+    std::vector<T> v(n);
+    if constexpr (std::is_floating_point_v<T>) {
+        std::uniform_real_distribution<T> dist{lo, hi};
+        std::generate(v.begin(), v.end(), [&] { return dist(gen); });
+    } else {
+        // uniform_int_distribution does not take 8-bit types
+        using Wide = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+        std::uniform_int_distribution<Wide> dist{lo, hi};
+        std::generate(v.begin(), v.end(), [&] { return static_cast<T>(dist(gen)); });
+    }
+    return v;
+}
+
+// Sizes around the sequential fallback and the part boundaries
+const std::vector<std::size_t> sizes{0, 1, 2, 100, 255, 256, 257, 1000, 4099, 50'000};
+
+template <typename T>
+void check_radix_sort(T lo, T hi) {
+    for (const std::size_t threads : {1UL, 3UL, 8UL}) {
+        ThreadPool pool{threads};
+        for (const auto n : sizes) {
+            auto v = random_values<T>(n, lo, hi);
+            auto expected = v;
+            std::sort(expected.begin(), expected.end());
+            parallel::radix_sort(parallel::on(pool, 64), v);
+            REQUIRE(v == expected);
+        }
+    }
+}
+
+struct Record {
+    std::uint32_t key;
+    std::size_t position;
+    bool operator==(const Record&) const = default;
+};
+
+} // namespace
+
+TEST_CASE("parallel::radix_sort orders integer keys", "[parallel][radix_sort]") {
+    SECTION("unsigned") {
+        check_radix_sort<std::uint8_t>(0, 255);
+        check_radix_sort<std::uint32_t>(0, std::numeric_limits<std::uint32_t>::max());
+        check_radix_sort<std::uint64_t>(0, std::numeric_limits<std::uint64_t>::max());
+    }
+
+    SECTION("signed, across zero") {
+        check_radix_sort<std::int16_t>(-30'000, 30'000);
+        check_radix_sort<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+        check_radix_sort<std::int64_t>(-1'000'000'000'000LL, 1'000'000'000'000LL);
+    }
+
+    SECTION("small values skip the high passes") {
+        check_radix_sort<std::uint64_t>(0, 200);
+    }
+
+    SECTION("already sorted, reversed and constant input") {
+        ThreadPool pool{4};
+        std::vector<int> v(10'000);
+        std::iota(v.begin(), v.end(), -5000);
+        const auto expected = v;
+        parallel::radix_sort(parallel::on(pool, 64), v);
+        REQUIRE(v == expected);
+        std::reverse(v.begin(), v.end());
+        parallel::radix_sort(parallel::on(pool, 64), v);
+        REQUIRE(v == expected);
+        std::vector<int> same(10'000, 7);
+        parallel::radix_sort(parallel::on(pool, 64), same);
+        REQUIRE(std::all_of(same.begin(), same.end(), [](int x) { return x == 7; }));
+    }
+}
+
+TEST_CASE("parallel::radix_sort orders floating-point keys", "[parallel][radix_sort]") {
+    check_radix_sort<float>(-1e6f, 1e6f);
+    check_radix_sort<double>(-1e300, 1e300);
+
+    SECTION("infinities and signed zeros") {
+        ThreadPool pool{4};
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        std::vector<double> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.insert(v.end(), {inf, 0.0, -inf, -0.0, 1.5, -1.5, std::numeric_limits<double>::min(),
+                               -std::numeric_limits<double>::denorm_min()});
+        }
+        parallel::radix_sort(parallel::on(pool, 64), v);
+        REQUIRE(std::is_sorted(v.begin(), v.end()));
+        REQUIRE(v.front() == -inf);
+        REQUIRE(v.back() == inf);
+        // -0.0 sorts before +0.0
+        const auto zero = std::find(v.begin(), v.end(), 0.0);
+        REQUIRE(std::signbit(*zero));
+        REQUIRE_FALSE(std::signbit(*(zero + 1000)));
+    }
+
+    SECTION("NaNs go to the ends by sign") {
+        std::vector<float> v(1000, 1.0f);
+        v[10] = std::numeric_limits<float>::quiet_NaN();
+        v[20] = -std::numeric_limits<float>::quiet_NaN();
+        parallel::radix_sort(parallel::par, v);
+        REQUIRE(std::isnan(v.front()));
+        REQUIRE(std::signbit(v.front()));
+        REQUIRE(std::isnan(v.back()));
+        REQUIRE_FALSE(std::signbit(v.back()));
+    }
+}
+
+TEST_CASE("parallel::radix_sort is stable and sorts by projection", "[parallel][radix_sort]") {
+    ThreadPool pool{4};
+    const auto keys = random_values<std::uint32_t>(20'000, 0, 300);
+    std::vector<Record> v;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        v.push_back({keys[i], i});
+    }
+    auto expected = v;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const Record& a, const Record& b) { return a.key < b.key; });
+
+    SECTION("data member") {
+        parallel::radix_sort(parallel::on(pool, 64), v, &Record::key);
+        REQUIRE(v == expected);
+    }
+
+    SECTION("iterators and a lambda") {
+        parallel::radix_sort(parallel::on(pool, 64), v.begin(), v.end(),
+                             [](const Record& r) { return r.key; });
+        REQUIRE(v == expected);
+    }
+}
+
+TEST_CASE("parallel::sample_sort", "[parallel][sample_sort]") {
+    SECTION("matches std::sort for every size and pool") {
+        for (const std::size_t threads : {1UL, 2UL, 3UL, 8UL}) {
+            ThreadPool pool{threads};
+            for (const auto n : sizes) {
+                auto v = random_values<int>(n, 0, 1'000'000);
+                auto expected = v;
+                std::sort(expected.begin(), expected.end());
+                parallel::sample_sort(parallel::on(pool, 16), v);
+                REQUIRE(v == expected);
+            }
+        }
+    }
+
+    SECTION("custom comparator and many duplicates") {
+        ThreadPool pool{4};
+        auto v = random_values<int>(20'000, 0, 3);
+        parallel::sample_sort(parallel::on(pool, 64), v.begin(), v.end(), std::greater<>{});
+        REQUIRE(std::is_sorted(v.begin(), v.end(), std::greater<>{}));
+        REQUIRE(std::count(v.begin(), v.end(), 0) > 0);
+    }
+
+    SECTION("strings") {
+        ThreadPool pool{4};
+        std::vector<std::string> v(5000);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            v[i] = std::to_string((i * 7919) % 5000);
+        }
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+        parallel::sample_sort(parallel::on(pool, 64), v);
+        REQUIRE(v == expected);
+    }
+
+    SECTION("move-only elements") {
+        ThreadPool pool{4};
+        std::vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < 5000; ++i) {
+            v.push_back(std::make_unique<int>((i * 7919) % 5000));
+        }
+        parallel::sample_sort(parallel::on(pool, 64), v,
+                              [](const auto& a, const auto& b) { return *a < *b; });
+        for (int i = 0; i < 5000; ++i) {
+            REQUIRE(*v[static_cast<std::size_t>(i)] == i);
+        }
+    }
+}
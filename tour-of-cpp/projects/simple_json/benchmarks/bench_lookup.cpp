@@ -0,0 +1,214 @@
+// Benchmark: string-keyed lookups with and without transparent comparison
+//
+// Lookups of n keys, in random order, that the caller holds as
+// std::string_views - slices of a parsed document or of a request line:
+//   json       - JsonValue::operator[] on an object of n members
+//   map        - std::map<std::string, int>
+//   unordered  - std::unordered_map<std::string, int>
+//
+//   copy       - the key is first copied into a std::string, as an API
+//                taking const std::string& forces its callers to do
+//   view       - the string_view is looked up as it is, through std::less<>
+//                or Chapter 12's StringHash and StringEqual
+//
+// Keys are over 20 characters, past the short-string buffer, so every
+// copy allocates. This program replaces the global operator new with one
+// that counts calls. A "view" benchmark that sees an allocation stops the
+// run with an error, which makes the smoke test a check that transparent
+// lookup stays allocation-free.
+
+#include "bench.h"
+#include "json_value.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::uint64_t allocations = 0;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct StringHash {
+    using is_transparent = void;  // Enable heterogeneous lookup
+
+    std::size_t operator()(std::string_view sv) const {
+        return std::hash<std::string_view>{}(sv);
+    }
+};
+
+struct StringEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a == b;
+    }
+};
+
+// Keys like "customer_account_0000123" inside one buffer, and views of
+// them in random order
+struct Keys {
+    std::string buffer;
+    std::vector<std::string_view> views;
+};
+
+const Keys& keys(std::int64_t n) {
+    static std::map<std::int64_t, Keys> cache;
+    auto& out = cache[n];
+    if (out.views.empty()) {
+        const auto count = static_cast<std::size_t>(n);
+        std::vector<std::size_t> offsets;
+        for (std::size_t i = 0; i < count; ++i) {
+            char key[40];  // the prefix and the widest std::size_t
+            const int length = std::snprintf(key, sizeof key, "customer_account_%07zu", i);
+            offsets.push_back(out.buffer.size());
+            out.buffer.append(key, static_cast<std::size_t>(length));
+        }
+        const std::size_t length = out.buffer.size() / count;
+        for (const auto offset : offsets) {
+            out.views.push_back(std::string_view{out.buffer}.substr(offset, length));
+        }
+        std::shuffle(out.views.begin(), out.views.end(), std::mt19937{7});
+    }
+    return out;
+}
+
+template <typename Map>
+Map build(std::int64_t n) {
+    Map map;
+    int value = 0;
+    for (const auto key : keys(n).views) {
+        map.emplace(std::string(key), value++);
+    }
+    return map;
+}
+
+json::JsonValue build_json(std::int64_t n) {
+    json::JsonObject members;
+    int value = 0;
+    for (const auto key : keys(n).views) {
+        members.emplace(std::string(key), json::JsonValue(value++));
+    }
+    return json::JsonValue(std::move(members));
+}
+
+// Runs lookup(key) over every key, and fails the run if a lookup that
+// should not allocate does
+template <typename Lookup>
+void run(bench::State& state, bool must_not_allocate, Lookup lookup) {
+    const auto& views = keys(state.arg()).views;
+    while (state.keep_running()) {
+        const auto before = allocations;
+        double found = 0;
+        for (const auto key : views) {
+            found += lookup(key);
+        }
+        bench::do_not_optimize(found);
+        if (must_not_allocate && allocations != before) {
+            std::fprintf(stderr, "bench_lookup: %llu allocations in %zu string_view lookups\n",
+                         static_cast<unsigned long long>(allocations - before), views.size());
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+const Map& built(std::int64_t n) {
+    static std::map<std::int64_t, Map> cache;
+    auto it = cache.find(n);
+    if (it == cache.end()) {
+        it = cache.emplace(n, build<Map>(n)).first;
+    }
+    return it->second;
+}
+
+const json::JsonValue& built_json(std::int64_t n) {
+    static std::map<std::int64_t, json::JsonValue> cache;
+    auto it = cache.find(n);
+    if (it == cache.end()) {
+        it = cache.emplace(n, build_json(n)).first;
+    }
+    return it->second;
+}
+
+void json_copy(bench::State& state) {
+    const auto& object = built_json(state.arg());
+    run(state, false, [&](std::string_view key) {
+        const std::string copy{key};
+        return object[copy].as_number();
+    });
+}
+
+void json_view(bench::State& state) {
+    const auto& object = built_json(state.arg());
+    run(state, true, [&](std::string_view key) { return object[key].as_number(); });
+}
+
+template <typename Map>
+void find_copy(bench::State& state) {
+    const auto& map = built<Map>(state.arg());
+    run(state, false, [&](std::string_view key) {
+        const auto it = map.find(std::string(key));
+        if (it == map.end()) {
+            std::abort();
+        }
+        return static_cast<double>(it->second);
+    });
+}
+
+template <typename Map>
+void find_view(bench::State& state) {
+    const auto& map = built<Map>(state.arg());
+    run(state, true, [&](std::string_view key) {
+        const auto it = map.find(key);
+        if (it == map.end()) {
+            std::abort();
+        }
+        return static_cast<double>(it->second);
+    });
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 6;
+    constexpr std::int64_t large = 1 << 14;
+
+    using Map = std::map<std::string, int>;
+    using TransparentMap = std::map<std::string, int, std::less<>>;
+    using Unordered = std::unordered_map<std::string, int>;
+    using TransparentUnordered = std::unordered_map<std::string, int, StringHash, StringEqual>;
+
+    bench::register_benchmark("json/copy", json_copy)->range(small, large, 16);
+    bench::register_benchmark("json/view", json_view)->range(small, large, 16);
+    bench::register_benchmark("map/copy", find_copy<Map>)->range(small, large, 16);
+    bench::register_benchmark("map/view", find_view<TransparentMap>)->range(small, large, 16);
+    bench::register_benchmark("unordered/copy", find_copy<Unordered>)->range(small, large, 16);
+    bench::register_benchmark("unordered/view", find_view<TransparentUnordered>)
+        ->range(small, large, 16);
+    return true;
+}();
+
+} // namespace
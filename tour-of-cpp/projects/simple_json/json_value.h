@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <stdexcept>
+#include <string_view>
 #include <type_traits>
 
 namespace json {
@@ -13,9 +14,11 @@ namespace json {
 // Forward declaration for recursive types
 struct JsonValue;
 
-// Type aliases for JSON compound types
+// Type aliases for JSON compound types. std::less<> is a transparent
+// comparator: find() accepts a std::string_view without building a
+// std::string, so looking up a member never allocates.
 using JsonArray = std::vector<JsonValue>;
-using JsonObject = std::map<std::string, JsonValue>;
+using JsonObject = std::map<std::string, JsonValue, std::less<>>;
 
 /**
  * Represents a JSON value using std::variant.
@@ -26,7 +29,7 @@ using JsonObject = std::map<std::string, JsonValue>;
  * - number (double)
  * - string (std::string)
  * - array (std::vector<JsonValue>)
- * - object (std::map<std::string, JsonValue>)
+ * - object (std::map<std::string, JsonValue, std::less<>>)
  */
 struct JsonValue {
     // The variant holding the actual value
@@ -178,22 +181,23 @@ struct JsonValue {
     }
 
     /**
-     * Object key access.
+     * Object key access. Takes a std::string_view, so a literal or a slice
+     * of a larger buffer is looked up as it is, with no temporary string.
      */
-    [[nodiscard]] const JsonValue& operator[](const std::string& key) const {
+    [[nodiscard]] const JsonValue& operator[](std::string_view key) const {
         const auto& obj = as_object();
         auto it = obj.find(key);
         if (it == obj.end()) {
-            throw std::runtime_error("Key not found: " + key);
+            throw std::runtime_error("Key not found: " + std::string(key));
         }
         return it->second;
     }
 
-    [[nodiscard]] JsonValue& operator[](const std::string& key) {
+    [[nodiscard]] JsonValue& operator[](std::string_view key) {
         auto& obj = as_object();
         auto it = obj.find(key);
         if (it == obj.end()) {
-            throw std::runtime_error("Key not found: " + key);
+            throw std::runtime_error("Key not found: " + std::string(key));
         }
         return it->second;
     }
@@ -201,7 +205,7 @@ struct JsonValue {
     /**
      * Check if object contains key.
      */
-    [[nodiscard]] bool contains(const std::string& key) const {
+    [[nodiscard]] bool contains(std::string_view key) const {
         if (!is_object()) return false;
         const auto& obj = std::get<JsonObject>(data);
         return obj.find(key) != obj.end();
@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include "json_parser.h"
+#include <string>
+#include <string_view>
 
 using namespace json;
 using Catch::Matchers::WithinRel;
@@ -107,6 +109,30 @@ TEST_CASE("JsonValue object access", "[json][value]") {
     REQUIRE_THROWS(obj["missing"]);
 }
 
+TEST_CASE("JsonValue object access by string_view", "[json][value]") {
+    JsonValue obj = JsonObject{
+        {"user_name", JsonValue("Alice")},
+        {"user", JsonValue(1)}
+    };
+
+    // A slice of a larger buffer, not null-terminated, is looked up as it is
+    const std::string path = "user_name.first";
+    const std::string_view head = std::string_view{path}.substr(0, 9);
+    REQUIRE(obj[head].as_string() == "Alice");
+    REQUIRE(obj[head.substr(0, 4)].as_number() == 1.0);
+    REQUIRE(obj.contains(head));
+    REQUIRE_FALSE(obj.contains(std::string_view{path}));
+
+    // std::string keys and array indices still pick the right overload
+    REQUIRE(obj[std::string("user")].as_number() == 1.0);
+    const JsonValue arr = JsonArray{JsonValue(7)};
+    REQUIRE(arr[0].as_number() == 7.0);
+
+    // The object's map finds string_views directly
+    const auto& members = obj.as_object();
+    REQUIRE(members.find(head) != members.end());
+}
+
 TEST_CASE("JsonValue comparison", "[json][value]") {
     REQUIRE(JsonValue(42) == JsonValue(42));
     REQUIRE(JsonValue("hello") == JsonValue("hello"));
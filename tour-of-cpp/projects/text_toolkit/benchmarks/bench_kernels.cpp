@@ -0,0 +1,244 @@
+// Benchmark: vectorized string kernels vs. byte-at-a-time loops
+//
+// Each kernel is timed against the way Chapter 10's exercises suggest
+// ("std": std::toupper, std::isspace, std::istringstream, find/replace)
+// and against a plain loop over ASCII that the compiler is free to
+// vectorize itself ("scalar"):
+//   upper    - upper-casing text of n bytes in place
+//   trim     - trimming n short strings padded with 0-40 blanks per side;
+//              items are strings
+//   words    - counting the words in text of n bytes
+//   find     - finding a 16-byte needle at the end of n bytes of text;
+//              "bmh" is std::boyer_moore_horspool_searcher
+//   replace  - replacing "the" with "a" in n bytes of text
+//
+// The text is lower-case words of 1-10 letters separated by spaces and the
+// odd newline. Sizes stop at 64K bytes (strings for trim) to keep the smoke
+// test short; inputs are built once per size.
+
+#include "bench.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view needle = "needle-in-a-hay";
+
+const std::string& words_text(std::int64_t n) {
+    static std::map<std::int64_t, std::string> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<int> letter{'a', 'z'};
+        std::uniform_int_distribution<std::size_t> length{1, 10};
+        std::uniform_int_distribution<int> line{0, 11};
+        const auto size = static_cast<std::size_t>(n);
+        while (out.size() < size) {
+            if (out.size() % 7 == 0 && out.size() + 4 < size) {
+                out += "the ";
+            }
+            for (std::size_t i = length(gen); i > 0; --i) {
+                out += static_cast<char>(letter(gen));
+            }
+            out += line(gen) == 0 ? '\n' : ' ';
+        }
+        out.resize(size - needle.size());
+        out += needle;
+    }
+    return out;
+}
+
+const std::vector<std::string>& padded_strings(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::string>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937 gen{7};
+        std::uniform_int_distribution<std::size_t> pad{0, 40};
+        const auto& words = words_text(1 << 16);
+        for (std::int64_t i = 0; i < n; ++i) {
+            const auto start = static_cast<std::size_t>(i * 13) % (words.size() - 20);
+            out.push_back(std::string(pad(gen), ' ') + words.substr(start, 12) +
+                          std::string(pad(gen), ' '));
+        }
+    }
+    return out;
+}
+
+// upper
+
+void upper_std(std::string& s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+}
+
+void upper_scalar(std::string& s) {
+    for (auto& c : s) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+    }
+}
+
+void upper_text(std::string& s) {
+    text::to_upper_in_place(s);
+}
+
+template <void (*Upper)(std::string&)>
+void upper(bench::State& state) {
+    std::string s = words_text(state.arg());
+    while (state.keep_running()) {
+        Upper(s);
+        bench::do_not_optimize(s.data());
+        state.pause_timing();
+        s = words_text(state.arg());
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+// trim
+
+std::string_view trim_std(std::string_view s) {
+    const auto space = [](unsigned char c) { return std::isspace(c) != 0; };
+    const auto first = std::find_if_not(s.begin(), s.end(), space);
+    const auto last = std::find_if_not(s.rbegin(), s.rend(), space).base();
+    return first < last ? std::string_view{first, last} : std::string_view{};
+}
+
+std::string_view trim_scalar(std::string_view s) {
+    const auto space = [](char c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+    std::size_t first = 0;
+    std::size_t last = s.size();
+    while (first < last && space(s[first])) {
+        ++first;
+    }
+    while (last > first && space(s[last - 1])) {
+        --last;
+    }
+    return s.substr(first, last - first);
+}
+
+template <std::string_view (*Trim)(std::string_view)>
+void trim(bench::State& state) {
+    const auto& strings = padded_strings(state.arg());
+    while (state.keep_running()) {
+        std::size_t total = 0;
+        for (const auto& s : strings) {
+            total += Trim(s).size();
+        }
+        bench::do_not_optimize(total);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+// words
+
+std::size_t words_std(std::string_view s) {
+    std::istringstream in{std::string{s}};
+    std::string word;
+    std::size_t count = 0;
+    while (in >> word) {
+        ++count;
+    }
+    return count;
+}
+
+std::size_t words_scalar(std::string_view s) {
+    std::size_t count = 0;
+    bool after_space = true;
+    for (const char c : s) {
+        const bool space = c == ' ' || (c >= '\t' && c <= '\r');
+        count += !space && after_space ? 1u : 0u;
+        after_space = space;
+    }
+    return count;
+}
+
+template <std::size_t (*Count)(std::string_view)>
+void words(bench::State& state) {
+    const auto& s = words_text(state.arg());
+    while (state.keep_running()) {
+        bench::do_not_optimize(Count(s));
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+// find
+
+std::size_t find_std(std::string_view s) {
+    return s.find(needle);
+}
+
+std::size_t find_bmh(std::string_view s) {
+    static const std::boyer_moore_horspool_searcher searcher{needle.begin(), needle.end()};
+    return static_cast<std::size_t>(std::search(s.begin(), s.end(), searcher) - s.begin());
+}
+
+std::size_t find_text(std::string_view s) {
+    return text::find_substring(s, needle);
+}
+
+// replace
+
+std::size_t replace_std(std::string_view s) {
+    std::string out{s};
+    for (auto pos = out.find("the"); pos != std::string::npos; pos = out.find("the", pos + 1)) {
+        out.replace(pos, 3, "a");
+    }
+    return out.size();
+}
+
+std::size_t replace_scalar(std::string_view s) {
+    std::string out;
+    std::size_t start = 0;
+    for (auto pos = s.find("the"); pos != std::string_view::npos; pos = s.find("the", start)) {
+        out.append(s, start, pos - start);
+        out += 'a';
+        start = pos + 3;
+    }
+    out.append(s, start);
+    return out.size();
+}
+
+std::size_t replace_text(std::string_view s) {
+    static std::string out;  // reused, as a caller's buffer would be
+    text::replace_all(s, "the", "a", out);
+    return out.size();
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 16;
+
+    const auto add = [&](const std::string& name, auto fn) {
+        bench::register_benchmark(name, fn)->range(small, large, 16);
+    };
+    add("upper/std", upper<upper_std>);
+    add("upper/scalar", upper<upper_scalar>);
+    add("upper/text", upper<upper_text>);
+    add("trim/std", trim<trim_std>);
+    add("trim/scalar", trim<trim_scalar>);
+    add("trim/text", trim<text::trim>);
+    add("words/std", words<words_std>);
+    add("words/scalar", words<words_scalar>);
+    add("words/text", words<text::count_words>);
+    add("find/std", words<find_std>);
+    add("find/bmh", words<find_bmh>);
+    add("find/text", words<find_text>);
+    add("replace/std", words<replace_std>);
+    add("replace/scalar", words<replace_scalar>);
+    add("replace/text", words<replace_text>);
+    return true;
+}();
+
+} // namespace
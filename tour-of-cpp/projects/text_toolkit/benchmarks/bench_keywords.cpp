@@ -0,0 +1,142 @@
+// Benchmark: many keywords in one pass vs. a search per keyword
+//
+// A log filter's job: count every occurrence of n keywords (random words
+// of 4-10 letters) in 64K of log text, in which a keyword occurs every
+// 200 bytes or so. The contenders:
+//   find        - a std::string_view::find loop per keyword
+//   std_regex   - one std::regex alternation of the keywords, as in
+//                 Chapter 10's examples; up to 64 keywords, as it is slow
+//                 to build and to run; it counts only non-overlapping matches
+//   text_regex  - the same alternation as a text::Regex; up to 256 keywords
+//   keywords    - text::KeywordSet, every occurrence
+//   icase       - text::KeywordSet with icase
+//
+// Items are bytes of text. The keywords and the text are built once per
+// keyword count.
+
+#include "bench.h"
+#include "keywords.h"
+#include "regex.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t text_size = std::size_t{1} << 16;
+
+std::string random_word(std::mt19937& gen, std::size_t min, std::size_t max) {
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<std::size_t> length{min, max};
+    std::string word;
+    for (std::size_t i = length(gen); i > 0; --i) {
+        word += static_cast<char>(letter(gen));
+    }
+    return word;
+}
+
+struct Input {
+    std::vector<std::string> keywords;
+    std::string text;
+    std::string alternation;  // keyword|keyword|...
+};
+
+const Input& input(std::int64_t n) {
+    static std::map<std::int64_t, Input> cache;
+    Input& in = cache[n];
+    if (in.keywords.empty()) {
+        std::mt19937 gen{11};
+        for (std::int64_t i = 0; i < n; ++i) {
+            in.keywords.push_back(random_word(gen, 4, 10));
+            in.alternation += (i == 0 ? "" : "|") + in.keywords.back();
+        }
+        std::uniform_int_distribution<int> kind{0, 39};
+        std::uniform_int_distribution<std::size_t> pick{0, in.keywords.size() - 1};
+        while (in.text.size() < text_size) {
+            in.text += kind(gen) == 0 ? in.keywords[pick(gen)] : random_word(gen, 1, 10);
+            in.text += kind(gen) == 0 ? '\n' : ' ';
+        }
+        in.text.resize(text_size);
+    }
+    return in;
+}
+
+void find(bench::State& state) {
+    const Input& in = input(state.arg());
+    const std::string_view text = in.text;
+    while (state.keep_running()) {
+        std::size_t hits = 0;
+        for (const std::string& keyword : in.keywords) {
+            for (auto at = text.find(keyword); at != std::string_view::npos;
+                 at = text.find(keyword, at + 1)) {
+                ++hits;
+            }
+        }
+        bench::do_not_optimize(hits);
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(text_size));
+}
+
+void std_regex(bench::State& state) {
+    const Input& in = input(state.arg());
+    const std::regex re{in.alternation};
+    while (state.keep_running()) {
+        std::size_t hits = 0;
+        for (auto it = std::sregex_iterator{in.text.begin(), in.text.end(), re};
+             it != std::sregex_iterator{}; ++it) {
+            ++hits;
+        }
+        bench::do_not_optimize(hits);
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(text_size));
+}
+
+void text_regex(bench::State& state) {
+    const Input& in = input(state.arg());
+    const text::Regex re{in.alternation};
+    while (state.keep_running()) {
+        std::size_t hits = 0;
+        for ([[maybe_unused]] const text::Match& m : re.find_all(in.text)) {
+            ++hits;
+        }
+        bench::do_not_optimize(hits);
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(text_size));
+}
+
+void keyword_set(bench::State& state, text::KeywordSet::Flags flags) {
+    const Input& in = input(state.arg());
+    const text::KeywordSet set{in.keywords, flags};
+    while (state.keep_running()) {
+        std::size_t hits = 0;
+        for ([[maybe_unused]] const text::KeywordMatch& m : set.find_all(in.text)) {
+            ++hits;
+        }
+        bench::do_not_optimize(hits);
+    }
+    state.set_items_per_iteration(static_cast<std::int64_t>(text_size));
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t few = 1 << 4;
+    constexpr std::int64_t some = 1 << 8;
+    constexpr std::int64_t many = 1 << 12;
+
+    bench::register_benchmark("find", find)->range(few, many, 16);
+    bench::register_benchmark("std_regex", std_regex)->range(few, few * 4, 4);
+    bench::register_benchmark("text_regex", text_regex)->range(few, some, 16);
+    bench::register_benchmark("keywords", [](bench::State& state) {
+        keyword_set(state, text::KeywordSet::none);
+    })->range(few, many, 16);
+    bench::register_benchmark("icase", [](bench::State& state) {
+        keyword_set(state, text::KeywordSet::icase);
+    })->range(few, many, 16);
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,241 @@
+// Benchmark: DFA regular expressions vs. std::regex
+//
+// The patterns are Chapter 10's (examples/regex.cpp, exercises/ex02_regex.cpp),
+// each run with std::regex ("std"), text::Regex ("text") and, where no
+// capture groups are needed, text::StaticRegex ("static"):
+//   email  - is_valid_email: regex_match of [\w.]+@[\w.]+\.\w+ on n
+//            addresses, half of them invalid; items are addresses
+//   phone  - extract_phone_numbers: every (XXX) XXX-XXXX or XXX-XXX-XXXX
+//            in n bytes of text
+//   url    - parse_url: regex_match of (https?)://([\w.]+)(/.*)? with its
+//            three groups on n URLs; items are URLs
+//   date   - every \d{4}-\d{2}-\d{2} in n bytes of log lines
+//
+// Sizes stop at 64K bytes (4K strings) to keep the smoke test short;
+// inputs are built once per size.
+
+#include "bench.h"
+#include "regex.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view email_pattern = R"([\w.]+@[\w.]+\.\w+)";
+constexpr std::string_view phone_pattern = R"(\(\d{3}\) \d{3}-\d{4}|\d{3}-\d{3}-\d{4})";
+constexpr std::string_view url_pattern = R"((https?)://([\w.]+)(/.*)?)";
+constexpr std::string_view date_pattern = R"(\d{4}-\d{2}-\d{2})";
+
+std::string random_word(std::mt19937& gen, std::size_t min, std::size_t max) {
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<std::size_t> length{min, max};
+    std::string word;
+    for (std::size_t i = length(gen); i > 0; --i) {
+        word += static_cast<char>(letter(gen));
+    }
+    return word;
+}
+
+std::string digits(std::mt19937& gen, std::size_t n) {
+    std::uniform_int_distribution<int> digit{'0', '9'};
+    std::string out;
+    for (std::size_t i = 0; i < n; ++i) {
+        out += static_cast<char>(digit(gen));
+    }
+    return out;
+}
+
+const std::vector<std::string>& emails(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::string>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937 gen{42};
+        for (std::int64_t i = 0; i < n; ++i) {
+            std::string email = random_word(gen, 3, 10) + "." + random_word(gen, 2, 8);
+            if (i % 2 == 0) {
+                email += "@" + random_word(gen, 4, 10) + ".com";
+            } else {
+                email += "-at-" + random_word(gen, 4, 10) + ".com";  // invalid
+            }
+            out.push_back(std::move(email));
+        }
+    }
+    return out;
+}
+
+const std::vector<std::string>& urls(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::string>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937 gen{7};
+        for (std::int64_t i = 0; i < n; ++i) {
+            std::string url = i % 3 == 0 ? "http://" : "https://";
+            url += "www." + random_word(gen, 4, 12) + ".org";
+            for (std::int64_t part = i % 4; part > 0; --part) {
+                url += "/" + random_word(gen, 2, 9);
+            }
+            out.push_back(std::move(url));
+        }
+    }
+    return out;
+}
+
+// Words with a phone number or an ISO date every few hundred bytes
+const std::string& log_text(std::int64_t n) {
+    static std::map<std::int64_t, std::string> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937 gen{3};
+        std::uniform_int_distribution<int> kind{0, 39};
+        const auto size = static_cast<std::size_t>(n);
+        while (out.size() < size) {
+            switch (kind(gen)) {
+            case 0:
+                out += "(" + digits(gen, 3) + ") " + digits(gen, 3) + "-" + digits(gen, 4);
+                break;
+            case 1:
+                out += digits(gen, 3) + "-" + digits(gen, 3) + "-" + digits(gen, 4);
+                break;
+            case 2:
+                out += digits(gen, 4) + "-" + digits(gen, 2) + "-" + digits(gen, 2);
+                break;
+            case 3:
+                out += digits(gen, 2);
+                break;
+            default:
+                out += random_word(gen, 1, 10);
+                break;
+            }
+            out += kind(gen) == 0 ? '\n' : ' ';
+        }
+        out.resize(size);
+    }
+    return out;
+}
+
+// Full matches of every string: email and url
+
+template <typename Match>
+void validate(bench::State& state, const std::vector<std::string>& (*input)(std::int64_t),
+              Match match) {
+    const auto& strings = input(state.arg());
+    while (state.keep_running()) {
+        std::size_t valid = 0;
+        for (const auto& s : strings) {
+            valid += match(s) ? 1u : 0u;
+        }
+        bench::do_not_optimize(valid);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+void email_std(bench::State& state) {
+    const std::regex re{std::string{email_pattern}};
+    validate(state, emails, [&](const std::string& s) { return std::regex_match(s, re); });
+}
+
+void email_text(bench::State& state) {
+    const text::Regex re{email_pattern};
+    validate(state, emails, [&](const std::string& s) { return re.match(s); });
+}
+
+void email_static(bench::State& state) {
+    constexpr text::StaticRegex<R"([\w.]+@[\w.]+\.\w+)"> re;
+    validate(state, emails, [&](const std::string& s) { return re.match(s); });
+}
+
+// The host's length, so every group is read
+void url_std(bench::State& state) {
+    const std::regex re{std::string{url_pattern}};
+    std::smatch m;
+    validate(state, urls, [&](const std::string& s) {
+        return std::regex_match(s, m, re) && m[2].length() + m[3].length() > 0;
+    });
+}
+
+void url_text(bench::State& state) {
+    const text::Regex re{url_pattern};
+    text::Match m;
+    validate(state, urls,
+             [&](const std::string& s) { return re.match(s, m) && m[2].size() + m[3].size() > 0; });
+}
+
+// Every match in the text: phone and date
+
+void find_all_std(bench::State& state, std::string_view pattern) {
+    const std::regex re{std::string{pattern}};
+    const auto& s = log_text(state.arg());
+    while (state.keep_running()) {
+        std::size_t bytes = 0;
+        for (auto it = std::sregex_iterator{s.begin(), s.end(), re}; it != std::sregex_iterator{};
+             ++it) {
+            bytes += static_cast<std::size_t>(it->length());
+        }
+        bench::do_not_optimize(bytes);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+void find_all_text(bench::State& state, std::string_view pattern) {
+    const text::Regex re{pattern};
+    const auto& s = log_text(state.arg());
+    while (state.keep_running()) {
+        std::size_t bytes = 0;
+        for (const text::Match& m : re.find_all(s)) {
+            bytes += m.length();
+        }
+        bench::do_not_optimize(bytes);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Static>
+void find_all_static(bench::State& state) {
+    constexpr Static re;
+    const auto& s = log_text(state.arg());
+    while (state.keep_running()) {
+        std::size_t bytes = 0;
+        for (auto hit = re.find(s); hit; hit = re.find(s, static_cast<std::size_t>(
+                                                             hit->data() - s.data()) +
+                                                             hit->size())) {
+            bytes += hit->size();
+        }
+        bench::do_not_optimize(bytes);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+using StaticPhone = text::StaticRegex<R"(\(\d{3}\) \d{3}-\d{4}|\d{3}-\d{3}-\d{4})">;
+using StaticDate = text::StaticRegex<R"(\d{4}-\d{2}-\d{2})">;
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t few = 1 << 8;
+    constexpr std::int64_t many = 1 << 12;
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 16;
+
+    bench::register_benchmark("email/std", email_std)->range(few, many, 16);
+    bench::register_benchmark("email/text", email_text)->range(few, many, 16);
+    bench::register_benchmark("email/static", email_static)->range(few, many, 16);
+    bench::register_benchmark("url/std", url_std)->range(few, many, 16);
+    bench::register_benchmark("url/text", url_text)->range(few, many, 16);
+
+    const auto add = [&](const std::string& name, auto fn) {
+        bench::register_benchmark(name, fn)->range(small, large, 16);
+    };
+    add("phone/std", [](bench::State& state) { find_all_std(state, phone_pattern); });
+    add("phone/text", [](bench::State& state) { find_all_text(state, phone_pattern); });
+    add("phone/static", find_all_static<StaticPhone>);
+    add("date/std", [](bench::State& state) { find_all_std(state, date_pattern); });
+    add("date/text", [](bench::State& state) { find_all_text(state, date_pattern); });
+    add("date/static", find_all_static<StaticDate>);
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,153 @@
+// Benchmark: SharedString vs. std::string
+//
+// Operations on n strings of 20-200 characters, most too long for
+// std::string's short-string buffer (15 characters in libstdc++):
+//   copy     - copying every string into a vector
+//   substr   - taking a 60-character slice of every string
+//   lookup   - counting every string in a hash map that holds them all,
+//              with the same string objects hashed on each pass; SharedString
+//              hashes each one once and keeps the result
+//   make     - building every string from a std::string_view, on the heap
+//              or in a StringArena ("arena")
+//
+// Sizes stop at 64K to keep the smoke test short; the input strings are
+// built once per size.
+
+#include "bench.h"
+#include "shared_string.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using text::SharedString;
+
+const std::vector<std::string>& texts(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::string>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937_64 gen{42};
+        std::uniform_int_distribution<std::size_t> length{20, 200};
+        std::uniform_int_distribution<int> letter{'a', 'z'};
+        for (std::int64_t i = 0; i < n; ++i) {
+            std::string s = std::to_string(i) + ':';
+            s.resize(length(gen));
+            for (std::size_t j = s.find(':') + 1; j < s.size(); ++j) {
+                s[j] = static_cast<char>(letter(gen));
+            }
+            out.push_back(std::move(s));
+        }
+    }
+    return out;
+}
+
+template <typename S>
+const std::vector<S>& strings(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<S>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        for (const auto& t : texts(n)) {
+            out.emplace_back(t);
+        }
+    }
+    return out;
+}
+
+template <typename S>
+void copy(bench::State& state) {
+    const auto& input = strings<S>(state.arg());
+    while (state.keep_running()) {
+        std::vector<S> copies = input;
+        bench::do_not_optimize(copies.data());
+        state.pause_timing();
+        copies = {};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename S>
+void substr(bench::State& state) {
+    const auto& input = strings<S>(state.arg());
+    std::vector<S> slices;
+    slices.reserve(input.size());
+    while (state.keep_running()) {
+        for (const auto& s : input) {
+            slices.push_back(s.size() > 70 ? s.substr(10, 60) : s);
+        }
+        bench::do_not_optimize(slices.data());
+        state.pause_timing();
+        slices.clear();
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Map>
+void lookup(bench::State& state) {
+    using S = typename Map::key_type;
+    const auto& input = strings<S>(state.arg());
+    Map counts;
+    for (const auto& s : input) {
+        counts.emplace(s, 0);
+    }
+    while (state.keep_running()) {
+        for (const auto& s : input) {
+            ++counts.find(s)->second;
+        }
+        bench::do_not_optimize(counts.size());
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+template <typename Make>
+void make(bench::State& state, Make make_one) {
+    const auto& input = texts(state.arg());
+    while (state.keep_running()) {
+        text::StringArena arena;
+        std::vector<SharedString> out;
+        out.reserve(input.size());
+        for (const auto& t : input) {
+            out.push_back(make_one(arena, std::string_view{t}));
+        }
+        bench::do_not_optimize(out.data());
+        state.pause_timing();
+        out = {};
+        state.resume_timing();
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 16;
+
+    using StdMap = std::unordered_map<std::string, int>;
+    using SharedMap =
+        std::unordered_map<SharedString, int, text::SharedStringHash, text::SharedStringEqual>;
+
+    const auto add = [&](const std::string& name, auto fn) {
+        bench::register_benchmark(name, fn)->range(small, large, 16);
+    };
+    add("copy/std", copy<std::string>);
+    add("copy/shared", copy<SharedString>);
+    add("substr/std", substr<std::string>);
+    add("substr/shared", substr<SharedString>);
+    add("lookup/std", lookup<StdMap>);
+    add("lookup/shared", lookup<SharedMap>);
+    add("make/heap", [](bench::State& s) {
+        make(s, [](text::StringArena&, std::string_view t) { return SharedString{t}; });
+    });
+    add("make/arena", [](bench::State& s) {
+        make(s, [](text::StringArena& arena, std::string_view t) { return arena.copy(t); });
+    });
+    return true;
+}();
+
+} // namespace
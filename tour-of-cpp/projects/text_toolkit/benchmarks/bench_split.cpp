@@ -0,0 +1,210 @@
+// Benchmark: lazy split vs. the usual ways to split a string
+//
+// Workloads, each a text of n fields:
+//   short  - CSV fields of 1-12 characters, split on ','
+//   long   - CSV fields of 60-140 characters, split on ','
+//   words  - words separated by runs of ' ', '\t' and '\n', tokenized
+//   multi  - fields of 1-12 characters separated by "||"
+//
+// The contenders:
+//   vector   - find() and substr() into a std::vector<std::string>, as in
+//              Chapter 10's split exercise
+//   getline  - std::getline on a std::istringstream, as in Chapter 11's
+//              input example
+//   find     - a std::string_view::find (memchr) loop, with no allocation;
+//              find_first_of for words, find(string_view) for multi
+//   ranges   - std::views::split (std::views::lazy_split for multi)
+//   text     - text::split and text::tokenize
+//
+// Each consumes every field by adding up its length. Items are fields.
+// Sizes stop at 64K fields to keep the smoke test short; the texts are
+// built once per size.
+
+#include "bench.h"
+#include "split.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+enum class Workload { short_fields, long_fields, words, multi };
+
+const std::string& input(Workload w, std::int64_t n) {
+    static std::map<std::pair<Workload, std::int64_t>, std::string> cache;
+    auto& out = cache[{w, n}];
+    if (out.empty()) {
+        std::mt19937 gen{42};
+        const bool long_fields = w == Workload::long_fields;
+        std::uniform_int_distribution<std::size_t> length{long_fields ? 60u : 1u,
+                                                          long_fields ? 140u : 12u};
+        std::uniform_int_distribution<int> letter{'a', 'z'};
+        std::uniform_int_distribution<int> gap{1, 3};
+        for (std::int64_t i = 0; i < n; ++i) {
+            if (i > 0) {
+                switch (w) {
+                case Workload::short_fields:
+                case Workload::long_fields:
+                    out += ',';
+                    break;
+                case Workload::words:
+                    for (int g = gap(gen); g > 0; --g) {
+                        out += " \t\n"[static_cast<std::size_t>(g - 1)];
+                    }
+                    break;
+                case Workload::multi:
+                    out += "||";
+                    break;
+                }
+            }
+            for (std::size_t j = length(gen); j > 0; --j) {
+                out += static_cast<char>(letter(gen));
+            }
+        }
+    }
+    return out;
+}
+
+constexpr std::string_view whitespace = " \t\n";
+
+std::size_t by_vector(const std::string& s, Workload w) {
+    std::vector<std::string> fields;
+    if (w == Workload::words) {
+        std::size_t start = s.find_first_not_of(whitespace);
+        while (start != std::string::npos) {
+            const auto end = s.find_first_of(whitespace, start);
+            fields.push_back(s.substr(start, end - start));
+            start = s.find_first_not_of(whitespace, end);
+        }
+    } else {
+        const std::string delimiter = w == Workload::multi ? "||" : ",";
+        std::size_t start = 0;
+        for (std::size_t pos; (pos = s.find(delimiter, start)) != std::string::npos;
+             start = pos + delimiter.size()) {
+            fields.push_back(s.substr(start, pos - start));
+        }
+        fields.push_back(s.substr(start));
+    }
+    std::size_t total = 0;
+    for (const auto& f : fields) {
+        total += f.size();
+    }
+    return total;
+}
+
+std::size_t by_getline(const std::string& s, Workload w) {
+    std::istringstream in{s};
+    std::string field;
+    std::size_t total = 0;
+    if (w == Workload::words) {
+        while (in >> field) {
+            total += field.size();
+        }
+    } else {
+        while (std::getline(in, field, ',')) {
+            total += field.size();
+        }
+    }
+    return total;
+}
+
+std::size_t by_find(std::string_view s, Workload w) {
+    std::size_t total = 0;
+    if (w == Workload::words) {
+        std::size_t start = s.find_first_not_of(whitespace);
+        while (start != std::string_view::npos) {
+            const auto end = s.find_first_of(whitespace, start);
+            total += std::min(end, s.size()) - start;
+            start = s.find_first_not_of(whitespace, end);
+        }
+        return total;
+    }
+    const std::string_view delimiter = w == Workload::multi ? "||" : ",";
+    std::size_t start = 0;
+    for (std::size_t pos; (pos = s.find(delimiter, start)) != std::string_view::npos;
+         start = pos + delimiter.size()) {
+        total += pos - start;
+    }
+    return total + s.size() - start;
+}
+
+std::size_t by_ranges(std::string_view s, Workload w) {
+    std::size_t total = 0;
+    if (w == Workload::multi) {
+        for (const auto field : s | std::views::lazy_split(std::string_view{"||"})) {
+            total += static_cast<std::size_t>(std::ranges::distance(field));
+        }
+    } else {
+        for (const auto field : s | std::views::split(',')) {
+            total += std::string_view{field.begin(), field.end()}.size();
+        }
+    }
+    return total;
+}
+
+std::size_t by_text(std::string_view s, Workload w) {
+    std::size_t total = 0;
+    const auto add = [&](auto&& fields) {
+        for (const std::string_view f : fields) {
+            total += f.size();
+        }
+    };
+    switch (w) {
+    case Workload::short_fields:
+    case Workload::long_fields:
+        add(text::split(s, ','));
+        break;
+    case Workload::words:
+        add(text::tokenize(s, text::any_of(whitespace)));
+        break;
+    case Workload::multi:
+        add(text::split(s, "||"));
+        break;
+    }
+    return total;
+}
+
+template <typename Split>
+void run(bench::State& state, Workload w, Split split) {
+    const std::string& s = input(w, state.arg());
+    while (state.keep_running()) {
+        bench::do_not_optimize(split(s, w));
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t small = 1 << 10;
+    constexpr std::int64_t large = 1 << 16;
+
+    const auto add = [&](const std::string& name, Workload w, auto split) {
+        bench::register_benchmark(name, [w, split](bench::State& s) { run(s, w, split); })
+            ->range(small, large, 16);
+    };
+    const std::pair<std::string, Workload> workloads[] = {
+        {"short", Workload::short_fields},
+        {"long", Workload::long_fields},
+        {"words", Workload::words},
+        {"multi", Workload::multi},
+    };
+    for (const auto& [name, w] : workloads) {
+        add(name + "/vector", w, by_vector);
+        if (w != Workload::multi) {
+            add(name + "/getline", w, by_getline);
+        }
+        add(name + "/find", w, by_find);
+        if (w != Workload::words) {
+            add(name + "/ranges", w, by_ranges);
+        }
+        add(name + "/text", w, by_text);
+    }
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,234 @@
+// Benchmark: URL parsing and query decoding
+//
+// n URLs of 30-400 bytes, some with userinfo, ports, queries of 1-5 pairs
+// with percent-escapes, some of whose values are URLs, and fragments.
+// Items are URLs.
+//
+// parse - split each URL and read every component's length:
+//   views       - Chapter 10's parse_url (examples/string_views.cpp): find
+//                 "://" and '/'; scheme, host and path only
+//   std_regex   - RFC 3986's regular expression for the five top-level
+//                 components, with std::regex into std::smatch
+//   text_regex  - the same expression with text::Regex
+//   text        - text::parse_url: all seven components, validated
+//
+// query - decode every query value, found with text::query_params:
+//   string      - a loop appending each decoded byte to a new std::string
+//   text        - text::percent_decode into one reused buffer
+//
+// The URLs are built once per size.
+
+#include "bench.h"
+#include "regex.h"
+#include "url.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Appendix B of RFC 3986
+constexpr std::string_view rfc3986_pattern =
+    R"(^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)";
+
+std::string random_word(std::mt19937& gen, std::size_t min, std::size_t max) {
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<std::size_t> length{min, max};
+    std::string word;
+    for (std::size_t i = length(gen); i > 0; --i) {
+        word += static_cast<char>(letter(gen));
+    }
+    return word;
+}
+
+const std::vector<std::string>& urls(std::int64_t n) {
+    static std::map<std::int64_t, std::vector<std::string>> cache;
+    auto& out = cache[n];
+    if (out.empty()) {
+        std::mt19937 gen{5};
+        std::uniform_int_distribution<int> percent{0, 99};
+        std::uniform_int_distribution<int> count{0, 4};
+        for (std::int64_t i = 0; i < n; ++i) {
+            std::string url = percent(gen) < 70 ? "https://" : "http://";
+            if (percent(gen) < 10) {
+                url += random_word(gen, 3, 8) + ":" + random_word(gen, 6, 12) + "@";
+            }
+            url += "www." + random_word(gen, 4, 12) + ".com";
+            if (percent(gen) < 20) {
+                url += ":" + std::to_string(1024 + percent(gen) * 64);
+            }
+            for (int segment = count(gen); segment >= 0; --segment) {
+                url += "/" + random_word(gen, 2, 10);
+            }
+            if (percent(gen) < 60) {
+                for (int pair = count(gen); pair >= 0; --pair) {
+                    url += pair == 0 ? "?" : "&";
+                    url += random_word(gen, 1, 6) + "=";
+                    if (percent(gen) < 15) {
+                        // A URL as a value, as in a redirect
+                        url += "https%3A%2F%2Fwww." + random_word(gen, 4, 12) + ".com%2F" +
+                               random_word(gen, 10, 40);
+                    } else {
+                        url += random_word(gen, 0, 8);
+                        if (percent(gen) < 30) {
+                            url += "%20" + random_word(gen, 1, 6);
+                        }
+                    }
+                }
+            }
+            if (percent(gen) < 10) {
+                url += "#" + random_word(gen, 3, 10);
+            }
+            out.push_back(std::move(url));
+        }
+    }
+    return out;
+}
+
+// Chapter 10's parse_url
+struct ParsedUrl {
+    std::string_view scheme;
+    std::string_view host;
+    std::string_view path;
+};
+
+ParsedUrl chapter_parse_url(std::string_view url) {
+    ParsedUrl result;
+    if (auto pos = url.find("://"); pos != std::string_view::npos) {
+        result.scheme = url.substr(0, pos);
+        url.remove_prefix(pos + 3);
+    }
+    if (auto pos = url.find('/'); pos != std::string_view::npos) {
+        result.host = url.substr(0, pos);
+        result.path = url.substr(pos);
+    } else {
+        result.host = url;
+        result.path = "/";
+    }
+    return result;
+}
+
+template <typename Parse>
+void parse(bench::State& state, Parse parse_one) {
+    const auto& input = urls(state.arg());
+    while (state.keep_running()) {
+        std::size_t bytes = 0;
+        for (const std::string& url : input) {
+            bytes += parse_one(url);
+        }
+        bench::do_not_optimize(bytes);
+    }
+    state.set_items_per_iteration(state.arg());
+}
+
+void parse_views(bench::State& state) {
+    parse(state, [](const std::string& url) {
+        const ParsedUrl parts = chapter_parse_url(url);
+        return parts.scheme.size() + parts.host.size() + parts.path.size();
+    });
+}
+
+void parse_std_regex(bench::State& state) {
+    const std::regex re{std::string{rfc3986_pattern}};
+    std::smatch m;
+    parse(state, [&](const std::string& url) {
+        std::size_t bytes = 0;
+        if (std::regex_match(url, m, re)) {
+            for (const std::size_t group : {2u, 4u, 5u, 7u, 9u}) {
+                bytes += static_cast<std::size_t>(m.length(group));
+            }
+        }
+        return bytes;
+    });
+}
+
+void parse_text_regex(bench::State& state) {
+    const text::Regex re{rfc3986_pattern};
+    text::Match m;
+    parse(state, [&](const std::string& url) {
+        std::size_t bytes = 0;
+        if (re.match(url, m)) {
+            for (const std::size_t group : {2u, 4u, 5u, 7u, 9u}) {
+                bytes += m.length(group);
+            }
+        }
+        return bytes;
+    });
+}
+
+void parse_text(bench::State& state) {
+    parse(state, [](const std::string& url) {
+        const auto parts = text::parse_url(url);
+        return parts ? parts->scheme.size() + parts->userinfo.size() + parts->host.size() +
+                           parts->port.size() + parts->path.size() + parts->query.size() +
+                           parts->fragment.size()
+                     : 0;
+    });
+}
+
+// The usual decoder: a new string per value, a byte at a time
+std::string decode_to_string(std::string_view s) {
+    std::string out;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '%' && i + 2 < s.size()) {
+            out += static_cast<char>(std::stoi(std::string{s.substr(i + 1, 2)}, nullptr, 16));
+            i += 2;
+        } else {
+            out += s[i] == '+' ? ' ' : s[i];
+        }
+    }
+    return out;
+}
+
+void query_string(bench::State& state) {
+    parse(state, [](const std::string& url) {
+        std::size_t bytes = 0;
+        const auto query_start = url.find('?');
+        if (query_start == std::string::npos) {
+            return bytes;
+        }
+        const std::string_view query = std::string_view{url}.substr(query_start + 1);
+        for (const auto [name, value] : text::query_params(query)) {
+            bytes += name.size() + decode_to_string(value).size();
+        }
+        return bytes;
+    });
+}
+
+void query_text(bench::State& state) {
+    std::array<char, 256> buffer{};
+    parse(state, [&](const std::string& url) {
+        std::size_t bytes = 0;
+        const auto query_start = url.find('?');
+        if (query_start == std::string::npos) {
+            return bytes;
+        }
+        const std::string_view query = std::string_view{url}.substr(query_start + 1);
+        for (const auto [name, value] : text::query_params(query)) {
+            bytes += name.size() + text::percent_decode(value, buffer, text::Encoding::form)
+                                       .value_or(0);
+        }
+        return bytes;
+    });
+}
+
+[[maybe_unused]] const bool registered = [] {
+    constexpr std::int64_t few = 1 << 8;
+    constexpr std::int64_t many = 1 << 12;
+
+    bench::register_benchmark("parse/views", parse_views)->range(few, many, 16);
+    bench::register_benchmark("parse/std_regex", parse_std_regex)->range(few, many, 16);
+    bench::register_benchmark("parse/text_regex", parse_text_regex)->range(few, many, 16);
+    bench::register_benchmark("parse/text", parse_text)->range(few, many, 16);
+    bench::register_benchmark("query/string", query_string)->range(few, many, 16);
+    bench::register_benchmark("query/text", query_text)->range(few, many, 16);
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,334 @@
+#ifndef TEXT_KERNELS_H
+#define TEXT_KERNELS_H
+
+#include "scan.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * Vectorized versions of Chapter 10's string exercises.
+ *
+ * std::toupper and std::isspace take an int, consult the current locale,
+ * and are called once per character, so a loop over them cannot be
+ * vectorized. These kernels are for ASCII text, or for UTF-8 text of which
+ * only the ASCII characters matter: bytes of 0x80 and up, which include
+ * every byte of a multi-byte UTF-8 character, are never changed and never
+ * whitespace. They work on 32 bytes at a time with the operations in
+ * scan.h, and on the remaining bytes one at a time.
+ */
+
+namespace text {
+
+namespace detail {
+
+// std::isspace in the "C" locale: ' ', and '\t' '\n' '\v' '\f' '\r'
+[[nodiscard]] constexpr bool is_space(char c) noexcept {
+    return c == ' ' || static_cast<unsigned char>(c - '\t') < 5;
+}
+
+// c in [first, first + count), with one add and one signed compare per
+// byte: the range is moved to the bottom of the signed range, -128 up
+#if TEXT_SIMD
+[[nodiscard]] inline Bytes32 in_range(Bytes32 v, char first, int count) noexcept {
+    const auto shifted = add(v, splat(static_cast<char>(-128 - first)));
+    return less(shifted, splat(static_cast<char>(-128 + count)));
+}
+
+[[nodiscard]] inline std::uint32_t space_mask(const char* p) noexcept {
+    const auto v = load(p);
+    return mask(equal(v, splat(' ')) | in_range(v, '\t', 5));
+}
+#endif
+
+// Flips the case bit (0x20) of the letters in [first, first + 26)
+inline void flip_case(const char* in, char* out, std::size_t n, char first) noexcept {
+    std::size_t i = 0;
+#if TEXT_SIMD
+    const auto bit = splat(0x20);
+    for (; n - i >= block_size; i += block_size) {
+        const auto v = load(in + i);
+        store(out + i, v ^ (in_range(v, first, 26) & bit));
+    }
+#endif
+    for (; i < n; ++i) {
+        const char c = in[i];
+        out[i] = static_cast<unsigned char>(c - first) < 26 ? static_cast<char>(c ^ 0x20) : c;
+    }
+}
+
+} // namespace detail
+
+// =============================================================================
+// Case mapping
+// =============================================================================
+
+// Maps 'a'-'z' to 'A'-'Z' in place; other bytes are unchanged
+inline void to_upper_in_place(std::span<char> s) noexcept {
+    detail::flip_case(s.data(), s.data(), s.size(), 'a');
+}
+
+// Maps 'A'-'Z' to 'a'-'z' in place; other bytes are unchanged
+inline void to_lower_in_place(std::span<char> s) noexcept {
+    detail::flip_case(s.data(), s.data(), s.size(), 'A');
+}
+
+[[nodiscard]] inline std::string to_upper(std::string_view s) {
+    std::string out(s.size(), '\0');
+    detail::flip_case(s.data(), out.data(), s.size(), 'a');
+    return out;
+}
+
+[[nodiscard]] inline std::string to_lower(std::string_view s) {
+    std::string out(s.size(), '\0');
+    detail::flip_case(s.data(), out.data(), s.size(), 'A');
+    return out;
+}
+
+// =============================================================================
+// Whitespace
+// =============================================================================
+
+// s without its leading ASCII whitespace
+[[nodiscard]] inline std::string_view trim_left(std::string_view s) noexcept {
+    std::size_t i = 0;
+#if TEXT_SIMD
+    for (; s.size() - i >= detail::block_size; i += detail::block_size) {
+        const auto text = ~detail::space_mask(s.data() + i);
+        if (text != 0) {
+            return s.substr(i + static_cast<std::size_t>(std::countr_zero(text)));
+        }
+    }
+#endif
+    while (i < s.size() && detail::is_space(s[i])) {
+        ++i;
+    }
+    return s.substr(i);
+}
+
+// s without its trailing ASCII whitespace
+[[nodiscard]] inline std::string_view trim_right(std::string_view s) noexcept {
+    std::size_t end = s.size();
+#if TEXT_SIMD
+    // Blocks ending at end, from the back: the last non-space is the
+    // highest clear bit of the mask
+    for (; end >= detail::block_size; end -= detail::block_size) {
+        const auto text = ~detail::space_mask(s.data() + end - detail::block_size);
+        if (text != 0) {
+            return s.substr(0, end - static_cast<std::size_t>(std::countl_zero(text)));
+        }
+    }
+#endif
+    while (end > 0 && detail::is_space(s[end - 1])) {
+        --end;
+    }
+    return s.substr(0, end);
+}
+
+[[nodiscard]] inline std::string_view trim(std::string_view s) noexcept {
+    return trim_right(trim_left(s));
+}
+
+/**
+ * The number of words: runs of characters other than ASCII whitespace.
+ * A word starts wherever a non-space follows a space or the start of the
+ * text, so a block's count is popcount(~spaces & (spaces << 1 | carry)).
+ */
+[[nodiscard]] inline std::size_t count_words(std::string_view s) noexcept {
+    std::size_t count = 0;
+    std::size_t i = 0;
+    bool after_space = true;
+#if TEXT_SIMD
+    for (; s.size() - i >= detail::block_size; i += detail::block_size) {
+        const auto spaces = detail::space_mask(s.data() + i);
+        const auto before = (spaces << 1) | (after_space ? 1u : 0u);
+        count += static_cast<std::size_t>(std::popcount(~spaces & before));
+        after_space = (spaces >> 31) != 0;
+    }
+#endif
+    for (; i < s.size(); ++i) {
+        const bool space = detail::is_space(s[i]);
+        count += !space && after_space ? 1u : 0u;
+        after_space = space;
+    }
+    return count;
+}
+
+// =============================================================================
+// Substring search
+// =============================================================================
+
+/**
+ * The occurrences of a needle in a haystack, in order; a Scanner for
+ * strings.
+ *
+ * The standard find looks for the needle's first character with memchr
+ * and compares the rest at each one, so in ordinary text, where the first
+ * character is common, it stops every few bytes. Here a block of 32
+ * candidate positions is tested for the first character, and the block
+ * n - 1 bytes further on for the last, in two compares. Only positions
+ * where both match are compared in full, and in text that is rarely more
+ * than one per block. The candidates of the current block are kept
+ * between calls, so finding every occurrence reads each block once.
+ */
+class SubstringScanner {
+public:
+    // needle must not be empty
+    SubstringScanner(std::string_view haystack, std::string_view needle) noexcept
+        : haystack_{haystack}, needle_{needle} {}
+
+    /**
+     * The first occurrence at or after pos, or npos.
+     * Calls must not go backwards: pos is at least the previous pos.
+     */
+    [[nodiscard]] std::size_t next(std::size_t pos) noexcept {
+        if (pos > haystack_.size()) {
+            return std::string_view::npos;
+        }
+#if TEXT_SIMD
+        const std::size_t n = needle_.size();
+        const char* h = haystack_.data();
+        while (true) {
+            if (!loaded_ || pos >= block_ + detail::block_size) {
+                // Only blocks whose last-character loads stay inside
+                if (haystack_.size() - pos < n - 1 + detail::block_size) {
+                    break;
+                }
+                load(pos);
+            } else {
+                candidates_ &= ~std::uint32_t{0} << (pos - block_);
+            }
+            while (candidates_ != 0) {
+                const auto at = block_ + static_cast<std::size_t>(std::countr_zero(candidates_));
+                if (n < 3 || std::memcmp(h + at + 1, needle_.data() + 1, n - 2) == 0) {
+                    return at;
+                }
+                candidates_ &= candidates_ - 1;
+            }
+            pos = block_ + detail::block_size;
+        }
+#endif
+        return haystack_.find(needle_, pos);
+    }
+
+private:
+#if TEXT_SIMD
+    void load(std::size_t pos) noexcept {
+        const char* p = haystack_.data() + pos;
+        loaded_ = true;
+        block_ = pos;
+        candidates_ =
+            detail::mask(detail::equal(detail::load(p), detail::splat(needle_.front())) &
+                         detail::equal(detail::load(p + needle_.size() - 1),
+                                       detail::splat(needle_.back())));
+    }
+#endif
+
+    std::string_view haystack_;
+    std::string_view needle_;
+    std::size_t block_ = 0;
+    std::uint32_t candidates_ = 0;
+    bool loaded_ = false;
+};
+
+// The first occurrence of needle in haystack at or after pos, or npos;
+// std::string_view::find, vectorized
+[[nodiscard]] inline std::size_t find_substring(std::string_view haystack,
+                                                std::string_view needle,
+                                                std::size_t pos = 0) noexcept {
+    if (needle.empty()) {
+        return pos <= haystack.size() ? pos : std::string_view::npos;
+    }
+    return SubstringScanner{haystack, needle}.next(pos);
+}
+
+// Occurrences of needle that do not overlap, counted from the left
+[[nodiscard]] inline std::size_t count_substring(std::string_view haystack,
+                                                 std::string_view needle) noexcept {
+    if (needle.empty()) {
+        return 0;
+    }
+    SubstringScanner scanner{haystack, needle};
+    std::size_t count = 0;
+    for (auto at = scanner.next(0); at != std::string_view::npos;
+         at = scanner.next(at + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+// =============================================================================
+// Replacement
+// =============================================================================
+
+namespace detail {
+
+// Whether v points into out's buffer, which writing to out overwrites
+[[nodiscard]] inline bool views_into(std::string_view v, const std::string& out) noexcept {
+    const std::less<const char*> before;
+    return !v.empty() && !before(v.data(), out.data()) &&
+           before(v.data(), out.data() + out.capacity());
+}
+
+} // namespace detail
+
+/**
+ * s with every occurrence of from, left to right and not overlapping,
+ * replaced by to, written to out. out is sized once and keeps its
+ * capacity, so a caller that reuses it allocates only while it grows.
+ * An empty from replaces nothing.
+ *
+ * When to is not longer than from, the result fits in s.size() bytes and
+ * is written in one pass. Otherwise a first pass counts the occurrences to
+ * size out exactly.
+ *
+ * s, from and to may view out itself, as in replace_all(out, "a", "b",
+ * out); the result is then built in a temporary and copied into out.
+ */
+inline void replace_all(std::string_view s, std::string_view from, std::string_view to,
+                        std::string& out) {
+    if (from.empty()) {
+        out.assign(s);
+        return;
+    }
+    if (detail::views_into(s, out) || detail::views_into(from, out) ||
+        detail::views_into(to, out)) {
+        std::string result;
+        replace_all(s, from, to, result);
+        out.assign(result);
+        return;
+    }
+    std::size_t size = s.size();
+    if (to.size() > from.size()) {
+        size += count_substring(s, from) * (to.size() - from.size());
+    }
+    out.resize(size);
+
+    SubstringScanner scanner{s, from};
+    char* dest = out.data();
+    std::size_t start = 0;
+    for (auto at = scanner.next(0); at != std::string_view::npos; at = scanner.next(start)) {
+        dest = std::copy_n(s.data() + start, at - start, dest);
+        dest = std::copy_n(to.data(), to.size(), dest);
+        start = at + from.size();
+    }
+    dest = std::copy_n(s.data() + start, s.size() - start, dest);
+    out.resize(static_cast<std::size_t>(dest - out.data()));
+}
+
+[[nodiscard]] inline std::string replace_all(std::string_view s, std::string_view from,
+                                             std::string_view to) {
+    std::string out;
+    replace_all(s, from, to, out);
+    return out;
+}
+
+} // namespace text
+
+#endif // TEXT_KERNELS_H
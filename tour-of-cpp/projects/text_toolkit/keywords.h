@@ -0,0 +1,354 @@
+#ifndef TEXT_KEYWORDS_H
+#define TEXT_KEYWORDS_H
+
+#include "scan.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Many literal keywords found in one pass over a text: Aho-Corasick.
+ *
+ * Searching a log line for a thousand keywords with a find, or a
+ * std::regex_search, per keyword reads the line a thousand times. Here the
+ * keywords are built into one trie, and the trie into a DFA whose states
+ * are its nodes: after each byte the DFA is at the longest keyword prefix
+ * the text ends with. One table lookup per byte finds every occurrence of
+ * every keyword, however many there are.
+ */
+
+namespace text {
+
+// An occurrence of a keyword: where it is, and which one it is
+struct KeywordMatch {
+    std::string_view text;  // into the searched text, which must outlive it
+    std::size_t position = 0;
+    std::size_t keyword = 0;  // its index in the KeywordSet
+};
+
+class KeywordSet;
+
+/**
+ * The occurrences of a KeywordSet's keywords in a text, in order of where
+ * they end, and of those that end together, longest first. Overlapping
+ * occurrences are all reported: "she" and "he" in "ushers".
+ *
+ * The end iterator is default-constructed, or std::default_sentinel.
+ */
+class KeywordIterator {
+public:
+    using value_type = KeywordMatch;
+    using difference_type = std::ptrdiff_t;
+    using reference = const KeywordMatch&;
+    using pointer = const KeywordMatch*;
+    using iterator_category = std::forward_iterator_tag;
+
+    KeywordIterator() = default;
+
+    // The set must outlive the iterator
+    KeywordIterator(std::string_view text, const KeywordSet& set);
+
+    [[nodiscard]] const KeywordMatch& operator*() const noexcept { return match_; }
+    [[nodiscard]] const KeywordMatch* operator->() const noexcept { return &match_; }
+
+    KeywordIterator& operator++() {
+        advance();
+        return *this;
+    }
+
+    KeywordIterator operator++(int) {
+        KeywordIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(const KeywordIterator& a, const KeywordIterator& b) noexcept {
+        if (a.set_ == nullptr || b.set_ == nullptr) {
+            return a.set_ == b.set_;
+        }
+        return a.set_ == b.set_ && a.text_.data() == b.text_.data() && a.pos_ == b.pos_ &&
+               a.output_ == b.output_;
+    }
+    friend bool operator==(const KeywordIterator& it, std::default_sentinel_t) noexcept {
+        return it.set_ == nullptr;
+    }
+
+private:
+    void advance();
+
+    const KeywordSet* set_ = nullptr;
+    std::string_view text_;
+    std::size_t pos_ = 0;          // the next byte to read
+    std::int32_t state_ = 0;       // the DFA's row after text_[0, pos_)
+    std::int32_t output_ = -1;     // the state whose keyword match_ is
+    Scanner<CharSetMatcher> scanner_;
+    KeywordMatch match_;
+};
+
+/**
+ * A set of literal keywords, searched for all at once.
+ *
+ *     text::KeywordSet alerts({"error", "timeout", "refused"}, text::KeywordSet::icase);
+ *     if (alerts.search(line)) { ... }
+ *     for (const text::KeywordMatch& hit : alerts.find_all(line)) {
+ *         use(hit.text, alerts.keyword(hit.keyword));
+ *     }
+ *
+ * The table has a row per trie node and a column per distinct byte of the
+ * keywords, bytes in no keyword sharing one: 1,000 random words of 4-10
+ * letters take 5,536 rows of 28 columns, about 600 KiB. With icase,
+ * ASCII letters of either case share a column, so case costs nothing
+ * while searching.
+ *
+ * Between occurrences the DFA is mostly at its root. If at most
+ * CharSet::simd_limit bytes can start a keyword, it skips from there to
+ * the next of them with a Scanner, 32 bytes at a time.
+ *
+ * A keyword given more than once is reported once, with its first index.
+ */
+class KeywordSet {
+public:
+    enum Flags : unsigned { none = 0, icase = 1u << 0 };
+
+    // KeywordSet{"a", "b"} or KeywordSet({"a", "b"}, icase); not
+    // KeywordSet{{"a", "b"}}, which is one std::string_view{first, last}
+    // @throws std::invalid_argument if a keyword is empty
+    // @throws std::length_error if the table would have 2^31 entries
+    explicit KeywordSet(std::initializer_list<std::string_view> keywords, Flags flags = none)
+        : KeywordSet{std::views::all(keywords), flags} {}
+
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+    explicit KeywordSet(R&& keywords, Flags flags = none) : icase_{(flags & icase) != 0} {
+        for (auto&& keyword : keywords) {
+            add(std::string_view{keyword});
+        }
+        build();
+    }
+
+    // Whether any keyword occurs in text
+    [[nodiscard]] bool search(std::string_view text) const noexcept {
+        return find(text).has_value();
+    }
+
+    // The occurrence that ends first, of those the longest; nullopt if none
+    [[nodiscard]] std::optional<KeywordMatch> find(std::string_view text) const noexcept {
+        KeywordIterator it{text, *this};
+        return it == std::default_sentinel ? std::nullopt : std::optional{*it};
+    }
+
+    // Every occurrence of every keyword, overlapping ones included
+    [[nodiscard]] std::ranges::subrange<KeywordIterator, std::default_sentinel_t> find_all(
+        std::string_view text) const {
+        return {KeywordIterator{text, *this}, std::default_sentinel};
+    }
+
+    // Keywords, duplicates included, in the order given
+    [[nodiscard]] std::size_t size() const noexcept { return keywords_.size(); }
+    [[nodiscard]] std::string_view keyword(std::size_t i) const noexcept { return keywords_[i]; }
+
+    // Rows of the DFA: the trie's nodes, the root included
+    [[nodiscard]] std::size_t states() const noexcept { return output_.size(); }
+
+private:
+    friend class KeywordIterator;
+
+    [[nodiscard]] unsigned char fold(unsigned char byte) const noexcept {
+        return icase_ && byte >= 'A' && byte <= 'Z' ? static_cast<unsigned char>(byte | 0x20)
+                                                    : byte;
+    }
+
+    void add(std::string_view keyword) {
+        if (keyword.empty()) {
+            throw std::invalid_argument{"KeywordSet: empty keyword"};
+        }
+        keywords_.emplace_back(keyword);
+    }
+
+    // Numbers the byte classes, builds the trie into the table, then fills
+    // in the rest of the table breadth first
+    void build() {
+        std::array<bool, 256> used{};
+        for (const std::string& keyword : keywords_) {
+            for (const char c : keyword) {
+                used[fold(static_cast<unsigned char>(c))] = true;
+            }
+        }
+        std::size_t count = 1;  // class 0: bytes in no keyword
+        for (std::size_t byte = 0; byte < 256; ++byte) {
+            if (used[byte]) {
+                class_of_[byte] = static_cast<std::uint16_t>(count++);
+            }
+        }
+        for (std::size_t byte = 0; byte < 256; ++byte) {
+            class_of_[byte] = class_of_[fold(static_cast<unsigned char>(byte))];
+        }
+        stride_ = (count + 1) & ~std::size_t{1};
+
+        // The trie, with entries holding child nodes; 0, the root, for none
+        table_.assign(stride_, 0);
+        output_.assign(1, -1);
+        for (std::size_t k = 0; k < keywords_.size(); ++k) {
+            std::size_t node = 0;
+            for (const char c : keywords_[k]) {
+                const std::size_t at = node * stride_ + class_of_[static_cast<unsigned char>(c)];
+                if (table_[at] == 0) {
+                    if (output_.size() >= max_entries / stride_) {
+                        throw std::length_error{"KeywordSet: too many keywords"};
+                    }
+                    table_[at] = static_cast<std::int32_t>(output_.size());
+                    output_.push_back(-1);
+                    table_.resize(table_.size() + stride_, 0);
+                }
+                node = static_cast<std::size_t>(table_[at]);
+            }
+            if (output_[node] < 0) {
+                output_[node] = static_cast<std::int32_t>(k);
+            }
+        }
+
+        // A node's missing edges are those of its failure node, the longest
+        // proper suffix of its path that is also in the trie. That node is
+        // nearer the root, so its row is already complete.
+        const std::size_t nodes = output_.size();
+        dictionary_.assign(nodes, -1);
+        std::vector<std::int32_t> fail(nodes, 0);
+        std::vector<std::int32_t> queue{0};
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const auto node = static_cast<std::size_t>(queue[head]);
+            const auto from = static_cast<std::size_t>(fail[node]);
+            for (std::size_t cls = 1; cls < count; ++cls) {
+                std::int32_t& entry = table_[node * stride_ + cls];
+                const std::int32_t next = node == 0 ? 0 : table_[from * stride_ + cls];
+                if (entry == 0) {
+                    entry = next;
+                    continue;
+                }
+                const auto child = static_cast<std::size_t>(entry);
+                const auto suffix = static_cast<std::size_t>(next);
+                fail[child] = next;
+                dictionary_[child] = output_[suffix] >= 0 ? next : dictionary_[suffix];
+                queue.push_back(entry);
+            }
+        }
+
+        // Rows are renumbered in breadth-first order, which puts the nodes
+        // near the root, where a search spends most of its time, together
+        // in the cache. Entries become row offsets, with bit 0 set where a
+        // keyword ends.
+        std::vector<std::int32_t> renumbered(nodes);
+        for (std::size_t i = 0; i < nodes; ++i) {
+            renumbered[static_cast<std::size_t>(queue[i])] = static_cast<std::int32_t>(i);
+        }
+        std::vector<std::int32_t> table(table_.size());
+        std::vector<std::int32_t> output(nodes);
+        std::vector<std::int32_t> dictionary(nodes);
+        for (std::size_t i = 0; i < nodes; ++i) {
+            const auto node = static_cast<std::size_t>(queue[i]);
+            output[i] = output_[node];
+            dictionary[i] = dictionary_[node] < 0
+                                ? -1
+                                : renumbered[static_cast<std::size_t>(dictionary_[node])];
+            for (std::size_t cls = 0; cls < stride_; ++cls) {
+                const auto target = static_cast<std::size_t>(table_[node * stride_ + cls]);
+                const bool hit = output_[target] >= 0 || dictionary_[target] >= 0;
+                table[i * stride_ + cls] =
+                    renumbered[target] * static_cast<std::int32_t>(stride_) | (hit ? 1 : 0);
+            }
+        }
+        table_ = std::move(table);
+        output_ = std::move(output);
+        dictionary_ = std::move(dictionary);
+
+        // The bytes that leave the root, in both cases with icase
+        std::string first;
+        for (std::size_t byte = 0; byte < 256; ++byte) {
+            if (table_[class_of_[byte]] != 0) {
+                first += static_cast<char>(byte);
+            }
+        }
+        first_bytes_ = CharSet{first};
+        skip_ = first_bytes_.size() <= CharSet::simd_limit;
+    }
+
+    static constexpr std::size_t max_entries =
+        static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+    std::vector<std::string> keywords_;
+    std::vector<std::int32_t> output_;      // the keyword ending at each node, or -1
+    std::vector<std::int32_t> dictionary_;  // the next node on the failure path with one
+    std::vector<std::int32_t> table_;       // stride_ entries per node
+    std::array<std::uint16_t, 256> class_of_{};
+    std::size_t stride_ = 2;
+    CharSet first_bytes_;
+    bool skip_ = false;
+    bool icase_ = false;
+};
+
+inline KeywordIterator::KeywordIterator(std::string_view text, const KeywordSet& set)
+    : set_{&set}, text_{text} {
+    if (set.skip_) {
+        scanner_ = Scanner{text, CharSetMatcher{set.first_bytes_}};
+    }
+    advance();
+}
+
+inline void KeywordIterator::advance() {
+    const KeywordSet& set = *set_;
+    // The shorter keywords ending at the same place, on the failure path
+    if (output_ >= 0) {
+        output_ = set.dictionary_[static_cast<std::size_t>(output_)];
+    }
+    if (output_ < 0) {
+        const std::int32_t* rows = set.table_.data();
+        const auto& class_of = set.class_of_;
+        const std::string_view text = text_;
+        // Not state == 0 && skip_: where the root is common, that branch
+        // would go both ways, and a mispredicted branch costs more than the
+        // byte's lookups
+        const std::int32_t skip_state = set.skip_ ? 0 : -1;
+        std::int32_t state = state_;
+        std::size_t i = pos_;
+        for (; i < text.size(); ++i) {
+            if (state == skip_state) {
+                i = scanner_.next(i);
+                if (i == text.size()) {
+                    break;
+                }
+            }
+            const std::size_t cls = class_of[static_cast<unsigned char>(text[i])];
+            const std::int32_t next = rows[static_cast<std::size_t>(state) + cls];
+            state = next & ~1;
+            if ((next & 1) != 0) {
+                break;
+            }
+        }
+        if (i == text_.size()) {
+            set_ = nullptr;
+            return;
+        }
+        pos_ = i + 1;
+        state_ = state;
+        const std::size_t node = static_cast<std::size_t>(state) / set.stride_;
+        output_ = set.output_[node] >= 0 ? static_cast<std::int32_t>(node) : set.dictionary_[node];
+    }
+    const auto keyword = static_cast<std::size_t>(set.output_[static_cast<std::size_t>(output_)]);
+    const std::size_t length = set.keywords_[keyword].size();
+    match_.position = pos_ - length;
+    match_.text = text_.substr(match_.position, length);
+    match_.keyword = keyword;
+}
+
+} // namespace text
+
+#endif // TEXT_KEYWORDS_H
@@ -0,0 +1,228 @@
+#include "kernels.h"
+#include "keywords.h"
+#include "regex.h"
+#include "shared_string.h"
+#include "split.h"
+#include "url.h"
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Demonstrates the text toolkit, starting from Chapter 10's string
+ * exercises: trimming, splitting and counting words without copying text.
+ */
+
+namespace {
+
+using text::SharedString;
+
+// Chapter 10's trim, as a slice: text::trim finds the ends, and no
+// characters are copied for long text
+SharedString trim(const SharedString& s) {
+    const std::string_view trimmed = text::trim(s);
+    return s.substr(static_cast<std::size_t>(trimmed.data() - s.data()), trimmed.size());
+}
+
+// Chapter 10's split, into slices of one shared buffer: text::split finds
+// the fields as string_views, and each becomes a slice at the same place
+std::vector<SharedString> split(const SharedString& s, char delimiter) {
+    std::vector<SharedString> out;
+    for (const std::string_view field : text::split(s, delimiter)) {
+        out.push_back(s.substr(static_cast<std::size_t>(field.data() - s.data()), field.size()));
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Text Toolkit Demo ===\n\n";
+
+    // 1. Short strings live in the object, long ones in a shared buffer
+    std::cout << "1. SharedString storage:\n";
+    {
+        const SharedString word{"tokenizer"};
+        const SharedString line{"The quick brown fox jumps over the lazy dog, twice over."};
+        const SharedString copy = line;
+        std::cout << "   \"" << word << "\": inline, use_count " << word.use_count() << "\n";
+        std::cout << "   " << line.size() << "-character line and its copy: use_count "
+                  << line.use_count() << ", same buffer: " << std::boolalpha
+                  << (copy.data() == line.data()) << "\n";
+        std::cout << "   sizeof(SharedString) = " << sizeof(SharedString)
+                  << ", sizeof(std::string) = " << sizeof(std::string) << "\n\n";
+    }
+
+    // 2. Slices share the buffer
+    std::cout << "2. substr() and trim() without copying:\n";
+    {
+        const SharedString padded{"      a line with plenty of padding around it, "
+                                  "for trimming      "};
+        const SharedString trimmed = trim(padded);
+        std::cout << "   [" << trimmed << "]\n";
+        std::cout << "   points into the original: " << (trimmed.data() == padded.data() + 6)
+                  << ", use_count " << padded.use_count() << "\n\n";
+    }
+
+    // 3. Splitting a record into fields
+    std::cout << "3. split() of a CSV record:\n";
+    const SharedString record{"2024-03-01,Ada Lovelace,analytical engine,"
+                              "notes on the analytical engine (with note G),1843"};
+    const auto fields = split(record, ',');
+    for (const auto& field : fields) {
+        std::cout << "   [" << field << "]" << (field.use_count() > 0 ? " shared" : " inline")
+                  << "\n";
+    }
+    std::cout << "\n";
+
+    // 4. Counting words: each key is hashed once, lookups by string_view
+    std::cout << "4. Word counts in a hash map:\n";
+    {
+        const SharedString text{
+            "the cat sat on the mat and the dog sat on the log and the cat saw the dog"};
+        std::unordered_map<SharedString, int, text::SharedStringHash, text::SharedStringEqual>
+            counts;
+        for (const auto& word : split(text, ' ')) {
+            ++counts[word];
+        }
+        for (const std::string_view word : {"the", "cat", "sat", "fish"}) {
+            const auto it = counts.find(word);  // no SharedString built
+            std::cout << "   " << word << ": " << (it == counts.end() ? 0 : it->second) << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // 5. An arena for many strings that die together
+    std::cout << "5. StringArena:\n";
+    {
+        text::StringArena arena;
+        std::vector<SharedString> lines;
+        for (int i = 0; i < 1000; ++i) {
+            lines.push_back(arena.copy("log line " + std::to_string(i) +
+                                       ": request served in a few milliseconds"));
+        }
+        std::cout << "   " << lines.size() << " lines, " << arena.bytes_used() << " bytes in "
+                  << arena.bytes_reserved() << " reserved, use_count " << lines[0].use_count()
+                  << "\n";
+    }
+
+    // 6. Lazy splitting, with no strings at all
+    std::cout << "\n6. split() and tokenize() as ranges of string_views:\n";
+    {
+        const std::string_view csv = "id,name,,score\n17,ada,,93\n18,grace,,88";
+        for (const std::string_view row : text::split(csv, '\n')) {
+            std::cout << "  ";
+            for (const std::string_view field : text::split(row, ',')) {
+                std::cout << " [" << field << "]";
+            }
+            std::cout << "\n";
+        }
+
+        // Multi-character and character-set delimiters, and std::views on top
+        const std::string_view log = "GET /index.html || 200 || 5120 || 0.8ms";
+        std::cout << "   fields of a log line:";
+        for (const std::string_view field : text::split(log, " || ")) {
+            std::cout << " [" << field << "]";
+        }
+        const std::string_view prose = "It was the best of times,\tit was the worst of times;";
+        auto long_words = text::tokenize(prose, text::any_of(" \t,;"))
+                        | std::views::filter([](std::string_view w) { return w.size() > 3; });
+        std::cout << "\n   words longer than 3 letters:";
+        for (const std::string_view word : long_words) {
+            std::cout << " " << word;
+        }
+        std::cout << "\n   " << std::ranges::distance(text::words(prose)) << " words in all\n";
+    }
+
+    // 7. Vectorized versions of the other exercises
+    std::cout << "\n7. String kernels:\n";
+    {
+        const std::string sentence = "  The quick brown fox  jumps over the lazy dog  ";
+        std::cout << "   to_upper: [" << text::to_upper(sentence) << "]\n";
+        std::cout << "   to_lower: [" << text::to_lower(sentence) << "]\n";
+        std::cout << "   trim:     [" << text::trim(sentence) << "]\n";
+        std::cout << "   count_words: " << text::count_words(sentence) << "\n";
+        std::cout << "   find \"lazy\": " << text::find_substring(sentence, "lazy") << "\n";
+
+        // One output buffer for many replacements: it grows, then is reused
+        std::string out;
+        for (const std::string_view line : {"the cat sat on the mat", "the end"}) {
+            text::replace_all(line, "the", "a", out);
+            std::cout << "   replace_all: [" << out << "]\n";
+        }
+    }
+
+    // 8. Chapter 10's regular expressions, compiled to DFAs
+    std::cout << "\n8. Regular expressions:\n";
+    {
+        const text::Regex url{R"((https?)://([\w.]+)(/.*)?)"};
+        text::Match m;
+        if (url.match("https://example.com/path/to/page", m)) {
+            std::cout << "   url: scheme " << m[1] << ", host " << m[2] << ", path " << m[3]
+                      << "\n";
+        }
+
+        const text::Regex phone{R"(\(\d{3}\) \d{3}-\d{4}|\d{3}-\d{3}-\d{4})"};
+        std::cout << "   phone numbers:";
+        for (const text::Match& hit : phone.find_all("Call (123) 456-7890 or 987-654-3210")) {
+            std::cout << " [" << hit[0] << "]";
+        }
+
+        // Built by the compiler: only table lookups are left at run time
+        constexpr text::StaticRegex<R"(\d{4}-\d{2}-\d{2})"> date;
+        static_assert(date.match("2024-01-15"));
+        const std::string_view log = "backup done 2024-01-15 03:00, next 2024-01-22";
+        std::cout << "\n   dates:";
+        for (auto hit = date.find(log); hit;
+             hit = date.find(log, static_cast<std::size_t>(hit->data() - log.data()) +
+                                      hit->size())) {
+            std::cout << " " << *hit;
+        }
+        std::cout << "\n";
+    }
+
+    // 9. Many keywords in one pass
+    std::cout << "\n9. KeywordSet:\n";
+    {
+        const text::KeywordSet alerts({"error", "timeout", "refused", "denied"},
+                                      text::KeywordSet::icase);
+        for (const std::string_view line : {"GET /index.html 200", "ERROR: connection refused",
+                                            "upstream timeout; access denied"}) {
+            std::cout << "   [" << line << "]:";
+            for (const text::KeywordMatch& hit : alerts.find_all(line)) {
+                std::cout << " " << hit.text << "@" << hit.position;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    // 10. URLs split into views, and decoded into a buffer of our own
+    std::cout << "\n10. parse_url:\n";
+    {
+        const std::string_view link =
+            "https://alice@example.com:8443/search?q=tour+of+c%2B%2B&page=2#results";
+        if (const auto url = text::parse_url(link)) {
+            std::cout << "   scheme " << url->scheme << ", userinfo " << url->userinfo << ", host "
+                      << url->host << ", port " << url->port << "\n";
+            std::cout << "   path " << url->path << ", query " << url->query << ", fragment "
+                      << url->fragment << "\n";
+
+            std::array<char, 64> buffer{};
+            for (const auto [name, value] : url->query_params()) {
+                const auto size = text::percent_decode(value, buffer, text::Encoding::form);
+                std::cout << "   " << name << " = [" << std::string_view{buffer.data(), *size}
+                          << "]\n";
+            }
+        }
+        std::cout << "   \"http://bad host/\" is a URL: " << std::boolalpha
+                  << text::parse_url("http://bad host/").has_value() << "\n";
+    }
+
+    std::cout << "\n=== Demo Complete ===\n";
+    return 0;
+}
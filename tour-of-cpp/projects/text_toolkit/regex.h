@@ -0,0 +1,831 @@
+#ifndef TEXT_REGEX_H
+#define TEXT_REGEX_H
+
+#include "regex_program.h"
+#include "scan.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Regular expressions compiled to a DFA: a replacement for std::regex for
+ * the patterns of Chapter 10.
+ *
+ * std::regex tries the alternatives of a pattern one after another and
+ * backs up when one fails, so (a*)*b on a line of a's takes time
+ * exponential in its length, and every match allocates. Here a pattern is
+ * compiled to an NFA and from that to a DFA, whose table is walked one
+ * byte at a time: time linear in the text for every pattern, no
+ * allocation per match, and no backing up.
+ *
+ * Matches are the ones std::regex's ECMAScript grammar finds: the
+ * leftmost, and of those the one a backtracking matcher reaches first.
+ * A search runs the DFA forwards to find where that match ends, and a DFA
+ * of the reversed pattern backwards from there to find where it starts.
+ * Capture groups are filled in afterwards by running the NFA over the
+ * match alone.
+ */
+
+namespace text {
+
+namespace detail {
+
+// =============================================================================
+// Runs
+// =============================================================================
+//
+// Written once for the tables Regex builds as it goes and the ones
+// StaticRegex builds in the compiler: D has start, transition, rows,
+// classes and flushes, as Dfa does.
+
+/**
+ * The end of the leftmost-first match in text starting at pos (anchored)
+ * or anywhere after it, or npos. With first, the end of the first match
+ * seen, which is enough to say whether there is one.
+ *
+ * Between matches the DFA sits in its start state, which every byte
+ * outside skip leads back to; there the run jumps to the next byte in
+ * skip with a Scanner, 32 bytes at a time.
+ */
+template <typename D>
+constexpr std::size_t forward_end(D& dfa, std::string_view text, std::size_t pos, bool anchored,
+                                  bool first, const CharSet* skip) {
+    const std::size_t flushes = dfa.flushes();
+    std::int32_t state = dfa.start(anchored, pos == 0);
+    std::int32_t skip_state = -1;
+    Scanner<CharSetMatcher> scanner;
+    if (!std::is_constant_evaluated() && skip != nullptr && !anchored) {
+        skip_state = dfa.start(false, false) & ~1;
+        scanner = Scanner{text, CharSetMatcher{*skip}};
+        if (dfa.flushes() != flushes) {
+            skip_state = -1;
+            state = dfa.start(anchored, pos == 0);
+        }
+    }
+    if (state == Dfa::dead) {
+        return std::string_view::npos;
+    }
+
+    std::size_t end = std::string_view::npos;
+    if ((state & 1) != 0) {
+        end = pos;
+        if (first) {
+            return end;
+        }
+    }
+    state &= ~1;
+    const auto& classes = dfa.classes();
+    const std::int32_t* rows = dfa.rows();
+    for (std::size_t i = pos; i < text.size(); ++i) {
+        if (state == skip_state) {
+            i = scanner.next(i);
+            if (i == text.size()) {
+                break;
+            }
+        }
+        const std::size_t cls = classes.of[static_cast<unsigned char>(text[i])];
+        std::int32_t next = rows[static_cast<std::size_t>(state) + cls];
+        if (next < 0) {
+            if (next == Dfa::unknown) {
+                next = dfa.transition(state, cls);
+                rows = dfa.rows();
+                if (dfa.flushes() != flushes) {
+                    skip_state = -1;
+                }
+            }
+            if (next == Dfa::dead) {
+                return end;
+            }
+        }
+        if ((next & 1) != 0) {
+            end = i + 1;
+            if (first) {
+                return end;
+            }
+        }
+        state = next & ~1;
+    }
+    if (rows[static_cast<std::size_t>(state) + classes.count] != 0) {
+        end = text.size();
+    }
+    return end;
+}
+
+/**
+ * The start of the longest match of the reverse program that ends at end
+ * and starts at or after pos, or npos. For the leftmost-first match ending
+ * at end, that is where it starts: an earlier start would be a match
+ * further left.
+ */
+template <typename D>
+constexpr std::size_t reverse_start(D& dfa, std::string_view text, std::size_t pos,
+                                    std::size_t end) {
+    std::int32_t state = dfa.start(true, end == text.size());
+    if (state == Dfa::dead) {
+        return std::string_view::npos;
+    }
+    std::size_t start = (state & 1) != 0 ? end : std::string_view::npos;
+    state &= ~1;
+    const auto& classes = dfa.classes();
+    const std::int32_t* rows = dfa.rows();
+    for (std::size_t i = end; i > pos; --i) {
+        const std::size_t cls = classes.of[static_cast<unsigned char>(text[i - 1])];
+        std::int32_t next = rows[static_cast<std::size_t>(state) + cls];
+        if (next < 0) {
+            if (next == Dfa::unknown) {
+                next = dfa.transition(state, cls);
+                rows = dfa.rows();
+            }
+            if (next == Dfa::dead) {
+                return start;
+            }
+        }
+        if ((next & 1) != 0) {
+            start = i - 1;
+        }
+        state = next & ~1;
+    }
+    if (pos == 0 && rows[static_cast<std::size_t>(state) + classes.count] != 0) {
+        start = 0;
+    }
+    return start;
+}
+
+// The bytes a search can skip to, if there are few enough of them for a
+// Scanner (see forward_end)
+constexpr bool skip_set(const Program& program, Dfa& dfa, CharSet& out) {
+    ByteSet first;
+    if (program.begins_with_caret || !dfa.first_bytes(first) ||
+        first.size() > CharSet::simd_limit) {
+        return false;
+    }
+    std::array<char, CharSet::simd_limit> members{};
+    std::size_t n = 0;
+    for (unsigned b = 0; b < 256; ++b) {
+        if (first.contains(static_cast<unsigned char>(b))) {
+            members[n++] = static_cast<char>(b);
+        }
+    }
+    out = CharSet{std::string_view{members.data(), n}};
+    return true;
+}
+
+// =============================================================================
+// Capture groups
+// =============================================================================
+
+/**
+ * The capture groups of a match the DFAs have already found: the slots of
+ * the highest-priority thread that matches exactly text[start, end).
+ *
+ * A short match is found by backtracking, as std::regex does, but trying
+ * each (instruction, position) pair at most once, so the time is bounded
+ * by their product: RE2's "bit state" search. A longer one, whose bitmap
+ * of pairs would pass 32 KiB, goes to the Pike VM, which steps all the
+ * threads through the text together, each with its own slots.
+ */
+class Captures {
+public:
+    static constexpr std::size_t max_pairs = std::size_t{1} << 18;
+
+    // Into slots; false if no thread matches, which a found match rules out
+    bool run(const Program& program, std::string_view text, std::size_t start, std::size_t end,
+             std::vector<std::size_t>& slots) {
+        program_ = &program;
+        slot_count_ = static_cast<std::size_t>(program.slots);
+        caps_.assign(slot_count_, std::string_view::npos);
+        if (program.insts.size() * (end - start + 1) <= max_pairs) {
+            return backtrack(text, start, end, slots);
+        }
+        return pike(text, start, end, slots);
+    }
+
+private:
+    // A thread to try at position value, or (pc < 0) a slot to restore
+    // to value once the threads after a save are done
+    struct Frame {
+        int pc;
+        int slot;
+        std::size_t value;
+    };
+
+    bool backtrack(std::string_view text, std::size_t start, std::size_t end,
+                   std::vector<std::size_t>& slots) {
+        const std::size_t width = end - start + 1;
+        visited_.assign((program_->insts.size() * width + 63) / 64, 0);
+        stack_.clear();
+        stack_.push_back({program_->anchored, 0, start});
+        while (!stack_.empty()) {
+            const Frame frame = stack_.back();
+            stack_.pop_back();
+            if (frame.pc < 0) {
+                caps_[static_cast<std::size_t>(frame.slot)] = frame.value;
+                continue;
+            }
+            // Follow the preferred branch until it fails, leaving the
+            // others on the stack
+            int pc = frame.pc;
+            std::size_t pos = frame.value;
+            for (bool alive = true; alive;) {
+                const std::size_t pair = static_cast<std::size_t>(pc) * width + (pos - start);
+                auto& word = visited_[pair / 64];
+                const std::uint64_t bit = std::uint64_t{1} << (pair % 64);
+                if ((word & bit) != 0) {
+                    break;
+                }
+                word |= bit;
+                const Inst& inst = program_->insts[static_cast<std::size_t>(pc)];
+                switch (inst.op) {
+                case Op::byte_set:
+                    alive = pos < end && inst.bytes.contains(static_cast<unsigned char>(text[pos]));
+                    ++pos;
+                    pc = inst.x;
+                    break;
+                case Op::split:
+                    stack_.push_back({inst.y, 0, pos});
+                    pc = inst.x;
+                    break;
+                case Op::jump:
+                    pc = inst.x;
+                    break;
+                case Op::save: {
+                    auto& slot = caps_[static_cast<std::size_t>(inst.y)];
+                    stack_.push_back({-1, inst.y, slot});
+                    slot = pos;
+                    pc = inst.x;
+                    break;
+                }
+                case Op::assert_start:
+                    alive = pos == 0;
+                    pc = inst.x;
+                    break;
+                case Op::assert_finish:
+                    alive = pos == text.size();
+                    pc = inst.x;
+                    break;
+                case Op::match:
+                    if (pos == end) {
+                        slots = caps_;
+                        return true;
+                    }
+                    alive = false;
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool pike(std::string_view text, std::size_t start, std::size_t end,
+              std::vector<std::size_t>& slots) {
+        const Program& program = *program_;
+        current_.reset(program.insts.size(), slot_count_);
+        next_.reset(program.insts.size(), slot_count_);
+        stack_.clear();
+        add(current_, program.anchored, start, start == 0, start == text.size());
+
+        for (std::size_t i = start; i < end && !current_.dense.empty(); ++i) {
+            const auto byte = static_cast<unsigned char>(text[i]);
+            next_.dense.clear();
+            for (const int pc : current_.dense) {
+                const Inst& inst = program.insts[static_cast<std::size_t>(pc)];
+                if (inst.op == Op::byte_set && inst.bytes.contains(byte)) {
+                    std::copy_n(current_.caps_of(pc, slot_count_), slot_count_, caps_.begin());
+                    add(next_, inst.x, i + 1, false, i + 1 == text.size());
+                }
+            }
+            std::swap(current_, next_);
+        }
+        for (const int pc : current_.dense) {
+            if (program.insts[static_cast<std::size_t>(pc)].op == Op::match) {
+                const std::size_t* caps = current_.caps_of(pc, slot_count_);
+                slots.assign(caps, caps + slot_count_);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Threads in priority order, at most one per instruction
+    struct Threads {
+        std::vector<int> dense;
+        std::vector<std::size_t> sparse;
+        std::vector<std::size_t> caps;
+
+        void reset(std::size_t insts, std::size_t slots) {
+            dense.clear();
+            sparse.resize(insts);
+            caps.resize(insts * slots);
+        }
+        [[nodiscard]] bool contains(int pc) const noexcept {
+            const std::size_t i = sparse[static_cast<std::size_t>(pc)];
+            return i < dense.size() && dense[i] == pc;
+        }
+        void insert(int pc) {
+            sparse[static_cast<std::size_t>(pc)] = dense.size();
+            dense.push_back(pc);
+        }
+        [[nodiscard]] std::size_t* caps_of(int pc, std::size_t slots) noexcept {
+            return caps.data() + static_cast<std::size_t>(pc) * slots;
+        }
+    };
+
+    // Adds the threads pc leads to at pos, with the slots in caps_
+    void add(Threads& list, int pc, std::size_t pos, bool at_start, bool at_finish) {
+        stack_.push_back({pc, 0, 0});
+        while (!stack_.empty()) {
+            const Frame frame = stack_.back();
+            stack_.pop_back();
+            if (frame.pc < 0) {
+                caps_[static_cast<std::size_t>(frame.slot)] = frame.value;
+                continue;
+            }
+            if (list.contains(frame.pc)) {
+                continue;
+            }
+            list.insert(frame.pc);
+            const Inst& inst = program_->insts[static_cast<std::size_t>(frame.pc)];
+            switch (inst.op) {
+            case Op::split:
+                stack_.push_back({inst.y, 0, 0});
+                stack_.push_back({inst.x, 0, 0});
+                break;
+            case Op::jump:
+                stack_.push_back({inst.x, 0, 0});
+                break;
+            case Op::save: {
+                auto& slot = caps_[static_cast<std::size_t>(inst.y)];
+                stack_.push_back({-1, inst.y, slot});
+                slot = pos;
+                stack_.push_back({inst.x, 0, 0});
+                break;
+            }
+            case Op::assert_start:
+                if (at_start) {
+                    stack_.push_back({inst.x, 0, 0});
+                }
+                break;
+            case Op::assert_finish:
+                if (at_finish) {
+                    stack_.push_back({inst.x, 0, 0});
+                }
+                break;
+            case Op::byte_set:
+            case Op::match:
+                std::copy(caps_.begin(), caps_.end(), list.caps_of(frame.pc, slot_count_));
+                break;
+            }
+        }
+    }
+
+    const Program* program_ = nullptr;
+    std::size_t slot_count_ = 0;
+    Threads current_;
+    Threads next_;
+    std::vector<std::size_t> caps_;
+    std::vector<Frame> stack_;
+    std::vector<std::uint64_t> visited_;  // a bit per (instruction, position) tried
+};
+
+// A compiled pattern, shared by the copies of a Regex
+struct RegexImpl {
+    // A DFA that outgrows cache_bytes is cleared and rebuilt as it goes;
+    // one that fits in eager_bytes is built in full up front
+    static constexpr std::size_t cache_bytes = std::size_t{1} << 22;
+    static constexpr std::size_t eager_bytes = std::size_t{1} << 18;
+
+    RegexImpl(std::string_view pattern, bool icase)
+        : RegexImpl{pattern, Parser{pattern, icase}.parse()} {}
+
+    RegexImpl(std::string_view pattern, const Ast& ast)
+        : source{pattern},
+          forward{compile(ast, false)},
+          reverse{compile(ast, true)},
+          forward_dfa{forward, false, cache_bytes},
+          reverse_dfa{reverse, true, cache_bytes} {
+        complete = forward_dfa.build(eager_states(forward_dfa), true) &&
+                   reverse_dfa.build(eager_states(reverse_dfa), false);
+        skip = skip_set(forward, forward_dfa, first_bytes);
+    }
+
+    [[nodiscard]] static std::size_t eager_states(const Dfa& dfa) noexcept {
+        return eager_bytes / (dfa.stride() * sizeof(std::int32_t));
+    }
+
+    // Tables still being built are shared by every thread searching
+    [[nodiscard]] std::unique_lock<std::mutex> lock() {
+        return complete ? std::unique_lock<std::mutex>{} : std::unique_lock<std::mutex>{mutex};
+    }
+
+    [[nodiscard]] std::size_t find_end(std::string_view text, std::size_t pos, bool first) {
+        if (forward.begins_with_caret && pos > 0) {
+            return std::string_view::npos;
+        }
+        return forward_end(forward_dfa, text, pos, forward.begins_with_caret, first,
+                           skip ? &first_bytes : nullptr);
+    }
+
+    std::string source;
+    Program forward;
+    Program reverse;
+    Dfa forward_dfa;
+    Dfa reverse_dfa;
+    CharSet first_bytes;
+    bool skip = false;
+    bool complete = false;
+    std::mutex mutex;
+};
+
+} // namespace detail
+
+// =============================================================================
+// Match
+// =============================================================================
+
+/**
+ * The result of a search: the match and its capture groups, as
+ * std::string_views into the searched text, which must outlive them.
+ *
+ * std::smatch's counterpart; a Match reused across searches keeps its
+ * buffers, so searching with it does not allocate once they have grown.
+ */
+class Match {
+public:
+    Match() = default;
+
+    // Whether the last search found nothing
+    [[nodiscard]] bool empty() const noexcept { return slots_.empty(); }
+
+    // Groups, the whole match included; 0 if empty()
+    [[nodiscard]] std::size_t size() const noexcept { return slots_.size() / 2; }
+
+    // Whether group i took part in the match: in (a)|b, group 1 may not
+    [[nodiscard]] bool matched(std::size_t i = 0) const noexcept {
+        return i < size() && slots_[2 * i] != std::string_view::npos &&
+               slots_[2 * i + 1] != std::string_view::npos;
+    }
+
+    // Group i; empty if it did not take part
+    [[nodiscard]] std::string_view operator[](std::size_t i) const noexcept {
+        return matched(i) ? text_.substr(slots_[2 * i], slots_[2 * i + 1] - slots_[2 * i])
+                          : std::string_view{};
+    }
+
+    // Where group i starts in the text, or npos if it did not take part
+    [[nodiscard]] std::size_t position(std::size_t i = 0) const noexcept {
+        return matched(i) ? slots_[2 * i] : std::string_view::npos;
+    }
+    [[nodiscard]] std::size_t length(std::size_t i = 0) const noexcept {
+        return (*this)[i].size();
+    }
+    [[nodiscard]] std::string str(std::size_t i = 0) const { return std::string{(*this)[i]}; }
+
+    // The text before and after the match
+    [[nodiscard]] std::string_view prefix() const noexcept {
+        return empty() ? std::string_view{} : text_.substr(0, slots_[0]);
+    }
+    [[nodiscard]] std::string_view suffix() const noexcept {
+        return empty() ? std::string_view{} : text_.substr(slots_[1]);
+    }
+
+private:
+    friend class Regex;
+
+    std::string_view text_;
+    std::vector<std::size_t> slots_;  // start and end of each group, npos if unset
+    detail::Captures captures_;
+};
+
+class Regex;
+
+/**
+ * The matches of a Regex in a text, left to right: std::sregex_iterator
+ * for std::string_view. After an empty match the next search starts a
+ * byte later, so \d* on "a12b" gives "", "12", "", "" as std's does.
+ *
+ * The end iterator is default-constructed, or std::default_sentinel.
+ */
+class RegexIterator {
+public:
+    using value_type = Match;
+    using difference_type = std::ptrdiff_t;
+    using reference = const Match&;
+    using pointer = const Match*;
+    using iterator_category = std::forward_iterator_tag;
+
+    RegexIterator() = default;
+
+    // The regex must outlive the iterator
+    RegexIterator(std::string_view text, const Regex& regex) : regex_{&regex}, text_{text} {
+        find(0);
+    }
+
+    [[nodiscard]] const Match& operator*() const noexcept { return match_; }
+    [[nodiscard]] const Match* operator->() const noexcept { return &match_; }
+
+    RegexIterator& operator++() {
+        find(match_.position() + std::max<std::size_t>(match_.length(), 1));
+        return *this;
+    }
+
+    RegexIterator operator++(int) {
+        RegexIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(const RegexIterator& a, const RegexIterator& b) noexcept {
+        if (a.regex_ == nullptr || b.regex_ == nullptr) {
+            return a.regex_ == b.regex_;
+        }
+        return a.regex_ == b.regex_ && a.text_.data() == b.text_.data() &&
+               a.match_.position() == b.match_.position() && a.match_.length() == b.match_.length();
+    }
+    friend bool operator==(const RegexIterator& it, std::default_sentinel_t) noexcept {
+        return it.regex_ == nullptr;
+    }
+
+private:
+    void find(std::size_t pos);
+
+    const Regex* regex_ = nullptr;
+    std::string_view text_;
+    Match match_;
+};
+
+// =============================================================================
+// Regex
+// =============================================================================
+
+/**
+ * A compiled pattern, for ECMAScript syntax without backreferences,
+ * lookaround or \b.
+ *
+ *     text::Regex date{R"((\d{4})-(\d{2})-(\d{2}))"};
+ *     text::Match m;
+ *     if (date.search(line, m)) { use(m[1], m[2], m[3]); }
+ *     for (const text::Match& hit : date.find_all(log)) { ... }
+ *
+ * The DFA of a pattern whose table fits in 256 KiB is built when the
+ * Regex is; searches only read it, from any number of threads. A larger
+ * one is built state by state as searches reach them, in a table capped
+ * at 4 MiB; searches then take turns on a mutex.
+ *
+ * Copies share the compiled pattern.
+ */
+class Regex {
+public:
+    enum Flags : unsigned { none = 0, icase = 1u << 0 };
+
+    // @throws RegexError if the pattern is malformed or unsupported
+    explicit Regex(std::string_view pattern, Flags flags = none)
+        : impl_{std::make_shared<detail::RegexImpl>(pattern, (flags & icase) != 0)} {}
+
+    // Whether all of text matches: std::regex_match
+    [[nodiscard]] bool match(std::string_view text) const {
+        const auto lock = impl_->lock();
+        return matches_all(text);
+    }
+
+    // As match, filling m with the groups
+    bool match(std::string_view text, Match& m) const {
+        const auto lock = impl_->lock();
+        m.text_ = text;
+        m.slots_.clear();
+        if (!matches_all(text)) {
+            return false;
+        }
+        fill(m, 0, text.size());
+        return true;
+    }
+
+    // Whether some part of text matches: std::regex_search
+    [[nodiscard]] bool search(std::string_view text) const {
+        const auto lock = impl_->lock();
+        return impl_->find_end(text, 0, true) != std::string_view::npos;
+    }
+
+    // The first match starting at or after pos, into m. '^' holds only if
+    // pos is 0: the text before pos is still the text.
+    bool search(std::string_view text, Match& m, std::size_t pos = 0) const {
+        m.text_ = text;
+        m.slots_.clear();
+        if (pos > text.size()) {
+            return false;
+        }
+        const auto lock = impl_->lock();
+        const std::size_t end = impl_->find_end(text, pos, false);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        fill(m, detail::reverse_start(impl_->reverse_dfa, text, pos, end), end);
+        return true;
+    }
+
+    // Every match in text, left to right: std::sregex_iterator
+    [[nodiscard]] std::ranges::subrange<RegexIterator, std::default_sentinel_t> find_all(
+        std::string_view text) const {
+        return {RegexIterator{text, *this}, std::default_sentinel};
+    }
+
+    // Capture groups, not counting the whole match: std::regex::mark_count
+    [[nodiscard]] std::size_t mark_count() const noexcept {
+        return static_cast<std::size_t>(impl_->forward.slots / 2 - 1);
+    }
+
+    [[nodiscard]] std::string_view pattern() const noexcept { return impl_->source; }
+
+    // Whether the DFA is built as searches need it, being too large to
+    // build up front
+    [[nodiscard]] bool lazy() const noexcept { return !impl_->complete; }
+
+private:
+    [[nodiscard]] bool matches_all(std::string_view text) const {
+        return detail::reverse_start(impl_->reverse_dfa, text, 0, text.size()) == 0;
+    }
+
+    void fill(Match& m, std::size_t start, std::size_t end) const {
+        m.slots_.assign(static_cast<std::size_t>(impl_->forward.slots), std::string_view::npos);
+        m.slots_[0] = start;
+        m.slots_[1] = end;
+        if (m.slots_.size() > 2) {
+            m.captures_.run(impl_->forward, m.text_, start, end, m.slots_);
+        }
+    }
+
+    std::shared_ptr<detail::RegexImpl> impl_;
+};
+
+inline void RegexIterator::find(std::size_t pos) {
+    if (!regex_->search(text_, match_, pos)) {
+        regex_ = nullptr;
+    }
+}
+
+// The std::regex free functions, for code moving over from <regex>
+[[nodiscard]] inline bool regex_match(std::string_view text, const Regex& regex) {
+    return regex.match(text);
+}
+inline bool regex_match(std::string_view text, Match& m, const Regex& regex) {
+    return regex.match(text, m);
+}
+[[nodiscard]] inline bool regex_search(std::string_view text, const Regex& regex) {
+    return regex.search(text);
+}
+inline bool regex_search(std::string_view text, Match& m, const Regex& regex) {
+    return regex.search(text, m);
+}
+
+// =============================================================================
+// StaticRegex
+// =============================================================================
+
+// A string literal as a template argument: StaticRegex<R"(\d+)">
+template <std::size_t N>
+struct FixedPattern {
+    // Not explicit, so that a string literal converts
+    constexpr FixedPattern(const char (&pattern)[N]) noexcept {
+        std::copy_n(pattern, N, chars);
+    }
+    [[nodiscard]] constexpr std::string_view view() const noexcept { return {chars, N - 1}; }
+
+    char chars[N]{};
+};
+
+namespace detail {
+
+// A finished DFA table, with the interface of Dfa the runs use
+template <std::size_t Size>
+struct StaticDfa {
+    std::array<std::int32_t, Size> table{};
+    ByteClasses byte_classes{};
+    std::array<std::int32_t, 4> start_states{};
+
+    [[nodiscard]] constexpr std::int32_t start(bool anchored, bool at_start) const noexcept {
+        return start_states[(anchored ? 2u : 0u) + (at_start ? 1u : 0u)];
+    }
+    // Never reached: every entry of a finished table is known
+    [[nodiscard]] constexpr std::int32_t transition(std::int32_t, std::size_t) const noexcept {
+        return Dfa::dead;
+    }
+    [[nodiscard]] constexpr const std::int32_t* rows() const noexcept { return table.data(); }
+    [[nodiscard]] constexpr const ByteClasses& classes() const noexcept { return byte_classes; }
+    [[nodiscard]] constexpr std::size_t flushes() const noexcept { return 0; }
+};
+
+// States a StaticRegex table may have; larger patterns fail to compile
+inline constexpr std::size_t static_max_states = 1024;
+inline constexpr std::size_t static_max_bytes = std::size_t{1} << 24;
+
+template <FixedPattern Pattern, bool Icase, bool Reverse>
+constexpr std::size_t static_table_size() {
+    const Program program = compile(Parser{Pattern.view(), Icase}.parse(), Reverse);
+    Dfa dfa{program, Reverse, static_max_bytes};
+    return dfa.build(static_max_states, !Reverse) ? dfa.table().size() : 0;
+}
+
+template <FixedPattern Pattern, bool Icase, bool Reverse>
+constexpr auto make_static_dfa() {
+    constexpr std::size_t size = static_table_size<Pattern, Icase, Reverse>();
+    static_assert(size != 0, "StaticRegex: the pattern needs too many DFA states; use Regex");
+    const Program program = compile(Parser{Pattern.view(), Icase}.parse(), Reverse);
+    Dfa dfa{program, Reverse, static_max_bytes};
+    dfa.build(static_max_states, !Reverse);
+    StaticDfa<size> out;
+    std::copy(dfa.table().begin(), dfa.table().end(), out.table.begin());
+    out.byte_classes = dfa.classes();
+    out.start_states = dfa.starts();
+    return out;
+}
+
+struct StaticSearch {
+    bool begins_with_caret = false;
+    bool skip = false;
+    CharSet first_bytes;
+};
+
+template <FixedPattern Pattern, bool Icase>
+constexpr StaticSearch static_search() {
+    const Program program = compile(Parser{Pattern.view(), Icase}.parse(), false);
+    Dfa dfa{program, false, static_max_bytes};
+    StaticSearch search;
+    search.begins_with_caret = program.begins_with_caret;
+    search.skip = skip_set(program, dfa, search.first_bytes);
+    return search;
+}
+
+} // namespace detail
+
+/**
+ * A pattern fixed at compile time, compiled by the C++ compiler: the
+ * parser, the NFA and the DFA construction above all run in constant
+ * evaluation, and only the finished tables are kept, as constants.
+ *
+ *     constexpr text::StaticRegex<R"(\d{4}-\d{2}-\d{2})"> iso_date;
+ *     static_assert(iso_date.match("2024-01-15"));
+ *     if (auto date = iso_date.find(line)) { ... }
+ *
+ * A malformed pattern, or one whose DFA has more than 1024 states, is a
+ * compile error. There are no capture groups: match, search and find say
+ * whether and where the pattern matches, which is what validation and
+ * extraction loops need. All of them are constexpr and noexcept, and
+ * nothing is built or locked at run time.
+ */
+template <FixedPattern Pattern, Regex::Flags Flags = Regex::none>
+class StaticRegex {
+public:
+    [[nodiscard]] static constexpr std::string_view pattern() noexcept { return Pattern.view(); }
+
+    // Whether all of text matches
+    [[nodiscard]] constexpr bool match(std::string_view text) const noexcept {
+        return detail::reverse_start(reverse_, text, 0, text.size()) == 0;
+    }
+
+    // Whether some part of text matches
+    [[nodiscard]] constexpr bool search(std::string_view text) const noexcept {
+        return find_end(text, 0, true) != std::string_view::npos;
+    }
+
+    // The first match starting at or after pos, as std::regex_search finds it
+    [[nodiscard]] constexpr std::optional<std::string_view>
+    find(std::string_view text, std::size_t pos = 0) const noexcept {
+        if (pos > text.size()) {
+            return std::nullopt;
+        }
+        const std::size_t end = find_end(text, pos, false);
+        if (end == std::string_view::npos) {
+            return std::nullopt;
+        }
+        const std::size_t start = detail::reverse_start(reverse_, text, pos, end);
+        return text.substr(start, end - start);
+    }
+
+private:
+    static constexpr bool icase_ = (Flags & Regex::icase) != 0;
+    static constexpr auto forward_ = detail::make_static_dfa<Pattern, icase_, false>();
+    static constexpr auto reverse_ = detail::make_static_dfa<Pattern, icase_, true>();
+    static constexpr detail::StaticSearch search_ = detail::static_search<Pattern, icase_>();
+
+    [[nodiscard]] constexpr std::size_t find_end(std::string_view text, std::size_t pos,
+                                                 bool first) const noexcept {
+        if (search_.begins_with_caret && pos > 0) {
+            return std::string_view::npos;
+        }
+        return detail::forward_end(forward_, text, pos, search_.begins_with_caret, first,
+                                   search_.skip ? &search_.first_bytes : nullptr);
+    }
+};
+
+} // namespace text
+
+#endif // TEXT_REGEX_H
@@ -0,0 +1,1092 @@
+#ifndef TEXT_REGEX_PROGRAM_H
+#define TEXT_REGEX_PROGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * The compiler behind Regex and StaticRegex: a parser for the ECMAScript
+ * subset a DFA can run, the NFA program a pattern compiles to, and the DFA
+ * built from that program.
+ *
+ * Everything here is constexpr, so StaticRegex can run the whole compiler
+ * inside the C++ compiler and keep only the finished tables.
+ */
+
+namespace text {
+
+// A pattern that is malformed, or uses syntax a DFA cannot run
+class RegexError : public std::runtime_error {
+public:
+    RegexError(const char* what, std::size_t position)
+        : std::runtime_error{"regex: " + std::string{what} + " at position " +
+                             std::to_string(position)},
+          position_{position} {}
+
+    // Where in the pattern the parser stopped
+    [[nodiscard]] std::size_t position() const noexcept { return position_; }
+
+private:
+    std::size_t position_;
+};
+
+namespace detail {
+
+// A set of bytes, as 256 bits
+class ByteSet {
+public:
+    constexpr void add(unsigned char b) noexcept {
+        bits_[b / 64] |= std::uint64_t{1} << (b % 64);
+    }
+    constexpr void add_range(unsigned char first, unsigned char last) noexcept {
+        for (unsigned b = first; b <= last; ++b) {
+            add(static_cast<unsigned char>(b));
+        }
+    }
+    constexpr void add(const ByteSet& other) noexcept {
+        for (std::size_t i = 0; i < bits_.size(); ++i) {
+            bits_[i] |= other.bits_[i];
+        }
+    }
+    constexpr void invert() noexcept {
+        for (auto& word : bits_) {
+            word = ~word;
+        }
+    }
+    // Adds the other case of each ASCII letter in the set
+    constexpr void fold_case() noexcept {
+        for (unsigned char lower = 'a'; lower <= 'z'; ++lower) {
+            const auto upper = static_cast<unsigned char>(lower - 'a' + 'A');
+            if (contains(lower) || contains(upper)) {
+                add(lower);
+                add(upper);
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr bool contains(unsigned char b) const noexcept {
+        return ((bits_[b / 64] >> (b % 64)) & 1u) != 0;
+    }
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        std::size_t n = 0;
+        for (const auto word : bits_) {
+            n += static_cast<std::size_t>(std::popcount(word));
+        }
+        return n;
+    }
+
+private:
+    std::array<std::uint64_t, 4> bits_{};
+};
+
+// =============================================================================
+// Parser
+// =============================================================================
+
+enum class NodeKind : std::uint8_t { empty, bytes, concat, alternate, repeat, group, begin, end };
+
+struct Node {
+    NodeKind kind = NodeKind::empty;
+    ByteSet bytes;              // bytes
+    std::vector<int> children;  // concat and alternate; repeat and group have one
+    int min = 0;                // repeat
+    int max = 0;                // repeat; -1 if unbounded
+    bool greedy = true;         // repeat
+    int group = -1;             // group: the capture index, or -1 for (?:...)
+};
+
+struct Ast {
+    std::vector<Node> nodes;
+    int root = 0;
+    int groups = 1;  // capture groups, with the whole match as group 0
+};
+
+/**
+ * A recursive-descent parser for:
+ *
+ *     literals and escaped punctuation    a  \.  \(  \n  \t  \x41
+ *     classes                              .  [a-z_]  [^,]  \d \w \s \D \W \S
+ *     groups                               (...)  (?:...)
+ *     alternation                          a|b
+ *     quantifiers, greedy and lazy         * + ? {m} {m,} {m,n}  *? +? ?? {m,n}?
+ *     anchors                              ^ $
+ *
+ * Backreferences, lookaround and \b are rejected: none of them can be
+ * decided by a DFA. Characters are bytes; '.' is any byte but '\n' and
+ * '\r', as in std::regex.
+ */
+class Parser {
+public:
+    static constexpr int max_count = 1000;  // {m,n} bounds
+    static constexpr int max_depth = 200;   // nested groups
+
+    constexpr Parser(std::string_view pattern, bool icase) noexcept
+        : pattern_{pattern}, icase_{icase} {}
+
+    // @throws RegexError if the pattern is malformed or unsupported
+    constexpr Ast parse() {
+        ast_.root = alternation(0);
+        if (!at_end()) {
+            throw RegexError{"unmatched ')'", pos_};
+        }
+        return std::move(ast_);
+    }
+
+private:
+    [[nodiscard]] constexpr bool at_end() const noexcept { return pos_ >= pattern_.size(); }
+    [[nodiscard]] constexpr char peek() const noexcept { return pattern_[pos_]; }
+
+    constexpr int add(Node node) {
+        ast_.nodes.push_back(std::move(node));
+        return static_cast<int>(ast_.nodes.size()) - 1;
+    }
+
+    constexpr int add(NodeKind kind) {
+        Node node;
+        node.kind = kind;
+        return add(std::move(node));
+    }
+
+    constexpr int add(ByteSet bytes) {
+        if (icase_) {
+            bytes.fold_case();
+        }
+        Node node;
+        node.kind = NodeKind::bytes;
+        node.bytes = bytes;
+        return add(std::move(node));
+    }
+
+    // a|b|c
+    constexpr int alternation(int depth) {
+        if (depth > max_depth) {
+            throw RegexError{"groups nested too deeply", pos_};
+        }
+        Node node;
+        node.kind = NodeKind::alternate;
+        node.children.push_back(concatenation(depth));
+        while (!at_end() && peek() == '|') {
+            ++pos_;
+            node.children.push_back(concatenation(depth));
+        }
+        return node.children.size() == 1 ? node.children.front() : add(std::move(node));
+    }
+
+    // Quantified atoms up to a '|', a ')' or the end
+    constexpr int concatenation(int depth) {
+        Node node;
+        node.kind = NodeKind::concat;
+        while (!at_end() && peek() != '|' && peek() != ')') {
+            node.children.push_back(repetition(depth));
+        }
+        if (node.children.empty()) {
+            return add(NodeKind::empty);
+        }
+        return node.children.size() == 1 ? node.children.front() : add(std::move(node));
+    }
+
+    [[nodiscard]] static constexpr bool is_quantifier(char c) noexcept {
+        return c == '*' || c == '+' || c == '?' || c == '{';
+    }
+
+    constexpr int repetition(int depth) {
+        const int atom_index = atom(depth);
+        if (at_end() || !is_quantifier(peek())) {
+            return atom_index;
+        }
+        const NodeKind kind = ast_.nodes[static_cast<std::size_t>(atom_index)].kind;
+        if (kind == NodeKind::begin || kind == NodeKind::end) {
+            throw RegexError{"nothing to repeat", pos_};
+        }
+        Node node;
+        node.kind = NodeKind::repeat;
+        node.children.push_back(atom_index);
+        switch (pattern_[pos_++]) {
+        case '*':
+            node.max = -1;
+            break;
+        case '+':
+            node.min = 1;
+            node.max = -1;
+            break;
+        case '?':
+            node.max = 1;
+            break;
+        default:
+            counts(node);
+            break;
+        }
+        if (!at_end() && peek() == '?') {
+            node.greedy = false;
+            ++pos_;
+        }
+        if (!at_end() && is_quantifier(peek())) {
+            throw RegexError{"nothing to repeat", pos_};
+        }
+        return add(std::move(node));
+    }
+
+    // After '{': m} m,} or m,n}
+    constexpr void counts(Node& node) {
+        node.min = number();
+        node.max = node.min;
+        if (!at_end() && peek() == ',') {
+            ++pos_;
+            node.max = !at_end() && peek() == '}' ? -1 : number();
+        }
+        if (at_end() || peek() != '}') {
+            throw RegexError{"bad repetition count", pos_};
+        }
+        ++pos_;
+        if (node.max != -1 && node.max < node.min) {
+            throw RegexError{"repetition range out of order", pos_};
+        }
+    }
+
+    constexpr int number() {
+        if (at_end() || peek() < '0' || peek() > '9') {
+            throw RegexError{"bad repetition count", pos_};
+        }
+        int n = 0;
+        while (!at_end() && peek() >= '0' && peek() <= '9') {
+            n = n * 10 + (pattern_[pos_++] - '0');
+            if (n > max_count) {
+                throw RegexError{"repetition count too large", pos_};
+            }
+        }
+        return n;
+    }
+
+    constexpr int atom(int depth) {
+        const char c = peek();
+        if (is_quantifier(c)) {
+            throw RegexError{"nothing to repeat", pos_};
+        }
+        ++pos_;
+        switch (c) {
+        case '(':
+            return group(depth);
+        case '[':
+            return add(char_class());
+        case '.': {
+            ByteSet any;
+            any.add('\n');
+            any.add('\r');
+            any.invert();
+            return add(any);
+        }
+        case '^':
+            return add(NodeKind::begin);
+        case '$':
+            return add(NodeKind::end);
+        case '\\':
+            return escape();
+        default: {
+            ByteSet one;
+            one.add(static_cast<unsigned char>(c));
+            return add(one);
+        }
+        }
+    }
+
+    // After '(': a capture group, or (?:...)
+    constexpr int group(int depth) {
+        Node node;
+        node.kind = NodeKind::group;
+        if (!at_end() && peek() == '?') {
+            if (pattern_.substr(pos_, 2) != "?:") {
+                throw RegexError{"lookaround is not supported", pos_};
+            }
+            pos_ += 2;
+        } else {
+            node.group = ast_.groups++;
+        }
+        node.children.push_back(alternation(depth + 1));
+        if (at_end()) {
+            throw RegexError{"missing ')'", pos_};
+        }
+        ++pos_;
+        return add(std::move(node));
+    }
+
+    // After a '\\' outside a class
+    constexpr int escape() {
+        if (at_end()) {
+            throw RegexError{"trailing '\\'", pos_};
+        }
+        const char c = pattern_[pos_++];
+        if (c == 'b' || c == 'B') {
+            throw RegexError{"word boundaries are not supported", pos_ - 1};
+        }
+        if (c >= '1' && c <= '9') {
+            throw RegexError{"backreferences are not supported", pos_ - 1};
+        }
+        if (is_class_escape(c)) {
+            return add(class_escape(c));
+        }
+        ByteSet one;
+        one.add(escaped_char(c));
+        return add(one);
+    }
+
+    [[nodiscard]] static constexpr bool is_class_escape(char c) noexcept {
+        return c == 'd' || c == 'D' || c == 'w' || c == 'W' || c == 's' || c == 'S';
+    }
+
+    // \d \w \s, and their complements \D \W \S
+    [[nodiscard]] static constexpr ByteSet class_escape(char c) noexcept {
+        ByteSet set;
+        switch (c) {
+        case 'd':
+        case 'D':
+            set.add_range('0', '9');
+            break;
+        case 'w':
+        case 'W':
+            set.add_range('0', '9');
+            set.add_range('A', 'Z');
+            set.add_range('a', 'z');
+            set.add('_');
+            break;
+        default:
+            set.add(' ');
+            set.add_range('\t', '\r');
+            break;
+        }
+        if (c >= 'A' && c <= 'Z') {
+            set.invert();
+        }
+        return set;
+    }
+
+    // The byte a one-character escape stands for, after the '\\'
+    constexpr unsigned char escaped_char(char c) {
+        switch (c) {
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'f':
+            return '\f';
+        case 'v':
+            return '\v';
+        case '0':
+            return '\0';
+        case 'x':
+            return static_cast<unsigned char>(hex_digit() * 16 + hex_digit());
+        default:
+            break;
+        }
+        if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+            throw RegexError{"unsupported escape", pos_ - 1};
+        }
+        return static_cast<unsigned char>(c);
+    }
+
+    constexpr int hex_digit() {
+        if (!at_end()) {
+            const char c = pattern_[pos_++];
+            if (c >= '0' && c <= '9') {
+                return c - '0';
+            }
+            if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+                return (c | 0x20) - 'a' + 10;
+            }
+        }
+        throw RegexError{"bad \\x escape", pos_};
+    }
+
+    // After '[': the members up to the closing ']'
+    constexpr ByteSet char_class() {
+        ByteSet set;
+        bool negated = false;
+        if (!at_end() && peek() == '^') {
+            negated = true;
+            ++pos_;
+        }
+        while (true) {
+            if (at_end()) {
+                throw RegexError{"missing ']'", pos_};
+            }
+            if (peek() == ']') {
+                ++pos_;
+                break;
+            }
+            const int first = class_member(set);
+            if (first < 0) {
+                continue;
+            }
+            if (pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+                ++pos_;
+                const int last = class_member(set);
+                if (last < 0) {
+                    throw RegexError{"class escape in a range", pos_};
+                }
+                if (last < first) {
+                    throw RegexError{"range out of order", pos_};
+                }
+                set.add_range(static_cast<unsigned char>(first), static_cast<unsigned char>(last));
+            } else {
+                set.add(static_cast<unsigned char>(first));
+            }
+        }
+        // Folded before inverting, so [^a] excludes 'A' too
+        if (icase_) {
+            set.fold_case();
+        }
+        if (negated) {
+            set.invert();
+        }
+        return set;
+    }
+
+    // One member of a class: a byte, or -1 for \d \w \s and the like,
+    // which are added to set
+    constexpr int class_member(ByteSet& set) {
+        const char c = pattern_[pos_++];
+        if (c != '\\') {
+            return static_cast<unsigned char>(c);
+        }
+        if (at_end()) {
+            throw RegexError{"trailing '\\'", pos_};
+        }
+        const char e = pattern_[pos_++];
+        if (is_class_escape(e)) {
+            set.add(class_escape(e));
+            return -1;
+        }
+        return e == 'b' ? '\b' : escaped_char(e);
+    }
+
+    std::string_view pattern_;
+    std::size_t pos_ = 0;
+    bool icase_ = false;
+    Ast ast_;
+};
+
+// =============================================================================
+// Program
+// =============================================================================
+
+enum class Op : std::uint8_t {
+    byte_set,       // consume a byte in bytes, go to x
+    split,          // go to x, and with lower priority to y
+    jump,           // go to x
+    save,           // record the position in slot y, go to x
+    assert_start,   // go to x if at the position the run started from
+    assert_finish,  // go to x if at the position the run finishes at
+    match,
+};
+
+struct Inst {
+    Op op = Op::match;
+    int x = 0;
+    int y = 0;
+    ByteSet bytes;
+};
+
+/**
+ * A Thompson NFA: a pattern as instructions for a set of threads stepping
+ * through the text together.
+ *
+ * Threads are kept in priority order, as a backtracking matcher would try
+ * them: a greedy loop prefers another turn, the left alternative is
+ * preferred over the right. The match a backtracking std::regex finds is
+ * the one of the highest-priority thread.
+ *
+ * The reverse program matches the reversed language, for scanning
+ * backwards from the end of a match to its start: concatenations are
+ * emitted right to left, '^' and '$' change places, and there are no
+ * captures.
+ */
+struct Program {
+    std::vector<Inst> insts;
+    int anchored = 0;    // entry for a match starting where the run starts
+    int unanchored = 0;  // entry for a match starting there or anywhere later
+    int slots = 2;       // two per capture group
+    bool begins_with_caret = false;  // every match starts at 0
+};
+
+class Compiler {
+public:
+    static constexpr std::size_t max_insts = std::size_t{1} << 15;
+
+    constexpr Compiler(const Ast& ast, bool reverse) noexcept : ast_{&ast}, reverse_{reverse} {}
+
+    // @throws RegexError if the program would be too large
+    constexpr Program compile() {
+        // .*? before the pattern: a match may start at any later byte, and
+        // an earlier start has priority over a later one
+        program_.unanchored = emit(Op::split);
+        ByteSet any;
+        any.invert();
+        emit_bytes(any);
+        insts()[0].x = 2;
+        insts()[0].y = 1;
+        insts()[1].x = 0;
+
+        program_.anchored = 2;
+        if (!reverse_) {
+            emit_save(0);
+        }
+        node(ast_->root);
+        if (!reverse_) {
+            emit_save(1);
+        }
+        emit(Op::match);
+        program_.slots = 2 * ast_->groups;
+        program_.begins_with_caret = !reverse_ && begins_with_caret(ast_->root);
+        return std::move(program_);
+    }
+
+private:
+    constexpr std::vector<Inst>& insts() noexcept { return program_.insts; }
+    [[nodiscard]] constexpr int next_pc() const noexcept {
+        return static_cast<int>(program_.insts.size());
+    }
+
+    // An instruction that falls through to the next one
+    constexpr int emit(Op op) {
+        if (program_.insts.size() >= max_insts) {
+            throw RegexError{"pattern too large", 0};
+        }
+        Inst inst;
+        inst.op = op;
+        inst.x = next_pc() + 1;
+        program_.insts.push_back(inst);
+        return next_pc() - 1;
+    }
+
+    constexpr void emit_bytes(const ByteSet& bytes) {
+        const int pc = emit(Op::byte_set);
+        insts()[static_cast<std::size_t>(pc)].bytes = bytes;
+    }
+
+    constexpr void emit_save(int slot) {
+        const int pc = emit(Op::save);
+        insts()[static_cast<std::size_t>(pc)].y = slot;
+    }
+
+    constexpr void set_split(int pc, int body, int exit, bool greedy) {
+        Inst& inst = insts()[static_cast<std::size_t>(pc)];
+        inst.x = greedy ? body : exit;
+        inst.y = greedy ? exit : body;
+    }
+
+    [[nodiscard]] constexpr const Node& at(int index) const noexcept {
+        return ast_->nodes[static_cast<std::size_t>(index)];
+    }
+
+    constexpr void node(int index) {
+        const Node& n = at(index);
+        switch (n.kind) {
+        case NodeKind::empty:
+            break;
+        case NodeKind::bytes:
+            emit_bytes(n.bytes);
+            break;
+        case NodeKind::concat:
+            if (reverse_) {
+                for (auto it = n.children.rbegin(); it != n.children.rend(); ++it) {
+                    node(*it);
+                }
+            } else {
+                for (const int child : n.children) {
+                    node(child);
+                }
+            }
+            break;
+        case NodeKind::alternate:
+            alternate(n);
+            break;
+        case NodeKind::repeat:
+            repeat(n);
+            break;
+        case NodeKind::group:
+            if (n.group >= 0 && !reverse_) {
+                emit_save(2 * n.group);
+                node(n.children.front());
+                emit_save(2 * n.group + 1);
+            } else {
+                node(n.children.front());
+            }
+            break;
+        case NodeKind::begin:
+            emit(reverse_ ? Op::assert_finish : Op::assert_start);
+            break;
+        case NodeKind::end:
+            emit(reverse_ ? Op::assert_start : Op::assert_finish);
+            break;
+        }
+    }
+
+    // split L1, next; L1: a; jump end; next: split L2, next; ... last; end:
+    constexpr void alternate(const Node& n) {
+        std::vector<int> jumps;
+        for (std::size_t i = 0; i + 1 < n.children.size(); ++i) {
+            const int split = emit(Op::split);
+            node(n.children[i]);
+            jumps.push_back(emit(Op::jump));
+            set_split(split, split + 1, next_pc(), true);
+        }
+        node(n.children.back());
+        for (const int jump : jumps) {
+            insts()[static_cast<std::size_t>(jump)].x = next_pc();
+        }
+    }
+
+    constexpr void repeat(const Node& n) {
+        const int child = n.children.front();
+        if (n.max < 0 && n.min == 0) {
+            // loop: split body, exit; body; jump loop
+            const int split = emit(Op::split);
+            node(child);
+            const int jump = emit(Op::jump);
+            insts()[static_cast<std::size_t>(jump)].x = split;
+            set_split(split, split + 1, next_pc(), n.greedy);
+        } else if (n.max < 0) {
+            // m - 1 copies, then body; split body, exit
+            for (int i = 1; i < n.min; ++i) {
+                node(child);
+            }
+            const int body = next_pc();
+            node(child);
+            const int split = emit(Op::split);
+            set_split(split, body, split + 1, n.greedy);
+        } else {
+            // m copies, then n - m optional ones that all exit to the end
+            for (int i = 0; i < n.min; ++i) {
+                node(child);
+            }
+            std::vector<int> splits;
+            for (int i = n.min; i < n.max; ++i) {
+                splits.push_back(emit(Op::split));
+                node(child);
+            }
+            for (const int split : splits) {
+                set_split(split, split + 1, next_pc(), n.greedy);
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr bool begins_with_caret(int index) const noexcept {
+        const Node& n = at(index);
+        switch (n.kind) {
+        case NodeKind::begin:
+            return true;
+        case NodeKind::concat:
+        case NodeKind::group:
+            return begins_with_caret(n.children.front());
+        case NodeKind::alternate:
+            return std::all_of(n.children.begin(), n.children.end(),
+                               [this](int child) { return begins_with_caret(child); });
+        case NodeKind::empty:
+        case NodeKind::bytes:
+        case NodeKind::repeat:
+        case NodeKind::end:
+            return false;
+        }
+        return false;
+    }
+
+    const Ast* ast_;
+    bool reverse_;
+    Program program_;
+};
+
+// The forward or reverse program for a pattern
+// @throws RegexError if the pattern is malformed, unsupported or too large
+[[nodiscard]] constexpr Program compile(const Ast& ast, bool reverse) {
+    return Compiler{ast, reverse}.compile();
+}
+
+// =============================================================================
+// DFA
+// =============================================================================
+
+/**
+ * Bytes that no instruction tells apart, such as all the letters in a
+ * pattern that only uses \d, share a column of the DFA table. A pattern
+ * of a few classes has rows of a few entries rather than 256.
+ */
+struct ByteClasses {
+    std::array<std::uint8_t, 256> of{};     // the class of each byte
+    std::array<std::uint8_t, 256> first{};  // a byte of each class
+    std::size_t count = 0;
+};
+
+[[nodiscard]] constexpr ByteClasses byte_classes(const Program& program) noexcept {
+    std::array<bool, 256> boundary{};
+    for (const Inst& inst : program.insts) {
+        if (inst.op != Op::byte_set) {
+            continue;
+        }
+        for (unsigned b = 1; b < 256; ++b) {
+            if (inst.bytes.contains(static_cast<unsigned char>(b)) !=
+                inst.bytes.contains(static_cast<unsigned char>(b - 1))) {
+                boundary[b] = true;
+            }
+        }
+    }
+    ByteClasses classes;
+    std::size_t current = 0;
+    for (std::size_t b = 0; b < 256; ++b) {
+        if (b > 0 && boundary[b]) {
+            ++current;
+            classes.first[current] = static_cast<std::uint8_t>(b);
+        }
+        classes.of[b] = static_cast<std::uint8_t>(current);
+    }
+    classes.count = current + 1;
+    return classes;
+}
+
+/**
+ * A DFA for a program, built a state at a time as runs need them.
+ *
+ * A state is the list of NFA threads alive after some text: their
+ * byte-consuming instructions, in priority order. Its row holds, per byte
+ * class, the state after that byte, as the offset of its row with bit 0
+ * set if that state matches; unknown until first needed, and dead when no
+ * thread survives. One more entry says whether the state matches at the
+ * end of the text, where '$' holds.
+ *
+ * Leftmost-first (longest false): when a thread reaches the match, the
+ * threads after it have lower priority than a match already found and
+ * are dropped. The last match a run sees is the one a backtracking
+ * matcher would report. Longest: every thread is kept, and the last match
+ * seen is the longest; used for the reverse program.
+ *
+ * The table is capped at max_bytes, or four states if that is more. A run
+ * that needs more clears the table and carries on building from the
+ * current state, so memory stays bounded and the time per byte stays
+ * linear, if slower.
+ */
+class Dfa {
+public:
+    static constexpr std::int32_t unknown = -1;
+    static constexpr std::int32_t dead = -2;
+
+    constexpr Dfa(const Program& program, bool longest, std::size_t max_bytes)
+        : program_{&program},
+          classes_{byte_classes(program)},
+          stride_{(classes_.count + 2) & ~std::size_t{1}},
+          max_states_{std::max(max_bytes / (stride_ * sizeof(std::int32_t)), std::size_t{4})},
+          longest_{longest},
+          marks_(program.insts.size(), 0) {
+        clear();
+    }
+
+    // The start state for a run from text that is or is not the start of
+    // the text, for a match at the run's start (anchored) or anywhere
+    constexpr std::int32_t start(bool anchored, bool at_start) {
+        std::int32_t& state = starts_[(anchored ? 2u : 0u) + (at_start ? 1u : 0u)];
+        if (state == unknown) {
+            next_.clear();
+            next_generation();
+            add_threads(next_, anchored ? program_->anchored : program_->unanchored, at_start);
+            if (states() >= max_states_) {
+                clear();
+            }
+            state = find_or_add(next_);
+        }
+        return state;
+    }
+
+    // The state after a byte of class cls from the state at offset state;
+    // fills in that entry of the table
+    constexpr std::int32_t transition(std::int32_t state, std::size_t cls) {
+        const auto row = static_cast<std::size_t>(state);
+        const auto number = row / stride_;
+        const auto byte = classes_.first[cls];
+        next_.clear();
+        next_generation();
+        for (std::size_t i = list_starts_[number]; i < list_starts_[number + 1]; ++i) {
+            const Inst& inst = program_->insts[static_cast<std::size_t>(lists_[i])];
+            if (inst.op == Op::byte_set && inst.bytes.contains(byte) &&
+                add_threads(next_, inst.x, false)) {
+                break;
+            }
+        }
+        bool flushed = false;
+        if (!next_.empty() && states() >= max_states_) {
+            clear();
+            flushed = true;
+        }
+        const std::int32_t target = find_or_add(next_);
+        if (!flushed) {
+            table_[row + cls] = target;
+        }
+        return target;
+    }
+
+    /**
+     * Builds every state reachable from the start states, or stops once
+     * there are limit states; true if the table is complete. A complete
+     * table is never written again. limit must be below the cap.
+     */
+    constexpr bool build(std::size_t limit, bool unanchored) {
+        for (const bool at_start : {false, true}) {
+            start(true, at_start);
+            if (unanchored) {
+                start(false, at_start);
+            }
+        }
+        for (std::size_t number = 0; number < states(); ++number) {
+            for (std::size_t cls = 0; cls < classes_.count; ++cls) {
+                if (table_[number * stride_ + cls] != unknown) {
+                    continue;
+                }
+                if (states() >= limit) {
+                    return false;
+                }
+                transition(static_cast<std::int32_t>(number * stride_), cls);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Adds to out the bytes that a match starting after the start of the
+     * text can begin with; false if such a match can be empty. A search
+     * can skip straight to the next of those bytes.
+     */
+    constexpr bool first_bytes(ByteSet& out) {
+        next_.clear();
+        next_generation();
+        add_threads(next_, program_->anchored, false);
+        for (const int pc : next_) {
+            const Inst& inst = program_->insts[static_cast<std::size_t>(pc)];
+            if (inst.op == Op::match) {
+                return false;
+            }
+            if (inst.op == Op::byte_set) {
+                out.add(inst.bytes);
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] constexpr const std::int32_t* rows() const noexcept { return table_.data(); }
+    [[nodiscard]] constexpr const std::vector<std::int32_t>& table() const noexcept {
+        return table_;
+    }
+    [[nodiscard]] constexpr const ByteClasses& classes() const noexcept { return classes_; }
+    [[nodiscard]] constexpr std::size_t stride() const noexcept { return stride_; }
+    [[nodiscard]] constexpr std::size_t states() const noexcept { return list_starts_.size() - 1; }
+    [[nodiscard]] constexpr const std::array<std::int32_t, 4>& starts() const noexcept {
+        return starts_;
+    }
+    // Times the table was cleared because it was full
+    [[nodiscard]] constexpr std::size_t flushes() const noexcept { return flushes_; }
+
+private:
+    constexpr void clear() {
+        if (!list_starts_.empty()) {
+            ++flushes_;
+        }
+        lists_.clear();
+        list_starts_.assign(1, 0);
+        table_.clear();
+        matches_.clear();
+        index_.assign(64, -1);
+        starts_.fill(unknown);
+    }
+
+    // marks_[pc] == generation_ if pc was visited in the current pass
+    constexpr void next_generation() {
+        if (++generation_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    /**
+     * Appends to list the threads that pc leads to without consuming a
+     * byte, in priority order, skipping those already in it. Returns true
+     * if a thread reached the match and, leftmost-first, the threads
+     * still to come were dropped.
+     */
+    constexpr bool add_threads(std::vector<int>& list, int pc, bool at_start) {
+        stack_.clear();
+        stack_.push_back(pc);
+        while (!stack_.empty()) {
+            const int at = stack_.back();
+            stack_.pop_back();
+            auto& mark = marks_[static_cast<std::size_t>(at)];
+            if (mark == generation_) {
+                continue;
+            }
+            mark = generation_;
+            const Inst& inst = program_->insts[static_cast<std::size_t>(at)];
+            switch (inst.op) {
+            case Op::split:
+                stack_.push_back(inst.y);
+                stack_.push_back(inst.x);
+                break;
+            case Op::jump:
+            case Op::save:
+                stack_.push_back(inst.x);
+                break;
+            case Op::assert_start:
+                if (at_start) {
+                    stack_.push_back(inst.x);
+                }
+                break;
+            case Op::byte_set:
+            case Op::assert_finish:
+                list.push_back(at);
+                break;
+            case Op::match:
+                list.push_back(at);
+                if (!longest_) {
+                    return true;
+                }
+                break;
+            }
+        }
+        return false;
+    }
+
+    // Whether the threads waiting at a '$' reach the match when it holds
+    constexpr bool matches_at_finish(std::size_t begin, std::size_t end) {
+        next_generation();
+        for (std::size_t i = begin; i < end; ++i) {
+            const Inst& inst = program_->insts[static_cast<std::size_t>(lists_[i])];
+            if (inst.op == Op::match) {
+                return true;
+            }
+            if (inst.op != Op::assert_finish) {
+                continue;
+            }
+            stack_.clear();
+            stack_.push_back(inst.x);
+            while (!stack_.empty()) {
+                const int at = stack_.back();
+                stack_.pop_back();
+                auto& mark = marks_[static_cast<std::size_t>(at)];
+                if (mark == generation_) {
+                    continue;
+                }
+                mark = generation_;
+                const Inst& next = program_->insts[static_cast<std::size_t>(at)];
+                switch (next.op) {
+                case Op::match:
+                    return true;
+                case Op::split:
+                    stack_.push_back(next.y);
+                    stack_.push_back(next.x);
+                    break;
+                case Op::jump:
+                case Op::save:
+                case Op::assert_finish:
+                    stack_.push_back(next.x);
+                    break;
+                case Op::byte_set:
+                case Op::assert_start:
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] static constexpr std::uint32_t hash(const int* list, std::size_t size) noexcept {
+        std::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i) {
+            h = (h ^ static_cast<std::uint32_t>(list[i])) * 16777619u;
+        }
+        return h;
+    }
+
+    constexpr void insert(std::size_t number) {
+        const std::size_t mask = index_.size() - 1;
+        const std::size_t begin = list_starts_[number];
+        std::size_t slot = hash(lists_.data() + begin, list_starts_[number + 1] - begin) & mask;
+        while (index_[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = static_cast<std::int32_t>(number);
+    }
+
+    // The state for a thread list, as an offset with the match bit
+    constexpr std::int32_t find_or_add(std::vector<int>& list) {
+        if (list.empty()) {
+            return dead;
+        }
+        if (longest_) {
+            // Order does not matter, so equal sets are one state
+            std::sort(list.begin(), list.end());
+        }
+        const std::size_t mask = index_.size() - 1;
+        for (std::size_t slot = hash(list.data(), list.size()) & mask; index_[slot] >= 0;
+             slot = (slot + 1) & mask) {
+            const auto number = static_cast<std::size_t>(index_[slot]);
+            const auto begin = lists_.begin() + static_cast<std::ptrdiff_t>(list_starts_[number]);
+            const auto end = lists_.begin() + static_cast<std::ptrdiff_t>(list_starts_[number + 1]);
+            if (std::equal(begin, end, list.begin(), list.end())) {
+                return offset(number);
+            }
+        }
+
+        const std::size_t number = states();
+        const std::size_t begin = lists_.size();
+        lists_.insert(lists_.end(), list.begin(), list.end());
+        list_starts_.push_back(lists_.size());
+        const bool match = std::any_of(list.begin(), list.end(), [this](int pc) {
+            return program_->insts[static_cast<std::size_t>(pc)].op == Op::match;
+        });
+        matches_.push_back(match);
+        table_.resize(table_.size() + stride_, unknown);
+        table_[number * stride_ + classes_.count] = matches_at_finish(begin, lists_.size()) ? 1 : 0;
+
+        if (2 * states() > index_.size()) {
+            index_.assign(2 * index_.size(), -1);
+            for (std::size_t k = 0; k < states(); ++k) {
+                insert(k);
+            }
+        } else {
+            insert(number);
+        }
+        return offset(number);
+    }
+
+    [[nodiscard]] constexpr std::int32_t offset(std::size_t number) const noexcept {
+        return static_cast<std::int32_t>(number * stride_) | (matches_[number] ? 1 : 0);
+    }
+
+    const Program* program_;
+    ByteClasses classes_;
+    std::size_t stride_;
+    std::size_t max_states_;
+    bool longest_;
+
+    std::vector<std::int32_t> table_;        // stride_ entries per state
+    std::vector<int> lists_;                 // every state's threads, one after another
+    std::vector<std::size_t> list_starts_;   // where each state's threads begin in lists_
+    std::vector<bool> matches_;              // whether each state contains the match
+    std::vector<std::int32_t> index_;        // open-addressed hash of thread list to state
+    std::array<std::int32_t, 4> starts_{};
+    std::size_t flushes_ = 0;
+
+    std::vector<int> next_;
+    std::vector<int> stack_;
+    std::vector<std::uint32_t> marks_;
+    std::uint32_t generation_ = 0;
+};
+
+} // namespace detail
+
+} // namespace text
+
+#endif // TEXT_REGEX_PROGRAM_H
@@ -0,0 +1,327 @@
+#ifndef TEXT_SCAN_H
+#define TEXT_SCAN_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Text is scanned 32 bytes at a time: with one AVX2 compare, or two SSE2
+// compares, which every x86-64 has. Define TEXT_NO_SIMD to compare against
+// the portable loop.
+#if !defined(TEXT_NO_SIMD) && defined(__AVX2__)
+#define TEXT_AVX2 1
+#include <immintrin.h>
+#else
+#define TEXT_AVX2 0
+#endif
+
+#if !defined(TEXT_NO_SIMD) && !TEXT_AVX2 && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TEXT_SSE2 1
+#include <emmintrin.h>
+#else
+#define TEXT_SSE2 0
+#endif
+
+namespace text {
+
+/**
+ * A set of characters, such as the delimiters " \t,;".
+ *
+ * Any set answers contains() from a 256-bit table. Sets of up to
+ * simd_limit characters are also searched with one vector compare per
+ * member, 32 bytes at a time; larger ones fall back to the table, a byte
+ * at a time.
+ */
+class CharSet {
+public:
+    static constexpr std::size_t simd_limit = 8;
+
+    constexpr CharSet() noexcept = default;
+
+    constexpr explicit CharSet(std::string_view chars) noexcept {
+        for (const char c : chars) {
+            if (contains(c)) {
+                continue;
+            }
+            const auto byte = static_cast<unsigned char>(c);
+            table_[byte / 64] |= std::uint64_t{1} << (byte % 64);
+            if (size_ < simd_limit) {
+                members_[size_] = c;
+            }
+            ++size_;
+        }
+    }
+
+    [[nodiscard]] constexpr bool contains(char c) const noexcept {
+        const auto byte = static_cast<unsigned char>(c);
+        return ((table_[byte / 64] >> (byte % 64)) & 1u) != 0;
+    }
+
+    // Distinct characters in the set
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+    // The members, in first-seen order, if there are at most simd_limit
+    [[nodiscard]] constexpr std::string_view members() const noexcept {
+        return size_ <= simd_limit ? std::string_view{members_.data(), size_} : std::string_view{};
+    }
+
+private:
+    std::array<std::uint64_t, 4> table_{};
+    std::array<char, simd_limit> members_{};
+    std::size_t size_ = 0;
+};
+
+// The set of the characters in chars: split(line, any_of(" \t"))
+[[nodiscard]] constexpr CharSet any_of(std::string_view chars) noexcept {
+    return CharSet{chars};
+}
+
+// =============================================================================
+// 32-byte blocks
+// =============================================================================
+//
+// The few operations the kernels need, on 32 bytes at a time: one AVX2
+// register, or two SSE2 registers. Kernels are written once against these
+// and fall back to loops over single bytes when TEXT_SIMD is 0.
+
+#define TEXT_SIMD (TEXT_AVX2 || TEXT_SSE2)
+
+namespace detail {
+
+inline constexpr std::size_t block_size = 32;
+
+#if TEXT_AVX2
+struct Bytes32 {
+    __m256i v;
+};
+
+[[nodiscard]] inline Bytes32 load(const char* p) noexcept {
+    return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+}
+inline void store(char* p, Bytes32 b) noexcept {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), b.v);
+}
+[[nodiscard]] inline Bytes32 splat(char c) noexcept { return {_mm256_set1_epi8(c)}; }
+[[nodiscard]] inline Bytes32 equal(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm256_cmpeq_epi8(a.v, b.v)};
+}
+// Signed byte comparison a < b
+[[nodiscard]] inline Bytes32 less(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm256_cmpgt_epi8(b.v, a.v)};
+}
+[[nodiscard]] inline Bytes32 add(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm256_add_epi8(a.v, b.v)};
+}
+[[nodiscard]] inline Bytes32 operator&(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm256_and_si256(a.v, b.v)};
+}
+[[nodiscard]] inline Bytes32 operator|(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm256_or_si256(a.v, b.v)};
+}
+[[nodiscard]] inline Bytes32 operator^(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm256_xor_si256(a.v, b.v)};
+}
+// Bit i is the top bit of byte i: set where a comparison held
+[[nodiscard]] inline std::uint32_t mask(Bytes32 b) noexcept {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(b.v));
+}
+#elif TEXT_SSE2
+struct Bytes32 {
+    __m128i lo;
+    __m128i hi;
+};
+
+[[nodiscard]] inline Bytes32 load(const char* p) noexcept {
+    return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16))};
+}
+inline void store(char* p, Bytes32 b) noexcept {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), b.lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16), b.hi);
+}
+[[nodiscard]] inline Bytes32 splat(char c) noexcept {
+    return {_mm_set1_epi8(c), _mm_set1_epi8(c)};
+}
+[[nodiscard]] inline Bytes32 equal(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm_cmpeq_epi8(a.lo, b.lo), _mm_cmpeq_epi8(a.hi, b.hi)};
+}
+[[nodiscard]] inline Bytes32 less(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm_cmplt_epi8(a.lo, b.lo), _mm_cmplt_epi8(a.hi, b.hi)};
+}
+[[nodiscard]] inline Bytes32 add(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm_add_epi8(a.lo, b.lo), _mm_add_epi8(a.hi, b.hi)};
+}
+[[nodiscard]] inline Bytes32 operator&(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi)};
+}
+[[nodiscard]] inline Bytes32 operator|(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm_or_si128(a.lo, b.lo), _mm_or_si128(a.hi, b.hi)};
+}
+[[nodiscard]] inline Bytes32 operator^(Bytes32 a, Bytes32 b) noexcept {
+    return {_mm_xor_si128(a.lo, b.lo), _mm_xor_si128(a.hi, b.hi)};
+}
+[[nodiscard]] inline std::uint32_t mask(Bytes32 b) noexcept {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(b.lo)) |
+           (static_cast<std::uint32_t>(_mm_movemask_epi8(b.hi)) << 16);
+}
+#endif
+
+// Bit i set if p[i] == c, for the 32 bytes at p
+[[nodiscard]] inline std::uint32_t equal_mask(const char* p, char c) noexcept {
+#if TEXT_SIMD
+    return mask(equal(load(p), splat(c)));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < block_size; ++i) {
+        mask |= (p[i] == c ? 1u : 0u) << i;
+    }
+    return mask;
+#endif
+}
+
+} // namespace detail
+
+// =============================================================================
+// Matchers: which bytes of a block are wanted
+// =============================================================================
+//
+// mask(p) has bit i set if p[i] is wanted, for the 32 bytes at p; test(c)
+// says the same of a single byte, for the last, partial block.
+
+// Bytes equal to one character
+class ByteMatcher {
+public:
+    constexpr ByteMatcher() noexcept = default;
+    constexpr explicit ByteMatcher(char c) noexcept : c_{c} {}
+
+    [[nodiscard]] std::uint32_t mask(const char* p) const noexcept {
+        return detail::equal_mask(p, c_);
+    }
+    [[nodiscard]] constexpr bool test(char c) const noexcept { return c == c_; }
+
+private:
+    char c_ = '\0';
+};
+
+// Bytes in a CharSet; the set must outlive the matcher
+class CharSetMatcher {
+public:
+    constexpr CharSetMatcher() noexcept = default;
+    constexpr explicit CharSetMatcher(const CharSet& set) noexcept : set_{&set} {}
+
+    [[nodiscard]] std::uint32_t mask(const char* p) const noexcept {
+        const std::string_view members = set_->members();
+        if (members.empty() && !set_->empty()) {
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < detail::block_size; ++i) {
+                mask |= (set_->contains(p[i]) ? 1u : 0u) << i;
+            }
+            return mask;
+        }
+        std::uint32_t mask = 0;
+        for (const char c : members) {
+            mask |= detail::equal_mask(p, c);
+        }
+        return mask;
+    }
+    [[nodiscard]] constexpr bool test(char c) const noexcept { return set_->contains(c); }
+
+private:
+    const CharSet* set_ = nullptr;
+};
+
+/**
+ * The positions in a text where a matcher matches, in order.
+ *
+ *     Scanner scanner{text, ByteMatcher{','}};
+ *     for (auto i = scanner.next(0); i != text.size(); i = scanner.next(i + 1)) { ... }
+ *
+ * A call to std::string_view::find or memchr per delimiter starts over at
+ * every field, and for short fields pays its setup cost per field. A
+ * Scanner compares a block of 32 bytes once, keeps the bit mask of the
+ * matches in it, and hands them out one by one, so a line of short CSV
+ * fields costs one compare per 32 bytes rather than per field.
+ */
+template <typename Matcher>
+class Scanner {
+public:
+    Scanner() = default;
+
+    Scanner(std::string_view text, Matcher matcher) noexcept
+        : text_{text}, matcher_{matcher} {}
+
+    /**
+     * The first match at or after pos, or size() if there is none.
+     * Calls must not go backwards: pos is at least the previous pos.
+     */
+    [[nodiscard]] std::size_t next(std::size_t pos) noexcept {
+        if (pos >= block_ + detail::block_size || !loaded_) {
+            load(pos);
+        } else {
+            // Drop the matches before pos in the current block
+            mask_ &= ~std::uint32_t{0} << (pos - block_);
+        }
+        while (mask_ == 0) {
+            if (block_ + detail::block_size >= text_.size()) {
+                return text_.size();
+            }
+            load(block_ + detail::block_size);
+        }
+        return block_ + static_cast<std::size_t>(std::countr_zero(mask_));
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return text_.size(); }
+
+private:
+    // The mask of the block starting at pos. A last, partial block is the
+    // last 32 bytes of the text, with the bits before pos dropped, or, in a
+    // text shorter than a block, is tested a byte at a time, so nothing is
+    // read past the end
+    void load(std::size_t pos) noexcept {
+        loaded_ = true;
+        block_ = pos;
+        if (pos >= text_.size()) {
+            mask_ = 0;
+        } else if (text_.size() - pos >= detail::block_size) {
+            mask_ = matcher_.mask(text_.data() + pos);
+        } else if (text_.size() >= detail::block_size) {
+            block_ = text_.size() - detail::block_size;
+            mask_ = matcher_.mask(text_.data() + block_) & (~std::uint32_t{0} << (pos - block_));
+        } else {
+            mask_ = 0;
+            for (std::size_t i = 0; pos + i < text_.size(); ++i) {
+                mask_ |= (matcher_.test(text_[pos + i]) ? 1u : 0u) << i;
+            }
+        }
+    }
+
+    std::string_view text_;
+    Matcher matcher_;
+    std::size_t block_ = 0;
+    std::uint32_t mask_ = 0;
+    bool loaded_ = false;
+};
+
+// The first c at or after pos, or npos; std::string_view::find, vectorized
+[[nodiscard]] inline std::size_t find_byte(std::string_view s, char c,
+                                           std::size_t pos = 0) noexcept {
+    Scanner scanner{s, ByteMatcher{c}};
+    const auto i = scanner.next(pos);
+    return i < s.size() ? i : std::string_view::npos;
+}
+
+// The first member of set at or after pos, or npos; find_first_of, vectorized
+[[nodiscard]] inline std::size_t find_any(std::string_view s, const CharSet& set,
+                                          std::size_t pos = 0) noexcept {
+    Scanner scanner{s, CharSetMatcher{set}};
+    const auto i = scanner.next(pos);
+    return i < s.size() ? i : std::string_view::npos;
+}
+
+} // namespace text
+
+#endif // TEXT_SCAN_H
@@ -0,0 +1,416 @@
+#ifndef SHARED_STRING_H
+#define SHARED_STRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace text {
+
+// The hash of a SharedString, and of a plain string_view looked up among
+// them. Never 0, which marks a hash that has not been computed yet.
+[[nodiscard]] inline std::size_t hash_text(std::string_view s) noexcept {
+    const std::size_t h = std::hash<std::string_view>{}(s);
+    return h == 0 ? 1 : h;
+}
+
+class StringArena;
+
+/**
+ * An immutable string that is cheap to copy, slice and hash.
+ *
+ *     SharedString line{read_line()};           // one copy of the text
+ *     SharedString name = line.substr(5, 40);   // shares line's buffer
+ *     counts[name]++;                           // hashed once, then cached
+ *
+ * std::string copies its text whenever it is passed or returned by value,
+ * and so does every substr(). A SharedString never changes, so copies can
+ * share one buffer instead:
+ *
+ *   - Up to inline_capacity (32) characters are stored in the object
+ *     itself, as with std::string's short-string buffer, but twice as many.
+ *   - Longer text lives in a heap buffer with an atomic reference count.
+ *     Copying adds a reference, and substr() returns a string that points
+ *     into the same buffer: O(1), whatever the length.
+ *   - The hash is computed on first use and stored in the object. Copies
+ *     carry it along, so a string hashed once is never hashed again on its
+ *     way through a pipeline of hash tables.
+ *   - A StringArena can hold the text instead of the heap. Strings from an
+ *     arena are not reference counted at all, and must not outlive it.
+ *
+ * Copies may be used and destroyed on different threads. Any slice of a
+ * long string keeps the whole buffer alive; to let it go, copy the slice
+ * into a fresh string with SharedString{slice.view()}.
+ */
+class SharedString {
+public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+
+    static constexpr size_type inline_capacity = 32;
+    static constexpr size_type npos = std::string_view::npos;
+
+    // =========================================================================
+    // Construction
+    // =========================================================================
+
+    SharedString() noexcept : size_{0} {}
+
+    // Copies the text: into the object, or into a new shared buffer
+    explicit SharedString(std::string_view s) : size_{s.size()} {
+        if (is_inline()) {
+            std::memcpy(inline_, s.data(), s.size());
+            return;
+        }
+        Block* block = Block::allocate(s.size());
+        std::memcpy(block->chars(), s.data(), s.size());
+        heap_ = {block, block->chars()};
+    }
+
+    explicit SharedString(const char* s) : SharedString(std::string_view{s}) {}
+    explicit SharedString(const std::string& s) : SharedString(std::string_view{s}) {}
+
+    /**
+     * Refers to text that outlives every copy, such as a string literal,
+     * without copying it or counting references.
+     */
+    [[nodiscard]] static SharedString borrow(std::string_view s) noexcept {
+        SharedString out;
+        out.assign_borrowed(s);
+        return out;
+    }
+
+    SharedString(const SharedString& other) noexcept
+        : size_{other.size_}, hash_{other.hash_.load(std::memory_order_relaxed)} {
+        if (is_inline()) {
+            std::memcpy(inline_, other.inline_, size_);
+        } else {
+            heap_ = other.heap_;
+            if (heap_.block != nullptr) {
+                heap_.block->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    SharedString(SharedString&& other) noexcept
+        : size_{other.size_}, hash_{other.hash_.load(std::memory_order_relaxed)} {
+        if (is_inline()) {
+            std::memcpy(inline_, other.inline_, size_);
+        } else {
+            heap_ = other.heap_;
+        }
+        other.size_ = 0;
+        other.hash_.store(0, std::memory_order_relaxed);
+    }
+
+    SharedString& operator=(const SharedString& other) noexcept {
+        SharedString copy{other};
+        swap(copy);
+        return *this;
+    }
+
+    SharedString& operator=(SharedString&& other) noexcept {
+        SharedString moved{std::move(other)};
+        swap(moved);
+        return *this;
+    }
+
+    ~SharedString() { release(); }
+
+    void swap(SharedString& other) noexcept {
+        // Both layouts are trivially copyable, so the raw bytes can be swapped
+        std::swap(size_, other.size_);
+        unsigned char tmp[sizeof storage_];
+        std::memcpy(tmp, storage_, sizeof storage_);
+        std::memcpy(storage_, other.storage_, sizeof storage_);
+        std::memcpy(other.storage_, tmp, sizeof storage_);
+        const auto h = hash_.load(std::memory_order_relaxed);
+        hash_.store(other.hash_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.hash_.store(h, std::memory_order_relaxed);
+    }
+
+    friend void swap(SharedString& a, SharedString& b) noexcept { a.swap(b); }
+
+    // =========================================================================
+    // Access
+    // =========================================================================
+
+    [[nodiscard]] const char* data() const noexcept {
+        return is_inline() ? inline_ : heap_.data;
+    }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] size_type length() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return data(); }
+    [[nodiscard]] const_iterator end() const noexcept { return data() + size_; }
+
+    [[nodiscard]] char operator[](size_type i) const noexcept { return data()[i]; }
+    [[nodiscard]] char front() const noexcept { return data()[0]; }
+    [[nodiscard]] char back() const noexcept { return data()[size_ - 1]; }
+
+    [[nodiscard]] std::string_view view() const noexcept { return {data(), size_}; }
+    operator std::string_view() const noexcept { return view(); }
+    [[nodiscard]] std::string str() const { return std::string{view()}; }
+
+    /**
+     * Characters [pos, pos + n), clamped to the end, like std::string's.
+     * A short result is copied into the new object; a long one shares
+     * this string's buffer.
+     * @throws std::out_of_range if pos > size()
+     */
+    [[nodiscard]] SharedString substr(size_type pos = 0, size_type n = npos) const {
+        if (pos > size_) {
+            throw std::out_of_range{"SharedString::substr: position past the end"};
+        }
+        const size_type count = std::min(n, size_ - pos);
+        if (count == size_) {
+            return *this;
+        }
+        if (count <= inline_capacity) {
+            return SharedString{view().substr(pos, count)};
+        }
+        SharedString out;
+        out.size_ = count;
+        out.heap_ = {heap_.block, heap_.data + pos};
+        if (heap_.block != nullptr) {
+            heap_.block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return out;
+    }
+
+    [[nodiscard]] bool starts_with(std::string_view prefix) const noexcept {
+        return view().starts_with(prefix);
+    }
+    [[nodiscard]] bool ends_with(std::string_view suffix) const noexcept {
+        return view().ends_with(suffix);
+    }
+    [[nodiscard]] size_type find(std::string_view s, size_type pos = 0) const noexcept {
+        return view().find(s, pos);
+    }
+    [[nodiscard]] size_type find(char c, size_type pos = 0) const noexcept {
+        return view().find(c, pos);
+    }
+
+    /**
+     * hash_text(view()), computed the first time it is asked for and then
+     * kept. Racing first calls on one object compute the same value.
+     */
+    [[nodiscard]] std::size_t hash() const noexcept {
+        std::size_t h = hash_.load(std::memory_order_relaxed);
+        if (h == 0) {
+            h = hash_text(view());
+            hash_.store(h, std::memory_order_relaxed);
+        }
+        return h;
+    }
+
+    // Strings sharing this one's buffer, itself included; 0 for text held
+    // inline, borrowed or in an arena
+    [[nodiscard]] long use_count() const noexcept {
+        if (is_inline() || heap_.block == nullptr) {
+            return 0;
+        }
+        return heap_.block->refs.load(std::memory_order_relaxed);
+    }
+
+    // =========================================================================
+    // Comparison
+    // =========================================================================
+
+    // Known hashes that differ settle inequality without reading the text
+    friend bool operator==(const SharedString& a, const SharedString& b) noexcept {
+        if (a.size_ != b.size_) {
+            return false;
+        }
+        const auto ha = a.hash_.load(std::memory_order_relaxed);
+        const auto hb = b.hash_.load(std::memory_order_relaxed);
+        if (ha != 0 && hb != 0 && ha != hb) {
+            return false;
+        }
+        return a.data() == b.data() || std::memcmp(a.data(), b.data(), a.size_) == 0;
+    }
+
+    friend bool operator==(const SharedString& a, std::string_view b) noexcept {
+        return a.view() == b;
+    }
+
+    friend std::strong_ordering operator<=>(const SharedString& a,
+                                            const SharedString& b) noexcept {
+        return a.view() <=> b.view();
+    }
+
+    friend std::strong_ordering operator<=>(const SharedString& a, std::string_view b) noexcept {
+        return a.view() <=> b;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const SharedString& s) {
+        return out << s.view();
+    }
+
+private:
+    friend class StringArena;
+
+    // A shared buffer: the count, then the characters
+    struct Block {
+        std::atomic<std::uint32_t> refs{1};
+
+        [[nodiscard]] char* chars() noexcept { return reinterpret_cast<char*>(this + 1); }
+
+        [[nodiscard]] static Block* allocate(size_type n) {
+            if (n > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error{"SharedString: text longer than 4 GiB"};
+            }
+            return ::new (::operator new(sizeof(Block) + n)) Block{};
+        }
+    };
+
+    struct Heap {
+        Block* block;      // nullptr when the text is borrowed
+        const char* data;
+    };
+
+    [[nodiscard]] bool is_inline() const noexcept { return size_ <= inline_capacity; }
+
+    // Long text is referred to; short text is still copied in
+    void assign_borrowed(std::string_view s) noexcept {
+        size_ = s.size();
+        if (is_inline()) {
+            std::memcpy(inline_, s.data(), s.size());
+        } else {
+            heap_ = {nullptr, s.data()};
+        }
+    }
+
+    void release() noexcept {
+        if (!is_inline() && heap_.block != nullptr &&
+            heap_.block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ::operator delete(heap_.block);
+        }
+    }
+
+    union {
+        char inline_[inline_capacity];
+        Heap heap_;
+        unsigned char storage_[inline_capacity]{};  // zeroed: no indeterminate bytes to copy
+    };
+    size_type size_;
+    mutable std::atomic<std::size_t> hash_{0};
+};
+
+/**
+ * Transparent hash and equality for unordered containers of SharedStrings:
+ * find() also takes a std::string_view, and a SharedString key's cached
+ * hash is used instead of hashing its text again.
+ *
+ *     std::unordered_map<SharedString, int, SharedStringHash, SharedStringEqual> counts;
+ *     counts.find(std::string_view{"word"});
+ */
+struct SharedStringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(const SharedString& s) const noexcept { return s.hash(); }
+    std::size_t operator()(std::string_view s) const noexcept { return hash_text(s); }
+};
+
+struct SharedStringEqual {
+    using is_transparent = void;
+
+    bool operator()(const SharedString& a, const SharedString& b) const noexcept {
+        return a == b;
+    }
+    bool operator()(const SharedString& a, std::string_view b) const noexcept { return a == b; }
+    bool operator()(std::string_view a, const SharedString& b) const noexcept { return b == a; }
+};
+
+/**
+ * Holds the text of many SharedStrings in large chunks, freed all at once
+ * with the arena.
+ *
+ *     StringArena arena;
+ *     std::vector<SharedString> fields;
+ *     for (auto field : split(line)) fields.push_back(arena.copy(field));
+ *
+ * Copying text into an arena is a bump of a pointer instead of a call to
+ * operator new, and strings from it skip reference counting altogether.
+ * Every such string, its copies and its slices must be gone before the
+ * arena is destroyed.
+ */
+class StringArena {
+public:
+    explicit StringArena(std::size_t chunk_bytes = 64 * 1024) : chunk_bytes_{chunk_bytes} {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&&) noexcept = default;
+    StringArena& operator=(StringArena&&) noexcept = default;
+
+    // A string with the text of s; short text is stored inline as usual
+    [[nodiscard]] SharedString copy(std::string_view s) {
+        if (s.size() <= SharedString::inline_capacity) {
+            return SharedString{s};
+        }
+        char* dest = allocate(s.size());
+        std::memcpy(dest, s.data(), s.size());
+        SharedString out;
+        out.assign_borrowed({dest, s.size()});
+        return out;
+    }
+
+    // Bytes handed out, and bytes reserved in chunks
+    [[nodiscard]] std::size_t bytes_used() const noexcept { return used_; }
+    [[nodiscard]] std::size_t bytes_reserved() const noexcept { return reserved_; }
+
+private:
+    char* allocate(std::size_t n) {
+        if (n > left_) {
+            // Text larger than a quarter chunk gets a chunk of its own, so
+            // that it does not waste the rest of the current one
+            const std::size_t bytes = n > chunk_bytes_ / 4 ? n : chunk_bytes_;
+            chunks_.push_back(std::make_unique_for_overwrite<char[]>(bytes));
+            reserved_ += bytes;
+            if (bytes != chunk_bytes_) {
+                used_ += n;
+                return chunks_.back().get();
+            }
+            next_ = chunks_.back().get();
+            left_ = bytes;
+        }
+        char* out = next_;
+        next_ += n;
+        left_ -= n;
+        used_ += n;
+        return out;
+    }
+
+    std::size_t chunk_bytes_;
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* next_ = nullptr;
+    std::size_t left_ = 0;
+    std::size_t used_ = 0;
+    std::size_t reserved_ = 0;
+};
+
+} // namespace text
+
+template <>
+struct std::hash<text::SharedString> {
+    std::size_t operator()(const text::SharedString& s) const noexcept { return s.hash(); }
+};
+
+#endif // SHARED_STRING_H
@@ -0,0 +1,261 @@
+#ifndef TEXT_SPLIT_H
+#define TEXT_SPLIT_H
+
+#include "scan.h"
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace text {
+
+// =============================================================================
+// Delimiters
+// =============================================================================
+//
+// A delimiter says which bytes may start it (a matcher for Scanner), whether
+// it really starts at a candidate position, and how long it is.
+
+// One character: split(line, ',')
+class CharDelimiter {
+public:
+    CharDelimiter() = default;
+    explicit CharDelimiter(char c) noexcept : c_{c} {}
+
+    [[nodiscard]] ByteMatcher matcher() const noexcept { return ByteMatcher{c_}; }
+    [[nodiscard]] bool matches_at(std::string_view, std::size_t) const noexcept { return true; }
+    [[nodiscard]] std::size_t length() const noexcept { return 1; }
+
+private:
+    char c_ = ',';
+};
+
+// A string of one or more characters: split(record, "||"). One of up to
+// inline_capacity characters is copied, so split(s, std::string{", "}) is
+// safe; a longer one is referred to, and must outlive the range.
+class StringDelimiter {
+public:
+    static constexpr std::size_t inline_capacity = 16;
+
+    StringDelimiter() = default;
+
+    // @throws std::invalid_argument if s is empty
+    explicit StringDelimiter(std::string_view s) : size_{s.size()} {
+        if (s.empty()) {
+            throw std::invalid_argument{"split: empty delimiter"};
+        }
+        if (s.size() <= inline_capacity) {
+            s.copy(chars_.data(), s.size());
+        } else {
+            long_ = s.data();
+        }
+    }
+
+    // Candidates are the places where the first character occurs
+    [[nodiscard]] ByteMatcher matcher() const noexcept { return ByteMatcher{view().front()}; }
+    [[nodiscard]] bool matches_at(std::string_view text, std::size_t pos) const noexcept {
+        return text.substr(pos, size_) == view();
+    }
+    [[nodiscard]] std::size_t length() const noexcept { return size_; }
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return {long_ != nullptr ? long_ : chars_.data(), size_};
+    }
+
+private:
+    std::array<char, inline_capacity> chars_{','};
+    std::size_t size_ = 1;
+    const char* long_ = nullptr;  // the delimiter, if too long to copy
+};
+
+// Any one character of a set: split(text, any_of(" \t\n"))
+class AnyOfDelimiter {
+public:
+    AnyOfDelimiter() = default;
+    explicit AnyOfDelimiter(const CharSet& set) noexcept : set_{set} {}
+
+    [[nodiscard]] CharSetMatcher matcher() const noexcept { return CharSetMatcher{set_}; }
+    [[nodiscard]] bool matches_at(std::string_view, std::size_t) const noexcept { return true; }
+    [[nodiscard]] std::size_t length() const noexcept { return 1; }
+
+private:
+    CharSet set_;
+};
+
+// =============================================================================
+// SplitView
+// =============================================================================
+
+/**
+ * The fields of a text between delimiters, found as the range is iterated.
+ *
+ *     for (std::string_view field : text::split(line, ',')) { ... }
+ *
+ * Fields are std::string_views into the text: nothing is allocated or
+ * copied, and the text must outlive the view and its fields. Delimiters
+ * are found by a Scanner, 32 bytes at a time.
+ *
+ * With SkipEmpty false (split), n delimiters make n + 1 fields, empty ones
+ * included: "a,,b," is "a", "", "b", "", and "" is one empty field. With
+ * SkipEmpty true (tokenize), empty fields are left out: runs of
+ * delimiters count as one, and "" has no tokens.
+ *
+ * A SplitView is a std::ranges::forward_range and view, so it composes
+ * with the standard views:
+ *
+ *     auto numbers = text::split(line, ',')
+ *                  | std::views::filter([](auto f) { return !f.empty(); })
+ *                  | std::views::transform(parse_int);
+ *
+ * Iterators refer to the view, which must not be moved or destroyed while
+ * they are in use.
+ */
+template <typename Delimiter, bool SkipEmpty>
+class SplitView : public std::ranges::view_interface<SplitView<Delimiter, SkipEmpty>> {
+public:
+    class iterator;
+
+    SplitView() = default;
+    SplitView(std::string_view text, Delimiter delimiter) noexcept
+        : text_{text}, delimiter_{delimiter} {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator{*this}; }
+    [[nodiscard]] std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    // The text being split
+    [[nodiscard]] std::string_view base() const noexcept { return text_; }
+
+private:
+    std::string_view text_;
+    Delimiter delimiter_;
+};
+
+template <typename Delimiter, bool SkipEmpty>
+class SplitView<Delimiter, SkipEmpty>::iterator {
+public:
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+
+    iterator() = default;
+
+    [[nodiscard]] std::string_view operator*() const noexcept {
+        return parent_->text_.substr(start_, end_ - start_);
+    }
+
+    iterator& operator++() noexcept {
+        advance();
+        if constexpr (SkipEmpty) {
+            skip_empty();
+        }
+        return *this;
+    }
+
+    iterator operator++(int) noexcept {
+        iterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) noexcept {
+        return a.done_ == b.done_ && (a.done_ || a.start_ == b.start_);
+    }
+    friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+        return it.done_;
+    }
+
+private:
+    friend class SplitView;
+
+    explicit iterator(const SplitView& parent) noexcept
+        : parent_{&parent}, scanner_{parent.text_, parent.delimiter_.matcher()} {
+        find_end();
+        if constexpr (SkipEmpty) {
+            skip_empty();
+        }
+    }
+
+    // The field starting at start_ ends at the next delimiter, or the text
+    void find_end() noexcept {
+        const std::string_view text = parent_->text_;
+        end_ = scanner_.next(start_);
+        while (end_ < text.size() && !parent_->delimiter_.matches_at(text, end_)) {
+            end_ = scanner_.next(end_ + 1);
+        }
+    }
+
+    void advance() noexcept {
+        if (end_ == parent_->text_.size()) {
+            done_ = true;
+            start_ = end_;
+            return;
+        }
+        start_ = end_ + parent_->delimiter_.length();
+        find_end();
+    }
+
+    void skip_empty() noexcept {
+        while (!done_ && start_ == end_) {
+            advance();
+        }
+    }
+
+    const SplitView* parent_ = nullptr;
+    Scanner<decltype(std::declval<Delimiter>().matcher())> scanner_;
+    std::size_t start_ = 0;
+    std::size_t end_ = 0;
+    bool done_ = false;
+};
+
+// =============================================================================
+// split and tokenize
+// =============================================================================
+
+// The fields between each ',' (say), empty ones included
+[[nodiscard]] inline SplitView<CharDelimiter, false> split(std::string_view text,
+                                                           char delimiter) noexcept {
+    return {text, CharDelimiter{delimiter}};
+}
+
+// The fields between each occurrence of a string, such as "\r\n" or "||"
+// @throws std::invalid_argument if delimiter is empty
+[[nodiscard]] inline SplitView<StringDelimiter, false> split(std::string_view text,
+                                                             std::string_view delimiter) {
+    return {text, StringDelimiter{delimiter}};
+}
+
+// The fields between each character of a set: split(text, any_of(",;"))
+[[nodiscard]] inline SplitView<AnyOfDelimiter, false> split(std::string_view text,
+                                                            const CharSet& delimiters) noexcept {
+    return {text, AnyOfDelimiter{delimiters}};
+}
+
+// As split, without the empty fields: tokenize("  a  b ", ' ') is "a", "b"
+[[nodiscard]] inline SplitView<CharDelimiter, true> tokenize(std::string_view text,
+                                                             char delimiter) noexcept {
+    return {text, CharDelimiter{delimiter}};
+}
+
+// @throws std::invalid_argument if delimiter is empty
+[[nodiscard]] inline SplitView<StringDelimiter, true> tokenize(std::string_view text,
+                                                               std::string_view delimiter) {
+    return {text, StringDelimiter{delimiter}};
+}
+
+[[nodiscard]] inline SplitView<AnyOfDelimiter, true> tokenize(std::string_view text,
+                                                              const CharSet& delimiters) noexcept {
+    return {text, AnyOfDelimiter{delimiters}};
+}
+
+// Words separated by ASCII whitespace
+[[nodiscard]] inline SplitView<AnyOfDelimiter, true> words(std::string_view text) noexcept {
+    return tokenize(text, any_of(" \t\n\r\f\v"));
+}
+
+} // namespace text
+
+#endif // TEXT_SPLIT_H
@@ -0,0 +1,213 @@
+#include <catch2/catch_test_macros.hpp>
+#include "kernels.h"
+#include <cctype>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+// Random text with letters, digits, punctuation, every kind of ASCII
+// whitespace and bytes of 0x80 and up
+std::string random_text(std::mt19937& gen, std::size_t n) {
+    static constexpr std::string_view alphabet =
+        "abcxyzABCXYZ019 !@[`{~ \t\n\v\f\r\x80\xC3\xA9\xFF";
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    std::string s(n, ' ');
+    for (auto& c : s) {
+        c = alphabet[pick(gen)];
+    }
+    return s;
+}
+
+bool c_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+std::string reference_upper(std::string s) {
+    for (auto& c : s) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    return s;
+}
+
+std::string reference_lower(std::string s) {
+    for (auto& c : s) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    return s;
+}
+
+std::size_t reference_words(const std::string& s) {
+    // The same split into words as operator>>, but on the "C" locale's
+    // whitespace only
+    std::size_t count = 0;
+    bool after_space = true;
+    for (const char c : s) {
+        count += !c_space(c) && after_space ? 1u : 0u;
+        after_space = c_space(c);
+    }
+    return count;
+}
+
+std::string reference_replace(std::string s, const std::string& from, const std::string& to) {
+    if (from.empty()) {
+        return s;
+    }
+    for (auto pos = s.find(from); pos != std::string::npos; pos = s.find(from, pos + to.size())) {
+        s.replace(pos, from.size(), to);
+    }
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("Case mapping changes ASCII letters only", "[kernels]") {
+    REQUIRE(text::to_upper("Hello World, 123!") == "HELLO WORLD, 123!");
+    REQUIRE(text::to_lower("Hello World, 123!") == "hello world, 123!");
+    REQUIRE(text::to_upper("caf\xC3\xA9") == "CAF\xC3\xA9");  // UTF-8 untouched
+    REQUIRE(text::to_upper("").empty());
+
+    std::mt19937 gen{1};
+    for (std::size_t n = 0; n < 130; ++n) {
+        const auto s = random_text(gen, n);
+        REQUIRE(text::to_upper(s) == reference_upper(s));
+        REQUIRE(text::to_lower(s) == reference_lower(s));
+
+        std::string in_place = s;
+        text::to_upper_in_place(in_place);
+        REQUIRE(in_place == reference_upper(s));
+        text::to_lower_in_place(in_place);
+        REQUIRE(in_place == reference_lower(s));
+    }
+
+    // The characters just outside the letter ranges
+    const std::string edges = "@AZ[`az{";
+    REQUIRE(text::to_upper(edges) == "@AZ[`AZ{");
+    REQUIRE(text::to_lower(edges) == "@az[`az{");
+}
+
+TEST_CASE("trim removes ASCII whitespace at the ends", "[kernels]") {
+    REQUIRE(text::trim_left("  hello  ") == "hello  ");
+    REQUIRE(text::trim_right("  hello  ") == "  hello");
+    REQUIRE(text::trim(" \t\n\v\f\rhello world\r\n") == "hello world");
+    REQUIRE(text::trim("").empty());
+    REQUIRE(text::trim("      ").empty());
+    REQUIRE(text::trim("\xA0x\xA0") == "\xA0x\xA0");  // not ASCII whitespace
+
+    // Word positions on both sides of the block edges
+    for (std::size_t before = 0; before < 80; before += 7) {
+        for (std::size_t after = 0; after < 80; after += 5) {
+            const std::string padded = std::string(before, ' ') + "a b" + std::string(after, '\t');
+            REQUIRE(text::trim_left(padded) == std::string_view{padded}.substr(before));
+            REQUIRE(text::trim_right(padded) == std::string_view{padded}.substr(0, before + 3));
+            REQUIRE(text::trim(padded) == "a b");
+        }
+        REQUIRE(text::trim(std::string(before, '\n')).empty());
+    }
+}
+
+TEST_CASE("count_words counts runs of non-whitespace", "[kernels]") {
+    REQUIRE(text::count_words("  The quick brown fox  jumps  ") == 5);
+    REQUIRE(text::count_words("") == 0);
+    REQUIRE(text::count_words("   ") == 0);
+    REQUIRE(text::count_words("one") == 1);
+    REQUIRE(text::count_words("a\tb\nc\rd") == 4);
+
+    std::mt19937 gen{2};
+    for (std::size_t n = 0; n < 200; ++n) {
+        const auto s = random_text(gen, n);
+        REQUIRE(text::count_words(s) == reference_words(s));
+    }
+
+    // A word across a block edge counts once
+    const std::string across = std::string(30, ' ') + "abcd" + std::string(30, ' ') + "x";
+    REQUIRE(text::count_words(across) == 2);
+    REQUIRE(text::count_words(std::string(100, 'w')) == 1);
+}
+
+TEST_CASE("find_substring agrees with std::string_view::find", "[kernels]") {
+    REQUIRE(text::find_substring("hello world", "world") == 6);
+    REQUIRE(text::find_substring("hello world", "worlds") == std::string_view::npos);
+    REQUIRE(text::find_substring("hello", "") == 0);
+    REQUIRE(text::find_substring("hello", "", 5) == 5);
+    REQUIRE(text::find_substring("hello", "", 6) == std::string_view::npos);
+    REQUIRE(text::find_substring("hello", "l", 3) == 3);
+    REQUIRE(text::find_substring("hello", "lo", 10) == std::string_view::npos);
+
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<int> letter{'a', 'c'};  // many near misses
+    for (int round = 0; round < 300; ++round) {
+        std::string haystack(static_cast<std::size_t>(round), ' ');
+        for (auto& c : haystack) {
+            c = static_cast<char>(letter(gen));
+        }
+        for (const std::size_t n : {2u, 3u, 5u, 8u, 33u}) {
+            std::string needle(n, ' ');
+            for (auto& c : needle) {
+                c = static_cast<char>(letter(gen));
+            }
+            const std::string_view h{haystack};
+            for (std::size_t pos = 0; pos <= haystack.size() + 1; pos += 13) {
+                REQUIRE(text::find_substring(h, needle, pos) == h.find(needle, pos));
+            }
+            // Present at a random place
+            if (haystack.size() > n) {
+                const auto at = static_cast<std::size_t>(round) % (haystack.size() - n);
+                std::string with = haystack;
+                with.replace(at, n, needle);
+                REQUIRE(text::find_substring(with, needle) == std::string_view{with}.find(needle));
+            }
+        }
+    }
+    REQUIRE(text::count_substring("aaaaa", "aa") == 2);
+    REQUIRE(text::count_substring("abc", "") == 0);
+}
+
+TEST_CASE("replace_all replaces left to right into one output", "[kernels]") {
+    REQUIRE(text::replace_all("hello hello", "hello", "hi") == "hi hi");
+    REQUIRE(text::replace_all("the cat sat on the mat", "the", "a") == "a cat sat on a mat");
+    REQUIRE(text::replace_all("aaa", "a", "aa") == "aaaaaa");  // to contains from
+    REQUIRE(text::replace_all("aaaa", "aa", "b") == "bb");
+    REQUIRE(text::replace_all("abc", "", "x") == "abc");
+    REQUIRE(text::replace_all("", "a", "b").empty());
+    REQUIRE(text::replace_all("abc", "abc", "").empty());
+
+    std::mt19937 gen{4};
+    std::uniform_int_distribution<int> letter{'a', 'c'};
+    std::string out;
+    for (int round = 0; round < 200; ++round) {
+        std::string s(static_cast<std::size_t>(round), ' ');
+        for (auto& c : s) {
+            c = static_cast<char>(letter(gen));
+        }
+        for (const auto& [from, to] : {std::pair<std::string, std::string>{"ab", "X"},
+                                       {"abc", "LONGER"},
+                                       {"b", ""},
+                                       {"ca", "ac"}}) {
+            text::replace_all(s, from, to, out);  // out reused across calls
+            REQUIRE(out == reference_replace(s, from, to));
+        }
+    }
+}
+
+TEST_CASE("replace_all may read from its own output", "[kernels]") {
+    std::string out = "a cat and a hat, and another cat";
+    out.reserve(100);
+    text::replace_all(out, "cat", "tiger", out);  // grows
+    REQUIRE(out == "a tiger and a hat, and another tiger");
+    text::replace_all(out, "tiger", "ox", out);  // shrinks
+    REQUIRE(out == "a ox and a hat, and another ox");
+
+    // from and to viewing out
+    std::string words = "ab";
+    const std::string_view a = std::string_view{words}.substr(0, 1);
+    const std::string_view b = std::string_view{words}.substr(1, 1);
+    text::replace_all("abab", a, b, words);
+    REQUIRE(words == "bbbb");
+}
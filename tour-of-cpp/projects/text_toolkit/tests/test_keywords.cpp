@@ -0,0 +1,177 @@
+#include <catch2/catch_test_macros.hpp>
+#include "keywords.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+std::string random_text(std::mt19937& gen, std::string_view alphabet, std::size_t n) {
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    std::string s(n, ' ');
+    for (auto& c : s) {
+        c = alphabet[pick(gen)];
+    }
+    return s;
+}
+
+// A hit as (end, -length, keyword), which sorts in the order find_all
+// reports them: by end, then longest first
+using Hit = std::tuple<std::size_t, std::ptrdiff_t, std::size_t>;
+
+std::string lower(std::string_view s) {
+    std::string out{s};
+    for (auto& c : out) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+// A find per keyword and position, each keyword once under its first index
+std::vector<Hit> naive_find_all(std::string_view s, const std::vector<std::string>& keywords,
+                                bool icase) {
+    const std::string text = icase ? lower(s) : std::string{s};
+    std::vector<std::string> seen;
+    std::vector<Hit> hits;
+    for (std::size_t k = 0; k < keywords.size(); ++k) {
+        const std::string keyword = icase ? lower(keywords[k]) : keywords[k];
+        if (std::ranges::find(seen, keyword) != seen.end()) {
+            continue;
+        }
+        seen.push_back(keyword);
+        for (auto at = text.find(keyword); at != std::string::npos;
+             at = text.find(keyword, at + 1)) {
+            hits.emplace_back(at + keyword.size(), -static_cast<std::ptrdiff_t>(keyword.size()), k);
+        }
+    }
+    std::ranges::sort(hits);
+    return hits;
+}
+
+std::vector<Hit> hits_of(std::string_view s, const text::KeywordSet& set) {
+    std::vector<Hit> hits;
+    for (const text::KeywordMatch& m : set.find_all(s)) {
+        REQUIRE(m.text.data() == s.data() + m.position);
+        hits.emplace_back(m.position + m.text.size(), -static_cast<std::ptrdiff_t>(m.text.size()),
+                          m.keyword);
+    }
+    return hits;
+}
+
+} // namespace
+
+TEST_CASE("KeywordSet finds what a find per keyword finds", "[keywords]") {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<std::size_t> count{1, 40};
+    std::uniform_int_distribution<std::size_t> length{1, 5};
+    std::uniform_int_distribution<std::size_t> text_length{0, 200};
+    for (const std::string_view alphabet : {std::string_view{"ab"}, std::string_view{"abcdAB\0", 7},
+                                            std::string_view{"abcdefghijklmnopqrstuvwxyz ."}}) {
+        for (int round = 0; round < 200; ++round) {
+            std::vector<std::string> keywords;
+            for (std::size_t k = count(gen); k > 0; --k) {
+                keywords.push_back(random_text(gen, alphabet, length(gen)));
+            }
+            const bool icase = round % 2 == 1;
+            const text::KeywordSet set{keywords,
+                                       icase ? text::KeywordSet::icase : text::KeywordSet::none};
+            const std::string s = random_text(gen, alphabet, text_length(gen));
+            INFO("text \"" << s << "\", " << keywords.size() << " keywords, icase " << icase);
+
+            const auto expected = naive_find_all(s, keywords, icase);
+            REQUIRE(hits_of(s, set) == expected);
+            REQUIRE(set.search(s) == !expected.empty());
+            const auto first = set.find(s);
+            REQUIRE(first.has_value() == !expected.empty());
+            if (first) {
+                REQUIRE(first->position + first->text.size() == std::get<0>(expected.front()));
+                REQUIRE(first->keyword == std::get<2>(expected.front()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Overlapping keywords are all reported", "[keywords]") {
+    const text::KeywordSet set{"he", "she", "his", "hers"};
+    std::vector<std::string_view> hits;
+    for (const auto& m : set.find_all("ushers")) {
+        hits.push_back(m.text);
+    }
+    // "she" and "he" end together, the longer first
+    CHECK(hits == std::vector<std::string_view>{"she", "he", "hers"});
+    CHECK(set.size() == 4);
+    CHECK(set.keyword(3) == "hers");
+    CHECK(set.states() == 10);  // the root and each distinct prefix
+}
+
+TEST_CASE("icase matches either case and reports the text as it is", "[keywords]") {
+    const text::KeywordSet set({"Error", "TIMEOUT"}, text::KeywordSet::icase);
+    const std::string_view line = "ERROR: connection timeout; error again";
+    std::vector<std::string_view> hits;
+    std::vector<std::size_t> keywords;
+    for (const auto& m : set.find_all(line)) {
+        hits.push_back(m.text);
+        keywords.push_back(m.keyword);
+    }
+    CHECK(hits == std::vector<std::string_view>{"ERROR", "timeout", "error"});
+    CHECK(keywords == std::vector<std::size_t>{0, 1, 0});
+
+    // Duplicates under icase are one keyword, under its first index
+    const text::KeywordSet dup({"abc", "ABC"}, text::KeywordSet::icase);
+    CHECK(std::ranges::distance(dup.find_all("xAbCx")) == 1);
+    CHECK(dup.find("xAbCx")->keyword == 0);
+
+    CHECK_FALSE(text::KeywordSet{"Error"}.search("ERROR"));
+}
+
+TEST_CASE("The Scanner skip agrees with the table", "[keywords]") {
+    // Few first bytes: the search skips between them 32 bytes at a time
+    const text::KeywordSet few{"xyz", "q"};
+    std::string s(1000, '.');
+    s[31] = 'q';
+    s[32] = 'x';
+    s[33] = 'y';
+    s[34] = 'z';
+    s[999] = 'q';
+    std::vector<std::size_t> positions;
+    for (const auto& m : few.find_all(s)) {
+        positions.push_back(m.position);
+    }
+    CHECK(positions == std::vector<std::size_t>{31, 32, 999});
+
+    // A keyword cut off by the end of the text is no match
+    const std::string_view cut = std::string_view{s}.substr(0, 34);
+    CHECK(few.find(cut)->position == 31);
+    CHECK(std::ranges::distance(few.find_all(cut)) == 1);
+    CHECK_FALSE(text::KeywordSet{"xyz"}.search(cut));
+}
+
+TEST_CASE("find_all is a forward range", "[keywords]") {
+    const text::KeywordSet set{"ab", "b"};
+    const auto all = set.find_all("abab");
+    static_assert(std::ranges::forward_range<decltype(all)>);
+    CHECK(std::ranges::distance(all) == 4);
+    auto it = all.begin();
+    auto copy = it;
+    ++it;
+    CHECK(copy != it);
+    CHECK(copy->text == "ab");
+    CHECK(it->text == "b");
+    CHECK(text::KeywordIterator{} == text::KeywordIterator{});
+    CHECK(set.find_all("").empty());
+    CHECK(set.find_all("cccc").empty());
+}
+
+TEST_CASE("KeywordSet rejects empty keywords and accepts an empty set", "[keywords]") {
+    CHECK_THROWS_AS((text::KeywordSet{"a", ""}), std::invalid_argument);
+    const text::KeywordSet none{std::vector<std::string>{}};
+    CHECK(none.size() == 0);
+    CHECK_FALSE(none.search("anything"));
+}
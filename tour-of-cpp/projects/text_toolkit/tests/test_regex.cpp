@@ -0,0 +1,306 @@
+#include <catch2/catch_test_macros.hpp>
+#include "regex.h"
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::string random_text(std::mt19937& gen, std::string_view alphabet, std::size_t n) {
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    std::string s(n, ' ');
+    for (auto& c : s) {
+        c = alphabet[pick(gen)];
+    }
+    return s;
+}
+
+// A match as (position, length) per group, with (npos, 0) for a group
+// that did not take part
+using Groups = std::vector<std::pair<std::size_t, std::size_t>>;
+
+Groups groups_of(const std::smatch& m) {
+    Groups groups;
+    for (std::size_t i = 0; i < m.size(); ++i) {
+        groups.emplace_back(m[i].matched ? static_cast<std::size_t>(m.position(i))
+                                         : std::string_view::npos,
+                            m[i].matched ? static_cast<std::size_t>(m.length(i)) : 0);
+    }
+    return groups;
+}
+
+Groups groups_of(const text::Match& m) {
+    Groups groups;
+    for (std::size_t i = 0; i < m.size(); ++i) {
+        groups.emplace_back(m.position(i), m.length(i));
+    }
+    return groups;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> std_find_all(const std::string& s,
+                                                              const std::regex& re) {
+    std::vector<std::pair<std::size_t, std::size_t>> hits;
+    for (auto it = std::sregex_iterator{s.begin(), s.end(), re}; it != std::sregex_iterator{};
+         ++it) {
+        hits.emplace_back(static_cast<std::size_t>(it->position()),
+                          static_cast<std::size_t>(it->length()));
+    }
+    return hits;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> text_find_all(const std::string& s,
+                                                               const text::Regex& re) {
+    std::vector<std::pair<std::size_t, std::size_t>> hits;
+    for (const text::Match& m : re.find_all(s)) {
+        hits.emplace_back(m.position(), m.length());
+    }
+    return hits;
+}
+
+// match, search with groups and find_all agree with std::regex on random
+// texts over an alphabet chosen to make matches likely
+void check_against_std(std::string_view pattern, std::string_view alphabet,
+                       text::Regex::Flags flags = text::Regex::none) {
+    const std::regex expected{std::string{pattern},
+                              flags == text::Regex::icase
+                                  ? std::regex::ECMAScript | std::regex::icase
+                                  : std::regex::ECMAScript};
+    const text::Regex re{pattern, flags};
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<std::size_t> length{0, 80};
+    text::Match m;
+    for (int round = 0; round < 300; ++round) {
+        const std::string s = random_text(gen, alphabet, length(gen));
+        INFO("pattern " << pattern << " text \"" << s << '"');
+
+        std::smatch sm;
+        const bool whole = std::regex_match(s, sm, expected);
+        REQUIRE(re.match(s) == whole);
+        REQUIRE(re.match(s, m) == whole);
+        if (whole) {
+            REQUIRE(groups_of(m) == groups_of(sm));
+        }
+
+        const bool found = std::regex_search(s, sm, expected);
+        REQUIRE(re.search(s) == found);
+        REQUIRE(re.search(s, m) == found);
+        if (found) {
+            REQUIRE(groups_of(m) == groups_of(sm));
+            REQUIRE(m.prefix() == std::string_view{s}.substr(0, m.position()));
+        }
+
+        REQUIRE(text_find_all(s, re) == std_find_all(s, expected));
+    }
+}
+
+// StaticRegex agrees with Regex on the same pattern
+template <typename Static>
+void check_static(const Static& fixed, std::string_view alphabet) {
+    const text::Regex re{Static::pattern()};
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<std::size_t> length{0, 80};
+    text::Match m;
+    for (int round = 0; round < 300; ++round) {
+        const std::string s = random_text(gen, alphabet, length(gen));
+        INFO("pattern " << Static::pattern() << " text \"" << s << '"');
+        REQUIRE(fixed.match(s) == re.match(s));
+        REQUIRE(fixed.search(s) == re.search(s));
+        for (std::size_t pos = 0; pos <= s.size(); pos += 7) {
+            const auto hit = fixed.find(s, pos);
+            REQUIRE(hit.has_value() == re.search(s, m, pos));
+            if (hit) {
+                REQUIRE(hit->data() == m[0].data());
+                REQUIRE(hit->size() == m[0].size());
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Regex agrees with std::regex on the chapter's patterns", "[regex]") {
+    check_against_std(R"(\d+)", "12a ");
+    check_against_std(R"(\w+@\w+\.\w+)", "ab@._");
+    check_against_std(R"([\w.]+@[\w.]+\.\w+)", "ab@._");
+    check_against_std(R"(\$\d+\.\d{2})", "$1.2 ");
+    check_against_std(R"(\$(\d+)\.(\d{2}))", "$1.2");
+    check_against_std(R"((\w+) (\w+))", "ab ");
+    check_against_std(R"((\d{3})(\d{3})(\d{4}))", "12a");
+    check_against_std(R"(\(\d{3}\) \d{3}-\d{4}|\d{3}-\d{3}-\d{4})", "11()- ");
+    check_against_std(R"(\d{4}-\d{2}-\d{2})", "12-");
+    check_against_std(R"(\d{1,3}\.\d{1,3}\.\d{1,3}\.\d{1,3})", "19.");
+    check_against_std(R"(#[0-9A-Fa-f]{6})", "#aF9g");
+    check_against_std(R"(https?://\w+\.\w+(/\w+)*)", "htps:/.a");
+    check_against_std(R"((https?)://([\w.]+)(/.*)?)", "htps:/.a");
+    check_against_std(R"(#\w+)", "#a b");
+    check_against_std(R"((\d{2})/(\d{2})/(\d{4}))", "1/2");
+}
+
+TEST_CASE("Regex picks the match a backtracking matcher would", "[regex]") {
+    check_against_std("(a|ab)(c|bcd)(d*)", "abcd");
+    check_against_std("(?:ab|a)(bc|c)?", "abc");
+    check_against_std("(a+)(b+)?", "ab");
+    check_against_std("(a+?)(a*)", "ab");
+    check_against_std("a*?b", "ab");
+    check_against_std("a{2,}?", "ab");
+    check_against_std("a{2,3}", "aab");
+    check_against_std("(a?)(a?)b", "ab");
+    check_against_std("((a)|b)c", "abc");
+    check_against_std("(a|b)*?c", "abc");
+    check_against_std("x*", "xy");
+    check_against_std("[^a-c]+", "abcd ");
+    check_against_std("a.b", "ab\n\r.");
+    check_against_std(R"([\d\s-]+)", "1 -a\t");
+    check_against_std(R"(\x41[\]\\]\.)", "A]\\.");
+}
+
+TEST_CASE("Anchors hold at the ends of the text only", "[regex]") {
+    check_against_std("^ab", "ab");
+    check_against_std("ab$", "ab");
+    check_against_std("^$", "a");
+    check_against_std("^a|b$", "ab");
+    check_against_std("(^a|b)+", "ab");
+
+    const text::Regex caret{"^a"};
+    text::Match m;
+    CHECK(caret.search("aa", m, 0));
+    CHECK_FALSE(caret.search("aa", m, 1));
+    CHECK(m.empty());
+}
+
+TEST_CASE("icase folds ASCII letters", "[regex]") {
+    check_against_std("hello", "helo HELO", text::Regex::icase);
+    check_against_std("[a-c]+x", "abcxABCX", text::Regex::icase);
+    check_against_std("[^b]+", "abAB", text::Regex::icase);
+
+    const text::Regex hello{"hello", text::Regex::icase};
+    CHECK(hello.match("HeLLo"));
+    CHECK_FALSE(hello.match("help!"));
+}
+
+TEST_CASE("Capture groups are string_views into the text", "[regex]") {
+    const text::Regex url{R"((https?)://([\w.]+)(/.*)?)"};
+    CHECK(url.mark_count() == 3);
+
+    const std::string s = "https://example.com/path/to/page";
+    text::Match m;
+    REQUIRE(url.match(s, m));
+    REQUIRE(m.size() == 4);
+    CHECK(m[1] == "https");
+    CHECK(m[2] == "example.com");
+    CHECK(m[3] == "/path/to/page");
+    CHECK(m[3].data() == s.data() + 19);
+
+    REQUIRE(url.match("http://example.com", m));
+    CHECK_FALSE(m.matched(3));
+    CHECK(m[3].empty());
+    CHECK(m.position(3) == std::string_view::npos);
+
+    CHECK_FALSE(url.match("ftp://example.com", m));
+    CHECK(m.empty());
+    CHECK(m.size() == 0);
+
+    // Too long to backtrack over: the groups come from the Pike VM
+    const std::string long_path = "http://example.com/" + std::string(100000, 'p');
+    REQUIRE(url.match(long_path, m));
+    CHECK(m[2] == "example.com");
+    CHECK(m[3].size() == 100001);
+    const std::string padded = std::string(50000, 'x') + "abcd";
+    REQUIRE(text::Regex{"(a|ab)(c|bcd)(d*)"}.search(padded, m));
+    CHECK(m[1] == "a");
+    CHECK(m[2] == "bcd");
+    CHECK(m[3].empty());
+}
+
+TEST_CASE("find_all iterates like std::sregex_iterator", "[regex]") {
+    const text::Regex digits{R"(\d*)"};
+    std::vector<std::string> hits;
+    for (const text::Match& m : digits.find_all("a12b")) {
+        hits.push_back(m.str());
+    }
+    CHECK(hits == std::vector<std::string>{"", "12", "", ""});
+
+    const text::Regex phone{R"(\(\d{3}\) \d{3}-\d{4}|\d{3}-\d{3}-\d{4})"};
+    const auto all = phone.find_all("Call (123) 456-7890 or 987-654-3210");
+    static_assert(std::ranges::forward_range<decltype(all)>);
+    CHECK(std::ranges::distance(all) == 2);
+    CHECK((*all.begin())[0] == "(123) 456-7890");
+
+    CHECK(text::RegexIterator{} == text::RegexIterator{});
+    CHECK(phone.find_all("no numbers").empty());
+}
+
+TEST_CASE("The free functions mirror <regex>", "[regex]") {
+    const text::Regex email{R"([\w.]+@[\w.]+\.\w+)"};
+    CHECK(text::regex_match("test.user@domain.org", email));
+    CHECK_FALSE(text::regex_match("@missing.com", email));
+    CHECK(text::regex_search("mail test@x.io now", email));
+
+    text::Match m;
+    CHECK(text::regex_search("mail test@x.io now", m, email));
+    CHECK(m[0] == "test@x.io");
+    CHECK(m.suffix() == " now");
+}
+
+TEST_CASE("Matching takes linear time where std::regex backtracks", "[regex]") {
+    // Exponential for a backtracking matcher when there is no b
+    const std::string as(100000, 'a');
+    CHECK_FALSE(text::Regex{"(a*)*b"}.search(as));
+    CHECK_FALSE(text::Regex{"(x+x+)+y"}.match(std::string(5000, 'x')));
+    CHECK(text::Regex{"(a|aa)+$"}.search(as));
+}
+
+TEST_CASE("Large DFAs are built lazily and still match", "[regex]") {
+    // 196,608 states: the 17th byte from the end is an 'a'
+    const text::Regex late_a{"(a|b)*a(a|b){16}"};
+    CHECK(late_a.lazy());
+    CHECK_FALSE(text::Regex{R"(\d{4}-\d{2}-\d{2})"}.lazy());
+    check_against_std("(a|b)*a(a|b){16}", "ab");
+    check_against_std("[ab]*a[ab]{16}c", "abc");
+
+    std::mt19937 gen{3};
+    const std::string s = random_text(gen, "ab", 200000);
+    const auto expected = s[s.size() - 17] == 'a';
+    CHECK(late_a.match(s) == expected);
+}
+
+TEST_CASE("Bad patterns throw RegexError with a position", "[regex]") {
+    for (const std::string_view pattern :
+         {"(", "a)", "[a", "a**", "*a", "a{2", "a{3,2}", "a{1001}", R"(\)", R"(\1)", R"(\b)",
+          "(?=a)", "^*", R"(\q)", R"(\xZ1)", "[z-a]"}) {
+        INFO(pattern);
+        CHECK_THROWS_AS(text::Regex{pattern}, text::RegexError);
+    }
+    try {
+        text::Regex{"ab("};
+        FAIL("no exception");
+    } catch (const text::RegexError& e) {
+        CHECK(e.position() == 3);
+    }
+}
+
+TEST_CASE("StaticRegex is compiled by the compiler", "[regex]") {
+    constexpr text::StaticRegex<R"(\d{4}-\d{2}-\d{2})"> iso_date;
+    static_assert(iso_date.match("2024-01-15"));
+    static_assert(!iso_date.match("2024-1-15"));
+    static_assert(iso_date.find("due 2024-01-15, paid").value() == "2024-01-15");
+    static_assert(!iso_date.search("no date"));
+
+    constexpr text::StaticRegex<"hello", text::Regex::icase> hello;
+    static_assert(hello.match("HELLO"));
+
+    constexpr text::StaticRegex<"^a|b$"> anchors;
+    static_assert(anchors.find("xab").value() == "b");
+    static_assert(!anchors.find("xa").has_value());
+
+    check_static(iso_date, "12-");
+    check_static(text::StaticRegex<R"([\w.]+@[\w.]+\.\w+)">{}, "ab@._");
+    check_static(text::StaticRegex<R"(\(\d{3}\) \d{3}-\d{4}|\d{3}-\d{3}-\d{4})">{}, "11()- ");
+    check_static(text::StaticRegex<"(a|ab)(c|bcd)(d*)">{}, "abcd");
+    check_static(text::StaticRegex<"x*">{}, "xy");
+}
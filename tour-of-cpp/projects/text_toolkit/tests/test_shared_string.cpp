@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+#include "shared_string.h"
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using text::SharedString;
+using text::StringArena;
+
+namespace {
+
+std::string long_text(std::size_t n) {
+    std::string s;
+    for (std::size_t i = 0; i < n; ++i) {
+        s.push_back(static_cast<char>('a' + i % 26));
+    }
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("SharedString stores short text inline and shares long text", "[shared_string]") {
+    const SharedString empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty.view().empty());
+    REQUIRE(empty == std::string_view{});
+
+    for (const std::size_t n : {1u, 31u, 32u, 33u, 100u, 5000u}) {
+        const std::string text = long_text(n);
+        const SharedString s{text};
+        REQUIRE(s.size() == n);
+        REQUIRE(s == text);
+        REQUIRE(s.str() == text);
+        REQUIRE(std::string(s.begin(), s.end()) == text);
+        REQUIRE(s.front() == 'a');
+        REQUIRE(s[n - 1] == text.back());
+
+        const SharedString copy = s;
+        REQUIRE(copy == s);
+        if (n <= SharedString::inline_capacity) {
+            REQUIRE(s.use_count() == 0);
+            REQUIRE(copy.data() != s.data());
+        } else {
+            REQUIRE(s.use_count() == 2);
+            REQUIRE(copy.data() == s.data());
+        }
+    }
+}
+
+TEST_CASE("SharedString copies, moves and assignment keep counts right", "[shared_string]") {
+    const std::string text = long_text(200);
+    SharedString a{text};
+    {
+        SharedString b = a;
+        SharedString c;
+        c = b;
+        REQUIRE(a.use_count() == 3);
+        SharedString d = std::move(c);
+        REQUIRE(c.empty());  // NOLINT(bugprone-use-after-move)
+        REQUIRE(a.use_count() == 3);
+        d = SharedString{"short"};
+        REQUIRE(a.use_count() == 2);
+        REQUIRE(d == "short");
+    }
+    REQUIRE(a.use_count() == 1);
+
+    SharedString small{"tiny"};
+    swap(a, small);
+    REQUIRE(a == "tiny");
+    REQUIRE(small == text);
+    REQUIRE(small.use_count() == 1);
+
+    a = a;  // self-assignment
+    REQUIRE(a == "tiny");
+}
+
+TEST_CASE("SharedString slices share the buffer", "[shared_string]") {
+    const std::string text = long_text(1000);
+    const SharedString s{text};
+
+    const SharedString middle = s.substr(100, 500);
+    REQUIRE(middle == std::string_view{text}.substr(100, 500));
+    REQUIRE(middle.data() == s.data() + 100);
+    REQUIRE(s.use_count() == 2);
+
+    // Slices of slices, and slices clamped at the end
+    const SharedString inner = middle.substr(50);
+    REQUIRE(inner == std::string_view{text}.substr(150, 450));
+    REQUIRE(s.use_count() == 3);
+    REQUIRE(s.substr(990, 100) == std::string_view{text}.substr(990));
+
+    // Short slices are copied inline and do not pin the buffer
+    const SharedString word = s.substr(10, 5);
+    REQUIRE(word == "klmno");
+    REQUIRE(word.use_count() == 0);
+    REQUIRE(s.use_count() == 3);
+
+    REQUIRE(s.substr(1000).empty());
+    REQUIRE_THROWS_AS(s.substr(1001), std::out_of_range);
+    REQUIRE(s.substr().data() == s.data());
+}
+
+TEST_CASE("SharedString hashing and comparison", "[shared_string]") {
+    const std::string text = long_text(300);
+    const SharedString s{text};
+    REQUIRE(s.hash() == text::hash_text(text));
+    REQUIRE(std::hash<SharedString>{}(s) == s.hash());
+
+    // Equal text, different buffers
+    const SharedString other{text};
+    REQUIRE(other == s);
+    REQUIRE(s.substr(0, 299) != s);
+    REQUIRE(s.substr(0, 299) < s);
+    REQUIRE(SharedString{"abc"} < SharedString{"abd"});
+    REQUIRE(SharedString{"abc"} > std::string_view{"abb"});
+
+    // A slice's hash is its own text's
+    REQUIRE(s.substr(7, 100).hash() == text::hash_text(std::string_view{text}.substr(7, 100)));
+
+    // Heterogeneous lookup: string_view keys find SharedStrings
+    std::unordered_map<SharedString, int, text::SharedStringHash, text::SharedStringEqual> counts;
+    counts[SharedString{"alpha"}] = 1;
+    counts[s] = 2;
+    REQUIRE(counts.find(std::string_view{"alpha"})->second == 1);
+    REQUIRE(counts.find(std::string_view{text})->second == 2);
+    REQUIRE(counts.find(std::string_view{"beta"}) == counts.end());
+
+    std::unordered_set<SharedString> plain{SharedString{"x"}, SharedString{"y"}};
+    REQUIRE(plain.contains(SharedString{"y"}));
+}
+
+TEST_CASE("SharedString borrows text without copying", "[shared_string]") {
+    static const std::string text = long_text(100);
+    const SharedString s = SharedString::borrow(text);
+    REQUIRE(s.data() == text.data());
+    REQUIRE(s.use_count() == 0);
+    const SharedString slice = s.substr(40);
+    REQUIRE(slice.data() == text.data() + 40);
+    REQUIRE(SharedString::borrow("short").use_count() == 0);
+}
+
+TEST_CASE("StringArena holds the text of many strings", "[shared_string][arena]") {
+    std::vector<std::string> texts;
+    for (std::size_t i = 0; i < 500; ++i) {
+        texts.push_back(long_text(40 + i % 60) + std::to_string(i));
+    }
+
+    StringArena arena{4096};
+    std::vector<SharedString> strings;
+    for (const auto& t : texts) {
+        strings.push_back(arena.copy(t));
+    }
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+        REQUIRE(strings[i] == texts[i]);
+        REQUIRE(strings[i].use_count() == 0);
+    }
+    REQUIRE(arena.bytes_used() >= 500 * 40);
+    REQUIRE(arena.bytes_reserved() >= arena.bytes_used());
+    REQUIRE(arena.bytes_reserved() < arena.bytes_used() + 2 * 4096 + 500 * 50);
+
+    // Larger than a quarter chunk: a chunk of its own
+    const std::string big = long_text(3000);
+    REQUIRE(arena.copy(big) == big);
+
+    // Short text is inline as always
+    REQUIRE(arena.copy("short") == "short");
+}
+
+TEST_CASE("SharedString copies may cross threads", "[shared_string][threads]") {
+    const SharedString s{long_text(500)};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([s] {
+            for (int i = 0; i < 10'000; ++i) {
+                const SharedString copy = s;
+                const SharedString slice = copy.substr(static_cast<std::size_t>(i % 400), 80);
+                (void)slice.hash();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    REQUIRE(s.use_count() == 1);
+}
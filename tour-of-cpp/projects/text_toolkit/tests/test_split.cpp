@@ -0,0 +1,183 @@
+#include <catch2/catch_test_macros.hpp>
+#include "split.h"
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+template <typename Range>
+std::vector<std::string> collect(Range&& range) {
+    std::vector<std::string> out;
+    for (const std::string_view field : range) {
+        out.emplace_back(field);
+    }
+    return out;
+}
+
+using Fields = std::vector<std::string>;
+
+// The fields by the obvious std::string_view::find loop
+Fields reference_split(std::string_view s, std::string_view delimiter, bool skip_empty) {
+    Fields out;
+    std::size_t start = 0;
+    while (true) {
+        const auto pos = s.find(delimiter, start);
+        const auto field = s.substr(start, pos == std::string_view::npos ? s.npos : pos - start);
+        if (!skip_empty || !field.empty()) {
+            out.emplace_back(field);
+        }
+        if (pos == std::string_view::npos) {
+            return out;
+        }
+        start = pos + delimiter.size();
+    }
+}
+
+} // namespace
+
+static_assert(std::ranges::forward_range<text::SplitView<text::CharDelimiter, false>>);
+static_assert(std::ranges::view<text::SplitView<text::AnyOfDelimiter, true>>);
+
+TEST_CASE("CharSet membership and search", "[scan]") {
+    constexpr auto set = text::any_of(",;,");
+    static_assert(set.contains(';') && !set.contains('a'));
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.members() == ",;");
+
+    // Past the SIMD limit, the table still answers
+    const auto large = text::any_of("abcdefghijklmnop\xff");
+    REQUIRE(large.size() == 17);
+    REQUIRE(large.members().empty());
+    REQUIRE(large.contains('\xff'));
+    REQUIRE_FALSE(large.contains('z'));
+
+    // Positions on both sides of every 32-byte block edge
+    for (std::size_t length = 0; length < 100; ++length) {
+        for (std::size_t at = 0; at < length; ++at) {
+            std::string s(length, 'x');
+            s[at] = ';';
+            REQUIRE(text::find_byte(s, ';') == at);
+            REQUIRE(text::find_any(s, set) == at);
+            s[at] = 'p';
+            REQUIRE(text::find_any(s, large) == at);
+            REQUIRE(text::find_byte(s, 'p', at + 1) == std::string_view::npos);
+        }
+        REQUIRE(text::find_byte(std::string(length, 'x'), ';') == std::string_view::npos);
+    }
+}
+
+TEST_CASE("Scanner hands out every match in order", "[scan]") {
+    std::string s;
+    for (int i = 0; i < 300; ++i) {
+        s += (i % 7 == 0 || i % 11 == 0) ? ',' : 'a';
+    }
+    text::Scanner scanner{std::string_view{s}, text::ByteMatcher{','}};
+    std::vector<std::size_t> found;
+    for (auto i = scanner.next(0); i != s.size(); i = scanner.next(i + 1)) {
+        found.push_back(i);
+    }
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == ',') {
+            expected.push_back(i);
+        }
+    }
+    REQUIRE(found == expected);
+
+    // Jumping ahead, within the block and past it
+    text::Scanner again{std::string_view{s}, text::ByteMatcher{','}};
+    REQUIRE(again.next(1) == 7);
+    REQUIRE(again.next(12) == 14);
+    REQUIRE(again.next(100) == 105);
+    REQUIRE(again.next(299) == 300);
+}
+
+TEST_CASE("split keeps empty fields", "[split]") {
+    REQUIRE(collect(text::split("a,b,c", ',')) == Fields{"a", "b", "c"});
+    REQUIRE(collect(text::split("a,,b,", ',')) == Fields{"a", "", "b", ""});
+    REQUIRE(collect(text::split(",", ',')) == Fields{"", ""});
+    REQUIRE(collect(text::split("", ',')) == Fields{""});
+    REQUIRE(collect(text::split("no delimiter", ',')) == Fields{"no delimiter"});
+
+    REQUIRE(collect(text::split("a||b|c||", "||")) == Fields{"a", "b|c", ""});
+    REQUIRE(collect(text::split("a|||b", "||")) == Fields{"a", "|b"});
+    REQUIRE(collect(text::split("line 1\r\nline 2\r\n", "\r\n")) ==
+            Fields{"line 1", "line 2", ""});
+    REQUIRE_THROWS_AS(text::split("abc", std::string_view{}), std::invalid_argument);
+
+    // A short delimiter is copied, so a temporary string is fine
+    const auto fields = text::split("a, b, c", std::string{", "});
+    REQUIRE(collect(fields) == Fields{"a", "b", "c"});
+    const std::string long_delimiter = "<-- a delimiter longer than 16 -->";
+    REQUIRE(collect(text::split("x" + long_delimiter + "y", long_delimiter)) == Fields{"x", "y"});
+
+    REQUIRE(collect(text::split("k=v;k2=v2,x", text::any_of(";,="))) ==
+            Fields{"k", "v", "k2", "v2", "x"});
+}
+
+TEST_CASE("tokenize drops empty fields", "[split]") {
+    REQUIRE(collect(text::tokenize("  the quick  brown fox ", ' ')) ==
+            Fields{"the", "quick", "brown", "fox"});
+    REQUIRE(collect(text::tokenize("", ' ')).empty());
+    REQUIRE(collect(text::tokenize("    ", ' ')).empty());
+    REQUIRE(collect(text::tokenize("::a::::b::", "::")) == Fields{"a", "b"});
+    REQUIRE(collect(text::words("one\ttwo\n three\r\n")) == Fields{"one", "two", "three"});
+}
+
+TEST_CASE("split agrees with a find loop on long text", "[split]") {
+    std::string s;
+    unsigned state = 12345;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 1103515245u + 12345u;
+        const auto r = (state >> 16) % 10;
+        s += r == 0 ? ',' : r == 1 ? ';' : static_cast<char>('a' + r);
+    }
+    for (const bool skip : {false, true}) {
+        const auto by_char = skip ? collect(text::tokenize(s, ',')) : collect(text::split(s, ','));
+        REQUIRE(by_char == reference_split(s, ",", skip));
+
+        const auto by_string =
+            skip ? collect(text::tokenize(s, ",b")) : collect(text::split(s, ",b"));
+        REQUIRE(by_string == reference_split(s, ",b", skip));
+    }
+
+    // Two-character sets are one-character splits, applied twice
+    Fields expected;
+    for (const auto& part : reference_split(s, ",", false)) {
+        const auto inner = reference_split(part, ";", false);
+        expected.insert(expected.end(), inner.begin(), inner.end());
+    }
+    REQUIRE(collect(text::split(s, text::any_of(",;"))) == expected);
+}
+
+TEST_CASE("SplitView composes with std::ranges", "[split]") {
+    const std::string line = "3,,14,1,5,,92";
+    auto numbers = text::split(line, ',')
+                 | std::views::filter([](std::string_view f) { return !f.empty(); })
+                 | std::views::transform(
+                       [](std::string_view f) { return std::stoi(std::string{f}); });
+    std::vector<int> values;
+    std::ranges::copy(numbers, std::back_inserter(values));
+    REQUIRE(values == std::vector<int>{3, 14, 1, 5, 92});
+
+    const auto fields = text::split(line, ',');
+    REQUIRE(std::ranges::distance(fields) == 7);
+    REQUIRE(std::ranges::count(fields, std::string_view{}) == 2);
+    REQUIRE(*std::ranges::next(fields.begin(), 2) == "14");
+    REQUIRE(fields.front() == "3");
+
+    // Multi-pass: a copied iterator is unaffected by advancing the original
+    auto it = fields.begin();
+    const auto copy = it;
+    ++it;
+    REQUIRE(*copy == "3");
+    REQUIRE(it != copy);
+    REQUIRE(std::next(copy) == it);
+
+    auto first_three = text::tokenize(line, ',') | std::views::take(3);
+    REQUIRE(collect(first_three) == Fields{"3", "14", "1"});
+}
@@ -0,0 +1,121 @@
+// Benchmark: cost of one probe
+//
+// Times a loop of `iterations` empty scopes instrumented different ways and
+// reports the cost per scope over an uninstrumented loop:
+//
+//   TRACE_SCOPE (enabled)    TscClock + per-thread ring
+//   TRACE_SCOPE (disabled)   one relaxed load
+//   steady_clock pair        two steady_clock::now() calls, no recording
+//   Stopwatch to ostream     chapters/ch16_utilities/examples/chrono.cpp
+//                            style: high_resolution_clock and a formatted
+//                            print per scope (to a string stream, so the
+//                            terminal does not dominate)
+//
+// The rings are drained between rounds so the enabled probes never hit a
+// full ring and measure the drop path instead.
+
+#include "trace.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace tracing;
+
+namespace {
+
+constexpr int iterations = Tracer::ring_capacity / 2;
+constexpr int rounds = 200;
+
+volatile int sink = 0;
+
+class Stopwatch {
+public:
+    explicit Stopwatch(std::ostream& out)
+        : out_{out}, start_{std::chrono::high_resolution_clock::now()} {}
+
+    ~Stopwatch() {
+        const auto elapsed = std::chrono::high_resolution_clock::now() - start_;
+        out_ << "Elapsed: " << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+             << "ns\n";
+    }
+
+    Stopwatch(const Stopwatch&) = delete;
+    Stopwatch& operator=(const Stopwatch&) = delete;
+
+private:
+    std::ostream& out_;
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+// Returns the best ns per iteration over all rounds
+template <typename Body>
+double per_iteration(Body body) {
+    double best = 1e300;
+    for (int r = 0; r < rounds; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            body(i);
+        }
+        const std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / iterations);
+        Tracer::instance().drain();
+    }
+    return best;
+}
+
+void report(const std::string& name, double ns, double baseline) {
+    std::cout << "  " << std::left << std::setw(26) << name << std::right << std::setw(8)
+              << std::fixed << std::setprecision(2) << ns - baseline << " ns per scope\n";
+}
+
+} // namespace
+
+int main() {
+    auto& tracer = Tracer::instance();
+    (void)TscClock::ticks_per_ns();  // calibrate outside the timed loops
+
+    std::cout << "=== Probe overhead: best of " << rounds << " rounds x " << iterations
+              << " scopes ===\n\n";
+
+    const double baseline = per_iteration([](int i) { sink = i; });
+
+    tracer.enable();
+    const double enabled = per_iteration([](int i) {
+        TRACE_SCOPE("bench.enabled");
+        sink = i;
+    });
+
+    tracer.enable(false);
+    const double disabled = per_iteration([](int i) {
+        TRACE_SCOPE("bench.disabled");
+        sink = i;
+    });
+    tracer.enable();
+
+    const double steady = per_iteration([](int i) {
+        const auto start = std::chrono::steady_clock::now();
+        sink = i;
+        const auto end = std::chrono::steady_clock::now();
+        sink = static_cast<int>((end - start).count());
+    });
+
+    std::ostringstream out;
+    const double stopwatch = per_iteration([&out](int i) {
+        Stopwatch watch{out};
+        sink = i;
+    });
+
+    report("TRACE_SCOPE (enabled)", enabled, baseline);
+    report("TRACE_SCOPE (disabled)", disabled, baseline);
+    report("steady_clock pair", steady, baseline);
+    report("Stopwatch to ostream", stopwatch, baseline);
+
+    if (tracer.dropped() != 0) {
+        std::cout << "\nwarning: " << tracer.dropped() << " events dropped\n";
+    }
+    return 0;
+}
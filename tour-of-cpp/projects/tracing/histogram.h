@@ -0,0 +1,114 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace tracing {
+
+/**
+ * A log-linear histogram of non-negative integer values (nanoseconds).
+ *
+ * Every power of two is split into 16 equal sub-buckets, so a reported
+ * percentile is within about 6% of the true value, whatever the magnitude:
+ * 3ns and 3s are recorded with the same relative precision in a fixed
+ * ~8 KB of counters. Values below 16 are exact. This is the layout of
+ * HdrHistogram with one significant hex digit.
+ *
+ * Not thread-safe: the tracer's drainer is its only writer.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int sub_bucket_bits = 4;
+    static constexpr std::size_t sub_buckets = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t bucket_count = sub_buckets * (64 - sub_bucket_bits + 1);
+
+    void record(std::uint64_t value) noexcept {
+        ++counts_[index_of(value)];
+        ++count_;
+        sum_ += static_cast<double>(value);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void clear() noexcept { *this = LatencyHistogram{}; }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] std::uint64_t min() const noexcept { return count_ == 0 ? 0 : min_; }
+    [[nodiscard]] std::uint64_t max() const noexcept { return max_; }
+    [[nodiscard]] double mean() const noexcept {
+        return count_ == 0 ? 0.0 : sum_ / static_cast<double>(count_);
+    }
+
+    // Value at or below which `p` percent of the recorded values fall,
+    // reported as the midpoint of its bucket (clamped to [min, max])
+    [[nodiscard]] std::uint64_t percentile(double p) const noexcept {
+        if (count_ == 0) {
+            return 0;
+        }
+        const double clamped = std::clamp(p, 0.0, 100.0);
+        const auto rank = std::max<std::uint64_t>(
+            1,
+            static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count_))));
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                const std::uint64_t low = lower_bound_of(i);
+                const std::uint64_t mid = low + (width_of(i) - 1) / 2;
+                return std::clamp(mid, min(), max_);
+            }
+        }
+        return max_;
+    }
+
+    [[nodiscard]] static std::size_t index_of(std::uint64_t value) noexcept {
+        if (value < sub_buckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const int exponent = 63 - std::countl_zero(value);  // >= sub_bucket_bits
+        const int shift = exponent - sub_bucket_bits;
+        const auto sub = static_cast<std::size_t>((value >> shift) & (sub_buckets - 1));
+        return sub_buckets * static_cast<std::size_t>(shift + 1) + sub;
+    }
+
+    [[nodiscard]] static std::uint64_t lower_bound_of(std::size_t index) noexcept {
+        if (index < sub_buckets) {
+            return index;
+        }
+        const std::size_t shift = index / sub_buckets - 1;
+        const std::uint64_t sub = index % sub_buckets;
+        return (sub_buckets + sub) << shift;
+    }
+
+    [[nodiscard]] static std::uint64_t width_of(std::size_t index) noexcept {
+        return index < sub_buckets ? 1 : std::uint64_t{1} << (index / sub_buckets - 1);
+    }
+
+private:
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t count_ = 0;
+    double sum_ = 0.0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+};
+
+} // namespace tracing
+
+#endif // HISTOGRAM_H
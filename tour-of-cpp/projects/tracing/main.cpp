@@ -0,0 +1,71 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace tracing;
+
+/**
+ * Demonstrates scoped probes on a small multi-threaded workload.
+ */
+
+namespace {
+
+std::vector<int> make_data(std::size_t n, unsigned seed) {
+    TRACE_SCOPE("make_data");
+    std::vector<int> data(n);
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<int> dist{0, 1'000'000};
+    for (auto& x : data) {
+        x = dist(gen);
+    }
+    return data;
+}
+
+long long process(std::vector<int> data) {
+    TRACE_SCOPE("process");
+    {
+        TRACE_SCOPE("process.sort");
+        std::sort(data.begin(), data.end());
+    }
+    TRACE_SCOPE("process.sum");
+    return std::accumulate(data.begin(), data.end(), 0LL);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Tracing Demo ===\n\n";
+
+    auto& tracer = Tracer::instance();
+    std::cout << "TSC ticks per ns: " << TscClock::ticks_per_ns() << "\n";
+
+    tracer.start_drainer(std::chrono::milliseconds{5});
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < 4; ++t) {
+        workers.emplace_back([t] {
+            long long total = 0;
+            for (unsigned i = 0; i < 50; ++i) {
+                const std::size_t n = (i % 5 == 0) ? 20'000 : 2'000;  // occasional big batch
+                total += process(make_data(n, t * 100 + i));
+            }
+            (void)total;
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    tracer.stop_drainer();
+
+    std::cout << "\nPer-site timings (slowest p99 first):\n\n";
+    tracer.print_report(std::cout);
+
+    std::cout << "\n=== Demo Complete ===\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include "histogram.h"
+#include <cstdint>
+
+using namespace tracing;
+
+TEST_CASE("LatencyHistogram bucketing", "[histogram][buckets]") {
+    SECTION("small values are exact") {
+        for (std::uint64_t v = 0; v < LatencyHistogram::sub_buckets; ++v) {
+            REQUIRE(LatencyHistogram::index_of(v) == v);
+            REQUIRE(LatencyHistogram::lower_bound_of(v) == v);
+        }
+    }
+
+    SECTION("every value falls inside its bucket") {
+        bool inside = true;
+        for (std::uint64_t v : {16ULL, 17ULL, 31ULL, 32ULL, 100ULL, 1000ULL, 123456ULL,
+                                1ULL << 40, (1ULL << 40) + 12345, ~0ULL}) {
+            const auto i = LatencyHistogram::index_of(v);
+            const auto low = LatencyHistogram::lower_bound_of(i);
+            const auto width = LatencyHistogram::width_of(i);
+            inside = inside && i < LatencyHistogram::bucket_count && low <= v && v - low < width;
+        }
+        REQUIRE(inside);
+    }
+
+    SECTION("relative bucket width is at most 1/16") {
+        for (std::size_t i = LatencyHistogram::sub_buckets; i < LatencyHistogram::bucket_count;
+             i += 7) {
+            REQUIRE(LatencyHistogram::width_of(i) * 16 <= LatencyHistogram::lower_bound_of(i));
+        }
+    }
+}
+
+TEST_CASE("LatencyHistogram statistics", "[histogram][stats]") {
+    LatencyHistogram h;
+
+    SECTION("empty histogram") {
+        REQUIRE(h.count() == 0);
+        REQUIRE(h.percentile(50) == 0);
+        REQUIRE(h.max() == 0);
+        REQUIRE(h.mean() == 0.0);
+    }
+
+    SECTION("count, min, max and mean are exact") {
+        h.record(10);
+        h.record(20);
+        h.record(30);
+        REQUIRE(h.count() == 3);
+        REQUIRE(h.min() == 10);
+        REQUIRE(h.max() == 30);
+        REQUIRE(h.mean() == 20.0);
+    }
+
+    SECTION("percentiles are within one bucket") {
+        for (std::uint64_t v = 1; v <= 1000; ++v) {
+            h.record(v);
+        }
+        const auto p50 = h.percentile(50);
+        const auto p99 = h.percentile(99);
+        REQUIRE(p50 >= 500 * 15 / 16);
+        REQUIRE(p50 <= 500 * 17 / 16);
+        REQUIRE(p99 >= 990 * 15 / 16);
+        REQUIRE(p99 <= 1000);
+        REQUIRE(h.percentile(100) <= h.max());
+        REQUIRE(h.percentile(0) >= h.min());
+    }
+
+    SECTION("a slow outlier shows up in max, not p50") {
+        for (int i = 0; i < 999; ++i) {
+            h.record(100);
+        }
+        h.record(1'000'000);
+        REQUIRE(h.percentile(50) >= 96);
+        REQUIRE(h.percentile(50) <= 104);
+        REQUIRE(h.max() == 1'000'000);
+    }
+
+    SECTION("merge combines counts") {
+        LatencyHistogram other;
+        h.record(5);
+        other.record(7);
+        other.record(9);
+        h.merge(other);
+        REQUIRE(h.count() == 3);
+        REQUIRE(h.min() == 5);
+        REQUIRE(h.max() == 9);
+    }
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tracing;
+
+namespace {
+
+const SiteStats* find_site(const std::vector<SiteStats>& stats, const std::string& name) {
+    auto it = std::find_if(stats.begin(), stats.end(),
+                           [&name](const SiteStats& s) { return s.name == name; });
+    return it == stats.end() ? nullptr : &*it;
+}
+
+void traced_work(int n) {
+    TRACE_SCOPE("test.work");
+    volatile int sink = 0;
+    for (int i = 0; i < n; ++i) {
+        sink = sink + i;
+    }
+}
+
+void traced_sleep() {
+    TRACE_SCOPE("test.sleep");
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+}
+
+} // namespace
+
+TEST_CASE("Tracer aggregates probes per site", "[trace][basic]") {
+    auto& tracer = Tracer::instance();
+    tracer.enable();
+    tracer.reset();
+
+    SECTION("counts every probe") {
+        for (int i = 0; i < 100; ++i) {
+            traced_work(10);
+        }
+        traced_sleep();
+
+        const auto stats = tracer.report();
+        const auto* work = find_site(stats, "test.work");
+        const auto* sleep = find_site(stats, "test.sleep");
+        REQUIRE(work != nullptr);
+        REQUIRE(sleep != nullptr);
+        REQUIRE(work->count == 100);
+        REQUIRE(sleep->count == 1);
+        REQUIRE(work->location.find("test_trace.cpp") != std::string::npos);
+    }
+
+    SECTION("durations are in nanoseconds") {
+        traced_sleep();
+        const auto stats = tracer.report();
+        const auto* sleep = find_site(stats, "test.sleep");
+        REQUIRE(sleep != nullptr);
+        // 2ms sleep: at least 1.5ms even with bucket rounding and calibration error
+        REQUIRE(sleep->max_ns >= 1'500'000);
+        REQUIRE(sleep->p50_ns >= 1'500'000);
+        // Sorted slowest first
+        REQUIRE(stats.front().name == "test.sleep");
+    }
+
+    SECTION("disabled tracer records nothing") {
+        tracer.enable(false);
+        traced_work(10);
+        tracer.enable();
+        REQUIRE(find_site(tracer.report(), "test.work") == nullptr);
+    }
+
+    SECTION("full rings drop events instead of blocking") {
+        const auto extra = 100;
+        for (std::size_t i = 0; i < Tracer::ring_capacity + extra; ++i) {
+            traced_work(0);
+        }
+        REQUIRE(tracer.dropped() >= extra);
+
+        const auto* work = find_site(tracer.report(), "test.work");
+        REQUIRE(work != nullptr);
+        REQUIRE(work->count <= Tracer::ring_capacity);
+        tracer.reset();
+        REQUIRE(tracer.dropped() == 0);
+    }
+
+    SECTION("print_report lists every site") {
+        traced_work(1);
+        std::ostringstream out;
+        tracer.print_report(out);
+        REQUIRE(out.str().find("test.work") != std::string::npos);
+        REQUIRE(out.str().find("p99 ns") != std::string::npos);
+    }
+}
+
+TEST_CASE("Tracer collects from many threads", "[trace][concurrent]") {
+    auto& tracer = Tracer::instance();
+    tracer.enable();
+    tracer.reset();
+    tracer.start_drainer(std::chrono::milliseconds{1});
+
+    constexpr int threads = 4;
+    constexpr int per_thread = 20'000;  // more than one ring's worth
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([] {
+            for (int i = 0; i < per_thread; ++i) {
+                traced_work(5);
+                if (i % 1000 == 0) {
+                    // Give the drainer a chance on machines with few cores
+                    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    tracer.stop_drainer();
+
+    const auto* work = find_site(tracer.report(), "test.work");
+    REQUIRE(work != nullptr);
+    // Exited threads' rings are drained too; all that can be missing is drops
+    REQUIRE(work->count + tracer.dropped() == static_cast<std::uint64_t>(threads) * per_thread);
+    REQUIRE(work->count > 0);
+}
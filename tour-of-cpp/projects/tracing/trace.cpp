@@ -0,0 +1,159 @@
+#include "trace.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace tracing {
+
+// =============================================================================
+// Lifetime
+// =============================================================================
+
+Tracer::~Tracer() {
+    stop_drainer();
+}
+
+std::shared_ptr<Tracer::ThreadBuffer> Tracer::register_thread() {
+    auto buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock{registry_mutex_};
+    buffers_.push_back(buffer);
+    return buffer;
+}
+
+// =============================================================================
+// Draining
+// =============================================================================
+
+std::size_t Tracer::drain() {
+    std::lock_guard<std::mutex> lock{drain_mutex_};
+    return drain_locked();
+}
+
+std::size_t Tracer::drain_locked() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock{registry_mutex_};
+        buffers = buffers_;
+    }
+
+    std::size_t drained = 0;
+    std::vector<ThreadBuffer*> finished;
+    for (const auto& buffer : buffers) {
+        // Read the flag first: once it is set the owner pushes nothing more
+        const bool exited = buffer->exited.load(std::memory_order_acquire);
+        while (auto event = buffer->ring.try_pop()) {
+            const double ns = TscClock::to_ns(event->end - event->start);
+            histograms_[event->site].record(static_cast<std::uint64_t>(ns));
+            ++drained;
+        }
+        if (exited) {
+            finished.push_back(buffer.get());
+        }
+    }
+
+    if (!finished.empty()) {
+        std::lock_guard<std::mutex> lock{registry_mutex_};
+        std::erase_if(buffers_, [&](const std::shared_ptr<ThreadBuffer>& b) {
+            if (std::find(finished.begin(), finished.end(), b.get()) == finished.end()) {
+                return false;
+            }
+            retired_dropped_ += b->dropped.load(std::memory_order_relaxed);
+            return true;
+        });
+    }
+    return drained;
+}
+
+void Tracer::start_drainer(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock{drainer_mutex_};
+    if (drainer_.joinable()) {
+        return;
+    }
+    drainer_stop_ = false;
+    drainer_ = std::thread{[this, interval] {
+        std::unique_lock<std::mutex> guard{drainer_mutex_};
+        while (!drainer_cv_.wait_for(guard, interval, [this] { return drainer_stop_; })) {
+            guard.unlock();
+            drain();
+            guard.lock();
+        }
+    }};
+}
+
+void Tracer::stop_drainer() {
+    std::thread drainer;
+    {
+        std::lock_guard<std::mutex> lock{drainer_mutex_};
+        drainer_stop_ = true;
+        drainer = std::move(drainer_);
+    }
+    drainer_cv_.notify_all();
+    if (drainer.joinable()) {
+        drainer.join();
+    }
+}
+
+// =============================================================================
+// Reporting
+// =============================================================================
+
+std::vector<SiteStats> Tracer::report() {
+    std::lock_guard<std::mutex> lock{drain_mutex_};
+    drain_locked();
+
+    std::vector<SiteStats> stats;
+    stats.reserve(histograms_.size());
+    for (const auto& [site, histogram] : histograms_) {
+        stats.push_back(SiteStats{
+            .name = site->name,
+            .location = std::string{site->file} + ":" + std::to_string(site->line),
+            .count = histogram.count(),
+            .mean_ns = histogram.mean(),
+            .p50_ns = histogram.percentile(50.0),
+            .p99_ns = histogram.percentile(99.0),
+            .max_ns = histogram.max(),
+        });
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const SiteStats& a, const SiteStats& b) { return a.p99_ns > b.p99_ns; });
+    return stats;
+}
+
+void Tracer::print_report(std::ostream& out) {
+    const auto stats = report();
+
+    out << std::left << std::setw(24) << "probe" << std::right << std::setw(10) << "count"
+        << std::setw(12) << "mean ns" << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns"
+        << std::setw(12) << "max ns" << "\n";
+    for (const auto& s : stats) {
+        out << std::left << std::setw(24) << s.name << std::right << std::setw(10) << s.count
+            << std::setw(12) << std::fixed << std::setprecision(1) << s.mean_ns << std::setw(10)
+            << s.p50_ns << std::setw(10) << s.p99_ns << std::setw(12) << s.max_ns << "\n";
+    }
+    if (const auto lost = dropped(); lost > 0) {
+        out << "(" << lost << " events dropped: rings were full)\n";
+    }
+}
+
+std::uint64_t Tracer::dropped() const {
+    std::lock_guard<std::mutex> lock{registry_mutex_};
+    std::uint64_t total = retired_dropped_;
+    for (const auto& buffer : buffers_) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Tracer::reset() {
+    std::lock_guard<std::mutex> lock{drain_mutex_};
+    drain_locked();
+    histograms_.clear();
+
+    std::lock_guard<std::mutex> registry_lock{registry_mutex_};
+    retired_dropped_ = 0;
+    for (const auto& buffer : buffers_) {
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace tracing
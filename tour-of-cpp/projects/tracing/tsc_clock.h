@@ -0,0 +1,80 @@
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define TRACING_HAS_RDTSC 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define TRACING_HAS_RDTSC 1
+#else
+    #define TRACING_HAS_RDTSC 0
+#endif
+
+namespace tracing {
+
+/**
+ * The cheapest timestamp the machine offers.
+ *
+ * On x86 this is the time-stamp counter (RDTSC): a single instruction of
+ * roughly 20 cycles, versus a vDSO call for steady_clock. Modern x86 CPUs
+ * have an invariant TSC that ticks at a constant rate on every core, so
+ * differences are meaningful even if a thread migrates. Elsewhere it falls
+ * back to steady_clock, in nanoseconds.
+ *
+ * RDTSC is not serializing: the CPU may execute it slightly before or after
+ * its neighbours. For probes around code that takes tens of nanoseconds or
+ * more this error does not matter; for timing a handful of instructions,
+ * use a microbenchmark instead.
+ */
+class TscClock {
+public:
+    [[nodiscard]] static std::uint64_t now() noexcept {
+#if TRACING_HAS_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+#endif
+    }
+
+    // Ticks per nanosecond, measured once against steady_clock
+    [[nodiscard]] static double ticks_per_ns() noexcept {
+        static const double rate = calibrate();
+        return rate;
+    }
+
+    [[nodiscard]] static double to_ns(std::uint64_t ticks) noexcept {
+        return static_cast<double>(ticks) / ticks_per_ns();
+    }
+
+private:
+    static double calibrate() noexcept {
+#if TRACING_HAS_RDTSC
+        using namespace std::chrono;
+        const auto wall_start = steady_clock::now();
+        const std::uint64_t tsc_start = now();
+        std::this_thread::sleep_for(milliseconds{20});
+        const std::uint64_t tsc_end = now();
+        const auto wall_end = steady_clock::now();
+
+        const auto elapsed_ns = duration_cast<nanoseconds>(wall_end - wall_start).count();
+        if (elapsed_ns <= 0 || tsc_end <= tsc_start) {
+            return 1.0;
+        }
+        return static_cast<double>(tsc_end - tsc_start) / static_cast<double>(elapsed_ns);
+#else
+        return 1.0;
+#endif
+    }
+};
+
+} // namespace tracing
+
+#endif // TSC_CLOCK_H